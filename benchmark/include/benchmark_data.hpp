@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>  // size_t
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "databento/enums.hpp"      // Schema
+#include "databento/ireadable.hpp"  // IReadable
+#include "databento/record.hpp"     // MboMsg
+
+namespace databento {
+namespace bench {
+// The schemas with test data files.
+const std::vector<Schema>& TestDataSchemas();
+// The path of the test data file for `schema` in DBN `version`, optionally
+// Zstd-compressed.
+std::string TestDataPath(Schema schema, std::uint8_t version,
+                         bool is_compressed);
+// The paths of all test data files: every schema in each version and
+// compression.
+const std::vector<std::string>& TestDataPaths();
+
+// The schemas whose test data files have records to generate synthetic files
+// from.
+const std::vector<Schema>& SyntheticSchemas();
+// Returns the path of a synthetic DBN file of about `kSyntheticFileSize`
+// bytes of records, generated by repeating the records of the test data file
+// for `schema` in `version`. Files are generated on first use. Only the most
+// recently used synthetic file is kept, so running the whole suite doesn't
+// need much disk space.
+std::string SyntheticPath(Schema schema, std::uint8_t version,
+                          bool is_compressed);
+constexpr std::size_t kSyntheticFileSize = 32 * 1024 * 1024;
+
+// The name of the file at `file_path` without its directory, for labeling
+// results.
+std::string FileName(const std::string& file_path);
+std::uint64_t FileSize(const std::string& file_path);
+// Generates `count` MBO messages spread evenly over `instrument_count`
+// instruments. Most are adds and cancels near the top of the book, with some
+// modifies and trades, like a busy futures market. The messages are the same
+// on every run.
+std::vector<MboMsg> GenMboMessages(std::size_t count,
+                                   std::uint32_t instrument_count);
+constexpr std::size_t kSyntheticMboCount = 1000000;
+
+// Reads a whole file into memory.
+std::vector<std::uint8_t> ReadFile(const std::string& file_path);
+// The resident set size of the process in bytes, or 0 if it can't be
+// determined on this platform. Free heap memory is first returned to the OS
+// where possible, so the difference between two calls reflects the memory
+// allocated in between.
+std::size_t ResidentBytes();
+
+// Streams from an in-memory buffer it doesn't own, so decoding can be measured
+// without reading from disk.
+class MemoryStream : public IReadable {
+ public:
+  MemoryStream(const std::uint8_t* data, std::size_t size)
+      : data_{data}, size_{size} {}
+
+  void ReadExact(std::uint8_t* buffer, std::size_t length) override;
+  std::size_t ReadSome(std::uint8_t* buffer, std::size_t max_length) override;
+
+ private:
+  const std::uint8_t* data_;
+  std::size_t size_;
+  std::size_t pos_{};
+};
+}  // namespace bench
+}  // namespace databento
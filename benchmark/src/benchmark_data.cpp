@@ -0,0 +1,291 @@
+#include "benchmark_data.hpp"
+
+#ifdef __linux__
+#include <unistd.h>  // sysconf
+#endif
+#ifdef __GLIBC__
+#include <malloc.h>  // malloc_trim
+#endif
+
+#include <algorithm>  // copy, min
+#include <chrono>     // nanoseconds
+#include <cstdio>     // remove
+#include <fstream>    // ifstream
+#include <iterator>   // istreambuf_iterator
+#include <memory>     // unique_ptr
+#include <random>     // mt19937_64
+#include <sstream>    // ostringstream
+#include <utility>    // move
+
+#include "databento/constants.hpp"           // kFixedPriceScale
+#include "databento/datetime.hpp"            // UnixNanos
+#include "databento/dbn.hpp"                 // Metadata
+#include "databento/dbn_decoder.hpp"         // DbnDecoder
+#include "databento/dbn_encoder.hpp"         // DbnEncoder
+#include "databento/detail/file_stream.hpp"  // FileStream, OutFileStream
+#include "databento/exceptions.hpp"          // DbnResponseError
+#include "databento/flag_set.hpp"            // FlagSet
+#include "databento/record.hpp"              // Record, RecordBatch
+
+namespace databento {
+namespace bench {
+namespace {
+std::string SchemaFileName(const std::string& prefix, Schema schema,
+                           std::uint8_t version, bool is_compressed) {
+  std::ostringstream file_name;
+  file_name << prefix << '.' << ToString(schema);
+  if (version == 1) {
+    file_name << ".v1";
+  }
+  file_name << ".dbn";
+  if (is_compressed) {
+    file_name << ".zst";
+  }
+  return file_name.str();
+}
+
+// Decodes the records of a test data file as they're encoded in the file.
+std::vector<std::uint8_t> ReadTestRecords(Schema schema, std::uint8_t version,
+                                          Metadata* metadata) {
+  DbnDecoder decoder{
+      detail::FileStream{TestDataPath(schema, version, false)}};
+  *metadata = decoder.DecodeMetadata();
+  std::vector<std::uint8_t> res;
+  while (const Record* record = decoder.DecodeRecord()) {
+    const auto* bytes =
+        reinterpret_cast<const std::uint8_t*>(&record->Header());
+    res.insert(res.end(), bytes, bytes + record->Size());
+  }
+  return res;
+}
+
+void GenerateSyntheticFile(const std::string& file_path, Schema schema,
+                           std::uint8_t version, bool is_compressed) {
+  Metadata metadata{};
+  const auto test_records = ReadTestRecords(schema, version, &metadata);
+  if (test_records.empty()) {
+    throw DbnResponseError{"No test data records for " +
+                           std::string{ToString(schema)}};
+  }
+  std::vector<std::uint8_t> records;
+  records.reserve(kSyntheticFileSize + test_records.size());
+  while (records.size() < kSyntheticFileSize) {
+    records.insert(records.end(), test_records.begin(), test_records.end());
+  }
+  // Vary the timestamps and instruments so the records compress more like
+  // real data than exact repeats would
+  std::mt19937_64 rng{42};
+  auto ts_event = metadata.start.time_since_epoch().count();
+  for (std::size_t pos = 0; pos < records.size();) {
+    auto& header = *reinterpret_cast<RecordHeader*>(&records[pos]);
+    ts_event += rng() % 1000;
+    header.ts_event = UnixNanos{std::chrono::nanoseconds{ts_event}};
+    header.instrument_id += static_cast<std::uint32_t>(rng() % 16);
+    pos += header.Size();
+  }
+  DbnEncoder encoder{
+      metadata,
+      std::unique_ptr<IWritable>{new detail::OutFileStream{file_path}},
+      is_compressed ? Compression::Zstd : Compression::None};
+  encoder.EncodeRecords(RecordBatch{records.data(), records.size()});
+  encoder.Finish();
+}
+
+// Removes the most recently used synthetic file when the next one is
+// generated and at exit.
+class SyntheticFileCache {
+ public:
+  SyntheticFileCache() = default;
+  SyntheticFileCache(const SyntheticFileCache&) = delete;
+  SyntheticFileCache& operator=(const SyntheticFileCache&) = delete;
+  ~SyntheticFileCache() { Remove(); }
+
+  const std::string& Get(Schema schema, std::uint8_t version,
+                         bool is_compressed) {
+    auto file_path = SchemaFileName(BENCHMARK_BUILD_DIR "/synthetic", schema,
+                                    version, is_compressed);
+    if (file_path != file_path_) {
+      Remove();
+      GenerateSyntheticFile(file_path, schema, version, is_compressed);
+      file_path_ = std::move(file_path);
+    }
+    return file_path_;
+  }
+
+ private:
+  void Remove() {
+    if (!file_path_.empty()) {
+      std::remove(file_path_.c_str());
+      file_path_.clear();
+    }
+  }
+
+  std::string file_path_;
+};
+}  // namespace
+
+const std::vector<Schema>& TestDataSchemas() {
+  static const std::vector<Schema> kSchemas{
+      Schema::Mbo,        Schema::Mbp1,      Schema::Mbp10,
+      Schema::Tbbo,       Schema::Trades,    Schema::Ohlcv1S,
+      Schema::Ohlcv1M,    Schema::Ohlcv1H,   Schema::Ohlcv1D,
+      Schema::Definition, Schema::Imbalance, Schema::Statistics};
+  return kSchemas;
+}
+
+const std::vector<Schema>& SyntheticSchemas() {
+  static const std::vector<Schema> kSchemas = [] {
+    std::vector<Schema> res;
+    for (const auto schema : TestDataSchemas()) {
+      Metadata metadata{};
+      if (!ReadTestRecords(schema, 1, &metadata).empty() &&
+          !ReadTestRecords(schema, 2, &metadata).empty()) {
+        res.push_back(schema);
+      }
+    }
+    return res;
+  }();
+  return kSchemas;
+}
+
+std::string TestDataPath(Schema schema, std::uint8_t version,
+                         bool is_compressed) {
+  return SchemaFileName(BENCHMARK_DATA_DIR "/test_data", schema, version,
+                        is_compressed);
+}
+
+const std::vector<std::string>& TestDataPaths() {
+  static const std::vector<std::string> kPaths = [] {
+    std::vector<std::string> res;
+    for (const auto schema : TestDataSchemas()) {
+      for (std::uint8_t version = 1; version <= 2; ++version) {
+        res.emplace_back(TestDataPath(schema, version, false));
+        res.emplace_back(TestDataPath(schema, version, true));
+      }
+    }
+    return res;
+  }();
+  return kPaths;
+}
+
+std::string SyntheticPath(Schema schema, std::uint8_t version,
+                          bool is_compressed) {
+  static SyntheticFileCache cache;
+  return cache.Get(schema, version, is_compressed);
+}
+
+std::vector<MboMsg> GenMboMessages(std::size_t count,
+                                   std::uint32_t instrument_count) {
+  constexpr std::int64_t kTick = kFixedPriceScale / 4;
+  constexpr std::int64_t kMid = 4000 * kFixedPriceScale;
+  struct LiveOrder {
+    std::uint64_t order_id;
+    std::int64_t price;
+    std::uint32_t size;
+    Side side;
+  };
+  std::vector<std::vector<LiveOrder>> live_orders(instrument_count);
+  std::mt19937_64 rng{42};
+  std::uint64_t next_order_id = 1;
+  std::vector<MboMsg> res;
+  res.reserve(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    const auto instrument_idx =
+        static_cast<std::uint32_t>(rng() % instrument_count);
+    auto& orders = live_orders[instrument_idx];
+    MboMsg mbo{};
+    mbo.hd = RecordHeader{sizeof(MboMsg) / RecordHeader::kLengthMultiplier,
+                          RType::Mbo, 1, instrument_idx + 1, UnixNanos{}};
+    mbo.ts_recv = UnixNanos{std::chrono::nanoseconds{i}};
+    mbo.flags = FlagSet::kLast;
+    mbo.sequence = static_cast<std::uint32_t>(i);
+    const auto roll = rng() % 100;
+    if (orders.empty() || roll < 50) {
+      const auto side = rng() % 2 == 0 ? Side::Bid : Side::Ask;
+      const auto ticks = static_cast<std::int64_t>(1 + rng() % 20);
+      const LiveOrder order{
+          next_order_id++,
+          side == Side::Bid ? kMid - ticks * kTick : kMid + ticks * kTick,
+          static_cast<std::uint32_t>(1 + rng() % 10), side};
+      orders.push_back(order);
+      mbo.action = Action::Add;
+      mbo.order_id = order.order_id;
+      mbo.price = order.price;
+      mbo.size = order.size;
+      mbo.side = order.side;
+    } else {
+      auto& order = orders[rng() % orders.size()];
+      mbo.order_id = order.order_id;
+      mbo.price = order.price;
+      mbo.side = order.side;
+      if (roll < 85) {
+        mbo.action = Action::Cancel;
+        mbo.size = order.size;
+        order = orders.back();
+        orders.pop_back();
+      } else if (roll < 95) {
+        mbo.action = Action::Modify;
+        order.size = static_cast<std::uint32_t>(1 + rng() % 10);
+        mbo.size = order.size;
+      } else {
+        mbo.action = Action::Trade;
+        mbo.size = 1;
+      }
+    }
+    res.push_back(mbo);
+  }
+  return res;
+}
+
+std::string FileName(const std::string& file_path) {
+  return file_path.substr(file_path.find_last_of('/') + 1);
+}
+
+std::uint64_t FileSize(const std::string& file_path) {
+  std::ifstream stream{file_path, std::ios::binary | std::ios::ate};
+  if (!stream.good()) {
+    throw DbnResponseError{"Couldn't open benchmark data file " + file_path};
+  }
+  return static_cast<std::uint64_t>(stream.tellg());
+}
+
+std::vector<std::uint8_t> ReadFile(const std::string& file_path) {
+  std::ifstream stream{file_path, std::ios::binary};
+  if (!stream.good()) {
+    throw DbnResponseError{"Couldn't open benchmark data file " + file_path};
+  }
+  return {std::istreambuf_iterator<char>{stream},
+          std::istreambuf_iterator<char>{}};
+}
+
+std::size_t ResidentBytes() {
+#ifdef __GLIBC__
+  ::malloc_trim(0);
+#endif
+#ifdef __linux__
+  std::ifstream statm{"/proc/self/statm"};
+  std::size_t total_pages{};
+  std::size_t resident_pages{};
+  if (statm >> total_pages >> resident_pages) {
+    return resident_pages * static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+  }
+#endif
+  return 0;
+}
+
+void MemoryStream::ReadExact(std::uint8_t* buffer, std::size_t length) {
+  if (size_ - pos_ < length) {
+    throw DbnResponseError{"Unexpected end of benchmark input"};
+  }
+  ReadSome(buffer, length);
+}
+
+std::size_t MemoryStream::ReadSome(std::uint8_t* buffer,
+                                   std::size_t max_length) {
+  const auto read_size = std::min(max_length, size_ - pos_);
+  std::copy(data_ + pos_, data_ + pos_ + read_size, buffer);
+  pos_ += read_size;
+  return read_size;
+}
+}  // namespace bench
+}  // namespace databento
@@ -0,0 +1,71 @@
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "benchmark_data.hpp"
+#include "databento/column_kernels.hpp"
+#include "databento/constants.hpp"
+#include "databento/record.hpp"
+
+namespace databento {
+namespace bench {
+namespace {
+// The price and size columns of synthetic MBO messages.
+struct Columns {
+  Columns() {
+    for (const auto& mbo : GenMboMessages(kSyntheticMboCount, 1)) {
+      prices.push_back(mbo.price);
+      sizes.push_back(mbo.size);
+    }
+  }
+
+  std::vector<std::int64_t> prices;
+  std::vector<std::uint32_t> sizes;
+};
+
+const Columns& SyntheticColumns() {
+  static const Columns kColumns;
+  return kColumns;
+}
+
+// Selects the prices within 10 ticks of the middle, then computes the VWAP of
+// the selected rows.
+//
+// Args: instruction set
+void BM_ColumnKernelsRangeVwap(benchmark::State& state) {
+  constexpr std::int64_t kMinPrice = 39975 * kFixedPriceScale / 10;
+  constexpr std::int64_t kMaxPrice = 40025 * kFixedPriceScale / 10;
+  const auto isa = static_cast<KernelIsa>(state.range(0));
+  state.SetLabel(ToString(isa));
+  if (!ColumnKernels::IsSupported(isa)) {
+    state.SkipWithError("Instruction set not supported by this CPU");
+    return;
+  }
+  const ColumnKernels kernels{isa};
+  const auto& columns = SyntheticColumns();
+  const auto count = columns.prices.size();
+  std::vector<std::uint8_t> mask(count);
+  for (auto _ : state) {
+    kernels.RangeMask(columns.prices.data(), count, kMinPrice, kMaxPrice,
+                      mask.data());
+    benchmark::DoNotOptimize(kernels.Vwap(
+        columns.prices.data(), columns.sizes.data(), mask.data(), count));
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<std::int64_t>(count));
+  state.SetBytesProcessed(
+      state.iterations() *
+      static_cast<std::int64_t>(count * (sizeof(std::int64_t) +
+                                         sizeof(std::uint32_t))));
+}
+}  // namespace
+
+BENCHMARK(BM_ColumnKernelsRangeVwap)
+    ->Arg(static_cast<std::int64_t>(KernelIsa::Scalar))
+    ->Arg(static_cast<std::int64_t>(KernelIsa::Sse42))
+    ->Arg(static_cast<std::int64_t>(KernelIsa::Avx2))
+    ->Unit(benchmark::kMicrosecond);
+}  // namespace bench
+}  // namespace databento
@@ -0,0 +1,125 @@
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>  // unique_ptr
+#include <string>
+#include <vector>
+
+#include "benchmark_data.hpp"
+#include "databento/dbn_decoder.hpp"
+#include "databento/enums.hpp"
+#include "databento/ireadable.hpp"
+#include "databento/record.hpp"
+
+namespace databento {
+namespace bench {
+namespace {
+enum ReadMode : std::int64_t {
+  // Streams the input from memory through the decoder's buffer.
+  kStream = 0,
+  // Decodes uncompressed input in place without copying.
+  kInPlace = 1,
+};
+
+// Decodes all records with `DecodeRecord`, adding to the counts of records
+// and record bytes.
+void DecodeAll(DbnDecoder* decoder, std::int64_t* record_count,
+               std::int64_t* record_bytes) {
+  decoder->DecodeMetadata();
+  while (const Record* record = decoder->DecodeRecord()) {
+    benchmark::DoNotOptimize(record);
+    ++*record_count;
+    *record_bytes += static_cast<std::int64_t>(record->Size());
+  }
+}
+
+std::string Label(const std::string& file_path,
+                  VersionUpgradePolicy upgrade_policy) {
+  return FileName(file_path) + " " + ToString(upgrade_policy);
+}
+
+// Args: test data file index, upgrade policy
+void BM_DecodeRecordTestData(benchmark::State& state) {
+  const auto& file_path =
+      TestDataPaths()[static_cast<std::size_t>(state.range(0))];
+  const auto upgrade_policy = static_cast<VersionUpgradePolicy>(state.range(1));
+  const auto buffer = ReadFile(file_path);
+  std::int64_t record_count{};
+  std::int64_t record_bytes{};
+  for (auto _ : state) {
+    DbnDecoder decoder{buffer.data(), buffer.size(), upgrade_policy};
+    DecodeAll(&decoder, &record_count, &record_bytes);
+  }
+  state.SetItemsProcessed(record_count);
+  state.SetBytesProcessed(record_bytes);
+  state.SetLabel(Label(file_path, upgrade_policy));
+}
+
+void TestDataArgs(benchmark::internal::Benchmark* bm) {
+  const auto& file_paths = TestDataPaths();
+  for (std::size_t i = 0; i < file_paths.size(); ++i) {
+    const auto idx = static_cast<std::int64_t>(i);
+    bm->Args({idx, static_cast<std::int64_t>(VersionUpgradePolicy::AsIs)});
+    if (file_paths[i].find(".v1.") != std::string::npos) {
+      bm->Args(
+          {idx, static_cast<std::int64_t>(VersionUpgradePolicy::Upgrade)});
+    }
+  }
+}
+
+// Args: schema index, DBN version, is compressed, upgrade policy, read mode
+void BM_DecodeRecordSynthetic(benchmark::State& state) {
+  const auto schema =
+      SyntheticSchemas()[static_cast<std::size_t>(state.range(0))];
+  const auto version = static_cast<std::uint8_t>(state.range(1));
+  const bool is_compressed = state.range(2) != 0;
+  const auto upgrade_policy = static_cast<VersionUpgradePolicy>(state.range(3));
+  const auto read_mode = state.range(4);
+  const auto file_path = SyntheticPath(schema, version, is_compressed);
+  const auto buffer = ReadFile(file_path);
+  std::int64_t record_count{};
+  std::int64_t record_bytes{};
+  for (auto _ : state) {
+    if (read_mode == kInPlace) {
+      DbnDecoder decoder{buffer.data(), buffer.size(), upgrade_policy};
+      DecodeAll(&decoder, &record_count, &record_bytes);
+    } else {
+      DbnDecoder decoder{
+          std::unique_ptr<IReadable>{
+              new MemoryStream{buffer.data(), buffer.size()}},
+          upgrade_policy};
+      DecodeAll(&decoder, &record_count, &record_bytes);
+    }
+  }
+  state.SetItemsProcessed(record_count);
+  state.SetBytesProcessed(record_bytes);
+  state.SetLabel(Label(file_path, upgrade_policy) +
+                 (read_mode == kInPlace ? " in place" : " stream"));
+}
+
+// Compares reading modes, compression, and decoding v1 as-is and upgraded to
+// v2 against decoding v2 for each schema.
+void SyntheticArgs(benchmark::internal::Benchmark* bm) {
+  constexpr auto kAsIs = static_cast<std::int64_t>(VersionUpgradePolicy::AsIs);
+  constexpr auto kUpgrade =
+      static_cast<std::int64_t>(VersionUpgradePolicy::Upgrade);
+  for (std::size_t i = 0; i < SyntheticSchemas().size(); ++i) {
+    const auto idx = static_cast<std::int64_t>(i);
+    // Grouped by file so each synthetic file is only generated once
+    bm->Args({idx, 2, 0, kAsIs, kStream});
+    bm->Args({idx, 2, 0, kAsIs, kInPlace});
+    bm->Args({idx, 2, 1, kAsIs, kStream});
+    bm->Args({idx, 1, 0, kAsIs, kStream});
+    bm->Args({idx, 1, 0, kUpgrade, kStream});
+    bm->Args({idx, 1, 1, kUpgrade, kStream});
+  }
+}
+}  // namespace
+
+BENCHMARK(BM_DecodeRecordTestData)->Apply(TestDataArgs);
+BENCHMARK(BM_DecodeRecordSynthetic)
+    ->Apply(SyntheticArgs)
+    ->Unit(benchmark::kMillisecond);
+}  // namespace bench
+}  // namespace databento
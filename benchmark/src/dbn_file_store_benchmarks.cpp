@@ -0,0 +1,107 @@
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "benchmark_data.hpp"
+#include "databento/dbn_file_store.hpp"
+#include "databento/enums.hpp"
+#include "databento/record.hpp"
+#include "databento/timeseries.hpp"
+
+namespace databento {
+namespace bench {
+namespace {
+// Replays the file once per iteration, reporting records and record bytes
+// per second as well as file bytes per second, which differ for compressed
+// files.
+template <typename MakeFileStore>
+void ReplayFile(benchmark::State& state, const std::string& file_path,
+                const MakeFileStore& make_file_store) {
+  const auto file_size = FileSize(file_path);
+  std::int64_t record_count{};
+  std::int64_t record_bytes{};
+  for (auto _ : state) {
+    auto file_store = make_file_store();
+    file_store.Replay([&record_count, &record_bytes](const Record& record) {
+      benchmark::DoNotOptimize(&record);
+      ++record_count;
+      record_bytes += static_cast<std::int64_t>(record.Size());
+      return KeepGoing::Continue;
+    });
+  }
+  state.SetItemsProcessed(record_count);
+  state.SetBytesProcessed(record_bytes);
+  state.counters["file_bytes_per_second"] =
+      benchmark::Counter{static_cast<double>(file_size) *
+                             static_cast<double>(state.iterations()),
+                         benchmark::Counter::kIsRate};
+}
+
+// Args: test data file index, upgrade policy
+void BM_DbnFileStoreReplayTestData(benchmark::State& state) {
+  const auto& file_path =
+      TestDataPaths()[static_cast<std::size_t>(state.range(0))];
+  const auto upgrade_policy = static_cast<VersionUpgradePolicy>(state.range(1));
+  ReplayFile(state, file_path, [&file_path, upgrade_policy] {
+    return DbnFileStore{file_path, upgrade_policy};
+  });
+  state.SetLabel(FileName(file_path) + " " + ToString(upgrade_policy));
+}
+
+void TestDataArgs(benchmark::internal::Benchmark* bm) {
+  const auto& file_paths = TestDataPaths();
+  for (std::size_t i = 0; i < file_paths.size(); ++i) {
+    const auto idx = static_cast<std::int64_t>(i);
+    bm->Args({idx, static_cast<std::int64_t>(VersionUpgradePolicy::AsIs)});
+    if (file_paths[i].find(".v1.") != std::string::npos) {
+      bm->Args(
+          {idx, static_cast<std::int64_t>(VersionUpgradePolicy::Upgrade)});
+    }
+  }
+}
+
+// Args: schema index, DBN version, is compressed, upgrade policy, read mode
+void BM_DbnFileStoreReplaySynthetic(benchmark::State& state) {
+  const auto schema =
+      SyntheticSchemas()[static_cast<std::size_t>(state.range(0))];
+  const auto version = static_cast<std::uint8_t>(state.range(1));
+  const bool is_compressed = state.range(2) != 0;
+  const auto upgrade_policy = static_cast<VersionUpgradePolicy>(state.range(3));
+  const auto read_mode = static_cast<DbnFileStore::ReadMode>(state.range(4));
+  const auto file_path = SyntheticPath(schema, version, is_compressed);
+  ReplayFile(state, file_path, [&file_path, upgrade_policy, read_mode] {
+    return DbnFileStore{file_path, upgrade_policy, read_mode};
+  });
+  state.SetLabel(FileName(file_path) + " " + ToString(upgrade_policy) +
+                 (read_mode == DbnFileStore::ReadMode::MemoryMap ? " mmap"
+                                                                 : " stream"));
+}
+
+void SyntheticArgs(benchmark::internal::Benchmark* bm) {
+  constexpr auto kAsIs = static_cast<std::int64_t>(VersionUpgradePolicy::AsIs);
+  constexpr auto kUpgrade =
+      static_cast<std::int64_t>(VersionUpgradePolicy::Upgrade);
+  constexpr auto kStream =
+      static_cast<std::int64_t>(DbnFileStore::ReadMode::Stream);
+  constexpr auto kMemoryMap =
+      static_cast<std::int64_t>(DbnFileStore::ReadMode::MemoryMap);
+  for (std::size_t i = 0; i < SyntheticSchemas().size(); ++i) {
+    const auto idx = static_cast<std::int64_t>(i);
+    // Grouped by file so each synthetic file is only generated once
+    bm->Args({idx, 2, 0, kAsIs, kStream});
+    bm->Args({idx, 2, 0, kAsIs, kMemoryMap});
+    bm->Args({idx, 2, 1, kAsIs, kStream});
+    bm->Args({idx, 1, 0, kUpgrade, kStream});
+    bm->Args({idx, 1, 1, kUpgrade, kStream});
+  }
+}
+}  // namespace
+
+BENCHMARK(BM_DbnFileStoreReplayTestData)->Apply(TestDataArgs);
+BENCHMARK(BM_DbnFileStoreReplaySynthetic)
+    ->Apply(SyntheticArgs)
+    ->Unit(benchmark::kMillisecond);
+}  // namespace bench
+}  // namespace databento
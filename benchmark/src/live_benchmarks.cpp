@@ -0,0 +1,243 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>  // min, sort
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <thread>  // this_thread
+#include <vector>
+
+#include "databento/constants.hpp"
+#include "databento/datetime.hpp"
+#include "databento/dbn.hpp"
+#include "databento/enums.hpp"
+#include "databento/live_blocking.hpp"
+#include "databento/live_threaded.hpp"
+#include "databento/log.hpp"
+#include "databento/record.hpp"
+#include "databento/timeseries.hpp"
+#include "mock/mock_lsg_server.hpp"
+
+namespace databento {
+namespace bench {
+namespace {
+using test::mock::MockLsgServer;
+
+constexpr auto kKey = "32-character-with-lots-of-filler";
+constexpr auto kLocalhost = "127.0.0.1";
+constexpr auto kDataset = dataset::kGlbxMdp3;
+constexpr auto kSymbol = "ES.FUT";
+constexpr auto kTsOut = false;
+// Records sent per iteration when streaming as fast as possible
+constexpr std::int64_t kFlatOutCount = 200000;
+// The most records the mock gateway sends with a single write
+constexpr std::size_t kMaxBatchSize = 64;
+
+std::int64_t SteadyNanos() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+// Streams for about a quarter of a second when rate limited.
+std::int64_t RecordCount(std::int64_t rate) {
+  return rate == 0 ? kFlatOutCount : std::max<std::int64_t>(rate / 4, 1000);
+}
+
+// Completes the session handshake, then sends `count` trades at `rate`
+// records per second, or as fast as possible when `rate` is 0. Each trade's
+// `ts_event` is the steady clock time it was sent, for measuring latency.
+void StreamTrades(MockLsgServer& server, std::int64_t count,
+                  std::int64_t rate) {
+  server.Accept();
+  server.Authenticate();
+  server.Subscribe({kSymbol}, Schema::Trades, SType::Parent);
+  server.Start();
+
+  TradeMsg trade{};
+  trade.hd = {sizeof(TradeMsg) / RecordHeader::kLengthMultiplier, RType::Mbp0,
+              1, 1, UnixNanos{}};
+  trade.price = 4000 * kFixedPriceScale;
+  trade.size = 1;
+  trade.action = Action::Trade;
+  trade.side = Side::Bid;
+  std::string batch;
+  batch.reserve(kMaxBatchSize * sizeof(TradeMsg));
+  const auto start = SteadyNanos();
+  std::int64_t sent{};
+  while (sent < count) {
+    auto due = count - sent;
+    if (rate > 0) {
+      // Send the records whose scheduled time has passed, the first
+      // immediately
+      const auto elapsed = static_cast<double>(SteadyNanos() - start);
+      const auto scheduled =
+          static_cast<std::int64_t>(elapsed * static_cast<double>(rate) / 1e9) +
+          1;
+      due = std::min(due, scheduled - sent);
+      if (due <= 0) {
+        std::this_thread::yield();
+        continue;
+      }
+    }
+    const auto batch_size =
+        std::min(static_cast<std::size_t>(due), kMaxBatchSize);
+    batch.clear();
+    const UnixNanos now{std::chrono::nanoseconds{SteadyNanos()}};
+    for (std::size_t i = 0; i < batch_size; ++i) {
+      trade.hd.ts_event = now;
+      trade.sequence = static_cast<std::uint32_t>(sent);
+      batch.append(reinterpret_cast<const char*>(&trade), sizeof(trade));
+      ++sent;
+    }
+    server.Send(batch);
+  }
+}
+
+void AddLatency(const Record& record, std::vector<std::int64_t>* latencies) {
+  latencies->emplace_back(
+      SteadyNanos() -
+      static_cast<std::int64_t>(
+          record.Header().ts_event.time_since_epoch().count()));
+}
+
+// Reports the sustained throughput and the distribution of the latency from
+// the mock gateway sending each record to the client handing it to the
+// caller.
+void ReportLatencies(benchmark::State& state,
+                     std::vector<std::int64_t>* latencies) {
+  const auto record_count = static_cast<std::int64_t>(latencies->size());
+  state.SetItemsProcessed(record_count);
+  state.SetBytesProcessed(record_count *
+                          static_cast<std::int64_t>(sizeof(TradeMsg)));
+  if (latencies->empty()) {
+    return;
+  }
+  std::sort(latencies->begin(), latencies->end());
+  const auto percentile = [latencies](double quantile) {
+    const auto idx = std::min(
+        static_cast<std::size_t>(quantile *
+                                 static_cast<double>(latencies->size())),
+        latencies->size() - 1);
+    return static_cast<double>((*latencies)[idx]);
+  };
+  state.counters["p50_latency_ns"] = percentile(0.5);
+  state.counters["p99_latency_ns"] = percentile(0.99);
+  state.counters["p99.9_latency_ns"] = percentile(0.999);
+}
+
+std::string RateLabel(std::int64_t rate) {
+  return rate == 0 ? "flat-out" : std::to_string(rate) + " records/s";
+}
+
+enum NextRecordMode : std::int64_t {
+  // Blocks until the next record is received.
+  kBlocking = 0,
+  // Polls with a timeout, retrying after each timeout.
+  kTimeout = 1,
+};
+
+// Args: send rate in records per second (0 for flat-out), `NextRecord` mode
+void BM_LiveBlocking(benchmark::State& state) {
+  constexpr std::chrono::milliseconds kPollTimeout{50};
+  const auto rate = state.range(0);
+  const auto mode = state.range(1);
+  const auto count = RecordCount(rate);
+  NullLogReceiver logger;
+  std::vector<std::int64_t> latencies;
+  for (auto _ : state) {
+    const MockLsgServer mock_server{
+        kDataset, kTsOut, [count, rate](MockLsgServer& self) {
+          StreamTrades(self, count, rate);
+        }};
+    LiveBlocking client{&logger,
+                        kKey,
+                        kDataset,
+                        kLocalhost,
+                        mock_server.Port(),
+                        kTsOut,
+                        VersionUpgradePolicy{}};
+    client.Subscribe({kSymbol}, Schema::Trades, SType::Parent);
+    // Only receiving records is timed, not the session handshake
+    client.Start();
+    const auto start = std::chrono::steady_clock::now();
+    for (std::int64_t i = 0; i < count; ++i) {
+      if (mode == kTimeout) {
+        const Record* record;
+        while ((record = client.NextRecord(kPollTimeout)) == nullptr) {
+        }
+        AddLatency(*record, &latencies);
+      } else {
+        AddLatency(client.NextRecord(), &latencies);
+      }
+    }
+    state.SetIterationTime(
+        std::chrono::duration<double>{std::chrono::steady_clock::now() - start}
+            .count());
+  }
+  ReportLatencies(state, &latencies);
+  state.SetLabel(RateLabel(rate) +
+                 (mode == kTimeout ? " timeout" : " blocking"));
+}
+
+// Args: send rate in records per second (0 for flat-out)
+void BM_LiveThreaded(benchmark::State& state) {
+  const auto rate = state.range(0);
+  const auto count = RecordCount(rate);
+  NullLogReceiver logger;
+  std::vector<std::int64_t> latencies;
+  for (auto _ : state) {
+    const MockLsgServer mock_server{
+        kDataset, kTsOut, [count, rate](MockLsgServer& self) {
+          StreamTrades(self, count, rate);
+        }};
+    LiveThreaded client{&logger,
+                        kKey,
+                        kDataset,
+                        kLocalhost,
+                        mock_server.Port(),
+                        kTsOut,
+                        VersionUpgradePolicy{}};
+    client.Subscribe({kSymbol}, Schema::Trades, SType::Parent);
+    // Only receiving records is timed, not the session handshake. Both
+    // callbacks are called from the client's thread, which `BlockForStop`
+    // synchronizes with.
+    std::chrono::steady_clock::time_point start;
+    std::int64_t received{};
+    client.Start(
+        [&start](Metadata&&) { start = std::chrono::steady_clock::now(); },
+        [count, &received, &latencies](const Record& record) {
+          AddLatency(record, &latencies);
+          return ++received < count ? KeepGoing::Continue : KeepGoing::Stop;
+        });
+    client.BlockForStop();
+    state.SetIterationTime(
+        std::chrono::duration<double>{std::chrono::steady_clock::now() - start}
+            .count());
+  }
+  ReportLatencies(state, &latencies);
+  state.SetLabel(RateLabel(rate));
+}
+
+void BlockingArgs(benchmark::internal::Benchmark* bm) {
+  for (const std::int64_t rate : {0, 10000, 100000, 1000000}) {
+    bm->Args({rate, kBlocking});
+    bm->Args({rate, kTimeout});
+  }
+}
+}  // namespace
+
+BENCHMARK(BM_LiveBlocking)
+    ->Apply(BlockingArgs)
+    ->UseManualTime()
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_LiveThreaded)
+    ->Arg(0)
+    ->Arg(10000)
+    ->Arg(100000)
+    ->Arg(1000000)
+    ->UseManualTime()
+    ->Unit(benchmark::kMillisecond);
+}  // namespace bench
+}  // namespace databento
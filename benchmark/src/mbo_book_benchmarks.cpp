@@ -0,0 +1,81 @@
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "benchmark_data.hpp"
+#include "databento/dbn_file_store.hpp"
+#include "databento/enums.hpp"
+#include "databento/mbo_book.hpp"
+#include "databento/record.hpp"
+#include "databento/timeseries.hpp"
+
+namespace databento {
+namespace bench {
+namespace {
+void BM_MboBookApplyTestData(benchmark::State& state) {
+  std::vector<MboMsg> messages;
+  DbnFileStore{TestDataPath(Schema::Mbo, 2, false)}.Replay(
+      [&messages](const Record& record) {
+        messages.push_back(record.Get<MboMsg>());
+        return KeepGoing::Continue;
+      });
+  for (auto _ : state) {
+    MboBook book;
+    for (const auto& mbo : messages) {
+      book.Apply(mbo);
+    }
+    benchmark::DoNotOptimize(book.Bbo());
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<std::int64_t>(messages.size()));
+}
+
+// Applies messages for a single instrument to a book that's cleared between
+// iterations, so its pools are already at their working size.
+void BM_MboBookApplySynthetic(benchmark::State& state) {
+  const auto messages = GenMboMessages(kSyntheticMboCount, 1);
+  MboBook book;
+  for (auto _ : state) {
+    for (const auto& mbo : messages) {
+      book.Apply(mbo);
+    }
+    benchmark::DoNotOptimize(book.Bbo());
+    book.Clear();
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<std::int64_t>(messages.size()));
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<std::int64_t>(messages.size() *
+                                                    sizeof(MboMsg)));
+}
+
+// Args: instrument count
+void BM_MboBookEngineSynthetic(benchmark::State& state) {
+  auto messages = GenMboMessages(kSyntheticMboCount,
+                                 static_cast<std::uint32_t>(state.range(0)));
+  for (auto _ : state) {
+    // Includes growing each book to its working size, like a replay
+    MboBookEngine engine;
+    for (auto& mbo : messages) {
+      engine.OnRecord(Record{&mbo.hd});
+    }
+    benchmark::DoNotOptimize(engine.BookCount());
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<std::int64_t>(messages.size()));
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<std::int64_t>(messages.size() *
+                                                    sizeof(MboMsg)));
+}
+}  // namespace
+
+BENCHMARK(BM_MboBookApplyTestData);
+BENCHMARK(BM_MboBookApplySynthetic)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_MboBookEngineSynthetic)
+    ->RangeMultiplier(100)
+    ->Range(1, 10000)
+    ->Unit(benchmark::kMillisecond);
+}  // namespace bench
+}  // namespace databento
@@ -0,0 +1,113 @@
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>  // move
+#include <vector>
+
+#include "benchmark_data.hpp"
+#include "databento/dbn.hpp"
+#include "databento/dbn_decoder.hpp"
+#include "databento/dbn_encoder.hpp"
+#include "databento/enums.hpp"
+#include "databento/metadata_view.hpp"
+#include "databento/record.hpp"
+
+namespace databento {
+namespace bench {
+namespace {
+// Returns the test data file for MBO with its metadata replaced by metadata
+// with `symbol_count` symbols, each with one mapping interval.
+std::vector<std::uint8_t> LargeMetadataFile(std::size_t symbol_count) {
+  const auto test_file = ReadFile(TestDataPath(Schema::Mbo, 2, false));
+  DbnDecoder decoder{test_file.data(), test_file.size()};
+  auto metadata = decoder.DecodeMetadata();
+  // The metadata follows the DBN prefix, version, and length
+  const auto records_offset =
+      8 + DbnDecoder::DecodeMetadataVersionAndSize(test_file.data(),
+                                                   test_file.size())
+              .second;
+  metadata.symbols.clear();
+  metadata.mappings.clear();
+  for (std::size_t i = 0; i < symbol_count; ++i) {
+    auto symbol = "SYM" + std::to_string(i);
+    metadata.mappings.emplace_back(SymbolMapping{
+        symbol, {MappingInterval{20230101, 20240101, std::to_string(i)}}});
+    metadata.symbols.emplace_back(std::move(symbol));
+  }
+  auto res = DbnEncoder::EncodeMetadata(metadata);
+  res.insert(res.end(),
+             test_file.begin() + static_cast<std::ptrdiff_t>(records_offset),
+             test_file.end());
+  return res;
+}
+
+// Args: test data file index
+void BM_DecodeMetadataTestData(benchmark::State& state) {
+  const auto& file_path =
+      TestDataPaths()[static_cast<std::size_t>(state.range(0))];
+  const auto buffer = ReadFile(file_path);
+  for (auto _ : state) {
+    DbnDecoder decoder{buffer.data(), buffer.size()};
+    benchmark::DoNotOptimize(decoder.DecodeMetadata());
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.SetLabel(FileName(file_path));
+}
+
+// Measures the time to the first record of a file with large metadata, and
+// the memory held by the decoded metadata, when decoding it in full compared
+// to decoding a `MetadataView`.
+//
+// Args: symbol count, whether to decode a view
+void BM_DecodeMetadataLarge(benchmark::State& state) {
+  const auto symbol_count = static_cast<std::size_t>(state.range(0));
+  const bool is_view = state.range(1) != 0;
+  const auto buffer = LargeMetadataFile(symbol_count);
+  const auto decode_first_record = [&buffer, is_view] {
+    DbnDecoder decoder{buffer.data(), buffer.size()};
+    if (is_view) {
+      auto metadata = decoder.DecodeMetadataView();
+      benchmark::DoNotOptimize(decoder.DecodeRecord());
+      return metadata.Symbols().Size();
+    }
+    auto metadata = decoder.DecodeMetadata();
+    benchmark::DoNotOptimize(decoder.DecodeRecord());
+    return metadata.symbols.size();
+  };
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(decode_first_record());
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<std::int64_t>(symbol_count));
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<std::int64_t>(buffer.size()));
+
+  // Measured outside the timed loop while the metadata is alive
+  const auto rss_before = ResidentBytes();
+  double rss_bytes{};
+  {
+    DbnDecoder decoder{buffer.data(), buffer.size()};
+    if (is_view) {
+      const auto metadata = decoder.DecodeMetadataView();
+      rss_bytes = static_cast<double>(ResidentBytes()) -
+                  static_cast<double>(rss_before);
+    } else {
+      const auto metadata = decoder.DecodeMetadata();
+      rss_bytes = static_cast<double>(ResidentBytes()) -
+                  static_cast<double>(rss_before);
+    }
+  }
+  state.counters["rss_bytes"] = rss_bytes;
+  state.SetLabel(is_view ? "view" : "full");
+}
+}  // namespace
+
+BENCHMARK(BM_DecodeMetadataTestData)
+    ->DenseRange(0, static_cast<int>(TestDataPaths().size()) - 1);
+BENCHMARK(BM_DecodeMetadataLarge)
+    ->ArgsProduct({{1000, 10000, 100000}, {1, 0}})
+    ->Unit(benchmark::kMicrosecond);
+}  // namespace bench
+}  // namespace databento
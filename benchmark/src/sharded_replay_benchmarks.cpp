@@ -0,0 +1,62 @@
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "benchmark_data.hpp"
+#include "databento/mbo_book.hpp"
+#include "databento/record.hpp"
+#include "databento/sharded_replay.hpp"
+#include "databento/timeseries.hpp"
+
+namespace databento {
+namespace bench {
+namespace {
+constexpr std::uint32_t kInstrumentCount = 1000;
+
+// Builds a book for each instrument with one `MboBookEngine` per shard, the
+// scaling case `ShardedReplay` is for. Compare to `BM_MboBookEngineSynthetic`
+// for the throughput without sharding.
+//
+// Args: shard count
+void BM_ShardedReplayMboBooks(benchmark::State& state) {
+  const auto shard_count = static_cast<std::size_t>(state.range(0));
+  auto messages = GenMboMessages(kSyntheticMboCount, kInstrumentCount);
+  for (auto _ : state) {
+    // Only dispatching and processing the messages is timed
+    state.PauseTiming();
+    {
+      std::vector<MboBookEngine> engines(shard_count);
+      ShardedReplay replay{
+          shard_count, [&engines](std::size_t shard_idx) -> RecordCallback {
+            MboBookEngine* engine = &engines[shard_idx];
+            return [engine](const Record& record) {
+              engine->OnRecord(record);
+              return KeepGoing::Continue;
+            };
+          }};
+      state.ResumeTiming();
+      for (auto& mbo : messages) {
+        replay.OnRecord(Record{&mbo.hd});
+      }
+      replay.Flush();
+      state.PauseTiming();
+    }
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<std::int64_t>(messages.size()));
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<std::int64_t>(messages.size() *
+                                                    sizeof(MboMsg)));
+}
+}  // namespace
+
+BENCHMARK(BM_ShardedReplayMboBooks)
+    ->RangeMultiplier(2)
+    ->Range(1, 32)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+}  // namespace bench
+}  // namespace databento
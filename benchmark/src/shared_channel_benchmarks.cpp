@@ -0,0 +1,106 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>  // min
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "benchmark_data.hpp"
+#include "databento/dbn_decoder.hpp"
+#include "databento/detail/scoped_thread.hpp"
+#include "databento/detail/shared_channel.hpp"
+#include "databento/enums.hpp"
+#include "databento/record.hpp"
+
+namespace databento {
+namespace bench {
+namespace {
+// Writes `size` bytes from `data` to `channel` in chunks of `chunk_size`
+// bytes, like the HTTP client does with a response body.
+void WriteChunks(detail::SharedChannel channel, const std::uint8_t* data,
+                 std::size_t size, std::size_t chunk_size) {
+  for (std::size_t offset = 0; offset < size; offset += chunk_size) {
+    channel.Write(data + offset, std::min(chunk_size, size - offset));
+  }
+  channel.Finish();
+}
+
+// Moves a synthetic file through the channel without decoding it.
+//
+// Args: channel capacity, write chunk size
+void BM_SharedChannelTransfer(benchmark::State& state) {
+  constexpr std::size_t kReadSize = DbnDecoder::kDefaultBufferSize;
+  const auto capacity = static_cast<std::size_t>(state.range(0));
+  const auto chunk_size = static_cast<std::size_t>(state.range(1));
+  const auto file_path = SyntheticPath(Schema::Mbo, 2, false);
+  const auto input = ReadFile(file_path);
+  std::vector<std::uint8_t> buffer(kReadSize);
+  for (auto _ : state) {
+    detail::SharedChannel channel{capacity};
+    detail::ScopedThread writer{WriteChunks, channel, input.data(),
+                                input.size(), chunk_size};
+    while (channel.ReadSome(buffer.data(), buffer.size()) > 0) {
+      benchmark::DoNotOptimize(buffer.data());
+    }
+  }
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<std::int64_t>(input.size()));
+}
+
+// Decodes a synthetic file from the channel, as `Historical` does with a
+// response body.
+//
+// Args: channel capacity, write chunk size, is compressed
+void BM_SharedChannelDecode(benchmark::State& state) {
+  const auto capacity = static_cast<std::size_t>(state.range(0));
+  const auto chunk_size = static_cast<std::size_t>(state.range(1));
+  const bool is_compressed = state.range(2) != 0;
+  const auto file_path = SyntheticPath(Schema::Mbo, 2, is_compressed);
+  const auto input = ReadFile(file_path);
+  std::int64_t record_count{};
+  std::int64_t record_bytes{};
+  for (auto _ : state) {
+    detail::SharedChannel channel{capacity};
+    detail::ScopedThread writer{WriteChunks, channel, input.data(),
+                                input.size(), chunk_size};
+    DbnDecoder decoder{channel};
+    decoder.DecodeMetadata();
+    while (const Record* record = decoder.DecodeRecord()) {
+      benchmark::DoNotOptimize(record);
+      ++record_count;
+      record_bytes += static_cast<std::int64_t>(record->Size());
+    }
+  }
+  state.SetItemsProcessed(record_count);
+  state.SetBytesProcessed(record_bytes);
+  state.SetLabel(FileName(file_path));
+}
+
+constexpr auto kDefaultCapacity =
+    static_cast<std::int64_t>(detail::SharedChannel::kDefaultCapacity);
+
+void ChannelArgs(benchmark::internal::Benchmark* bm) {
+  // cpp-httplib's receive buffer size and a larger chunk
+  for (const std::int64_t chunk_size : {4 * 1024, 64 * 1024}) {
+    bm->Args({64 * 1024, chunk_size});
+    bm->Args({kDefaultCapacity, chunk_size});
+    bm->Args({16 * 1024 * 1024, chunk_size});
+  }
+}
+
+void DecodeArgs(benchmark::internal::Benchmark* bm) {
+  bm->Args({kDefaultCapacity, 4 * 1024, 0});
+  bm->Args({kDefaultCapacity, 4 * 1024, 1});
+}
+}  // namespace
+
+BENCHMARK(BM_SharedChannelTransfer)
+    ->Apply(ChannelArgs)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_SharedChannelDecode)
+    ->Apply(DecodeArgs)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+}  // namespace bench
+}  // namespace databento
@@ -0,0 +1,59 @@
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>  // unique_ptr
+#include <vector>
+
+#include "benchmark_data.hpp"
+#include "databento/detail/zstd_stream.hpp"
+#include "databento/ireadable.hpp"
+
+namespace databento {
+namespace bench {
+namespace {
+// Args: schema index, read size
+void BM_ZstdStreamReadSome(benchmark::State& state) {
+  const auto schema =
+      SyntheticSchemas()[static_cast<std::size_t>(state.range(0))];
+  const auto file_path = SyntheticPath(schema, 2, true);
+  const auto compressed = ReadFile(file_path);
+  std::vector<std::uint8_t> buffer(static_cast<std::size_t>(state.range(1)));
+  std::int64_t decompressed_bytes{};
+  for (auto _ : state) {
+    detail::ZstdStream stream{std::unique_ptr<IReadable>{
+        new MemoryStream{compressed.data(), compressed.size()}}};
+    while (true) {
+      const auto read_size = stream.ReadSome(buffer.data(), buffer.size());
+      if (read_size == 0) {
+        break;
+      }
+      benchmark::DoNotOptimize(buffer.data());
+      decompressed_bytes += static_cast<std::int64_t>(read_size);
+    }
+  }
+  // Bytes of DBN output, like the other benchmarks
+  state.SetBytesProcessed(decompressed_bytes);
+  state.counters["compressed_bytes_per_second"] =
+      benchmark::Counter{static_cast<double>(compressed.size()) *
+                             static_cast<double>(state.iterations()),
+                         benchmark::Counter::kIsRate};
+  state.SetLabel(FileName(file_path));
+}
+
+void ReadSomeArgs(benchmark::internal::Benchmark* bm) {
+  for (std::size_t i = 0; i < SyntheticSchemas().size(); ++i) {
+    // The decoder's default buffer size
+    bm->Args({static_cast<std::int64_t>(i), 64 * 1024});
+  }
+  // Smaller and larger reads of a single schema
+  bm->Args({0, 4 * 1024});
+  bm->Args({0, 1024 * 1024});
+}
+}  // namespace
+
+BENCHMARK(BM_ZstdStreamReadSome)
+    ->Apply(ReadSomeArgs)
+    ->Unit(benchmark::kMillisecond);
+}  // namespace bench
+}  // namespace databento
@@ -1,64 +1,106 @@
 set(headers
+  include/databento/bar_builder.hpp
   include/databento/batch.hpp
+  include/databento/column_kernels.hpp
+  include/databento/columnar_builder.hpp
   include/databento/compat.hpp
   include/databento/constants.hpp
   include/databento/datetime.hpp
   include/databento/dbn.hpp
   include/databento/dbn_decoder.hpp
+  include/databento/dbn_encoder.hpp
   include/databento/dbn_file_store.hpp
+  include/databento/dbn_frame_index.hpp
+  include/databento/dbn_transcoder.hpp
   include/databento/enums.hpp
   include/databento/exceptions.hpp
   include/databento/fixed_price.hpp
   include/databento/flag_set.hpp
   include/databento/historical.hpp
   include/databento/ireadable.hpp
+  include/databento/iwritable.hpp
   include/databento/live.hpp
   include/databento/live_blocking.hpp
+  include/databento/live_recorder.hpp
   include/databento/live_threaded.hpp
   include/databento/log.hpp
+  include/databento/mbo_book.hpp
+  include/databento/merged_file_store.hpp
   include/databento/metadata.hpp
+  include/databento/metadata_view.hpp
+  include/databento/parallel_dbn_decoder.hpp
   include/databento/publishers.hpp
   include/databento/record.hpp
+  include/databento/record_filter.hpp
+  include/databento/record_visitor.hpp
+  include/databento/sharded_replay.hpp
   include/databento/symbol_map.hpp
   include/databento/symbology.hpp
+  include/databento/tick_ladder_book.hpp
   include/databento/timeseries.hpp
   include/databento/with_ts_out.hpp
   include/databento/detail/file_stream.hpp
   include/databento/detail/http_client.hpp
+  include/databento/detail/instrument_index.hpp
   include/databento/detail/json_helpers.hpp
+  include/databento/detail/mmap_file.hpp
+  include/databento/detail/parallel_zstd_stream.hpp
+  include/databento/detail/record_limits.hpp
+  include/databento/detail/ring_buffer.hpp
   include/databento/detail/scoped_fd.hpp
   include/databento/detail/scoped_thread.hpp
   include/databento/detail/shared_channel.hpp
+  include/databento/detail/spin_wait.hpp
+  include/databento/detail/spsc_record_queue.hpp
   include/databento/detail/tcp_client.hpp
   include/databento/detail/zstd_stream.hpp
   src/stream_op_helper.hpp
 )
 
 set(sources
+  src/bar_builder.cpp
   src/batch.cpp
+  src/column_kernels.cpp
+  src/columnar_builder.cpp
   src/compat.cpp
   src/datetime.cpp
   src/dbn.cpp
   src/dbn_decoder.cpp
+  src/dbn_encoder.cpp
   src/enums.cpp
   src/exceptions.cpp
   src/dbn_file_store.cpp
+  src/dbn_frame_index.cpp
+  src/dbn_transcoder.cpp
   src/fixed_price.cpp
   src/historical.cpp
   src/live.cpp
   src/live_blocking.cpp
+  src/live_recorder.cpp
   src/live_threaded.cpp
   src/log.cpp
+  src/mbo_book.cpp
+  src/merged_file_store.cpp
   src/metadata.cpp
+  src/metadata_view.cpp
+  src/parallel_dbn_decoder.cpp
   src/publishers.cpp
   src/record.cpp
+  src/record_filter.cpp
+  src/sharded_replay.cpp
   src/symbol_map.cpp
   src/symbology.cpp
+  src/tick_ladder_book.cpp
   src/detail/file_stream.cpp
   src/detail/http_client.cpp
+  src/detail/instrument_index.cpp
   src/detail/json_helpers.cpp
+  src/detail/mmap_file.cpp
+  src/detail/parallel_zstd_stream.cpp
+  src/detail/ring_buffer.cpp
   src/detail/scoped_fd.cpp
   src/detail/shared_channel.cpp
+  src/detail/spsc_record_queue.cpp
   src/detail/tcp_client.cpp
   src/detail/zstd_stream.cpp
 )
@@ -5,6 +5,7 @@
 option(${PROJECT_NAME_UPPERCASE}_USE_EXTERNAL_JSON "Use an external JSON library" OFF)
 option(${PROJECT_NAME_UPPERCASE}_USE_EXTERNAL_HTTPLIB "Use an external httplib library" OFF)
 option(${PROJECT_NAME_UPPERCASE}_USE_EXTERNAL_GTEST "Use an external google test (gtest) library" ON)
+option(${PROJECT_NAME_UPPERCASE}_USE_EXTERNAL_BENCHMARK "Use an external Google Benchmark library" ON)
 
 #
 # Compiler options
@@ -19,6 +20,7 @@ option(${PROJECT_NAME_UPPERCASE}_WARNINGS_AS_ERRORS "Treat compiler warnings as
 # Default to ON if main project, otherwise OFF
 option(${PROJECT_NAME_UPPERCASE}_ENABLE_UNIT_TESTING "Enable unit tests for the projects (from the `test` subfolder)." OFF)
 option(${PROJECT_NAME_UPPERCASE}_ENABLE_EXAMPLES "Enable building examples for the project." OFF)
+option(${PROJECT_NAME_UPPERCASE}_ENABLE_BENCHMARKS "Enable building benchmarks for the project (from the `benchmark` subfolder)." OFF)
 
 #
 # Static analyzers
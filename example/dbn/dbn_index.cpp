@@ -0,0 +1,24 @@
+#include <exception>
+#include <iostream>
+
+#include "databento/dbn_frame_index.hpp"
+
+// Builds the sidecar frame index for a Zstd-compressed DBN file so replaying a
+// time window with `DbnFileStore` can skip frames outside of it.
+int main(int argc, char* argv[]) {
+  if (argc != 2) {
+    std::cerr << "Usage: " << argv[0] << " FILE.dbn.zst\n";
+    return 1;
+  }
+  try {
+    const auto index = databento::DbnFrameIndex::Build(argv[1]);
+    const auto index_path = databento::DbnFrameIndex::SidecarPath(argv[1]);
+    index.Write(index_path);
+    std::cout << "Indexed " << index.Entries().size() << " frames to "
+              << index_path << '\n';
+  } catch (const std::exception& exc) {
+    std::cerr << exc.what() << '\n';
+    return 1;
+  }
+  return 0;
+}
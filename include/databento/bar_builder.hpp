@@ -0,0 +1,93 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>  // size_t
+#include <cstdint>
+#include <functional>  // function
+#include <vector>
+
+#include "databento/datetime.hpp"                 // UnixNanos
+#include "databento/detail/instrument_index.hpp"  // InstrumentIndex
+#include "databento/enums.hpp"                    // RType
+#include "databento/record.hpp"                   // OhlcvMsg, Record
+
+namespace databento {
+// Aggregates trades into OHLCV bars per instrument and publisher, closing bars
+// at fixed time intervals or once they reach a volume. Trades are taken from
+// trade records and trade actions of MBO and MBP records from any replay or
+// live source.
+//
+// Bars are passed to the callback as `OhlcvMsg` records, which can be encoded
+// with `DbnEncoder`. The callback must not call back into the builder. Bar
+// state is kept in a flat array indexed by instrument and publisher, so
+// aggregating a trade doesn't allocate.
+class BarBuilder {
+ public:
+  using BarCallback = std::function<void(const OhlcvMsg& bar)>;
+
+  // Builds bars over intervals aligned to multiples of `interval` since the
+  // UNIX epoch based on `ts_event`. Each bar's `ts_event` is the start of its
+  // interval. Intervals of 1 second, 1 minute, 1 hour, and 1 day have the
+  // rtype of the corresponding OHLCV schema; other intervals have
+  // `RType::OhlcvDeprecated`. Throws `InvalidArgumentError` if `interval`
+  // isn't positive.
+  static BarBuilder TimeBars(std::chrono::nanoseconds interval,
+                             BarCallback callback);
+  // Builds bars closed by the trade that brings their volume to at least
+  // `volume`, so a bar's volume can exceed it. Each bar's `ts_event` is the
+  // `ts_event` of its first trade and its rtype is `RType::OhlcvDeprecated`.
+  // Throws `InvalidArgumentError` if `volume` is zero.
+  static BarBuilder VolumeBars(std::uint64_t volume, BarCallback callback);
+
+  // Aggregates a trade. Time bars are closed by the first trade in a later
+  // interval or `Flush`.
+  void OnTrade(std::uint32_t instrument_id, std::uint16_t publisher_id,
+               UnixNanos ts_event, std::int64_t price, std::uint32_t size);
+  // Aggregates `record` if it's a trade and ignores it otherwise.
+  void OnRecord(const Record& record);
+  // Closes the time bars whose interval ends at or before `ts`, such as the
+  // current time when building bars from live data. Does nothing for volume
+  // bars.
+  void Flush(UnixNanos ts);
+  // Closes all open bars, including incomplete ones. Call at the end of the
+  // data.
+  void FlushAll();
+  // The number of instrument and publisher pairs with bar state.
+  std::size_t InstrumentCount() const { return states_.size(); }
+
+ private:
+  enum class Boundary : std::uint8_t { Time, Volume };
+
+  struct BarState {
+    std::uint32_t instrument_id;
+    std::uint16_t publisher_id;
+    bool is_open;
+    // The start of the interval for time bars, otherwise the first trade
+    std::uint64_t start;
+    std::int64_t open;
+    std::int64_t high;
+    std::int64_t low;
+    std::int64_t close;
+    std::uint64_t volume;
+  };
+
+  BarBuilder(Boundary boundary, std::uint64_t threshold, RType rtype,
+             BarCallback callback);
+
+  static std::uint64_t Key(std::uint32_t instrument_id,
+                           std::uint16_t publisher_id) {
+    return (std::uint64_t{instrument_id} << 16) | std::uint64_t{publisher_id};
+  }
+
+  void Close(BarState& state);
+
+  Boundary boundary_;
+  // The interval in nanoseconds or volume
+  std::uint64_t threshold_;
+  RType rtype_;
+  BarCallback callback_;
+  // Keyed by `Key`
+  detail::InstrumentIndex index_;
+  std::vector<BarState> states_;
+};
+}  // namespace databento
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstddef>  // size_t
+#include <cstdint>
+#include <vector>
+
+#include "databento/datetime.hpp"  // UnixNanos
+#include "databento/flag_set.hpp"  // FlagSet
+
+namespace databento {
+namespace detail {
+struct ColumnKernelTable;
+}  // namespace detail
+
+// An instruction set `ColumnKernels` can be implemented with.
+enum class KernelIsa : std::uint8_t {
+  // Portable C++.
+  Scalar = 0,
+  // SSE4.2 on x86-64.
+  Sse42 = 1,
+  // AVX2 on x86-64.
+  Avx2 = 2,
+};
+
+const char* ToString(KernelIsa isa);
+
+// Filter and reduction kernels over the columns of a `ColumnarBuilder`, or any
+// other contiguous arrays of values.
+//
+// Filters write a mask with one byte per row: 1 if the row is selected and 0
+// otherwise. Masks passed in select the rows whose byte is nonzero. Filters
+// can be combined with `AndMask`.
+//
+// The implementation is chosen on construction. By default it's the widest
+// instruction set the CPU supports, and the scalar implementation on other
+// architectures and compilers.
+class ColumnKernels {
+ public:
+  // Uses the widest supported instruction set.
+  ColumnKernels();
+  // Throws `InvalidArgumentError` if `isa` isn't supported by the CPU.
+  explicit ColumnKernels(KernelIsa isa);
+
+  static bool IsSupported(KernelIsa isa);
+  // The widest instruction set supported by the CPU, detected once.
+  static KernelIsa BestIsa();
+
+  KernelIsa Isa() const { return isa_; }
+
+  /*
+   * Filters
+   */
+
+  // Selects rows with `min <= values[i] <= max`, such as a price range.
+  void RangeMask(const std::int64_t* values, std::size_t count,
+                 std::int64_t min, std::int64_t max, std::uint8_t* mask) const;
+  // Selects rows with `start <= timestamps[i] < end`, where `timestamps` are
+  // UNIX epoch nanoseconds such as the `ts_recv` column.
+  void TimeRangeMask(const std::uint64_t* timestamps, std::size_t count,
+                     UnixNanos start, UnixNanos end, std::uint8_t* mask) const;
+  // Selects rows whose instrument ID is one of `instrument_ids`.
+  void InstrumentIdMask(const std::uint32_t* values, std::size_t count,
+                        const std::vector<std::uint32_t>& instrument_ids,
+                        std::uint8_t* mask) const;
+  // Selects rows with any of `flags` set, such as `FlagSet::kLast`.
+  void FlagMask(const std::uint8_t* values, std::size_t count, FlagSet flags,
+                std::uint8_t* mask) const;
+  // Deselects the rows of `mask` that aren't selected in `other`.
+  void AndMask(const std::uint8_t* other, std::size_t count,
+               std::uint8_t* mask) const;
+
+  /*
+   * Reductions over the rows selected by `mask`
+   */
+
+  // The number of selected rows.
+  std::size_t CountMask(const std::uint8_t* mask, std::size_t count) const;
+  std::int64_t Sum(const std::int64_t* values, const std::uint8_t* mask,
+                   std::size_t count) const;
+  // Sums 32-bit values such as sizes without overflow.
+  std::uint64_t Sum(const std::uint32_t* values, const std::uint8_t* mask,
+                    std::size_t count) const;
+  // Returns `INT64_MAX` if no rows are selected.
+  std::int64_t Min(const std::int64_t* values, const std::uint8_t* mask,
+                   std::size_t count) const;
+  // Returns `INT64_MIN` if no rows are selected.
+  std::int64_t Max(const std::int64_t* values, const std::uint8_t* mask,
+                   std::size_t count) const;
+  // The volume-weighted average of `prices` in the same units, or NaN if the
+  // selected sizes sum to 0.
+  double Vwap(const std::int64_t* prices, const std::uint32_t* sizes,
+              const std::uint8_t* mask, std::size_t count) const;
+
+ private:
+  KernelIsa isa_;
+  const detail::ColumnKernelTable* table_;
+};
+}  // namespace databento
@@ -0,0 +1,218 @@
+#pragma once
+
+#include <cstddef>  // size_t
+#include <cstdint>
+#include <cstring>  // memcpy
+#include <memory>   // unique_ptr
+#include <utility>  // move
+#include <vector>
+
+#include "databento/enums.hpp"   // Schema
+#include "databento/record.hpp"  // Record, RecordBatch
+
+namespace databento {
+class DbnDecoder;
+
+// Contiguous storage for one field of `ColumnarBuilder` with the start aligned
+// to `kAlignment` bytes for vectorized loops.
+template <typename T>
+class Column {
+ public:
+  static constexpr std::size_t kAlignment = 64;
+
+  Column() = default;
+  Column(const Column&) = delete;
+  Column& operator=(const Column&) = delete;
+  Column(Column&&) = default;
+  Column& operator=(Column&&) = default;
+
+  const T* Data() const { return data_; }
+  const T* begin() const { return data_; }
+  const T* end() const { return data_ + size_; }
+  const T& operator[](std::size_t idx) const { return data_[idx]; }
+  std::size_t Size() const { return size_; }
+  bool IsEmpty() const { return size_ == 0; }
+  std::size_t Capacity() const { return capacity_; }
+
+ private:
+  friend class ColumnarBuilder;
+
+  // Grows the column by `count` values and returns a pointer to the first new
+  // one. Storage grows geometrically in multiples of `chunk_size` values.
+  T* Extend(std::size_t count, std::size_t chunk_size) {
+    if (size_ + count > capacity_) {
+      auto new_capacity = capacity_ * 2 > size_ + count ? capacity_ * 2
+                                                        : size_ + count;
+      new_capacity = (new_capacity + chunk_size - 1) / chunk_size * chunk_size;
+      std::unique_ptr<std::uint8_t[]> storage{
+          new std::uint8_t[new_capacity * sizeof(T) + kAlignment]};
+      auto* data = reinterpret_cast<T*>(Align(storage.get()));
+      if (size_ > 0) {
+        std::memcpy(data, data_, size_ * sizeof(T));
+      }
+      storage_ = std::move(storage);
+      data_ = data;
+      capacity_ = new_capacity;
+    }
+    T* res = data_ + size_;
+    size_ += count;
+    return res;
+  }
+  void Clear() { size_ = 0; }
+
+  static std::uint8_t* Align(std::uint8_t* ptr) {
+    const auto addr = reinterpret_cast<std::uintptr_t>(ptr);
+    return ptr + (kAlignment - addr % kAlignment) % kAlignment;
+  }
+
+  std::unique_ptr<std::uint8_t[]> storage_;
+  T* data_{};
+  std::size_t size_{};
+  std::size_t capacity_{};
+};
+
+template <typename T>
+constexpr std::size_t Column<T>::kAlignment;
+
+// Materializes the records of one schema as a column per field. Only the
+// columns for the fields of the schema's record type are filled, the others
+// stay empty:
+//
+// - `Schema::Mbo`: the header fields, `OrderId`, `Price`, `Size`, `Flags`,
+//   `ChannelId`, `Action`, `Side`, `TsRecv`, `TsInDelta`, and `Sequence`
+// - `Schema::Trades`: the header fields, `Price`, `Size`, `Action`, `Side`,
+//   `Flags`, `Depth`, `TsRecv`, `TsInDelta`, and `Sequence`
+// - `Schema::Mbp1`, `Schema::Tbbo`, and `Schema::Mbp10`: the same as
+//   `Schema::Trades` plus the bid and ask columns for each level
+// - `Schema::Ohlcv*`: the header fields, `Open`, `High`, `Low`, `Close`, and
+//   `Volume`
+//
+// Values are stored as their underlying integers: timestamps as UNIX epoch
+// nanoseconds, prices in units of 1e-9, and enums and flags as their raw
+// values.
+//
+// Columns are filled a batch of records at a time, one column after another,
+// with each value read directly from the decoder's buffer. Records of other
+// types, such as symbol mappings in live data, are skipped.
+class ColumnarBuilder {
+ public:
+  // Default number of rows column storage grows in multiples of.
+  static constexpr std::size_t kDefaultChunkSize = 64 * 1024;
+
+  explicit ColumnarBuilder(Schema schema);
+  // Throws `InvalidArgumentError` if `schema` isn't one of the supported
+  // schemas or `chunk_size` is 0.
+  ColumnarBuilder(Schema schema, std::size_t chunk_size);
+
+  // Decodes and appends all remaining records from `decoder`, whose metadata
+  // must already have been decoded. Returns the number of rows appended.
+  std::size_t Append(DbnDecoder* decoder);
+  // Returns the number of rows appended.
+  std::size_t Append(const RecordBatch& batch);
+  // Returns whether `record` was appended.
+  bool Append(const Record& record);
+  // Removes all rows, keeping the allocated storage.
+  void Clear();
+
+  Schema GetSchema() const { return schema_; }
+  std::size_t RowCount() const { return row_count_; }
+  // The number of bid and ask levels per row.
+  std::size_t LevelCount() const { return level_count_; }
+
+  // Header
+  const Column<std::uint16_t>& PublisherId() const { return publisher_id_; }
+  const Column<std::uint32_t>& InstrumentId() const { return instrument_id_; }
+  const Column<std::uint64_t>& TsEvent() const { return ts_event_; }
+  // MBO, trades, and MBP
+  const Column<std::uint64_t>& OrderId() const { return order_id_; }
+  const Column<std::int64_t>& Price() const { return price_; }
+  const Column<std::uint32_t>& Size() const { return size_column_; }
+  const Column<std::uint8_t>& Flags() const { return flags_; }
+  const Column<std::uint8_t>& ChannelId() const { return channel_id_; }
+  const Column<char>& Action() const { return action_; }
+  const Column<char>& Side() const { return side_; }
+  const Column<std::uint8_t>& Depth() const { return depth_; }
+  const Column<std::uint64_t>& TsRecv() const { return ts_recv_; }
+  const Column<std::int32_t>& TsInDelta() const { return ts_in_delta_; }
+  const Column<std::uint32_t>& Sequence() const { return sequence_; }
+  // MBP levels, where `level` is less than `LevelCount()`
+  const Column<std::int64_t>& BidPx(std::size_t level) const {
+    return levels_[level].bid_px;
+  }
+  const Column<std::int64_t>& AskPx(std::size_t level) const {
+    return levels_[level].ask_px;
+  }
+  const Column<std::uint32_t>& BidSz(std::size_t level) const {
+    return levels_[level].bid_sz;
+  }
+  const Column<std::uint32_t>& AskSz(std::size_t level) const {
+    return levels_[level].ask_sz;
+  }
+  const Column<std::uint32_t>& BidCt(std::size_t level) const {
+    return levels_[level].bid_ct;
+  }
+  const Column<std::uint32_t>& AskCt(std::size_t level) const {
+    return levels_[level].ask_ct;
+  }
+  // OHLCV
+  const Column<std::int64_t>& Open() const { return open_; }
+  const Column<std::int64_t>& High() const { return high_; }
+  const Column<std::int64_t>& Low() const { return low_; }
+  const Column<std::int64_t>& Close() const { return close_; }
+  const Column<std::uint64_t>& Volume() const { return volume_; }
+
+ private:
+  struct LevelColumns {
+    Column<std::int64_t> bid_px;
+    Column<std::int64_t> ask_px;
+    Column<std::uint32_t> bid_sz;
+    Column<std::uint32_t> ask_sz;
+    Column<std::uint32_t> bid_ct;
+    Column<std::uint32_t> ask_ct;
+  };
+
+  std::size_t AppendBytes(const std::uint8_t* data, std::size_t size);
+  // Appends the records of type `R` among the `size` bytes of records at
+  // `data`.
+  template <typename R>
+  std::size_t AppendRecords(const std::uint8_t* data, std::size_t size);
+  // Appends `count` records of type `R` that are `stride` bytes apart.
+  template <typename R>
+  void AppendRun(const std::uint8_t* data, std::size_t stride,
+                 std::size_t count);
+  void AppendHeaders(const std::uint8_t* data, std::size_t stride,
+                     std::size_t count);
+  // Appends the fields shared by `TradeMsg` and the MBP records.
+  template <typename R>
+  void AppendTradeFields(const std::uint8_t* data, std::size_t stride,
+                         std::size_t count);
+  template <typename R>
+  void AppendLevels(const std::uint8_t* data, std::size_t stride,
+                    std::size_t count);
+
+  Schema schema_;
+  std::size_t chunk_size_;
+  std::size_t level_count_{};
+  std::size_t row_count_{};
+  Column<std::uint16_t> publisher_id_;
+  Column<std::uint32_t> instrument_id_;
+  Column<std::uint64_t> ts_event_;
+  Column<std::uint64_t> order_id_;
+  Column<std::int64_t> price_;
+  Column<std::uint32_t> size_column_;
+  Column<std::uint8_t> flags_;
+  Column<std::uint8_t> channel_id_;
+  Column<char> action_;
+  Column<char> side_;
+  Column<std::uint8_t> depth_;
+  Column<std::uint64_t> ts_recv_;
+  Column<std::int32_t> ts_in_delta_;
+  Column<std::uint32_t> sequence_;
+  std::vector<LevelColumns> levels_;
+  Column<std::int64_t> open_;
+  Column<std::int64_t> high_;
+  Column<std::int64_t> low_;
+  Column<std::int64_t> close_;
+  Column<std::uint64_t> volume_;
+};
+}  // namespace databento
@@ -3,6 +3,7 @@
 
 #include <cstddef>  // size_t
 #include <cstdint>
+#include <vector>
 
 #include "databento/constants.hpp"  // kSymbolCstrLen
 #include "databento/datetime.hpp"   // UnixNanos
@@ -163,6 +164,14 @@ struct SystemMsgV1 {
 static_assert(sizeof(SystemMsgV1) == 80, "SystemMsg size must match Rust");
 static_assert(alignof(SystemMsgV1) == 8, "Must have 8-byte alignment");
 
+// Upgrades the DBN version 1 records in the `size` bytes at `data` to version
+// 2 in a single pass, replacing the contents of `output`. `data` must be 8-byte
+// aligned and contain only complete records. Instrument definitions and symbol
+// mappings are upgraded directly into `output` and other records are copied
+// as-is, the same as `DbnDecoder` with `VersionUpgradePolicy::Upgrade`.
+void UpgradeRecordsV1ToV2(const std::uint8_t* data, std::size_t size,
+                          std::vector<std::uint8_t>* output);
+
 bool operator==(const InstrumentDefMsgV1& lhs, const InstrumentDefMsgV1& rhs);
 inline bool operator!=(const InstrumentDefMsgV1& lhs,
                        const InstrumentDefMsgV1& rhs) {
@@ -4,25 +4,68 @@
 #include <cstdint>  // uint8_t
 #include <memory>   // unique_ptr
 #include <string>
+#include <utility>  // move
 
 #include "databento/dbn.hpp"
 #include "databento/detail/file_stream.hpp"
+#include "databento/detail/mmap_file.hpp"
+#include "databento/detail/record_limits.hpp"
+#include "databento/detail/ring_buffer.hpp"
 #include "databento/detail/shared_channel.hpp"
 #include "databento/enums.hpp"  // Upgrade Policy
 #include "databento/ireadable.hpp"
-#include "databento/record.hpp"  // Record, RecordHeader
+#include "databento/metadata_view.hpp"
+#include "databento/record.hpp"  // Record, RecordBatch, RecordHeader
+#include "databento/record_filter.hpp"
 
 namespace databento {
 // DBN decoder. Set upgrade_policy to control how DBN version 1 data should be
 // handled. Currently it defaults to returning this data as-is, but this default
 // will change in a future version.
+//
+// When constructed from an in-memory buffer or a memory-mapped file,
+// uncompressed records are decoded in place without being copied.
 class DbnDecoder {
  public:
+  // Default size in bytes of the buffer for streamed input.
+  static constexpr std::size_t kDefaultBufferSize = 64 * 1024;
+
   explicit DbnDecoder(detail::SharedChannel channel);
   explicit DbnDecoder(detail::FileStream file_stream);
   explicit DbnDecoder(std::unique_ptr<IReadable> input);
   DbnDecoder(std::unique_ptr<IReadable> input,
              VersionUpgradePolicy upgrade_policy);
+  // `buffer_size` is the size in bytes of the buffer input is read into. It's
+  // rounded up to a multiple of the page size and must be large enough to
+  // hold at least one record of the maximum length.
+  DbnDecoder(std::unique_ptr<IReadable> input,
+             VersionUpgradePolicy upgrade_policy, std::size_t buffer_size);
+  // If `zstd_thread_count` is greater than 0, Zstd-compressed input is
+  // decompressed one frame per worker thread. If 0, it's decompressed on the
+  // calling thread. This only speeds up input with multiple frames, each of
+  // known and bounded decompressed size. Other frames are decompressed on the
+  // calling thread.
+  DbnDecoder(std::unique_ptr<IReadable> input,
+             VersionUpgradePolicy upgrade_policy, std::size_t buffer_size,
+             std::size_t zstd_thread_count);
+  // Decode records from `input`, which must be uncompressed and positioned at
+  // the start of a record, such as after seeking within a file. `metadata` is
+  // the previously-decoded metadata of the input and `DecodeMetadata` shouldn't
+  // be called.
+  DbnDecoder(std::unique_ptr<IReadable> input, const Metadata& metadata,
+             VersionUpgradePolicy upgrade_policy);
+  // Decode from the `size` bytes at `buffer`, which must outlive the decoder.
+  DbnDecoder(const std::uint8_t* buffer, std::size_t size);
+  DbnDecoder(const std::uint8_t* buffer, std::size_t size,
+             VersionUpgradePolicy upgrade_policy);
+  // Decode records from the `size` bytes at `buffer`, which must start at a
+  // record and outlive the decoder, such as a range of a memory-mapped file.
+  // `metadata` is the previously-decoded metadata of the input and
+  // `DecodeMetadata` shouldn't be called.
+  DbnDecoder(const std::uint8_t* buffer, std::size_t size,
+             const Metadata& metadata, VersionUpgradePolicy upgrade_policy);
+  explicit DbnDecoder(detail::MmapFile mmap_file);
+  DbnDecoder(detail::MmapFile mmap_file, VersionUpgradePolicy upgrade_policy);
 
   // Decode metadata from the given buffer.
   static Metadata DecodeMetadata(const std::vector<std::uint8_t>& buffer);
@@ -37,40 +80,83 @@ class DbnDecoder {
       std::uint8_t version, VersionUpgradePolicy upgrade_policy,
       std::array<std::uint8_t, kMaxRecordLen>* compat_buffer, Record rec);
 
-  // Should be called exactly once.
+  // Should be called exactly once, or `DecodeMetadataView` instead.
   Metadata DecodeMetadata();
+  // Decodes the metadata without allocating its symbols and symbol mappings,
+  // which are decoded lazily through the view. Should be called exactly once
+  // instead of `DecodeMetadata`.
+  MetadataView DecodeMetadataView();
   // Lifetime of returned Record is until next call to DecodeRecord. Returns
   // nullptr once the end of the input has been reached.
+  //
+  // When decoding uncompressed data from memory, the returned Record points
+  // directly into the input, unless it was upgraded or the input isn't 8-byte
+  // aligned, in which case it's copied.
   const Record* DecodeRecord();
+  // Decodes all complete records currently buffered, reading more input if
+  // there are none. The batch is valid until the next call to DecodeRecord or
+  // DecodeRecords. Returns an empty batch once the end of the input has been
+  // reached.
+  //
+  // If any records need to be upgraded according to the upgrade policy, the
+  // whole batch is upgraded at once into a buffer owned by the decoder.
+  RecordBatch DecodeRecords();
+  // Skips records that don't match `filter` before they're upgraded or
+  // returned. Replaces any previous filter.
+  void SetFilter(RecordFilter filter) { filter_ = std::move(filter); }
+  const RecordFilter& Filter() const { return filter_; }
+  // The number of records that matched or didn't match the filter. Only
+  // records decoded while the filter was non-empty are counted.
+  std::uint64_t FilterPassCount() const { return filter_pass_count_; }
+  std::uint64_t FilterSkipCount() const { return filter_skip_count_; }
 
  private:
-  static std::string DecodeSymbol(
-      std::size_t symbol_cstr_len,
-      std::vector<std::uint8_t>::const_iterator& buffer_it);
-  static std::vector<std::string> DecodeRepeatedSymbol(
-      std::size_t symbol_cstr_len,
-      std::vector<std::uint8_t>::const_iterator& buffer_it,
-      std::vector<std::uint8_t>::const_iterator buffer_end_it);
-  static std::vector<SymbolMapping> DecodeSymbolMappings(
-      std::size_t symbol_cstr_len,
-      std::vector<std::uint8_t>::const_iterator& buffer_it,
-      std::vector<std::uint8_t>::const_iterator buffer_end_it);
-  static SymbolMapping DecodeSymbolMapping(
-      std::size_t symbol_cstr_len,
-      std::vector<std::uint8_t>::const_iterator& buffer_it,
-      std::vector<std::uint8_t>::const_iterator buffer_end_it);
+  void InitStream(std::size_t buffer_size, std::size_t zstd_thread_count);
+  void InitInMemory();
+  // Reads the metadata following the DBN prefix into `read_buffer_`.
+  void ReadMetadata();
   bool DetectCompression();
   std::size_t FillBuffer();
   RecordHeader* BufferRecordHeader();
+  bool IsRecordBuffered();
+  const Record* DecodeInMemoryRecord();
+  // Returns whether the record at `buffer`, which may not be aligned, should
+  // be skipped according to the filter.
+  bool IsFilteredOut(const std::uint8_t* buffer);
+  // Returns the size of the complete records at the start of `buffer` that
+  // should be skipped according to the filter.
+  std::size_t SkipSize(const std::uint8_t* buffer, std::size_t size);
+  // Returns the size of the complete records at the start of `buffer` that
+  // can be returned in a batch and sets `needs_upgrade` if any of them need to
+  // be upgraded.
+  std::size_t BatchSize(const std::uint8_t* buffer, std::size_t size,
+                        bool* needs_upgrade);
 
   std::uint8_t version_{};
   VersionUpgradePolicy upgrade_policy_;
+  // Must be declared before `input_`, which may read from the mapping
+  detail::MmapFile mmap_file_;
   std::unique_ptr<IReadable> input_;
+  // Used for the metadata and unaligned in-memory batches
   std::vector<std::uint8_t> read_buffer_;
+  // Batches of upgraded records
+  std::vector<std::uint8_t> upgrade_buffer_;
+  // Used for streamed records. Unread input is never moved when it's mirrored.
+  detail::RingBuffer record_buffer_;
+  // Position in the in-memory input
   std::size_t buffer_idx_{};
+  // Uncompressed in-memory input, decoded in place. `nullptr` otherwise.
+  const std::uint8_t* in_memory_{};
+  std::size_t in_memory_size_{};
   // Must be 8-byte aligned for records
   alignas(
       RecordHeader) std::array<std::uint8_t, kMaxRecordLen> compat_buffer_{};
+  // Used for in-memory records that aren't 8-byte aligned
+  alignas(RecordHeader)
+      std::array<std::uint8_t, detail::kMaxEncodedRecordLen> aligned_buffer_{};
   Record current_record_{nullptr};
+  RecordFilter filter_;
+  std::uint64_t filter_pass_count_{};
+  std::uint64_t filter_skip_count_{};
 };
 }  // namespace databento
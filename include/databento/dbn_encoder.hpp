@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>  // size_t
+#include <cstdint>  // uint8_t
+#include <memory>   // unique_ptr
+#include <string>
+#include <vector>
+
+#include "databento/dbn.hpp"  // Metadata
+#include "databento/detail/zstd_stream.hpp"
+#include "databento/enums.hpp"  // Compression
+#include "databento/iwritable.hpp"
+#include "databento/record.hpp"  // Record, RecordBatch
+
+namespace databento {
+// DBN encoder. Writes the metadata on construction and then records as they're
+// encoded, in the DBN version given by the metadata. Records are written as-is,
+// so they must match that version.
+//
+// Records are batched in a buffer and written to the output once it's full or
+// `Flush` is called. Optionally compression and writing happen on a background
+// thread, so encoding a record only blocks when the background thread is still
+// busy with the previous buffer.
+class DbnEncoder {
+ public:
+  // Default size in bytes of the buffer records are batched in.
+  static constexpr std::size_t kDefaultBufferSize = 64 * 1024;
+
+  DbnEncoder(const Metadata& metadata, std::unique_ptr<IWritable> output);
+  DbnEncoder(const Metadata& metadata, std::unique_ptr<IWritable> output,
+             Compression compression);
+  // `buffer_size` is the size in bytes records are batched up to before being
+  // written. If `use_background_thread` is true, batches are compressed and
+  // written to `output` on a background thread.
+  DbnEncoder(const Metadata& metadata, std::unique_ptr<IWritable> output,
+             Compression compression, std::size_t buffer_size,
+             bool use_background_thread);
+  DbnEncoder(const DbnEncoder&) = delete;
+  DbnEncoder& operator=(const DbnEncoder&) = delete;
+  DbnEncoder(DbnEncoder&&) noexcept;
+  DbnEncoder& operator=(DbnEncoder&&) = delete;
+  // Calls `Finish` if it hasn't been called, ignoring any errors.
+  ~DbnEncoder();
+
+  // Encode metadata into a buffer, including the leading DBN prefix, version,
+  // and length.
+  static std::vector<std::uint8_t> EncodeMetadata(const Metadata& metadata);
+
+  void EncodeRecord(const Record& record);
+  // Encode a record struct such as `MboMsg`.
+  template <typename R>
+  void EncodeRecord(const R& record) {
+    Write(reinterpret_cast<const std::uint8_t*>(&record), sizeof(record));
+  }
+  // Encode all records in `batch` with a single copy.
+  void EncodeRecords(const RecordBatch& batch);
+  // Write all encoded records to the output and flush it. Compressed output
+  // isn't a complete Zstd frame until `Finish` is called.
+  void Flush();
+  // Write all encoded records to the output, end any Zstd frame, and flush the
+  // output. Nothing can be encoded afterward.
+  void Finish();
+
+ private:
+  class Worker;
+
+  void Write(const std::uint8_t* data, std::size_t size);
+  void WriteBuffer();
+
+  std::unique_ptr<IWritable> output_;
+  // Points to `output_` when compressing
+  detail::ZstdCompressStream* zstd_stream_{};
+  std::size_t buffer_size_;
+  std::vector<std::uint8_t> buffer_;
+  bool is_finished_{};
+  // Only set when using a background thread
+  std::unique_ptr<Worker> worker_;
+};
+}  // namespace databento
@@ -1,25 +1,149 @@
 #pragma once
 
+#include <array>
+#include <cstddef>  // size_t
+#include <cstdint>
+#include <memory>  // unique_ptr
 #include <string>
+#include <type_traits>  // enable_if
 
+#include "databento/datetime.hpp"     // DateTimeRange, UnixNanos
 #include "databento/dbn.hpp"          // Metadata
 #include "databento/dbn_decoder.hpp"  // DbnDecoder
-#include "databento/enums.hpp"        // VersionUpgradePolicy
-#include "databento/timeseries.hpp"   // MetadataCallback, RecordCallback
+#include "databento/detail/file_stream.hpp"
+#include "databento/enums.hpp"           // VersionUpgradePolicy
+#include "databento/record.hpp"          // Record, kMaxRecordLen
+#include "databento/record_visitor.hpp"  // IsRecordVisitor
+#include "databento/timeseries.hpp"      // MetadataCallback, RecordCallback
 
 namespace databento {
 // A reader for DBN files.
 class DbnFileStore {
  public:
+  enum class ReadMode : std::uint8_t {
+    // Read the file through a buffered stream.
+    Stream,
+    // Memory-map the file. Uncompressed records are passed to the callback
+    // directly from the mapping without being copied.
+    MemoryMap,
+  };
+
   explicit DbnFileStore(const std::string& file_path);
   DbnFileStore(const std::string& file_path,
                VersionUpgradePolicy upgrade_policy);
+  DbnFileStore(const std::string& file_path,
+               VersionUpgradePolicy upgrade_policy, ReadMode read_mode);
+  // Streams the file through a buffer of `buffer_size` bytes.
+  DbnFileStore(const std::string& file_path,
+               VersionUpgradePolicy upgrade_policy, std::size_t buffer_size);
+  // Additionally decompresses Zstd frames in parallel on `zstd_thread_count`
+  // worker threads. See `DbnDecoder`.
+  DbnFileStore(const std::string& file_path,
+               VersionUpgradePolicy upgrade_policy, std::size_t buffer_size,
+               std::size_t zstd_thread_count);
 
   void Replay(const MetadataCallback& metadata_callback,
               const RecordCallback& record_callback);
   void Replay(const RecordCallback& record_callback);
+  // Replays the file to `visitor`, which must derive from `RecordVisitor`.
+  // Records are passed to its typed handlers without a type-erased callback.
+  template <typename Visitor>
+  typename std::enable_if<IsRecordVisitor<Visitor>::value>::type Replay(
+      Visitor& visitor) {
+    visitor.OnMetadata(parser_.DecodeMetadata());
+    RecordBatch batch;
+    while (!(batch = parser_.DecodeRecords()).IsEmpty()) {
+      for (const Record record : batch) {
+        if (visitor.Visit(record) == KeepGoing::Stop) {
+          return;
+        }
+      }
+    }
+  }
+  // Replays only the records whose index timestamp (see `Record::IndexTs`) is
+  // within `datetime_range`. `start` is inclusive and `end` is exclusive. An
+  // `end` of 0 means there's no end.
+  //
+  // If the file is Zstd-compressed and has an up-to-date sidecar index (see
+  // `DbnFrameIndex`), frames before `start` are skipped without being
+  // decompressed. If the file is uncompressed and has a single schema, the
+  // first record is found with a binary search, unless the file also contains
+  // records of other sizes or rtypes, like symbol mappings from a live
+  // session, in which case it's scanned linearly.
+  void Replay(const DateTimeRange<UnixNanos>& datetime_range,
+              const MetadataCallback& metadata_callback,
+              const RecordCallback& record_callback);
+  void Replay(const DateTimeRange<UnixNanos>& datetime_range,
+              const RecordCallback& record_callback);
+
+  // The following methods seek directly to records in uncompressed files with a
+  // single schema, where every record is the same size. They throw
+  // `InvalidArgumentError` for other files, and `DbnResponseError` if the
+  // records turn out to differ in size or rtype.
+
+  // Returns the number of records in the file based on its size.
+  std::uint64_t RecordCount();
+  // Returns the index of the first record whose index timestamp (see
+  // `Record::IndexTs`) is at or after `ts`, or `RecordCount()` if there's none.
+  // Assumes records are sorted by index timestamp.
+  std::uint64_t FindRecord(UnixNanos ts);
+  // Decodes the record at `index`. The record is valid until the next call to
+  // `DecodeRecordAt` or `FindRecord`.
+  Record DecodeRecordAt(std::uint64_t index);
+  // Replays the records starting from the one at `index`.
+  void ReplayFrom(std::uint64_t index, const RecordCallback& record_callback);
 
  private:
+  // The layout of an uncompressed file with a single schema.
+  struct FixedLayout {
+    Metadata metadata;
+    // Offset of the first record in the file
+    std::uint64_t records_offset;
+    std::size_t record_size;
+    // The rtype of the first record
+    RType rtype;
+    std::uint64_t record_count;
+  };
+
+  static DbnDecoder MakeDecoder(const std::string& file_path,
+                                VersionUpgradePolicy upgrade_policy,
+                                ReadMode read_mode);
+
+  // Returns a decoder starting from the first frame with records at or after
+  // `start` according to the sidecar index, or `nullptr` if there's no usable
+  // index. Sets `is_past_end` if the index has no such frame.
+  std::unique_ptr<DbnDecoder> MakeIndexedDecoder(const Metadata& metadata,
+                                                 UnixNanos start,
+                                                 bool* is_past_end) const;
+  // Returns the layout of the file, or `nullptr` if it's compressed, has mixed
+  // schemas, or its size isn't a multiple of the first record's.
+  const FixedLayout* FindLayout();
+  const FixedLayout& GetLayout(const char* method_name);
+  // Returns a decoder starting from the record at `index`.
+  std::unique_ptr<DbnDecoder> MakeFixedDecoder(const FixedLayout& layout,
+                                               std::uint64_t index) const;
+  // Reads the record at `index` as it's encoded in the file. Returns `nullptr`
+  // if its length or rtype differs from the first record's.
+  RecordHeader* TryReadRecord(const FixedLayout& layout, std::uint64_t index);
+  // Like `TryReadRecord`, but throws `DbnResponseError` on a mismatch.
+  Record ReadRecord(const FixedLayout& layout, std::uint64_t index);
+  // Binary searches for the first record not before `ts`. Returns false if a
+  // record it reads doesn't match the first record.
+  bool LowerBound(const FixedLayout& layout, UnixNanos ts,
+                  std::uint64_t* index);
+
+  std::string file_path_;
+  VersionUpgradePolicy upgrade_policy_;
   DbnDecoder parser_;
+  // Lazily initialized by `FindLayout`
+  bool is_layout_found_{};
+  // Set by `FindLayout` when the file size doesn't fit records of one size
+  bool has_irregular_size_{};
+  std::unique_ptr<FixedLayout> layout_;
+  std::unique_ptr<detail::FileStream> seek_stream_;
+  alignas(
+      RecordHeader) std::array<std::uint8_t, kMaxRecordLen> record_buffer_{};
+  alignas(
+      RecordHeader) std::array<std::uint8_t, kMaxRecordLen> compat_buffer_{};
 };
 }  // namespace databento
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "databento/datetime.hpp"  // UnixNanos
+
+namespace databento {
+// An index over the Zstd frames of a compressed DBN file, which allows
+// replaying a time window without decompressing the frames before it. The
+// index is stored in a sidecar file next to the DBN file. See `SidecarPath`.
+//
+// Assumes records are sorted by their index timestamp, as they are in DBN
+// files from Databento.
+class DbnFrameIndex {
+ public:
+  struct Entry {
+    // Offset of the frame in the compressed file.
+    std::uint64_t compressed_offset;
+    // Offset of the frame's first byte in the decompressed DBN stream.
+    std::uint64_t uncompressed_offset;
+    // Offset of the first record beginning in the frame in the decompressed
+    // DBN stream. Records may span frames.
+    std::uint64_t record_offset;
+    // Number of records beginning in the frame. The timestamps are undefined
+    // if 0.
+    std::uint64_t record_count;
+    UnixNanos first_ts_event;
+    UnixNanos last_ts_event;
+    // `ts_recv` or `ts_event` for records without a `ts_recv`. See
+    // `Record::IndexTs`.
+    UnixNanos first_ts_recv;
+    UnixNanos last_ts_recv;
+  };
+
+  // Builds the index in one pass over the compressed DBN file at `file_path`.
+  static DbnFrameIndex Build(const std::string& file_path);
+  // Reads an index previously written with `Write`.
+  static DbnFrameIndex Read(const std::string& index_path);
+  // Returns the path of the sidecar index file for the DBN file at
+  // `file_path`.
+  static std::string SidecarPath(const std::string& file_path);
+
+  void Write(const std::string& index_path) const;
+  // The size in bytes of the indexed file, used to detect a stale index.
+  std::uint64_t FileSize() const { return file_size_; }
+  const std::vector<Entry>& Entries() const { return entries_; }
+  // Returns the first frame with a record at or after `start`, or `nullptr` if
+  // there is none.
+  const Entry* FindStart(UnixNanos start) const;
+
+ private:
+  std::uint64_t file_size_{};
+  std::vector<Entry> entries_;
+};
+
+bool operator==(const DbnFrameIndex::Entry& lhs,
+                const DbnFrameIndex::Entry& rhs);
+inline bool operator!=(const DbnFrameIndex::Entry& lhs,
+                       const DbnFrameIndex::Entry& rhs) {
+  return !(lhs == rhs);
+}
+}  // namespace databento
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>  // size_t
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "databento/enums.hpp"  // Compression
+
+namespace databento {
+// Rewrites DBN files in the current DBN version, such as converting archives of
+// version 1 files to version 2. Records are upgraded a whole batch at a time
+// and the metadata's version and `symbol_cstr_len` are updated. Files already
+// in the current version are copied as-is apart from their compression.
+//
+// Multiple files are transcoded in parallel, one file per thread.
+class DbnTranscoder {
+ public:
+  struct Job {
+    // An uncompressed or Zstd-compressed DBN file.
+    std::string input_path;
+    // Created or truncated.
+    std::string output_path;
+    Compression output_compression;
+  };
+
+  // Transcodes with as many threads as the hardware supports.
+  DbnTranscoder();
+  // Throws `InvalidArgumentError` if `thread_count` is 0.
+  explicit DbnTranscoder(std::size_t thread_count);
+
+  // Transcodes a single file on the calling thread. Returns the number of
+  // records written.
+  static std::uint64_t TranscodeFile(const Job& job);
+
+  std::size_t ThreadCount() const { return thread_count_; }
+  // Transcodes `jobs` in parallel, blocking until they're all finished.
+  // Returns the total number of records written. If any job fails, no further
+  // jobs are started and the first error is rethrown once running jobs
+  // finish. The outputs of failed jobs may be incomplete.
+  std::uint64_t Transcode(const std::vector<Job>& jobs) const;
+
+ private:
+  std::size_t thread_count_;
+};
+}  // namespace databento
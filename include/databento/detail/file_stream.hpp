@@ -2,10 +2,11 @@
 
 #include <cstddef>  // size_t
 #include <cstdint>  // uint8_t
-#include <fstream>  // ifstream
+#include <fstream>  // ifstream, ofstream
 #include <string>
 
 #include "databento/ireadable.hpp"
+#include "databento/iwritable.hpp"
 
 namespace databento {
 namespace detail {
@@ -18,9 +19,25 @@ class FileStream : public IReadable {
   // Read at most `length` bytes. Returns the number of bytes read. Will only
   // return 0 if the end of the stream is reached.
   std::size_t ReadSome(std::uint8_t* buffer, std::size_t max_length) override;
+  // Move the read position to `offset` bytes from the start of the file.
+  void Seek(std::uint64_t offset);
 
  private:
   std::ifstream stream_;
 };
+
+class OutFileStream : public IWritable {
+ public:
+  // Creates or truncates the file at `file_path`.
+  explicit OutFileStream(const std::string& file_path);
+
+  // Write all `length` bytes of `buffer`.
+  void WriteAll(const std::uint8_t* buffer, std::size_t length) override;
+  // Write any internally-buffered data to the file.
+  void Flush() override;
+
+ private:
+  std::ofstream stream_;
+};
 }  // namespace detail
 }  // namespace databento
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>  // size_t
+#include <cstdint>
+#include <limits>  // numeric_limits
+#include <vector>
+
+namespace databento {
+namespace detail {
+// Fibonacci hashing spreads sequential IDs, like instrument and order IDs,
+// across the 32-bit result. Used for the table below, order tables, and
+// sharding.
+inline std::uint32_t HashId(std::uint64_t id) {
+  return static_cast<std::uint32_t>((id * 0x9E3779B97F4A7C15ULL) >> 32);
+}
+
+// The smallest power-of-two capacity, at least 16, that keeps the load factor
+// of an open-addressing table with `count` entries at or below 3/4.
+std::size_t TableCapacity(std::size_t count);
+
+// Assigns each instrument ID a dense index in the order they're inserted so
+// per-instrument state can be kept in flat arrays. IDs are 64-bit so an
+// instrument ID can be combined with a publisher ID. Backed by an
+// open-addressing table with linear probing; entries are never removed
+// individually.
+class InstrumentIndex {
+ public:
+  static constexpr std::uint32_t kNotFound =
+      std::numeric_limits<std::uint32_t>::max();
+
+  std::size_t Size() const { return size_; }
+  bool IsEmpty() const { return size_ == 0; }
+  // Returns the index of `instrument_id` or `kNotFound`.
+  std::uint32_t Find(std::uint64_t instrument_id) const;
+  // Returns the index of `instrument_id`, assigning it the next index if it's
+  // new.
+  std::uint32_t Insert(std::uint64_t instrument_id);
+  // Reserves space for `count` instruments to avoid rehashing.
+  void Reserve(std::size_t count);
+  void Clear();
+
+ private:
+  struct Slot {
+    std::uint64_t instrument_id;
+    // The index plus one, zero if the slot is empty
+    std::uint32_t index_slot;
+  };
+
+  std::size_t FindSlot(std::uint64_t instrument_id) const;
+  void Rehash(std::size_t capacity);
+
+  std::size_t size_{};
+  // Power-of-two sized
+  std::vector<Slot> table_;
+};
+}  // namespace detail
+}  // namespace databento
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>  // size_t
+#include <cstdint>  // uint8_t
+#include <string>
+
+namespace databento {
+namespace detail {
+// RAII wrapper around a read-only, copy-on-write memory mapping of an entire
+// file. The mapping is removed on destruction.
+class MmapFile {
+ public:
+  MmapFile() = default;
+  explicit MmapFile(const std::string& file_path);
+  MmapFile(const MmapFile&) = delete;
+  MmapFile& operator=(const MmapFile&) = delete;
+  MmapFile(MmapFile&& other) noexcept;
+  MmapFile& operator=(MmapFile&& rhs) noexcept;
+  ~MmapFile();
+
+  // Returns `nullptr` for an empty file.
+  const std::uint8_t* Data() const { return data_; }
+  std::size_t Size() const { return size_; }
+  void Close();
+
+ private:
+  std::uint8_t* data_{};
+  std::size_t size_{};
+};
+}  // namespace detail
+}  // namespace databento
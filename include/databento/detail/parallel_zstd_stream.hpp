@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>  // size_t
+#include <cstdint>  // uint8_t
+#include <memory>   // unique_ptr
+#include <vector>
+
+#include "databento/ireadable.hpp"
+
+namespace databento {
+namespace detail {
+// Decompresses Zstd input with multiple frames concurrently on a pool of
+// worker threads. Frames are read from `input` on the calling thread and
+// decompressed output is returned in the original order.
+//
+// Each frame is held in memory in its entirety, so this only speeds up input
+// with many frames. Once a frame's header doesn't state its decompressed size
+// or states one above `kMaxFrameContentSize`, such as the single frame
+// written by the `zstd` CLI, it and the rest of the input are decompressed as
+// a stream on the calling thread instead, keeping memory use bounded.
+class ParallelZstdStream : public IReadable {
+ public:
+  // Largest decompressed size in bytes of a frame held in memory.
+  static constexpr std::size_t kMaxFrameContentSize = 32 * 1024 * 1024;
+
+  ParallelZstdStream(std::unique_ptr<IReadable> input,
+                     std::size_t thread_count);
+  ParallelZstdStream(std::unique_ptr<IReadable> input, std::size_t thread_count,
+                     std::vector<std::uint8_t>&& in_buffer);
+  ParallelZstdStream(const ParallelZstdStream&) = delete;
+  ParallelZstdStream& operator=(const ParallelZstdStream&) = delete;
+  ParallelZstdStream(ParallelZstdStream&&) = delete;
+  ParallelZstdStream& operator=(ParallelZstdStream&&) = delete;
+  ~ParallelZstdStream() override;
+
+  // Read exactly `length` bytes into `buffer`.
+  void ReadExact(std::uint8_t* buffer, std::size_t length) override;
+  // Read at most `length` bytes. Returns the number of bytes read. Will only
+  // return 0 if the end of the stream is reached.
+  std::size_t ReadSome(std::uint8_t* buffer, std::size_t max_length) override;
+
+ private:
+  class Pool;
+
+  enum class FrameResult : std::uint8_t {
+    // A complete frame was read.
+    Frame,
+    // The next frame is too large or of unknown size to read in its entirety.
+    Unbounded,
+    // The end of the input was reached.
+    End,
+  };
+
+  // Reads the next complete frame from `input_` into `frame`.
+  FrameResult ReadFrame(std::vector<std::uint8_t>* frame);
+  // Reads more of `input_` into `in_buffer_`, discarding data that's already
+  // been consumed. Returns false at the end of the input.
+  bool ReadInput();
+  // Reads frames and queues them until `max_queued_` are in flight.
+  void QueueFrames();
+
+  std::unique_ptr<IReadable> input_;
+  std::vector<std::uint8_t> in_buffer_;
+  std::size_t in_buffer_pos_{};
+  bool is_input_done_{};
+  // Whether the remaining input is to be decompressed by `stream_` once all
+  // queued frames have been read
+  bool is_unbounded_{};
+  std::unique_ptr<IReadable> stream_;
+  std::size_t max_queued_;
+  // Position within the decompressed output of the oldest frame
+  std::size_t out_pos_{};
+  std::unique_ptr<Pool> pool_;
+};
+}  // namespace detail
+}  // namespace databento
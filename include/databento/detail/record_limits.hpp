@@ -0,0 +1,14 @@
+#pragma once
+
+#include <cstddef>  // size_t
+
+#include "databento/record.hpp"  // RecordHeader
+
+namespace databento {
+namespace detail {
+// Maximum length in bytes expressible by `RecordHeader::length`, so there's
+// always a record boundary within this many bytes of any offset.
+constexpr std::size_t kMaxEncodedRecordLen =
+    0xFF * RecordHeader::kLengthMultiplier;
+}  // namespace detail
+}  // namespace databento
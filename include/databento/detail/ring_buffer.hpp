@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>  // size_t
+#include <cstdint>  // uint8_t
+#include <vector>
+
+namespace databento {
+namespace detail {
+// A byte buffer for input that's read ahead of being decoded. Where supported,
+// the buffer's pages are mapped twice back to back, so both the readable and
+// writable regions are always contiguous and unread data is never moved, even
+// when it wraps around the end of the buffer. Otherwise, unread data is moved
+// to the front of the buffer only once the space at the end runs low.
+//
+// The capacity is a multiple of the page size and the start of the buffer is
+// at least 8-byte aligned, so data consumed in multiples of 8 bytes stays
+// 8-byte aligned.
+class RingBuffer {
+ public:
+  RingBuffer() = default;
+  // The capacity will be rounded up to a multiple of the page size.
+  explicit RingBuffer(std::size_t min_capacity);
+  RingBuffer(const RingBuffer&) = delete;
+  RingBuffer& operator=(const RingBuffer&) = delete;
+  RingBuffer(RingBuffer&& other) noexcept;
+  RingBuffer& operator=(RingBuffer&& rhs) noexcept;
+  ~RingBuffer();
+
+  std::size_t Capacity() const { return capacity_; }
+  bool IsMirrored() const { return mirror_ != nullptr; }
+
+  const std::uint8_t* ReadBegin() const { return data_ + read_pos_; }
+  std::uint8_t* ReadBegin() { return data_ + read_pos_; }
+  std::size_t ReadableSize() const { return write_pos_ - read_pos_; }
+  // Marks `length` bytes as read. Data that has been read remains valid until
+  // the next call to `WriteBegin`.
+  void Consume(std::size_t length);
+
+  // Returns the start of the writable region. Should be called before
+  // `WritableSize` as it may move unread data when the buffer isn't mirrored.
+  std::uint8_t* WriteBegin();
+  std::size_t WritableSize() const;
+  // Marks `length` bytes as written.
+  void Fill(std::size_t length) { write_pos_ += length; }
+
+ private:
+  static std::size_t PageSize();
+  void Unmap();
+
+  std::uint8_t* data_{};
+  std::size_t capacity_{};
+  std::size_t read_pos_{};
+  std::size_t write_pos_{};
+  // Start of the double mapping. `nullptr` if not mirrored.
+  std::uint8_t* mirror_{};
+  // Fallback storage when mirroring isn't supported
+  std::vector<std::uint8_t> storage_;
+};
+}  // namespace detail
+}  // namespace databento
@@ -8,15 +8,29 @@
 
 namespace databento {
 namespace detail {
-// Copyable, thread-safe, unidirectional channel.
+// Copyable, thread-safe, unidirectional channel for exactly one writer thread
+// and one reader thread. Bytes pass through a bounded lock-free ring buffer,
+// so writing blocks while the buffer is full until the reader catches up.
+// Either side spins briefly before parking while it waits on the other.
 class SharedChannel : public IReadable {
  public:
+  // Default size in bytes of the ring buffer.
+  static constexpr std::size_t kDefaultCapacity = 1024 * 1024;
+
   SharedChannel();
+  // `capacity` is the size of the ring buffer in bytes. Throws
+  // `InvalidArgumentError` if it's zero.
+  explicit SharedChannel(std::size_t capacity);
 
-  // Write `data` of `length` bytes to the channel.
+  std::size_t Capacity() const;
+  // Write `data` of `length` bytes to the channel, blocking while it's full.
+  // Does nothing once the channel has been closed.
   void Write(const std::uint8_t* data, std::size_t length);
   // Signal the end of input.
   void Finish();
+  // Signal the reader will read no more, unblocking the writer. Any unread or
+  // later-written bytes are discarded.
+  void Close();
   // Read exactly `length` bytes.
   void ReadExact(std::uint8_t* buffer, std::size_t length) override;
   // Read at most `length` bytes. Returns the number of bytes read. Will only
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <chrono>   // microseconds
+#include <cstddef>  // size_t
+#include <thread>   // this_thread
+
+namespace databento {
+namespace detail {
+// How many times a thread yields while waiting before it starts sleeping
+constexpr std::size_t kSpinCount = 1024;
+// How long a waiting thread sleeps between checks once it's done spinning
+constexpr std::chrono::microseconds kIdleSleep{50};
+
+// Called each time a check for work comes up empty. Yields for the first
+// `kSpinCount` calls, then sleeps. `wait_count` should be reset to 0 once
+// there's work again.
+inline void Wait(std::size_t* wait_count) {
+  if (*wait_count < kSpinCount) {
+    ++*wait_count;
+    std::this_thread::yield();
+  } else {
+    std::this_thread::sleep_for(kIdleSleep);
+  }
+}
+}  // namespace detail
+}  // namespace databento
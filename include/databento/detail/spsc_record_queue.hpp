@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>  // size_t
+#include <cstdint>  // uint64_t
+#include <memory>   // unique_ptr
+
+#include "databento/record.hpp"  // Record
+
+namespace databento {
+namespace detail {
+// A bounded lock-free queue of records for exactly one producer thread and one
+// consumer thread. Records are copied into a buffer allocated on construction,
+// so pushing never allocates or blocks.
+//
+// Each record is stored contiguously and 8-byte aligned. A record that doesn't
+// fit before the end of the buffer is stored at the start instead.
+class SpscRecordQueue {
+ public:
+  // `capacity` is the size of the buffer in bytes. It's rounded up to a
+  // multiple of 8 and must fit at least two records of the maximum length.
+  explicit SpscRecordQueue(std::size_t capacity);
+  SpscRecordQueue(const SpscRecordQueue&) = delete;
+  SpscRecordQueue& operator=(const SpscRecordQueue&) = delete;
+  SpscRecordQueue(SpscRecordQueue&&) = delete;
+  SpscRecordQueue& operator=(SpscRecordQueue&&) = delete;
+
+  std::size_t Capacity() const { return capacity_; }
+  // The number of bytes in use. Only exact when called from the producer or
+  // consumer while the other is idle.
+  std::size_t Size() const;
+
+  // Producer only. Copies `record` into the queue. Returns false if there isn't
+  // enough space.
+  bool TryPush(const Record& record);
+
+  // Consumer only. Returns the oldest record, or `nullptr` if the queue is
+  // empty. The record is valid until `Pop` is called.
+  const Record* Front();
+  // Consumer only. Removes the record returned by `Front`.
+  void Pop();
+
+ private:
+  static std::size_t SlotSize(std::size_t record_size) {
+    return (record_size + 7) / 8 * 8;
+  }
+
+  static constexpr std::size_t kCacheLineSize = 64;
+
+  std::size_t capacity_;
+  // `uint64_t` for 8-byte alignment
+  std::unique_ptr<std::uint64_t[]> storage_;
+  std::uint8_t* data_;
+  // Positions only ever increase. Each is written by one thread and padded
+  // onto its own cache line. Padding is used instead of `alignas` because
+  // C++11 `new` doesn't support over-aligned types.
+  std::uint8_t producer_padding_[kCacheLineSize]{};
+  std::atomic<std::uint64_t> write_pos_{};
+  // Producer's last-seen `read_pos_`
+  std::uint64_t cached_read_pos_{};
+  std::uint8_t consumer_padding_[kCacheLineSize]{};
+  std::atomic<std::uint64_t> read_pos_{};
+  // Consumer's last-seen `write_pos_`
+  std::uint64_t cached_write_pos_{};
+  Record front_{nullptr};
+  std::uint8_t end_padding_[kCacheLineSize]{};
+};
+}  // namespace detail
+}  // namespace databento
@@ -8,6 +8,7 @@
 #include <vector>
 
 #include "databento/ireadable.hpp"
+#include "databento/iwritable.hpp"
 
 namespace databento {
 namespace detail {
@@ -30,5 +31,31 @@ class ZstdStream : public IReadable {
   std::vector<std::uint8_t> in_buffer_;
   ZSTD_inBuffer z_in_buffer_;
 };
+
+// Compresses everything written to it into Zstd frames written to `output`.
+// `EndFrame` must be called for the output to be complete.
+class ZstdCompressStream : public IWritable {
+ public:
+  explicit ZstdCompressStream(std::unique_ptr<IWritable> output);
+  ZstdCompressStream(std::unique_ptr<IWritable> output, int compression_level);
+
+  // Compress all `length` bytes of `buffer`. Output is written once Zstd has
+  // accumulated enough input to emit a block.
+  void WriteAll(const std::uint8_t* buffer, std::size_t length) override;
+  // Compress any input accumulated by Zstd and write the output without ending
+  // the frame.
+  void Flush() override;
+  // End the current frame and write it to `output`. Later writes begin a new
+  // frame.
+  void EndFrame();
+
+ private:
+  void Compress(const std::uint8_t* buffer, std::size_t length,
+                ZSTD_EndDirective directive);
+
+  std::unique_ptr<IWritable> output_;
+  std::unique_ptr<ZSTD_CCtx, std::size_t (*)(ZSTD_CCtx*)> z_cctx_;
+  std::vector<std::uint8_t> out_buffer_;
+};
 }  // namespace detail
 }  // namespace databento
@@ -3,6 +3,7 @@
 #include <cstdint>
 #include <map>  // multimap
 #include <string>
+#include <type_traits>  // enable_if
 #include <vector>
 
 #include "databento/batch.hpp"     // BatchJob
@@ -11,6 +12,7 @@
 #include "databento/detail/http_client.hpp"  // HttpClient
 #include "databento/enums.hpp"  // BatchState, Delivery, DurationInterval, Packaging, Schema, SType
 #include "databento/metadata.hpp"  // DatasetConditionDetail, DatasetRange, FieldDetail, PublisherDetail, UnitPricesForMode
+#include "databento/record_visitor.hpp"  // IsRecordVisitor
 #include "databento/symbology.hpp"  // SymbologyResolution
 #include "databento/timeseries.hpp"  // KeepGoing, MetadataCallback, RecordCallback
 
@@ -197,6 +199,50 @@ class Historical {
                           std::uint64_t limit,
                           const MetadataCallback& metadata_callback,
                           const RecordCallback& record_callback);
+  // Stream historical market data to the typed handlers of `visitor`, which
+  // must derive from `RecordVisitor`.
+  template <typename Visitor>
+  typename std::enable_if<IsRecordVisitor<Visitor>::value>::type
+  TimeseriesGetRange(const std::string& dataset,
+                     const DateTimeRange<UnixNanos>& datetime_range,
+                     const std::vector<std::string>& symbols, Schema schema,
+                     Visitor& visitor) {
+    TimeseriesGetRange(dataset, datetime_range, symbols, schema,
+                       VisitRecordCallback(visitor));
+  }
+  template <typename Visitor>
+  typename std::enable_if<IsRecordVisitor<Visitor>::value>::type
+  TimeseriesGetRange(const std::string& dataset,
+                     const DateTimeRange<std::string>& datetime_range,
+                     const std::vector<std::string>& symbols, Schema schema,
+                     Visitor& visitor) {
+    TimeseriesGetRange(dataset, datetime_range, symbols, schema,
+                       VisitRecordCallback(visitor));
+  }
+  // `visitor.OnMetadata` will be called exactly once, before any records are
+  // visited.
+  template <typename Visitor>
+  typename std::enable_if<IsRecordVisitor<Visitor>::value>::type
+  TimeseriesGetRange(const std::string& dataset,
+                     const DateTimeRange<UnixNanos>& datetime_range,
+                     const std::vector<std::string>& symbols, Schema schema,
+                     SType stype_in, SType stype_out, std::uint64_t limit,
+                     Visitor& visitor) {
+    TimeseriesGetRange(dataset, datetime_range, symbols, schema, stype_in,
+                       stype_out, limit, VisitMetadataCallback(visitor),
+                       VisitRecordCallback(visitor));
+  }
+  template <typename Visitor>
+  typename std::enable_if<IsRecordVisitor<Visitor>::value>::type
+  TimeseriesGetRange(const std::string& dataset,
+                     const DateTimeRange<std::string>& datetime_range,
+                     const std::vector<std::string>& symbols, Schema schema,
+                     SType stype_in, SType stype_out, std::uint64_t limit,
+                     Visitor& visitor) {
+    TimeseriesGetRange(dataset, datetime_range, symbols, schema, stype_in,
+                       stype_out, limit, VisitMetadataCallback(visitor),
+                       VisitRecordCallback(visitor));
+  }
   // Stream historical market data to a file at `path`. Returns a `DbnFileStore`
   // object for replaying the data in `file_path`.
   //
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstddef>  // size_t
+#include <cstdint>  // uint8_t
+
+namespace databento {
+// An abstract class for writable objects to allow for runtime polymorphism
+// around DBN encoding.
+class IWritable {
+ public:
+  virtual ~IWritable() = default;
+
+  // Write all `length` bytes of `buffer`.
+  virtual void WriteAll(const std::uint8_t* buffer, std::size_t length) = 0;
+  // Write any internally-buffered data to the underlying sink.
+  virtual void Flush() = 0;
+};
+}  // namespace databento
@@ -5,13 +5,18 @@
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <type_traits>  // enable_if
+#include <utility>      // move
 #include <vector>
 
 #include "databento/datetime.hpp"           // UnixNanos
 #include "databento/dbn.hpp"                // Metadata
 #include "databento/detail/tcp_client.hpp"  // TcpClient
-#include "databento/enums.hpp"   // Schema, SType, VersionUpgradePolicy
-#include "databento/record.hpp"  // Record, RecordHeader
+#include "databento/enums.hpp"           // Schema, SType, VersionUpgradePolicy
+#include "databento/record.hpp"          // Record, RecordHeader
+#include "databento/record_filter.hpp"   // RecordFilter
+#include "databento/record_visitor.hpp"  // IsRecordVisitor
+#include "databento/timeseries.hpp"      // KeepGoing
 
 namespace databento {
 class ILogReceiver;
@@ -62,10 +67,30 @@ class LiveBlocking {
   const Record& NextRecord();
   // Block on getting the next record. The returned pointer is valid until
   // this method is called again. Will return `nullptr` if the `timeout` is
-  // reached.
+  // reached, including while skipping records rejected by the filter.
   //
   // This method should only be called after `Start`.
   const Record* NextRecord(std::chrono::milliseconds timeout);
+  // Block on getting the next record and pass it to the typed handler of
+  // `visitor`, which must derive from `RecordVisitor`. Returns the result of
+  // the handler.
+  //
+  // This method should only be called after `Start`.
+  template <typename Visitor>
+  typename std::enable_if<IsRecordVisitor<Visitor>::value, KeepGoing>::type
+  NextRecord(Visitor& visitor) {
+    return visitor.Visit(NextRecord());
+  }
+  // Skips records that don't match `filter` before they're upgraded or
+  // returned from `NextRecord`. Replaces any previous filter. Error, system,
+  // and symbol mapping records from the gateway are always returned and
+  // aren't counted.
+  void SetFilter(RecordFilter filter) { filter_ = std::move(filter); }
+  const RecordFilter& Filter() const { return filter_; }
+  // The number of records that matched or didn't match the filter. Only
+  // records received while the filter was non-empty are counted.
+  std::uint64_t FilterPassCount() const { return filter_pass_count_; }
+  std::uint64_t FilterSkipCount() const { return filter_skip_count_; }
   // Stops the session with the gateway. Once stopped, the session cannot be
   // restarted.
   void Stop();
@@ -81,6 +106,7 @@ class LiveBlocking {
   std::uint64_t DecodeAuthResp();
   detail::TcpClient::Result FillBuffer(std::chrono::milliseconds timeout);
   RecordHeader* BufferRecordHeader();
+  bool IsFilteredOut(const RecordHeader& header);
 
   static constexpr std::size_t kMaxStrLen = 24L * 1024;
 
@@ -102,5 +128,8 @@ class LiveBlocking {
       RecordHeader) std::array<std::uint8_t, kMaxRecordLen> compat_buffer_{};
   std::uint64_t session_id_;
   Record current_record_{nullptr};
+  RecordFilter filter_;
+  std::uint64_t filter_pass_count_{};
+  std::uint64_t filter_skip_count_{};
 };
 }  // namespace databento
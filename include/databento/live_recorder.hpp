@@ -0,0 +1,91 @@
+#pragma once
+
+#include <chrono>   // nanoseconds
+#include <cstddef>  // size_t
+#include <cstdint>
+#include <memory>  // unique_ptr
+#include <string>
+#include <vector>
+
+#include "databento/dbn.hpp"            // Metadata
+#include "databento/enums.hpp"          // Compression
+#include "databento/live_threaded.hpp"  // LiveThreaded
+#include "databento/record.hpp"         // Record
+#include "databento/timeseries.hpp"     // KeepGoing
+
+namespace databento {
+class ILogReceiver;
+
+// Records live data to DBN files without blocking the thread receiving it.
+// Records are copied into a queue allocated on construction and written to
+// disk by a background thread. If the queue is full, records are dropped and
+// counted rather than waiting on the writer.
+//
+// Files are named `{path_prefix}.{n}.dbn`, with a `.zst` suffix when
+// compressed, where `n` counts up from 0. A new file with its own metadata is
+// started when the current one reaches the size limit, when a record's index
+// timestamp (see `Record::IndexTs`) crosses into the next time window, or when
+// new metadata is received, such as after the client restarts the session.
+class LiveRecorder {
+ public:
+  // Default size in bytes of the queue between the receiving thread and the
+  // writer thread.
+  static constexpr std::size_t kDefaultQueueCapacity = 64 * 1024 * 1024;
+
+  // Throws `InvalidArgumentError` if `log_receiver` is null.
+  LiveRecorder(ILogReceiver* log_receiver, std::string path_prefix,
+               Compression compression);
+  // `max_file_size` is the uncompressed size in bytes a file won't exceed
+  // unless it contains a single record. `max_file_duration` is the length of
+  // the windows of index timestamps files are split on, aligned to the UNIX
+  // epoch. Either can be 0 for no limit.
+  LiveRecorder(ILogReceiver* log_receiver, std::string path_prefix,
+               Compression compression, std::uint64_t max_file_size,
+               std::chrono::nanoseconds max_file_duration,
+               std::size_t queue_capacity);
+  LiveRecorder(const LiveRecorder&) = delete;
+  LiveRecorder& operator=(const LiveRecorder&) = delete;
+  LiveRecorder(LiveRecorder&&) = delete;
+  LiveRecorder& operator=(LiveRecorder&&) = delete;
+  // Calls `Stop` if it hasn't been called, ignoring any errors.
+  ~LiveRecorder();
+
+  /*
+   * Methods
+   */
+
+  // Starts `client` with callbacks that pass its metadata and records to this
+  // recorder, which must outlive the session. If the client upgrades DBN
+  // version 1 data, the metadata is upgraded to match.
+  void Start(LiveThreaded* client);
+  // Queues new metadata, which applies to all records received after it. The
+  // metadata must match the version of those records.
+  void OnMetadata(Metadata metadata);
+  // Queues a copy of `record` without blocking. Records received before any
+  // metadata, after `Stop`, or while the queue is full are dropped.
+  KeepGoing OnRecord(const Record& record);
+  // Writes all queued records, finishes the current file, and stops the writer
+  // thread. Rethrows any exception from writing.
+  void Stop();
+
+  /*
+   * Counters. These can be read from any thread.
+   */
+
+  // The number of records written.
+  std::uint64_t RecordCount() const;
+  // The number of records dropped.
+  std::uint64_t DroppedCount() const;
+  // The number of bytes currently queued for the writer thread.
+  std::size_t QueueDepth() const;
+  // The highest number of bytes queued at once.
+  std::size_t MaxQueueDepth() const;
+  // The paths of all files started so far.
+  std::vector<std::string> FilePaths() const;
+
+ private:
+  struct Impl;
+
+  std::unique_ptr<Impl> impl_;
+};
+}  // namespace databento
@@ -4,6 +4,7 @@
 #include <functional>  // function
 #include <memory>      // unique_ptr
 #include <string>
+#include <type_traits>  // enable_if
 #include <vector>
 
 #include "databento/datetime.hpp"              // UnixNanos
@@ -11,6 +12,7 @@
 #include "databento/detail/scoped_thread.hpp"  // ScopedThread
 #include "databento/enums.hpp"                 // Schema, SType
 #include "databento/record.hpp"                // Record
+#include "databento/record_visitor.hpp"        // IsRecordVisitor
 #include "databento/timeseries.hpp"  // MetadataCallback, RecordCallback
 
 namespace databento {
@@ -78,6 +80,14 @@ class LiveThreaded {
              RecordCallback record_callback);
   void Start(MetadataCallback metadata_callback, RecordCallback record_callback,
              ExceptionCallback exception_callback);
+  // Passes the metadata and records to the typed handlers of `visitor`, which
+  // must derive from `RecordVisitor` and outlive the session. Records are
+  // dispatched on the rtype once by the visitor.
+  template <typename Visitor>
+  typename std::enable_if<IsRecordVisitor<Visitor>::value>::type Start(
+      Visitor& visitor) {
+    Start(VisitMetadataCallback(visitor), VisitRecordCallback(visitor));
+  }
   // Closes the current connection, and attempts to reconnect to the gateway.
   void Reconnect();
   // Blocking wait with an optional timeout for the session to close when the
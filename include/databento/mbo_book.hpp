@@ -0,0 +1,161 @@
+#pragma once
+
+#include <cstddef>  // size_t
+#include <cstdint>
+#include <functional>  // function
+#include <unordered_map>
+#include <vector>
+
+#include "databento/datetime.hpp"    // UnixNanos
+#include "databento/enums.hpp"       // Side
+#include "databento/record.hpp"      // BidAskPair, MboMsg, Record
+#include "databento/timeseries.hpp"  // KeepGoing, RecordCallback
+
+namespace databento {
+// A limit order book for a single instrument and publisher built from MBO
+// messages. Orders are kept in FIFO queues per price level and indexed by
+// order ID in a flat hash table. Order and level nodes are pooled and reused,
+// so once the book has grown to its working size, applying messages doesn't
+// allocate.
+class MboBook {
+ public:
+  MboBook() = default;
+
+  // Applies an add, cancel, modify, clear, trade, or fill. Trades and fills
+  // don't change the book: the orders they fill are removed by subsequent
+  // cancels. Top-of-book adds replace the whole side and aren't indexed by
+  // order ID, since both sides often share one.
+  void Apply(const MboMsg& mbo);
+  // Removes all orders.
+  void Clear();
+
+  // Whether the last message applied was the last in its packet for the
+  // instrument. The book should only be read when it's consistent.
+  bool IsConsistent() const { return is_consistent_; }
+  // Whether a snapshot is being applied. Set by the first snapshot message and
+  // cleared by the last.
+  bool InSnapshot() const { return in_snapshot_; }
+  // The `ts_recv` of the last message applied.
+  UnixNanos LastUpdate() const { return last_update_; }
+  std::size_t OrderCount() const { return order_count_; }
+  std::size_t BidLevelCount() const { return bids_.size(); }
+  std::size_t AskLevelCount() const { return asks_.size(); }
+  // The best bid and offer. Empty sides have a price of `kUndefPrice` and a
+  // size and count of zero.
+  BidAskPair Bbo() const;
+  // Fills `levels` with up to `level_count` levels of aggregated depth like an
+  // MBP-N record, returning the number of levels with a bid or ask.
+  std::size_t Snapshot(BidAskPair* levels, std::size_t level_count) const;
+  std::vector<BidAskPair> Snapshot(std::size_t level_count) const;
+
+ private:
+  struct Order {
+    std::uint64_t order_id;
+    std::uint32_t size;
+    // Index in `levels_`
+    std::uint32_t level;
+    // Indices in `orders_` of the neighbors in the level's queue
+    std::uint32_t prev;
+    std::uint32_t next;
+    // Whether the order is in `order_table_`. Top-of-book levels are a single
+    // synthetic order that isn't.
+    bool is_indexed;
+  };
+  struct Level {
+    std::int64_t price;
+    std::uint32_t size;
+    std::uint32_t count;
+    // Indices in `orders_` of the front and back of the queue
+    std::uint32_t head;
+    std::uint32_t tail;
+    Side side;
+  };
+  // Levels are sorted with the best at the back, where most changes happen.
+  struct LevelRef {
+    std::int64_t price;
+    // Index in `levels_`
+    std::uint32_t level;
+  };
+  struct OrderSlot {
+    std::uint64_t order_id;
+    // Index in `orders_` plus one, zero if the slot is empty
+    std::uint32_t order_slot;
+  };
+
+  void Add(const MboMsg& mbo);
+  void Cancel(const MboMsg& mbo);
+  void Modify(const MboMsg& mbo);
+  void ClearSide(Side side);
+  void AddOrder(std::uint64_t order_id, Side side, std::int64_t price,
+                std::uint32_t size);
+  // Links a new unindexed order into its level, returning its index in
+  // `orders_`.
+  std::uint32_t NewOrder(std::uint64_t order_id, Side side, std::int64_t price,
+                         std::uint32_t size);
+  void RemoveOrder(std::uint32_t order_idx);
+  void LinkOrder(std::uint32_t order_idx, std::uint32_t level_idx);
+  void UnlinkOrder(std::uint32_t order_idx);
+  std::uint32_t FindOrInsertLevel(Side side, std::int64_t price);
+  void RemoveLevel(std::uint32_t level_idx);
+  std::vector<LevelRef>& SideLevels(Side side) {
+    return side == Side::Bid ? bids_ : asks_;
+  }
+  // Returns the index in `orders_` of `order_id` or `kNoIndex`.
+  std::uint32_t FindOrder(std::uint64_t order_id) const;
+  std::size_t FindOrderSlot(std::uint64_t order_id) const;
+  void InsertOrderSlot(std::uint64_t order_id, std::uint32_t order_idx);
+  void EraseOrderSlot(std::uint64_t order_id);
+  void RehashOrders(std::size_t capacity);
+
+  bool is_consistent_{true};
+  bool in_snapshot_{};
+  UnixNanos last_update_{};
+  std::size_t order_count_{};
+  std::vector<LevelRef> bids_;
+  std::vector<LevelRef> asks_;
+  // Pools with free lists of released nodes
+  std::vector<Order> orders_;
+  std::vector<std::uint32_t> free_orders_;
+  std::vector<Level> levels_;
+  std::vector<std::uint32_t> free_levels_;
+  // Power-of-two sized with linear probing
+  std::vector<OrderSlot> order_table_;
+};
+
+// Maintains an `MboBook` for each instrument and publisher. Can be fed from
+// `DbnFileStore::Replay` or `LiveThreaded::Start` with `Bind`, or by calling
+// `Apply` from a `RecordVisitor`.
+class MboBookEngine {
+ public:
+  // Called with each MBO message that leaves its book consistent, i.e. the
+  // last message of a packet for the instrument.
+  using BookCallback =
+      std::function<KeepGoing(const MboMsg& mbo, const MboBook& book)>;
+
+  MboBookEngine() = default;
+
+  // Applies `mbo` to the book of its instrument and publisher, returning the
+  // book.
+  const MboBook& Apply(const MboMsg& mbo);
+  // Applies MBO records and ignores all others.
+  void OnRecord(const Record& record);
+  // Returns the book for the instrument and publisher or `nullptr` if no
+  // messages have been applied for it.
+  const MboBook* Find(std::uint32_t instrument_id,
+                      std::uint16_t publisher_id) const;
+  std::size_t BookCount() const { return books_.size(); }
+  // Removes all books.
+  void Clear() { books_.clear(); }
+  // Returns a record callback that applies MBO records and calls `callback`
+  // when a book is consistent. The engine must outlive the returned callback.
+  RecordCallback Bind(BookCallback callback);
+
+ private:
+  static std::uint64_t Key(std::uint32_t instrument_id,
+                           std::uint16_t publisher_id) {
+    return (std::uint64_t{instrument_id} << 16) | std::uint64_t{publisher_id};
+  }
+
+  std::unordered_map<std::uint64_t, MboBook> books_;
+};
+}  // namespace databento
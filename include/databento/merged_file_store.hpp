@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>     // size_t
+#include <functional>  // function
+#include <memory>      // unique_ptr
+#include <string>
+#include <vector>
+
+#include "databento/dbn.hpp"         // Metadata
+#include "databento/enums.hpp"       // VersionUpgradePolicy
+#include "databento/record.hpp"      // Record
+#include "databento/timeseries.hpp"  // KeepGoing, RecordCallback
+
+namespace databento {
+// Replays multiple DBN files as a single stream ordered by index timestamp
+// (see `Record::IndexTs`), such as the files of different schemas or venues
+// for the same day. Each file must be sorted by index timestamp. Records with
+// the same index timestamp are replayed in the order of the files.
+//
+// Each file is read and decompressed ahead on its own thread into a bounded
+// queue, so the replaying thread only merges the records.
+class MergedFileStore {
+ public:
+  // Receives each record and the index of the file it's from.
+  using MergedRecordCallback =
+      std::function<KeepGoing(const Record& record, std::size_t file_idx)>;
+
+  // Default size in bytes of the queue of records read ahead from each file.
+  static constexpr std::size_t kDefaultQueueCapacity = 1024 * 1024;
+
+  // Opens the files and decodes their metadata. Throws `InvalidArgumentError`
+  // if `file_paths` is empty.
+  explicit MergedFileStore(const std::vector<std::string>& file_paths);
+  MergedFileStore(const std::vector<std::string>& file_paths,
+                  VersionUpgradePolicy upgrade_policy);
+  MergedFileStore(const std::vector<std::string>& file_paths,
+                  VersionUpgradePolicy upgrade_policy,
+                  std::size_t queue_capacity);
+  MergedFileStore(const MergedFileStore&) = delete;
+  MergedFileStore& operator=(const MergedFileStore&) = delete;
+  MergedFileStore(MergedFileStore&&) noexcept;
+  MergedFileStore& operator=(MergedFileStore&&) noexcept;
+  // Stops any reader threads still running.
+  ~MergedFileStore();
+
+  std::size_t FileCount() const;
+  const std::string& FilePath(std::size_t file_idx) const;
+  // The metadata of the file at `file_idx` as it's encoded in the file.
+  const Metadata& FileMetadata(std::size_t file_idx) const;
+
+  // Replays the records of all files in order. Should be called at most once.
+  // Rethrows the first exception from reading a file once the records read
+  // before it have been replayed.
+  void Replay(const MergedRecordCallback& record_callback);
+  void Replay(const RecordCallback& record_callback);
+
+ private:
+  struct Impl;
+
+  std::unique_ptr<Impl> impl_;
+};
+}  // namespace databento
@@ -0,0 +1,233 @@
+#pragma once
+
+#include <cstddef>  // ptrdiff_t, size_t
+#include <cstdint>
+#include <iterator>  // forward_iterator_tag
+#include <string>
+#include <vector>
+
+#include "databento/datetime.hpp"  // UnixNanos
+#include "databento/dbn.hpp"       // Metadata, SymbolMapping
+#include "databento/enums.hpp"     // Schema, SType
+
+namespace databento {
+namespace detail {
+// A list of entries `stride` bytes apart, decoded as `T` when accessed.
+template <typename T>
+class FixedWidthList {
+ public:
+  class Iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const T*;
+    using reference = T;
+
+    Iterator(const std::uint8_t* pos, std::size_t stride)
+        : pos_{pos}, stride_{stride} {}
+
+    T operator*() const { return Get(pos_); }
+    Iterator& operator++() {
+      pos_ += stride_;
+      return *this;
+    }
+    Iterator operator++(int) {
+      auto res = *this;
+      ++*this;
+      return res;
+    }
+    bool operator==(const Iterator& rhs) const { return pos_ == rhs.pos_; }
+    bool operator!=(const Iterator& rhs) const { return pos_ != rhs.pos_; }
+
+   private:
+    const std::uint8_t* pos_;
+    std::size_t stride_;
+  };
+
+  FixedWidthList() = default;
+  FixedWidthList(const std::uint8_t* data, std::size_t count,
+                 std::size_t stride)
+      : data_{data}, count_{count}, stride_{stride} {}
+
+  std::size_t Size() const { return count_; }
+  bool IsEmpty() const { return count_ == 0; }
+  T operator[](std::size_t idx) const { return Get(data_ + idx * stride_); }
+  Iterator begin() const { return Iterator{data_, stride_}; }
+  Iterator end() const { return Iterator{data_ + count_ * stride_, stride_}; }
+
+ private:
+  static T Get(const std::uint8_t* pos) { return T{pos}; }
+
+  const std::uint8_t* data_{};
+  std::size_t count_{};
+  std::size_t stride_{};
+};
+
+// Symbols are null-terminated strings in fixed-width slots.
+template <>
+inline const char* FixedWidthList<const char*>::Get(const std::uint8_t* pos) {
+  return reinterpret_cast<const char*>(pos);
+}
+}  // namespace detail
+
+// A view of encoded DBN metadata that decodes the symbol lists and symbol
+// mappings lazily from their fixed-width `symbol_cstr_len` slots, without
+// allocating a string per symbol. The whole buffer is validated on
+// construction, including that every symbol is null-terminated within its
+// slot, so accessing the lists never fails.
+//
+// The lists and mappings point into the buffer owned by the `MetadataView` and
+// remain valid when it's moved. Use `ToMetadata` to decode everything eagerly.
+class MetadataView {
+ public:
+  // Null-terminated symbols.
+  using SymbolList = detail::FixedWidthList<const char*>;
+
+  class IntervalView {
+   public:
+    explicit IntervalView(const std::uint8_t* data) : data_{data} {}
+
+    // The start date of the interval (inclusive) as YYYYMMDD.
+    std::uint32_t StartDate() const;
+    // The end date of the interval (exclusive) as YYYYMMDD.
+    std::uint32_t EndDate() const;
+    const char* Symbol() const {
+      return reinterpret_cast<const char*>(data_ + 2 * sizeof(std::uint32_t));
+    }
+
+   private:
+    const std::uint8_t* data_;
+  };
+  using IntervalList = detail::FixedWidthList<IntervalView>;
+
+  class MappingView {
+   public:
+    MappingView(const std::uint8_t* data, std::size_t symbol_cstr_len)
+        : data_{data}, symbol_cstr_len_{symbol_cstr_len} {}
+
+    const char* RawSymbol() const {
+      return reinterpret_cast<const char*>(data_);
+    }
+    IntervalList Intervals() const;
+    SymbolMapping ToSymbolMapping() const;
+    // The size in bytes of the encoded mapping.
+    std::size_t EncodedSize() const;
+
+   private:
+    const std::uint8_t* data_;
+    std::size_t symbol_cstr_len_;
+  };
+
+  // Mappings have a variable number of intervals, so they can only be
+  // iterated over in order.
+  class MappingList {
+   public:
+    class Iterator {
+     public:
+      using iterator_category = std::forward_iterator_tag;
+      using value_type = MappingView;
+      using difference_type = std::ptrdiff_t;
+      using pointer = const MappingView*;
+      using reference = MappingView;
+
+      Iterator(const std::uint8_t* pos, std::size_t symbol_cstr_len)
+          : pos_{pos}, symbol_cstr_len_{symbol_cstr_len} {}
+
+      MappingView operator*() const {
+        return MappingView{pos_, symbol_cstr_len_};
+      }
+      Iterator& operator++() {
+        pos_ += MappingView{pos_, symbol_cstr_len_}.EncodedSize();
+        return *this;
+      }
+      Iterator operator++(int) {
+        auto res = *this;
+        ++*this;
+        return res;
+      }
+      bool operator==(const Iterator& rhs) const { return pos_ == rhs.pos_; }
+      bool operator!=(const Iterator& rhs) const { return pos_ != rhs.pos_; }
+
+     private:
+      const std::uint8_t* pos_;
+      std::size_t symbol_cstr_len_;
+    };
+
+    MappingList() = default;
+    MappingList(const std::uint8_t* data, const std::uint8_t* data_end,
+                std::size_t count, std::size_t symbol_cstr_len)
+        : data_{data},
+          data_end_{data_end},
+          count_{count},
+          symbol_cstr_len_{symbol_cstr_len} {}
+
+    std::size_t Size() const { return count_; }
+    bool IsEmpty() const { return count_ == 0; }
+    Iterator begin() const { return Iterator{data_, symbol_cstr_len_}; }
+    Iterator end() const { return Iterator{data_end_, symbol_cstr_len_}; }
+
+   private:
+    const std::uint8_t* data_{};
+    const std::uint8_t* data_end_{};
+    std::size_t count_{};
+    std::size_t symbol_cstr_len_{};
+  };
+
+  // `buffer` is the encoded metadata following the DBN prefix, version, and
+  // length. Throws `DbnResponseError` if it's invalid or of a newer version.
+  MetadataView(std::uint8_t version, std::vector<std::uint8_t> buffer);
+  MetadataView(const MetadataView&) = delete;
+  MetadataView& operator=(const MetadataView&) = delete;
+  MetadataView(MetadataView&&) = default;
+  MetadataView& operator=(MetadataView&&) = default;
+  ~MetadataView() = default;
+
+  std::uint8_t Version() const { return version_; }
+  const std::string& Dataset() const { return dataset_; }
+  bool HasMixedSchema() const { return has_mixed_schema_; }
+  Schema GetSchema() const { return schema_; }
+  UnixNanos Start() const { return start_; }
+  UnixNanos End() const { return end_; }
+  std::uint64_t Limit() const { return limit_; }
+  bool HasMixedSTypeIn() const { return has_mixed_stype_in_; }
+  SType STypeIn() const { return stype_in_; }
+  SType STypeOut() const { return stype_out_; }
+  bool TsOut() const { return ts_out_; }
+  std::size_t SymbolCstrLen() const { return symbol_cstr_len_; }
+  // The original query input symbols from the request.
+  SymbolList Symbols() const { return symbols_; }
+  // Symbols that did not resolve for at least one day in the query time range.
+  SymbolList Partial() const { return partial_; }
+  // Symbols that did not resolve for any day in the query time range.
+  SymbolList NotFound() const { return not_found_; }
+  MappingList Mappings() const { return mappings_; }
+  // The encoded metadata.
+  const std::vector<std::uint8_t>& Buffer() const { return buffer_; }
+
+  // Decodes all fields, allocating each symbol.
+  Metadata ToMetadata() const;
+
+ private:
+  void Decode();
+
+  std::uint8_t version_;
+  std::vector<std::uint8_t> buffer_;
+  std::string dataset_;
+  bool has_mixed_schema_{};
+  Schema schema_{};
+  UnixNanos start_;
+  UnixNanos end_;
+  std::uint64_t limit_{};
+  bool has_mixed_stype_in_{};
+  SType stype_in_{};
+  SType stype_out_{};
+  bool ts_out_{};
+  std::size_t symbol_cstr_len_{};
+  // Point into `buffer_`
+  SymbolList symbols_;
+  SymbolList partial_;
+  SymbolList not_found_;
+  MappingList mappings_;
+};
+}  // namespace databento
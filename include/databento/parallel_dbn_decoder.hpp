@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>  // size_t
+#include <cstdint>
+#include <functional>  // function
+#include <string>
+#include <vector>
+
+#include "databento/dbn.hpp"               // Metadata
+#include "databento/dbn_decoder.hpp"       // DbnDecoder
+#include "databento/detail/mmap_file.hpp"  // MmapFile
+#include "databento/enums.hpp"             // VersionUpgradePolicy
+#include "databento/record.hpp"            // Record
+#include "databento/timeseries.hpp"        // KeepGoing, RecordCallback
+
+namespace databento {
+// Decodes a large uncompressed DBN file on several threads. The file is
+// memory-mapped and its records are split into chunks of about the same size,
+// each decoded in place on one thread.
+//
+// Chunk boundaries are found by stride in files with a single schema, where
+// every record is the same size. In files with mixed schemas, each chunk's
+// first record is found by scanning for a run of valid record lengths, and
+// the scans are validated by following the record lengths from the start of
+// the records in parallel.
+class ParallelDbnDecoder {
+ public:
+  // Receives each record and the index of its chunk. Called concurrently from
+  // multiple threads.
+  using ChunkRecordCallback =
+      std::function<KeepGoing(const Record& record, std::size_t chunk_idx)>;
+
+  // Size in bytes of the queue of records decoded ahead by each thread when
+  // replaying in order.
+  static constexpr std::size_t kDefaultQueueCapacity = 1024 * 1024;
+
+  // Splits the file into 4 chunks per thread. Throws `InvalidArgumentError` if
+  // the file is compressed or `thread_count` is zero.
+  ParallelDbnDecoder(const std::string& file_path, std::size_t thread_count);
+  ParallelDbnDecoder(const std::string& file_path,
+                     VersionUpgradePolicy upgrade_policy,
+                     std::size_t thread_count);
+  // Splits the file into at most `chunk_count` chunks. Fewer chunks are used
+  // if the file has fewer records.
+  ParallelDbnDecoder(const std::string& file_path,
+                     VersionUpgradePolicy upgrade_policy,
+                     std::size_t thread_count, std::size_t chunk_count);
+
+  const Metadata& FileMetadata() const { return metadata_; }
+  std::size_t ThreadCount() const { return thread_count_; }
+  std::size_t ChunkCount() const { return chunk_offsets_.size() - 1; }
+  // The offset in bytes of the first record of the chunk at `chunk_idx` within
+  // the file. `ChunkOffset(ChunkCount())` is the end of the last chunk.
+  std::uint64_t ChunkOffset(std::size_t chunk_idx) const {
+    return chunk_offsets_[chunk_idx];
+  }
+
+  // Decodes the chunks in parallel, passing each record to `record_callback`
+  // on the thread decoding its chunk. Records within a chunk are passed in
+  // order, but there's no order between chunks. Returning `KeepGoing::Stop`
+  // stops decoding the rest of the current chunk. Rethrows the first exception
+  // from `record_callback`.
+  void ReplayChunks(const ChunkRecordCallback& record_callback);
+  // Decodes the chunks in parallel and passes all records to `record_callback`
+  // on the calling thread in the order they appear in the file.
+  void Replay(const RecordCallback& record_callback);
+
+ private:
+  // Splits the records evenly by count. Returns false without setting any
+  // offsets if the records aren't all the same length and rtype, such as when
+  // gateway records are interleaved.
+  bool FindChunkOffsets(std::uint64_t records_offset, std::size_t chunk_count);
+  void FindMixedChunkOffsets(std::uint64_t records_offset,
+                             std::size_t chunk_count);
+  DbnDecoder ChunkDecoder(std::size_t chunk_idx) const;
+
+  detail::MmapFile mmap_file_;
+  VersionUpgradePolicy upgrade_policy_;
+  std::size_t thread_count_;
+  Metadata metadata_;
+  // The offset of the first record of each chunk followed by the end of the
+  // last chunk
+  std::vector<std::uint64_t> chunk_offsets_;
+};
+}  // namespace databento
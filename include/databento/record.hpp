@@ -5,6 +5,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <cstring>  // strncmp
+#include <iterator>  // forward_iterator_tag
 #include <string>
 #include <tuple>  // tie
 
@@ -31,7 +32,9 @@ struct RecordHeader {
   // The exchange timestamp in UNIX epoch nanoseconds.
   UnixNanos ts_event;
 
-  std::size_t Size() const;
+  std::size_t Size() const {
+    return static_cast<std::size_t>(length) * kLengthMultiplier;
+  }
   // Retrieve the publisher based on the publisher ID.
   enum Publisher Publisher() const {
     return static_cast<enum Publisher>(publisher_id);
@@ -60,7 +63,10 @@ class Record {
     return *reinterpret_cast<T*>(record_);
   }
 
-  std::size_t Size() const;
+  std::size_t Size() const { return record_->Size(); }
+  // The timestamp records are sorted by: `ts_recv` if the record has one,
+  // otherwise `ts_event`.
+  UnixNanos IndexTs() const;
   static std::size_t SizeOfSchema(Schema schema);
   static ::databento::RType RTypeFromSchema(Schema schema);
 
@@ -68,6 +74,58 @@ class Record {
   RecordHeader* record_;
 };
 
+// A non-owning view of contiguous, complete records. Iterating over a batch
+// avoids a function call per record.
+class RecordBatch {
+ public:
+  class Iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = Record;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const Record*;
+    using reference = Record;
+
+    explicit Iterator(std::uint8_t* pos) : pos_{pos} {}
+
+    Record operator*() const {
+      return Record{reinterpret_cast<RecordHeader*>(pos_)};
+    }
+    Iterator& operator++() {
+      // `length` is the first byte of the header
+      pos_ += static_cast<std::size_t>(*pos_) * RecordHeader::kLengthMultiplier;
+      return *this;
+    }
+    Iterator operator++(int) {
+      Iterator prev{*this};
+      ++*this;
+      return prev;
+    }
+    bool operator==(const Iterator& rhs) const { return pos_ == rhs.pos_; }
+    bool operator!=(const Iterator& rhs) const { return pos_ != rhs.pos_; }
+
+   private:
+    std::uint8_t* pos_;
+  };
+
+  RecordBatch() = default;
+  // `data` must be 8-byte aligned and contain `size` bytes of complete
+  // records.
+  RecordBatch(std::uint8_t* data, std::size_t size)
+      : data_{data}, size_{size} {}
+
+  Iterator begin() const { return Iterator{data_}; }
+  Iterator end() const { return Iterator{data_ + size_}; }
+  bool IsEmpty() const { return size_ == 0; }
+  const std::uint8_t* Data() const { return data_; }
+  // The size of the batch in bytes.
+  std::size_t Size() const { return size_; }
+
+ private:
+  std::uint8_t* data_{};
+  std::size_t size_{};
+};
+
 // Market-by-order (MBO) message.
 struct MboMsg {
   static bool HasRType(RType rtype) { return rtype == RType::Mbo; }
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <array>
+#include <cstddef>  // size_t
+#include <cstdint>
+#include <unordered_set>
+#include <vector>
+
+#include "databento/enums.hpp"   // RType
+#include "databento/record.hpp"  // RecordHeader
+
+namespace databento {
+// A filter on the fields of the `RecordHeader`. `DbnDecoder` and `LiveBlocking`
+// apply it to records in their read buffers so records that don't match are
+// skipped before they're upgraded or returned.
+//
+// A record matches if its rtype, instrument ID, and publisher ID are each among
+// the ones added to the filter. Fields with none added match any value, so an
+// empty filter matches every record.
+//
+// `LiveBlocking` doesn't apply the filter to error, system, and symbol
+// mapping records from the gateway, so errors, heartbeats, and symbol
+// mappings are delivered even when they don't match.
+class RecordFilter {
+ public:
+  RecordFilter& AddRType(RType rtype);
+  RecordFilter& AddInstrumentId(std::uint32_t instrument_id);
+  RecordFilter& AddPublisherId(std::uint16_t publisher_id);
+
+  bool IsEmpty() const {
+    return !has_rtypes_ && !has_instrument_ids_ && !has_publisher_ids_;
+  }
+  bool Matches(const RecordHeader& header) const {
+    return (!has_rtypes_ || TestBit(rtypes_.data(), header.rtype)) &&
+           (!has_publisher_ids_ ||
+            TestBit(publisher_ids_.data(), header.publisher_id)) &&
+           (!has_instrument_ids_ || MatchesInstrumentId(header.instrument_id));
+  }
+
+ private:
+  // Instrument IDs below this are stored in a bitmap and the rest in a hash
+  // set. The bitmap is at most 2 MiB.
+  static constexpr std::uint32_t kMaxBitmapInstrumentId = 1 << 24;
+
+  static bool TestBit(const std::uint64_t* bitmap, std::size_t idx) {
+    return (bitmap[idx / 64] >> (idx % 64)) & 1;
+  }
+  static void SetBit(std::uint64_t* bitmap, std::size_t idx) {
+    bitmap[idx / 64] |= std::uint64_t{1} << (idx % 64);
+  }
+  bool MatchesInstrumentId(std::uint32_t instrument_id) const {
+    if (instrument_id < kMaxBitmapInstrumentId) {
+      return instrument_id / 64 < instrument_id_bitmap_.size() &&
+             TestBit(instrument_id_bitmap_.data(), instrument_id);
+    }
+    return instrument_id_set_.count(instrument_id) > 0;
+  }
+
+  bool has_rtypes_{};
+  bool has_instrument_ids_{};
+  bool has_publisher_ids_{};
+  std::array<std::uint64_t, 256 / 64> rtypes_{};
+  // Sized to fit the largest instrument ID added
+  std::vector<std::uint64_t> instrument_id_bitmap_;
+  std::unordered_set<std::uint32_t> instrument_id_set_;
+  std::vector<std::uint64_t> publisher_ids_;
+};
+}  // namespace databento
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <type_traits>  // is_base_of
+#include <utility>      // move
+
+#include "databento/compat.hpp"  // InstrumentDefMsgV1, SymbolMappingMsgV1
+#include "databento/dbn.hpp"     // Metadata
+#include "databento/enums.hpp"   // RType
+#include "databento/record.hpp"
+#include "databento/timeseries.hpp"  // KeepGoing, RecordCallback
+
+namespace databento {
+// A base for statically typed record visitors. Derive from it passing the
+// derived class as `Derived` and hide the handlers for the record types of
+// interest:
+//
+//   struct TradeCounter : RecordVisitor<TradeCounter> {
+//     KeepGoing OnTrade(const TradeMsg&) {
+//       ++count;
+//       return KeepGoing::Continue;
+//     }
+//     std::size_t count{};
+//   };
+//
+// `Visit` switches on the rtype once and calls the handler directly, without a
+// type-erased callback. Handlers that aren't hidden do nothing and are
+// optimized away. Visitors can be passed to `DbnFileStore::Replay`,
+// `LiveBlocking::NextRecord`, `LiveThreaded::Start`, and
+// `Historical::TimeseriesGetRange`.
+template <typename Derived>
+class RecordVisitor {
+ public:
+  // Calls the handler for the type of `record`.
+  KeepGoing Visit(const Record& record);
+
+  void OnMetadata(Metadata&&) {}
+  KeepGoing OnMbo(const MboMsg&) { return KeepGoing::Continue; }
+  KeepGoing OnTrade(const TradeMsg&) { return KeepGoing::Continue; }
+  KeepGoing OnMbp1(const Mbp1Msg&) { return KeepGoing::Continue; }
+  KeepGoing OnMbp10(const Mbp10Msg&) { return KeepGoing::Continue; }
+  KeepGoing OnOhlcv(const OhlcvMsg&) { return KeepGoing::Continue; }
+  KeepGoing OnInstrumentDef(const InstrumentDefMsg&) {
+    return KeepGoing::Continue;
+  }
+  KeepGoing OnImbalance(const ImbalanceMsg&) { return KeepGoing::Continue; }
+  KeepGoing OnStat(const StatMsg&) { return KeepGoing::Continue; }
+  KeepGoing OnError(const ErrorMsg&) { return KeepGoing::Continue; }
+  KeepGoing OnSymbolMapping(const SymbolMappingMsg&) {
+    return KeepGoing::Continue;
+  }
+  KeepGoing OnSystem(const SystemMsg&) { return KeepGoing::Continue; }
+  // DBN version 1 records, which are only passed to the visitor when they
+  // aren't upgraded. See `VersionUpgradePolicy`.
+  KeepGoing OnInstrumentDefV1(const InstrumentDefMsgV1&) {
+    return KeepGoing::Continue;
+  }
+  KeepGoing OnErrorV1(const ErrorMsgV1&) { return KeepGoing::Continue; }
+  KeepGoing OnSymbolMappingV1(const SymbolMappingMsgV1&) {
+    return KeepGoing::Continue;
+  }
+  KeepGoing OnSystemV1(const SystemMsgV1&) { return KeepGoing::Continue; }
+  // Called for records with an unknown rtype.
+  KeepGoing OnOther(const Record&) { return KeepGoing::Continue; }
+};
+
+// Whether `T` derives from `RecordVisitor<T>`. Used to select the visitor
+// overloads over the ones taking callbacks.
+template <typename T>
+using IsRecordVisitor = std::is_base_of<RecordVisitor<T>, T>;
+
+// Adapts `visitor` for APIs taking callbacks. `visitor` must outlive the
+// returned callback.
+template <typename Visitor>
+MetadataCallback VisitMetadataCallback(Visitor& visitor) {
+  return [&visitor](Metadata&& metadata) {
+    visitor.OnMetadata(std::move(metadata));
+  };
+}
+template <typename Visitor>
+RecordCallback VisitRecordCallback(Visitor& visitor) {
+  return [&visitor](const Record& record) { return visitor.Visit(record); };
+}
+
+template <typename Derived>
+KeepGoing RecordVisitor<Derived>::Visit(const Record& record) {
+  auto& derived = *static_cast<Derived*>(this);
+  switch (record.RType()) {
+    case RType::Mbo: {
+      return derived.OnMbo(record.Get<MboMsg>());
+    }
+    case RType::Mbp0: {
+      return derived.OnTrade(record.Get<TradeMsg>());
+    }
+    case RType::Mbp1: {
+      return derived.OnMbp1(record.Get<Mbp1Msg>());
+    }
+    case RType::Mbp10: {
+      return derived.OnMbp10(record.Get<Mbp10Msg>());
+    }
+    case RType::OhlcvDeprecated:
+    case RType::Ohlcv1S:
+    case RType::Ohlcv1M:
+    case RType::Ohlcv1H:
+    case RType::Ohlcv1D: {
+      return derived.OnOhlcv(record.Get<OhlcvMsg>());
+    }
+    case RType::InstrumentDef: {
+      // Version 1 records are smaller
+      if (record.Size() < sizeof(InstrumentDefMsg)) {
+        return derived.OnInstrumentDefV1(record.Get<InstrumentDefMsgV1>());
+      }
+      return derived.OnInstrumentDef(record.Get<InstrumentDefMsg>());
+    }
+    case RType::Imbalance: {
+      return derived.OnImbalance(record.Get<ImbalanceMsg>());
+    }
+    case RType::Statistics: {
+      return derived.OnStat(record.Get<StatMsg>());
+    }
+    case RType::Error: {
+      if (record.Size() < sizeof(ErrorMsg)) {
+        return derived.OnErrorV1(record.Get<ErrorMsgV1>());
+      }
+      return derived.OnError(record.Get<ErrorMsg>());
+    }
+    case RType::SymbolMapping: {
+      if (record.Size() < sizeof(SymbolMappingMsg)) {
+        return derived.OnSymbolMappingV1(record.Get<SymbolMappingMsgV1>());
+      }
+      return derived.OnSymbolMapping(record.Get<SymbolMappingMsg>());
+    }
+    case RType::System: {
+      if (record.Size() < sizeof(SystemMsg)) {
+        return derived.OnSystemV1(record.Get<SystemMsgV1>());
+      }
+      return derived.OnSystem(record.Get<SystemMsg>());
+    }
+    default: {
+      return derived.OnOther(record);
+    }
+  }
+}
+}  // namespace databento
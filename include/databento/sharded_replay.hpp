@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>  // size_t
+#include <cstdint>
+#include <functional>  // function
+#include <memory>      // unique_ptr
+
+#include "databento/record.hpp"      // Record
+#include "databento/timeseries.hpp"  // MetadataCallback, RecordCallback
+
+namespace databento {
+class DbnFileStore;
+
+// Processes records in parallel by routing each one by its instrument ID to one
+// of several shards, each with its own worker thread and callback. Records are
+// decoded or received on a single thread and handed off to the workers through
+// lock-free queues, so records of the same instrument are always processed by
+// the same callback in order. There's no ordering between shards.
+class ShardedReplay {
+ public:
+  // Creates the callback of the shard at `shard_idx`. Each callback is only
+  // called from its shard's worker thread, so its state doesn't need to be
+  // synchronized.
+  using ShardCallbackFactory =
+      std::function<RecordCallback(std::size_t shard_idx)>;
+
+  // Default size in bytes of the queue of each shard.
+  static constexpr std::size_t kDefaultQueueCapacity = 4 * 1024 * 1024;
+
+  // Starts `shard_count` worker threads. Throws `InvalidArgumentError` if
+  // `shard_count` is zero.
+  ShardedReplay(std::size_t shard_count,
+                const ShardCallbackFactory& callback_factory);
+  ShardedReplay(std::size_t shard_count,
+                const ShardCallbackFactory& callback_factory,
+                std::size_t queue_capacity);
+  ShardedReplay(const ShardedReplay&) = delete;
+  ShardedReplay& operator=(const ShardedReplay&) = delete;
+  ShardedReplay(ShardedReplay&&) = delete;
+  ShardedReplay& operator=(ShardedReplay&&) = delete;
+  // Stops the worker threads after they've processed the queued records,
+  // ignoring any errors.
+  ~ShardedReplay();
+
+  std::size_t ShardCount() const;
+  // The index of the shard records of `instrument_id` are routed to.
+  std::size_t ShardOf(std::uint32_t instrument_id) const;
+
+  // Replays `file_store` across the shards and waits for all of its records to
+  // be processed. Metadata is passed to `metadata_callback` on the calling
+  // thread.
+  void Replay(DbnFileStore& file_store,
+              const MetadataCallback& metadata_callback);
+  void Replay(DbnFileStore& file_store);
+  // Queues `record` to its shard, waiting while the shard's queue is full. Must
+  // always be called from the same thread, such as in the record callback of
+  // a live client or `MergedFileStore`. Returns `KeepGoing::Stop` once every
+  // shard's callback has returned `KeepGoing::Stop` or any callback has thrown.
+  KeepGoing OnRecord(const Record& record);
+  // Waits until all records queued so far have been processed. Rethrows the
+  // first exception from a shard callback. Must be called from the thread
+  // calling `OnRecord`.
+  void Flush();
+  // Flushes and stops the worker threads.
+  void Stop();
+
+ private:
+  struct Impl;
+
+  std::unique_ptr<Impl> impl_;
+};
+}  // namespace databento
@@ -1,11 +1,19 @@
 #pragma once
 
+#include <cstddef>  // size_t
 #include <cstdint>
+#include <functional>  // function
+#include <memory>      // unique_ptr
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "databento/compat.hpp"
-#include "databento/record.hpp"
+#include "databento/datetime.hpp"                 // UnixNanos
+#include "databento/dbn.hpp"                      // Metadata
+#include "databento/detail/instrument_index.hpp"  // InstrumentIndex
+#include "databento/record.hpp"                   // Record
+#include "databento/timeseries.hpp"               // KeepGoing, RecordCallback
 
 namespace databento {
 // A point-in-time symbol map. Useful for working with live symbology or
@@ -35,9 +43,155 @@ class PitSymbolMap {
   Store map_;
 };
 
+// A point-in-time symbol map for large universes, like all OPRA instruments,
+// that avoids an allocation per symbol mapping. Instrument IDs are stored in a
+// flat open-addressing table pointing to interned symbols in an append-only
+// arena, so looking up a symbol doesn't allocate or chase pointers through
+// buckets. Also maintains a reverse index from symbol to instrument ID.
+//
+// Symbols returned by `Find` are null-terminated and remain valid until the
+// map is cleared or destroyed, even when other mappings are added or changed.
+// Use `PitSymbolMap` for a `std::string`-based API.
+class FlatPitSymbolMap {
+ public:
+  FlatPitSymbolMap() = default;
+  // Reserves space for `instrument_count` instruments.
+  explicit FlatPitSymbolMap(std::size_t instrument_count);
+  FlatPitSymbolMap(const FlatPitSymbolMap&) = delete;
+  FlatPitSymbolMap& operator=(const FlatPitSymbolMap&) = delete;
+  // Leaves `other` empty so it never writes into the moved arena.
+  FlatPitSymbolMap(FlatPitSymbolMap&& other) noexcept;
+  FlatPitSymbolMap& operator=(FlatPitSymbolMap&& rhs) noexcept;
+  ~FlatPitSymbolMap() = default;
+
+  bool IsEmpty() const { return instruments_.empty(); }
+  // The number of mapped instruments.
+  std::size_t Size() const { return instruments_.size(); }
+  // The number of distinct symbols interned, including ones no longer mapped.
+  std::size_t SymbolCount() const { return symbols_.size(); }
+  // Reserves space for `instrument_count` instruments to avoid rehashing
+  // during the burst of symbol mappings at the start of a session.
+  void Reserve(std::size_t instrument_count);
+  // Returns the symbol of `instrument_id` or `nullptr` if it isn't mapped.
+  const char* Find(std::uint32_t instrument_id) const;
+  // Returns the instrument ID most recently mapped to `symbol` or `nullptr` if
+  // it isn't currently mapped. The pointer is invalidated by the next change
+  // to the map.
+  const std::uint32_t* FindInstrumentId(const char* symbol) const;
+  const std::uint32_t* FindInstrumentId(const std::string& symbol) const;
+  // Maps `instrument_id` to the first `length` characters of `symbol`,
+  // replacing any existing mapping.
+  void Insert(std::uint32_t instrument_id, const char* symbol,
+              std::size_t length);
+  void Insert(std::uint32_t instrument_id, const std::string& symbol) {
+    Insert(instrument_id, symbol.data(), symbol.size());
+  }
+  // Removes all mappings and releases the symbol arena.
+  void Clear();
+  // Copies the mappings to the map type of `PitSymbolMap`.
+  PitSymbolMap::Store ToStore() const;
+  void OnRecord(const Record& rec);
+  template <typename SymbolMappingRec>
+  void OnSymbolMapping(const SymbolMappingRec& symbol_mapping);
+
+ private:
+  struct Symbol {
+    // Null-terminated, points into the arena
+    const char* data;
+    std::uint32_t length;
+    std::uint32_t hash;
+    // The instrument ID most recently mapped to the symbol
+    std::uint32_t instrument_id;
+    bool is_mapped;
+  };
+  struct Instrument {
+    std::uint32_t instrument_id;
+    // Index in `symbols_`
+    std::uint32_t symbol_idx;
+  };
+
+  std::size_t FindSymbolSlot(const char* symbol, std::size_t length,
+                             std::uint32_t hash) const;
+  std::uint32_t Intern(const char* symbol, std::size_t length);
+  const char* StoreSymbol(const char* symbol, std::size_t length);
+  void RehashSymbols(std::size_t capacity);
+
+  detail::InstrumentIndex instrument_index_;
+  // Indexed by `instrument_index_`
+  std::vector<Instrument> instruments_;
+  // Power-of-two sized with linear probing. Index in `symbols_` plus one, zero
+  // if the slot is empty.
+  std::vector<std::uint32_t> symbol_table_;
+  std::vector<Symbol> symbols_;
+  std::vector<std::unique_ptr<char[]>> arena_chunks_;
+  char* arena_pos_{};
+  char* arena_end_{};
+};
+
+// A timeseries symbol map for historical data over multiple days, built once
+// from the symbol mappings of `Metadata`. Maps an instrument ID and a UTC date
+// to the symbol it had on that date.
+//
+// The mappings are stored in a compact table of date intervals sorted by
+// instrument ID and start date, with each distinct symbol stored once. Lookups
+// are a binary search over the table and never allocate.
+class TsSymbolMap {
+ public:
+  // Called with each record and its symbol, or an empty string if the
+  // record's instrument ID isn't mapped on its date.
+  using SymbolRecordCallback =
+      std::function<KeepGoing(const Record&, const std::string& symbol)>;
+
+  TsSymbolMap() = default;
+  // Throws `InvalidArgumentError` if the mappings contain an invalid
+  // instrument ID.
+  explicit TsSymbolMap(const Metadata& metadata);
+
+  bool IsEmpty() const { return intervals_.empty(); }
+  // The number of mapping intervals.
+  std::size_t Size() const { return intervals_.size(); }
+  // The number of distinct symbols.
+  std::size_t SymbolCount() const { return symbols_.size(); }
+  // Returns the symbol of `instrument_id` on `date`, a YYYYMMDD integer, or
+  // `nullptr` if it isn't mapped on that date.
+  const std::string* Find(std::uint32_t date,
+                          std::uint32_t instrument_id) const;
+  // Returns the symbol of `instrument_id` on the UTC date of `ts`, or
+  // `nullptr` if it isn't mapped on that date.
+  const std::string* Find(UnixNanos ts, std::uint32_t instrument_id) const;
+  // Returns the symbol of `record` on the date of its index timestamp (see
+  // `Record::IndexTs`). Throws `InvalidArgumentError` if it isn't mapped.
+  const std::string& At(const Record& record) const;
+  // Replaces the map with the mappings in `metadata`. Can be used to build the
+  // map from the metadata callback of `DbnFileStore::Replay`.
+  void OnMetadata(const Metadata& metadata);
+  // Returns a record callback for `DbnFileStore::Replay` that calls `callback`
+  // with each record and its symbol. The map must outlive the returned
+  // callback.
+  RecordCallback Bind(SymbolRecordCallback callback) const;
+
+ private:
+  struct Interval {
+    std::uint32_t instrument_id;
+    // YYYYMMDD, inclusive
+    std::uint32_t start_date;
+    // YYYYMMDD, exclusive
+    std::uint32_t end_date;
+    // Index in `symbols_`
+    std::uint32_t symbol_idx;
+  };
+
+  std::vector<Interval> intervals_;
+  std::vector<std::string> symbols_;
+};
+
 // Forward declare explicit instantiation
 extern template void PitSymbolMap::OnSymbolMapping(
     const SymbolMappingMsgV1& symbol_mapping);
 extern template void PitSymbolMap::OnSymbolMapping(
     const SymbolMappingMsgV2& symbol_mapping);
+extern template void FlatPitSymbolMap::OnSymbolMapping(
+    const SymbolMappingMsgV1& symbol_mapping);
+extern template void FlatPitSymbolMap::OnSymbolMapping(
+    const SymbolMappingMsgV2& symbol_mapping);
 }  // namespace databento
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstddef>  // size_t
+#include <cstdint>
+#include <vector>
+
+#include "databento/enums.hpp"   // Side
+#include "databento/record.hpp"  // BidAskPair, InstrumentDefMsg, Mbp1Msg
+
+namespace databento {
+// An aggregated depth book for a single instrument stored as a ladder of
+// price levels one tick apart, so updating a level is an array access. The
+// ladder covers a window of `tick_count` ticks that's re-centered on the best
+// price when the market drifts outside of it.
+//
+// Updates to levels outside the window that are worse than the best price of
+// their side are dropped, as are levels that fall outside the window when it's
+// re-centered. Prices are expected to be multiples of the tick size.
+class TickLadderBook {
+ public:
+  struct Level {
+    std::uint32_t size;
+    std::uint32_t count;
+  };
+
+  static constexpr std::size_t kDefaultTickCount = 4096;
+
+  // Throws `InvalidArgumentError` if `tick_size` isn't positive or
+  // `tick_count` is less than 2.
+  explicit TickLadderBook(std::int64_t tick_size,
+                          std::size_t tick_count = kDefaultTickCount);
+  // Uses the `min_price_increment` of `definition` as the tick size.
+  explicit TickLadderBook(const InstrumentDefMsg& definition,
+                          std::size_t tick_count = kDefaultTickCount);
+
+  // Replaces the top of book with the levels in the record.
+  void Apply(const Mbp1Msg& mbp);
+  // Replaces the top 10 levels with the levels in the record.
+  void Apply(const Mbp10Msg& mbp);
+  // Replaces the top `level_count` levels of each side with `levels`, such as
+  // from an MBP-N record. Levels with an undefined price mark the end of a
+  // side.
+  void ApplyLevels(const BidAskPair* levels, std::size_t level_count);
+  // Sets the aggregated size and order count of a single level, such as a
+  // level of an `MboBook` changed by an MBO message. A size of zero removes
+  // the level.
+  void SetLevel(Side side, std::int64_t price, std::uint32_t size,
+                std::uint32_t count);
+  // Removes all levels.
+  void Clear();
+
+  // The size and count at `price`, which are zero if there's no level at the
+  // price or it's outside the window.
+  Level DepthAt(Side side, std::int64_t price) const;
+  // The best bid and offer. Empty sides have a price of `kUndefPrice` and a
+  // size and count of zero.
+  BidAskPair Bbo() const;
+  // Fills `levels` with up to `level_count` levels like an MBP-N record,
+  // returning the number of levels with a bid or ask.
+  std::size_t Snapshot(BidAskPair* levels, std::size_t level_count) const;
+  std::vector<BidAskPair> Snapshot(std::size_t level_count) const;
+
+  std::int64_t TickSize() const { return tick_size_; }
+  std::size_t TickCount() const { return bids_.size(); }
+  // The price of the lowest tick in the window.
+  std::int64_t BasePrice() const { return base_price_; }
+  // The number of level updates dropped for being outside the window.
+  std::uint64_t DroppedCount() const { return dropped_count_; }
+
+ private:
+  std::vector<Level>& SideLevels(Side side) {
+    return side == Side::Bid ? bids_ : asks_;
+  }
+  const std::vector<Level>& SideLevels(Side side) const {
+    return side == Side::Bid ? bids_ : asks_;
+  }
+  bool IsEmpty() const;
+  // Returns the index of `price` in the ladder or `kNoLevel` if it's outside
+  // the window.
+  std::size_t ToIndex(std::int64_t price) const;
+  std::int64_t ToPrice(std::size_t idx) const;
+  bool IsBetter(Side side, std::int64_t price) const;
+  void Recenter(std::int64_t price);
+  void ApplySide(Side side, const BidAskPair* levels, std::size_t level_count);
+  void ClearSide(Side side);
+  // Returns the index of the first level found scanning away from the top of
+  // book starting at `idx` or `kNoLevel` if there's none.
+  std::size_t FindBidAtOrBelow(std::size_t idx) const;
+  std::size_t FindAskAtOrAbove(std::size_t idx) const;
+
+  std::int64_t tick_size_;
+  std::int64_t base_price_{};
+  std::uint64_t dropped_count_{};
+  // Indices of the best levels or `kNoLevel` if a side is empty
+  std::size_t best_bid_;
+  std::size_t best_ask_;
+  std::vector<Level> bids_;
+  std::vector<Level> asks_;
+};
+}  // namespace databento
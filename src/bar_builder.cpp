@@ -0,0 +1,158 @@
+#include "databento/bar_builder.hpp"
+
+#include <algorithm>  // max, min
+#include <utility>    // move
+
+#include "databento/constants.hpp"   // kUndefPrice
+#include "databento/exceptions.hpp"  // InvalidArgumentError
+
+using databento::BarBuilder;
+
+namespace {
+databento::RType TimeBarRType(std::chrono::nanoseconds interval) {
+  if (interval == std::chrono::seconds{1}) {
+    return databento::RType::Ohlcv1S;
+  }
+  if (interval == std::chrono::minutes{1}) {
+    return databento::RType::Ohlcv1M;
+  }
+  if (interval == std::chrono::hours{1}) {
+    return databento::RType::Ohlcv1H;
+  }
+  if (interval == std::chrono::hours{24}) {
+    return databento::RType::Ohlcv1D;
+  }
+  return databento::RType::OhlcvDeprecated;
+}
+}  // namespace
+
+BarBuilder BarBuilder::TimeBars(std::chrono::nanoseconds interval,
+                                BarCallback callback) {
+  if (interval.count() <= 0) {
+    throw InvalidArgumentError{"BarBuilder::TimeBars", "interval",
+                               "Must be positive"};
+  }
+  return BarBuilder{Boundary::Time,
+                    static_cast<std::uint64_t>(interval.count()),
+                    TimeBarRType(interval), std::move(callback)};
+}
+
+BarBuilder BarBuilder::VolumeBars(std::uint64_t volume, BarCallback callback) {
+  if (volume == 0) {
+    throw InvalidArgumentError{"BarBuilder::VolumeBars", "volume",
+                               "Must be greater than 0"};
+  }
+  return BarBuilder{Boundary::Volume, volume, RType::OhlcvDeprecated,
+                    std::move(callback)};
+}
+
+BarBuilder::BarBuilder(Boundary boundary, std::uint64_t threshold,
+                       RType rtype, BarCallback callback)
+    : boundary_{boundary},
+      threshold_{threshold},
+      rtype_{rtype},
+      callback_{std::move(callback)} {}
+
+void BarBuilder::OnTrade(std::uint32_t instrument_id,
+                         std::uint16_t publisher_id, UnixNanos ts_event,
+                         std::int64_t price, std::uint32_t size) {
+  if (price == kUndefPrice) {
+    return;
+  }
+  const auto idx = index_.Insert(Key(instrument_id, publisher_id));
+  if (idx == states_.size()) {
+    states_.push_back(BarState{instrument_id, publisher_id, false, 0, 0, 0, 0,
+                               0, 0});
+  }
+  auto& state = states_[idx];
+  const std::uint64_t ts = ts_event.time_since_epoch().count();
+  if (boundary_ == Boundary::Time) {
+    const auto start = ts - ts % threshold_;
+    // Late trades are added to the open bar
+    if (state.is_open && start > state.start) {
+      Close(state);
+    }
+    if (!state.is_open) {
+      state.start = start;
+    }
+  } else if (!state.is_open) {
+    state.start = ts;
+  }
+  if (state.is_open) {
+    state.high = std::max(state.high, price);
+    state.low = std::min(state.low, price);
+    state.volume += size;
+  } else {
+    state.is_open = true;
+    state.open = price;
+    state.high = price;
+    state.low = price;
+    state.volume = size;
+  }
+  state.close = price;
+  if (boundary_ == Boundary::Volume && state.volume >= threshold_) {
+    Close(state);
+  }
+}
+
+void BarBuilder::OnRecord(const Record& record) {
+  if (record.Holds<TradeMsg>()) {
+    const auto& trade = record.Get<TradeMsg>();
+    OnTrade(trade.hd.instrument_id, trade.hd.publisher_id, trade.hd.ts_event,
+            trade.price, trade.size);
+  } else if (record.Holds<Mbp1Msg>()) {
+    const auto& mbp = record.Get<Mbp1Msg>();
+    if (mbp.action == Action::Trade) {
+      OnTrade(mbp.hd.instrument_id, mbp.hd.publisher_id, mbp.hd.ts_event,
+              mbp.price, mbp.size);
+    }
+  } else if (record.Holds<Mbp10Msg>()) {
+    const auto& mbp = record.Get<Mbp10Msg>();
+    if (mbp.action == Action::Trade) {
+      OnTrade(mbp.hd.instrument_id, mbp.hd.publisher_id, mbp.hd.ts_event,
+              mbp.price, mbp.size);
+    }
+  } else if (record.Holds<MboMsg>()) {
+    const auto& mbo = record.Get<MboMsg>();
+    if (mbo.action == Action::Trade) {
+      OnTrade(mbo.hd.instrument_id, mbo.hd.publisher_id, mbo.hd.ts_event,
+              mbo.price, mbo.size);
+    }
+  }
+}
+
+void BarBuilder::Flush(UnixNanos ts) {
+  if (boundary_ != Boundary::Time) {
+    return;
+  }
+  const std::uint64_t now = ts.time_since_epoch().count();
+  for (auto& state : states_) {
+    if (state.is_open && state.start + threshold_ <= now) {
+      Close(state);
+    }
+  }
+}
+
+void BarBuilder::FlushAll() {
+  for (auto& state : states_) {
+    if (state.is_open) {
+      Close(state);
+    }
+  }
+}
+
+void BarBuilder::Close(BarState& state) {
+  OhlcvMsg bar{};
+  bar.hd = RecordHeader{sizeof(OhlcvMsg) / RecordHeader::kLengthMultiplier,
+                        rtype_,
+                        state.publisher_id,
+                        state.instrument_id,
+                        UnixNanos{UnixNanos::duration{state.start}}};
+  bar.open = state.open;
+  bar.high = state.high;
+  bar.low = state.low;
+  bar.close = state.close;
+  bar.volume = state.volume;
+  state.is_open = false;
+  callback_(bar);
+}
@@ -0,0 +1,736 @@
+#include "databento/column_kernels.hpp"
+
+#include <algorithm>  // binary_search, sort
+#include <cstring>    // memcpy
+#include <limits>
+#include <string>
+
+#include "databento/exceptions.hpp"  // InvalidArgumentError
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+// Each kernel is compiled for every instruction set with target attributes
+// rather than compiler flags so the library runs on any x86-64 CPU
+#define DATABENTO_X86_KERNELS
+#define DATABENTO_TARGET_SSE42 __attribute__((target("sse4.2")))
+#define DATABENTO_TARGET_AVX2 __attribute__((target("avx2")))
+#include <immintrin.h>
+#endif
+
+using databento::ColumnKernels;
+using databento::KernelIsa;
+
+namespace databento {
+namespace detail {
+// The implementations of the kernels for one instruction set
+struct ColumnKernelTable {
+  void (*range_mask)(const std::int64_t*, std::size_t, std::int64_t,
+                     std::int64_t, std::uint8_t*);
+  void (*time_range_mask)(const std::uint64_t*, std::size_t, std::uint64_t,
+                          std::uint64_t, std::uint8_t*);
+  // Only used for small sets of IDs
+  void (*instrument_id_mask)(const std::uint32_t*, std::size_t,
+                             const std::uint32_t*, std::size_t,
+                             std::uint8_t*);
+  void (*flag_mask)(const std::uint8_t*, std::size_t, std::uint8_t,
+                    std::uint8_t*);
+  void (*and_mask)(const std::uint8_t*, std::size_t, std::uint8_t*);
+  std::size_t (*count_mask)(const std::uint8_t*, std::size_t);
+  std::int64_t (*sum_i64)(const std::int64_t*, const std::uint8_t*,
+                          std::size_t);
+  std::uint64_t (*sum_u32)(const std::uint32_t*, const std::uint8_t*,
+                           std::size_t);
+  std::int64_t (*min)(const std::int64_t*, const std::uint8_t*, std::size_t);
+  std::int64_t (*max)(const std::int64_t*, const std::uint8_t*, std::size_t);
+};
+}  // namespace detail
+}  // namespace databento
+
+using databento::detail::ColumnKernelTable;
+
+namespace {
+// Sets with more instrument IDs than this are binary searched instead of
+// compared against each value
+constexpr std::size_t kMaxComparedIds = 16;
+
+namespace scalar {
+void RangeMask(const std::int64_t* values, std::size_t count, std::int64_t min,
+               std::int64_t max, std::uint8_t* mask) {
+  for (std::size_t i = 0; i < count; ++i) {
+    mask[i] = values[i] >= min && values[i] <= max;
+  }
+}
+
+void TimeRangeMask(const std::uint64_t* timestamps, std::size_t count,
+                   std::uint64_t start, std::uint64_t end,
+                   std::uint8_t* mask) {
+  for (std::size_t i = 0; i < count; ++i) {
+    mask[i] = timestamps[i] >= start && timestamps[i] < end;
+  }
+}
+
+void InstrumentIdMask(const std::uint32_t* values, std::size_t count,
+                      const std::uint32_t* ids, std::size_t id_count,
+                      std::uint8_t* mask) {
+  for (std::size_t i = 0; i < count; ++i) {
+    bool is_match = false;
+    for (std::size_t j = 0; j < id_count; ++j) {
+      is_match = is_match || values[i] == ids[j];
+    }
+    mask[i] = is_match;
+  }
+}
+
+void FlagMask(const std::uint8_t* values, std::size_t count,
+              std::uint8_t flags, std::uint8_t* mask) {
+  for (std::size_t i = 0; i < count; ++i) {
+    mask[i] = (values[i] & flags) != 0;
+  }
+}
+
+void AndMask(const std::uint8_t* other, std::size_t count,
+             std::uint8_t* mask) {
+  for (std::size_t i = 0; i < count; ++i) {
+    mask[i] = mask[i] != 0 && other[i] != 0;
+  }
+}
+
+std::size_t CountMask(const std::uint8_t* mask, std::size_t count) {
+  std::size_t res{};
+  for (std::size_t i = 0; i < count; ++i) {
+    res += mask[i] != 0;
+  }
+  return res;
+}
+
+std::int64_t SumI64(const std::int64_t* values, const std::uint8_t* mask,
+                    std::size_t count) {
+  // Unsigned so overflow wraps like the vectorized implementations
+  std::uint64_t res{};
+  for (std::size_t i = 0; i < count; ++i) {
+    if (mask[i] != 0) {
+      res += static_cast<std::uint64_t>(values[i]);
+    }
+  }
+  return static_cast<std::int64_t>(res);
+}
+
+std::uint64_t SumU32(const std::uint32_t* values, const std::uint8_t* mask,
+                     std::size_t count) {
+  std::uint64_t res{};
+  for (std::size_t i = 0; i < count; ++i) {
+    if (mask[i] != 0) {
+      res += values[i];
+    }
+  }
+  return res;
+}
+
+std::int64_t Min(const std::int64_t* values, const std::uint8_t* mask,
+                 std::size_t count) {
+  auto res = std::numeric_limits<std::int64_t>::max();
+  for (std::size_t i = 0; i < count; ++i) {
+    if (mask[i] != 0 && values[i] < res) {
+      res = values[i];
+    }
+  }
+  return res;
+}
+
+std::int64_t Max(const std::int64_t* values, const std::uint8_t* mask,
+                 std::size_t count) {
+  auto res = std::numeric_limits<std::int64_t>::min();
+  for (std::size_t i = 0; i < count; ++i) {
+    if (mask[i] != 0 && values[i] > res) {
+      res = values[i];
+    }
+  }
+  return res;
+}
+
+constexpr ColumnKernelTable kTable{
+    RangeMask, TimeRangeMask, InstrumentIdMask, FlagMask, AndMask,
+    CountMask, SumI64,        SumU32,           Min,      Max};
+}  // namespace scalar
+
+#ifdef DATABENTO_X86_KERNELS
+// Writes the lowest `n` bits of a compare result as one byte per row.
+void StoreBits(unsigned bits, std::size_t n, std::uint8_t* mask) {
+  for (std::size_t i = 0; i < n; ++i) {
+    mask[i] = static_cast<std::uint8_t>((bits >> i) & 1);
+  }
+}
+
+// The bit flipped to compare unsigned 64-bit integers with signed compares.
+constexpr std::uint64_t kSignBit = std::uint64_t{1} << 63;
+
+std::int64_t ToSigned(std::uint64_t value) {
+  return static_cast<std::int64_t>(value ^ kSignBit);
+}
+
+namespace sse42 {
+// Loads 2 mask bytes as 64-bit lanes that are all ones for unselected rows.
+DATABENTO_TARGET_SSE42 __m128i LoadUnselected2(const std::uint8_t* mask) {
+  std::uint16_t bytes;
+  std::memcpy(&bytes, mask, sizeof(bytes));
+  return _mm_cmpeq_epi64(_mm_cvtepu8_epi64(_mm_cvtsi32_si128(bytes)),
+                         _mm_setzero_si128());
+}
+
+DATABENTO_TARGET_SSE42 std::uint64_t HorizontalSum(__m128i acc) {
+  std::uint64_t lanes[2];
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), acc);
+  return lanes[0] + lanes[1];
+}
+
+DATABENTO_TARGET_SSE42 unsigned MoveMask64(__m128i v) {
+  return static_cast<unsigned>(_mm_movemask_pd(_mm_castsi128_pd(v)));
+}
+
+DATABENTO_TARGET_SSE42 void RangeMask(const std::int64_t* values,
+                                      std::size_t count, std::int64_t min,
+                                      std::int64_t max, std::uint8_t* mask) {
+  const auto vmin = _mm_set1_epi64x(min);
+  const auto vmax = _mm_set1_epi64x(max);
+  std::size_t i = 0;
+  for (; i + 2 <= count; i += 2) {
+    const auto v =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i));
+    const auto outside =
+        _mm_or_si128(_mm_cmpgt_epi64(vmin, v), _mm_cmpgt_epi64(v, vmax));
+    StoreBits(~MoveMask64(outside), 2, mask + i);
+  }
+  scalar::RangeMask(values + i, count - i, min, max, mask + i);
+}
+
+DATABENTO_TARGET_SSE42 void TimeRangeMask(const std::uint64_t* timestamps,
+                                          std::size_t count,
+                                          std::uint64_t start,
+                                          std::uint64_t end,
+                                          std::uint8_t* mask) {
+  const auto sign_bit = _mm_set1_epi64x(ToSigned(0));
+  const auto vstart = _mm_set1_epi64x(ToSigned(start));
+  const auto vend = _mm_set1_epi64x(ToSigned(end));
+  std::size_t i = 0;
+  for (; i + 2 <= count; i += 2) {
+    const auto v = _mm_xor_si128(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(timestamps + i)),
+        sign_bit);
+    const auto is_before = _mm_cmpgt_epi64(vstart, v);
+    StoreBits(
+        MoveMask64(_mm_andnot_si128(is_before, _mm_cmpgt_epi64(vend, v))), 2,
+        mask + i);
+  }
+  scalar::TimeRangeMask(timestamps + i, count - i, start, end, mask + i);
+}
+
+DATABENTO_TARGET_SSE42 void InstrumentIdMask(const std::uint32_t* values,
+                                             std::size_t count,
+                                             const std::uint32_t* ids,
+                                             std::size_t id_count,
+                                             std::uint8_t* mask) {
+  __m128i vids[kMaxComparedIds];
+  for (std::size_t j = 0; j < id_count; ++j) {
+    vids[j] = _mm_set1_epi32(static_cast<int>(ids[j]));
+  }
+  std::size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    const auto v =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i));
+    auto is_match = _mm_setzero_si128();
+    for (std::size_t j = 0; j < id_count; ++j) {
+      is_match = _mm_or_si128(is_match, _mm_cmpeq_epi32(v, vids[j]));
+    }
+    StoreBits(static_cast<unsigned>(
+                  _mm_movemask_ps(_mm_castsi128_ps(is_match))),
+              4, mask + i);
+  }
+  scalar::InstrumentIdMask(values + i, count - i, ids, id_count, mask + i);
+}
+
+DATABENTO_TARGET_SSE42 void FlagMask(const std::uint8_t* values,
+                                     std::size_t count, std::uint8_t flags,
+                                     std::uint8_t* mask) {
+  const auto vflags = _mm_set1_epi8(static_cast<char>(flags));
+  const auto ones = _mm_set1_epi8(1);
+  const auto zero = _mm_setzero_si128();
+  std::size_t i = 0;
+  for (; i + 16 <= count; i += 16) {
+    const auto v =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i));
+    const auto is_unset = _mm_cmpeq_epi8(_mm_and_si128(v, vflags), zero);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(mask + i),
+                     _mm_andnot_si128(is_unset, ones));
+  }
+  scalar::FlagMask(values + i, count - i, flags, mask + i);
+}
+
+DATABENTO_TARGET_SSE42 void AndMask(const std::uint8_t* other,
+                                    std::size_t count, std::uint8_t* mask) {
+  const auto ones = _mm_set1_epi8(1);
+  const auto zero = _mm_setzero_si128();
+  std::size_t i = 0;
+  for (; i + 16 <= count; i += 16) {
+    const auto a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(other + i));
+    const auto m = _mm_loadu_si128(reinterpret_cast<const __m128i*>(mask + i));
+    const auto is_unset =
+        _mm_or_si128(_mm_cmpeq_epi8(a, zero), _mm_cmpeq_epi8(m, zero));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(mask + i),
+                     _mm_andnot_si128(is_unset, ones));
+  }
+  scalar::AndMask(other + i, count - i, mask + i);
+}
+
+DATABENTO_TARGET_SSE42 std::size_t CountMask(const std::uint8_t* mask,
+                                             std::size_t count) {
+  const auto ones = _mm_set1_epi8(1);
+  const auto zero = _mm_setzero_si128();
+  auto acc = _mm_setzero_si128();
+  std::size_t i = 0;
+  for (; i + 16 <= count; i += 16) {
+    const auto m = _mm_min_epu8(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(mask + i)), ones);
+    acc = _mm_add_epi64(acc, _mm_sad_epu8(m, zero));
+  }
+  return HorizontalSum(acc) + scalar::CountMask(mask + i, count - i);
+}
+
+DATABENTO_TARGET_SSE42 std::int64_t SumI64(const std::int64_t* values,
+                                           const std::uint8_t* mask,
+                                           std::size_t count) {
+  auto acc = _mm_setzero_si128();
+  std::size_t i = 0;
+  for (; i + 2 <= count; i += 2) {
+    const auto v =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i));
+    acc = _mm_add_epi64(acc, _mm_andnot_si128(LoadUnselected2(mask + i), v));
+  }
+  return static_cast<std::int64_t>(
+      HorizontalSum(acc) +
+      static_cast<std::uint64_t>(scalar::SumI64(values + i, mask + i,
+                                                count - i)));
+}
+
+DATABENTO_TARGET_SSE42 std::uint64_t SumU32(const std::uint32_t* values,
+                                            const std::uint8_t* mask,
+                                            std::size_t count) {
+  auto acc = _mm_setzero_si128();
+  std::size_t i = 0;
+  for (; i + 2 <= count; i += 2) {
+    const auto v = _mm_cvtepu32_epi64(
+        _mm_loadl_epi64(reinterpret_cast<const __m128i*>(values + i)));
+    acc = _mm_add_epi64(acc, _mm_andnot_si128(LoadUnselected2(mask + i), v));
+  }
+  return HorizontalSum(acc) + scalar::SumU32(values + i, mask + i, count - i);
+}
+
+DATABENTO_TARGET_SSE42 std::int64_t Min(const std::int64_t* values,
+                                        const std::uint8_t* mask,
+                                        std::size_t count) {
+  const auto identity =
+      _mm_set1_epi64x(std::numeric_limits<std::int64_t>::max());
+  auto acc = identity;
+  std::size_t i = 0;
+  for (; i + 2 <= count; i += 2) {
+    const auto v = _mm_blendv_epi8(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i)),
+        identity, LoadUnselected2(mask + i));
+    acc = _mm_blendv_epi8(acc, v, _mm_cmpgt_epi64(acc, v));
+  }
+  std::int64_t lanes[2];
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), acc);
+  return std::min({lanes[0], lanes[1],
+                   scalar::Min(values + i, mask + i, count - i)});
+}
+
+DATABENTO_TARGET_SSE42 std::int64_t Max(const std::int64_t* values,
+                                        const std::uint8_t* mask,
+                                        std::size_t count) {
+  const auto identity =
+      _mm_set1_epi64x(std::numeric_limits<std::int64_t>::min());
+  auto acc = identity;
+  std::size_t i = 0;
+  for (; i + 2 <= count; i += 2) {
+    const auto v = _mm_blendv_epi8(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i)),
+        identity, LoadUnselected2(mask + i));
+    acc = _mm_blendv_epi8(acc, v, _mm_cmpgt_epi64(v, acc));
+  }
+  std::int64_t lanes[2];
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), acc);
+  return std::max({lanes[0], lanes[1],
+                   scalar::Max(values + i, mask + i, count - i)});
+}
+
+constexpr ColumnKernelTable kTable{
+    RangeMask, TimeRangeMask, InstrumentIdMask, FlagMask, AndMask,
+    CountMask, SumI64,        SumU32,           Min,      Max};
+}  // namespace sse42
+
+namespace avx2 {
+// Loads 4 mask bytes as 64-bit lanes that are all ones for unselected rows.
+DATABENTO_TARGET_AVX2 __m256i LoadUnselected4(const std::uint8_t* mask) {
+  std::int32_t bytes;
+  std::memcpy(&bytes, mask, sizeof(bytes));
+  return _mm256_cmpeq_epi64(_mm256_cvtepu8_epi64(_mm_cvtsi32_si128(bytes)),
+                            _mm256_setzero_si256());
+}
+
+DATABENTO_TARGET_AVX2 std::uint64_t HorizontalSum(__m256i acc) {
+  std::uint64_t lanes[4];
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), acc);
+  return lanes[0] + lanes[1] + lanes[2] + lanes[3];
+}
+
+DATABENTO_TARGET_AVX2 unsigned MoveMask64(__m256i v) {
+  return static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(v)));
+}
+
+DATABENTO_TARGET_AVX2 void RangeMask(const std::int64_t* values,
+                                     std::size_t count, std::int64_t min,
+                                     std::int64_t max, std::uint8_t* mask) {
+  const auto vmin = _mm256_set1_epi64x(min);
+  const auto vmax = _mm256_set1_epi64x(max);
+  std::size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    const auto v =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i));
+    const auto outside = _mm256_or_si256(_mm256_cmpgt_epi64(vmin, v),
+                                         _mm256_cmpgt_epi64(v, vmax));
+    StoreBits(~MoveMask64(outside), 4, mask + i);
+  }
+  scalar::RangeMask(values + i, count - i, min, max, mask + i);
+}
+
+DATABENTO_TARGET_AVX2 void TimeRangeMask(const std::uint64_t* timestamps,
+                                         std::size_t count,
+                                         std::uint64_t start,
+                                         std::uint64_t end,
+                                         std::uint8_t* mask) {
+  const auto sign_bit = _mm256_set1_epi64x(ToSigned(0));
+  const auto vstart = _mm256_set1_epi64x(ToSigned(start));
+  const auto vend = _mm256_set1_epi64x(ToSigned(end));
+  std::size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    const auto v = _mm256_xor_si256(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(timestamps + i)),
+        sign_bit);
+    const auto is_before = _mm256_cmpgt_epi64(vstart, v);
+    StoreBits(MoveMask64(_mm256_andnot_si256(is_before,
+                                             _mm256_cmpgt_epi64(vend, v))),
+              4, mask + i);
+  }
+  scalar::TimeRangeMask(timestamps + i, count - i, start, end, mask + i);
+}
+
+DATABENTO_TARGET_AVX2 void InstrumentIdMask(const std::uint32_t* values,
+                                            std::size_t count,
+                                            const std::uint32_t* ids,
+                                            std::size_t id_count,
+                                            std::uint8_t* mask) {
+  __m256i vids[kMaxComparedIds];
+  for (std::size_t j = 0; j < id_count; ++j) {
+    vids[j] = _mm256_set1_epi32(static_cast<int>(ids[j]));
+  }
+  std::size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    const auto v =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i));
+    auto is_match = _mm256_setzero_si256();
+    for (std::size_t j = 0; j < id_count; ++j) {
+      is_match = _mm256_or_si256(is_match, _mm256_cmpeq_epi32(v, vids[j]));
+    }
+    StoreBits(static_cast<unsigned>(
+                  _mm256_movemask_ps(_mm256_castsi256_ps(is_match))),
+              8, mask + i);
+  }
+  scalar::InstrumentIdMask(values + i, count - i, ids, id_count, mask + i);
+}
+
+DATABENTO_TARGET_AVX2 void FlagMask(const std::uint8_t* values,
+                                    std::size_t count, std::uint8_t flags,
+                                    std::uint8_t* mask) {
+  const auto vflags = _mm256_set1_epi8(static_cast<char>(flags));
+  const auto ones = _mm256_set1_epi8(1);
+  const auto zero = _mm256_setzero_si256();
+  std::size_t i = 0;
+  for (; i + 32 <= count; i += 32) {
+    const auto v =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i));
+    const auto is_unset =
+        _mm256_cmpeq_epi8(_mm256_and_si256(v, vflags), zero);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(mask + i),
+                        _mm256_andnot_si256(is_unset, ones));
+  }
+  scalar::FlagMask(values + i, count - i, flags, mask + i);
+}
+
+DATABENTO_TARGET_AVX2 void AndMask(const std::uint8_t* other,
+                                   std::size_t count, std::uint8_t* mask) {
+  const auto ones = _mm256_set1_epi8(1);
+  const auto zero = _mm256_setzero_si256();
+  std::size_t i = 0;
+  for (; i + 32 <= count; i += 32) {
+    const auto a =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(other + i));
+    const auto m =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(mask + i));
+    const auto is_unset =
+        _mm256_or_si256(_mm256_cmpeq_epi8(a, zero), _mm256_cmpeq_epi8(m, zero));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(mask + i),
+                        _mm256_andnot_si256(is_unset, ones));
+  }
+  scalar::AndMask(other + i, count - i, mask + i);
+}
+
+DATABENTO_TARGET_AVX2 std::size_t CountMask(const std::uint8_t* mask,
+                                            std::size_t count) {
+  const auto ones = _mm256_set1_epi8(1);
+  const auto zero = _mm256_setzero_si256();
+  auto acc = _mm256_setzero_si256();
+  std::size_t i = 0;
+  for (; i + 32 <= count; i += 32) {
+    const auto m = _mm256_min_epu8(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(mask + i)), ones);
+    acc = _mm256_add_epi64(acc, _mm256_sad_epu8(m, zero));
+  }
+  return HorizontalSum(acc) + scalar::CountMask(mask + i, count - i);
+}
+
+DATABENTO_TARGET_AVX2 std::int64_t SumI64(const std::int64_t* values,
+                                          const std::uint8_t* mask,
+                                          std::size_t count) {
+  auto acc = _mm256_setzero_si256();
+  std::size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    const auto v =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i));
+    acc = _mm256_add_epi64(acc,
+                           _mm256_andnot_si256(LoadUnselected4(mask + i), v));
+  }
+  return static_cast<std::int64_t>(
+      HorizontalSum(acc) +
+      static_cast<std::uint64_t>(scalar::SumI64(values + i, mask + i,
+                                                count - i)));
+}
+
+DATABENTO_TARGET_AVX2 std::uint64_t SumU32(const std::uint32_t* values,
+                                           const std::uint8_t* mask,
+                                           std::size_t count) {
+  auto acc = _mm256_setzero_si256();
+  std::size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    const auto v = _mm256_cvtepu32_epi64(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i)));
+    acc = _mm256_add_epi64(acc,
+                           _mm256_andnot_si256(LoadUnselected4(mask + i), v));
+  }
+  return HorizontalSum(acc) + scalar::SumU32(values + i, mask + i, count - i);
+}
+
+DATABENTO_TARGET_AVX2 std::int64_t Min(const std::int64_t* values,
+                                       const std::uint8_t* mask,
+                                       std::size_t count) {
+  const auto identity =
+      _mm256_set1_epi64x(std::numeric_limits<std::int64_t>::max());
+  auto acc = identity;
+  std::size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    const auto v = _mm256_blendv_epi8(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i)),
+        identity, LoadUnselected4(mask + i));
+    acc = _mm256_blendv_epi8(acc, v, _mm256_cmpgt_epi64(acc, v));
+  }
+  std::int64_t lanes[4];
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), acc);
+  return std::min({lanes[0], lanes[1], lanes[2], lanes[3],
+                   scalar::Min(values + i, mask + i, count - i)});
+}
+
+DATABENTO_TARGET_AVX2 std::int64_t Max(const std::int64_t* values,
+                                       const std::uint8_t* mask,
+                                       std::size_t count) {
+  const auto identity =
+      _mm256_set1_epi64x(std::numeric_limits<std::int64_t>::min());
+  auto acc = identity;
+  std::size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    const auto v = _mm256_blendv_epi8(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i)),
+        identity, LoadUnselected4(mask + i));
+    acc = _mm256_blendv_epi8(acc, v, _mm256_cmpgt_epi64(v, acc));
+  }
+  std::int64_t lanes[4];
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), acc);
+  return std::max({lanes[0], lanes[1], lanes[2], lanes[3],
+                   scalar::Max(values + i, mask + i, count - i)});
+}
+
+constexpr ColumnKernelTable kTable{
+    RangeMask, TimeRangeMask, InstrumentIdMask, FlagMask, AndMask,
+    CountMask, SumI64,        SumU32,           Min,      Max};
+}  // namespace avx2
+#endif  // DATABENTO_X86_KERNELS
+
+const ColumnKernelTable& TableFor(KernelIsa isa) {
+  switch (isa) {
+#ifdef DATABENTO_X86_KERNELS
+    case KernelIsa::Sse42: {
+      return sse42::kTable;
+    }
+    case KernelIsa::Avx2: {
+      return avx2::kTable;
+    }
+#endif
+    default: {
+      return scalar::kTable;
+    }
+  }
+}
+}  // namespace
+
+namespace databento {
+const char* ToString(KernelIsa isa) {
+  switch (isa) {
+    case KernelIsa::Scalar: {
+      return "scalar";
+    }
+    case KernelIsa::Sse42: {
+      return "sse4.2";
+    }
+    case KernelIsa::Avx2: {
+      return "avx2";
+    }
+    default: {
+      return "unknown";
+    }
+  }
+}
+}  // namespace databento
+
+ColumnKernels::ColumnKernels() : ColumnKernels{BestIsa()} {}
+
+ColumnKernels::ColumnKernels(KernelIsa isa)
+    : isa_{isa}, table_{&TableFor(isa)} {
+  if (!IsSupported(isa)) {
+    throw InvalidArgumentError{
+        "ColumnKernels::ColumnKernels", "isa",
+        std::string{"Not supported by this CPU: "} + ToString(isa)};
+  }
+}
+
+bool ColumnKernels::IsSupported(KernelIsa isa) {
+  switch (isa) {
+    case KernelIsa::Scalar: {
+      return true;
+    }
+#ifdef DATABENTO_X86_KERNELS
+    case KernelIsa::Sse42: {
+      __builtin_cpu_init();
+      return __builtin_cpu_supports("sse4.2");
+    }
+    case KernelIsa::Avx2: {
+      __builtin_cpu_init();
+      return __builtin_cpu_supports("avx2");
+    }
+#endif
+    default: {
+      return false;
+    }
+  }
+}
+
+KernelIsa ColumnKernels::BestIsa() {
+  static const KernelIsa kBestIsa = IsSupported(KernelIsa::Avx2)
+                                        ? KernelIsa::Avx2
+                                        : IsSupported(KernelIsa::Sse42)
+                                              ? KernelIsa::Sse42
+                                              : KernelIsa::Scalar;
+  return kBestIsa;
+}
+
+void ColumnKernels::RangeMask(const std::int64_t* values, std::size_t count,
+                              std::int64_t min, std::int64_t max,
+                              std::uint8_t* mask) const {
+  table_->range_mask(values, count, min, max, mask);
+}
+
+void ColumnKernels::TimeRangeMask(const std::uint64_t* timestamps,
+                                  std::size_t count, UnixNanos start,
+                                  UnixNanos end, std::uint8_t* mask) const {
+  table_->time_range_mask(timestamps, count, start.time_since_epoch().count(),
+                          end.time_since_epoch().count(), mask);
+}
+
+void ColumnKernels::InstrumentIdMask(
+    const std::uint32_t* values, std::size_t count,
+    const std::vector<std::uint32_t>& instrument_ids,
+    std::uint8_t* mask) const {
+  if (instrument_ids.size() <= kMaxComparedIds) {
+    table_->instrument_id_mask(values, count, instrument_ids.data(),
+                               instrument_ids.size(), mask);
+    return;
+  }
+  auto sorted_ids = instrument_ids;
+  std::sort(sorted_ids.begin(), sorted_ids.end());
+  for (std::size_t i = 0; i < count; ++i) {
+    mask[i] =
+        std::binary_search(sorted_ids.begin(), sorted_ids.end(), values[i]);
+  }
+}
+
+void ColumnKernels::FlagMask(const std::uint8_t* values, std::size_t count,
+                             FlagSet flags, std::uint8_t* mask) const {
+  table_->flag_mask(values, count, static_cast<std::uint8_t>(flags), mask);
+}
+
+void ColumnKernels::AndMask(const std::uint8_t* other, std::size_t count,
+                            std::uint8_t* mask) const {
+  table_->and_mask(other, count, mask);
+}
+
+std::size_t ColumnKernels::CountMask(const std::uint8_t* mask,
+                                     std::size_t count) const {
+  return table_->count_mask(mask, count);
+}
+
+std::int64_t ColumnKernels::Sum(const std::int64_t* values,
+                                const std::uint8_t* mask,
+                                std::size_t count) const {
+  return table_->sum_i64(values, mask, count);
+}
+
+std::uint64_t ColumnKernels::Sum(const std::uint32_t* values,
+                                 const std::uint8_t* mask,
+                                 std::size_t count) const {
+  return table_->sum_u32(values, mask, count);
+}
+
+std::int64_t ColumnKernels::Min(const std::int64_t* values,
+                                const std::uint8_t* mask,
+                                std::size_t count) const {
+  return table_->min(values, mask, count);
+}
+
+std::int64_t ColumnKernels::Max(const std::int64_t* values,
+                                const std::uint8_t* mask,
+                                std::size_t count) const {
+  return table_->max(values, mask, count);
+}
+
+double ColumnKernels::Vwap(const std::int64_t* prices,
+                           const std::uint32_t* sizes,
+                           const std::uint8_t* mask, std::size_t count) const {
+  // The products would overflow 64-bit integers, so they're accumulated as
+  // floating point
+  double notional{};
+  for (std::size_t i = 0; i < count; ++i) {
+    if (mask[i] != 0) {
+      notional += static_cast<double>(prices[i]) * sizes[i];
+    }
+  }
+  const auto total_size = Sum(sizes, mask, count);
+  if (total_size == 0) {
+    return std::numeric_limits<double>::quiet_NaN();
+  }
+  return notional / static_cast<double>(total_size);
+}
@@ -0,0 +1,310 @@
+#include "databento/columnar_builder.hpp"
+
+#include <cstddef>  // offsetof
+#include <string>
+
+#include "databento/dbn_decoder.hpp"
+#include "databento/exceptions.hpp"  // InvalidArgumentError
+
+using databento::ColumnarBuilder;
+
+namespace {
+// Converts field values to the integer type stored in their column.
+template <typename T>
+T ColumnValue(T value) {
+  return value;
+}
+std::uint64_t ColumnValue(databento::UnixNanos value) {
+  return value.time_since_epoch().count();
+}
+std::int32_t ColumnValue(databento::TimeDeltaNanos value) {
+  return value.count();
+}
+std::uint8_t ColumnValue(databento::FlagSet value) {
+  return static_cast<std::uint8_t>(value);
+}
+char ColumnValue(databento::Action value) { return static_cast<char>(value); }
+char ColumnValue(databento::Side value) { return static_cast<char>(value); }
+
+// Copies `member` of `count` structs `stride` bytes apart to `out`. Kept to a
+// single tight loop per field so it can be unrolled and vectorized.
+template <typename T, typename R, typename M>
+void Gather(T* out, M R::*member, const std::uint8_t* data, std::size_t stride,
+            std::size_t count) {
+  for (std::size_t i = 0; i < count; ++i) {
+    const auto& record = *reinterpret_cast<const R*>(data + i * stride);
+    out[i] = ColumnValue(record.*member);
+  }
+}
+}  // namespace
+
+constexpr std::size_t ColumnarBuilder::kDefaultChunkSize;
+
+ColumnarBuilder::ColumnarBuilder(Schema schema)
+    : ColumnarBuilder{schema, kDefaultChunkSize} {}
+
+ColumnarBuilder::ColumnarBuilder(Schema schema, std::size_t chunk_size)
+    : schema_{schema}, chunk_size_{chunk_size} {
+  if (chunk_size_ == 0) {
+    throw InvalidArgumentError{"ColumnarBuilder::ColumnarBuilder",
+                               "chunk_size", "Must be greater than 0"};
+  }
+  switch (schema_) {
+    case Schema::Mbo:
+    case Schema::Trades:
+    case Schema::Ohlcv1S:
+    case Schema::Ohlcv1M:
+    case Schema::Ohlcv1H:
+    case Schema::Ohlcv1D: {
+      break;
+    }
+    case Schema::Mbp1:
+    case Schema::Tbbo: {
+      level_count_ = 1;
+      break;
+    }
+    case Schema::Mbp10: {
+      level_count_ = 10;
+      break;
+    }
+    default: {
+      throw InvalidArgumentError{
+          "ColumnarBuilder::ColumnarBuilder", "schema",
+          std::string{"Unsupported schema "} + ToString(schema_)};
+    }
+  }
+  levels_.resize(level_count_);
+}
+
+void ColumnarBuilder::AppendHeaders(const std::uint8_t* data,
+                                    std::size_t stride, std::size_t count) {
+  Gather(publisher_id_.Extend(count, chunk_size_), &RecordHeader::publisher_id,
+         data, stride, count);
+  Gather(instrument_id_.Extend(count, chunk_size_),
+         &RecordHeader::instrument_id, data, stride, count);
+  Gather(ts_event_.Extend(count, chunk_size_), &RecordHeader::ts_event, data,
+         stride, count);
+}
+
+template <typename R>
+void ColumnarBuilder::AppendTradeFields(const std::uint8_t* data,
+                                        std::size_t stride, std::size_t count) {
+  Gather(price_.Extend(count, chunk_size_), &R::price, data, stride, count);
+  Gather(size_column_.Extend(count, chunk_size_), &R::size, data, stride,
+         count);
+  Gather(action_.Extend(count, chunk_size_), &R::action, data, stride, count);
+  Gather(side_.Extend(count, chunk_size_), &R::side, data, stride, count);
+  Gather(flags_.Extend(count, chunk_size_), &R::flags, data, stride, count);
+  Gather(depth_.Extend(count, chunk_size_), &R::depth, data, stride, count);
+  Gather(ts_recv_.Extend(count, chunk_size_), &R::ts_recv, data, stride,
+         count);
+  Gather(ts_in_delta_.Extend(count, chunk_size_), &R::ts_in_delta, data,
+         stride, count);
+  Gather(sequence_.Extend(count, chunk_size_), &R::sequence, data, stride,
+         count);
+}
+
+template <typename R>
+void ColumnarBuilder::AppendLevels(const std::uint8_t* data,
+                                   std::size_t stride, std::size_t count) {
+  for (std::size_t i = 0; i < level_count_; ++i) {
+    // Each level is gathered as if it were the start of the record
+    const auto* level_data =
+        data + offsetof(R, levels) + i * sizeof(BidAskPair);
+    auto& level = levels_[i];
+    Gather(level.bid_px.Extend(count, chunk_size_), &BidAskPair::bid_px,
+           level_data, stride, count);
+    Gather(level.ask_px.Extend(count, chunk_size_), &BidAskPair::ask_px,
+           level_data, stride, count);
+    Gather(level.bid_sz.Extend(count, chunk_size_), &BidAskPair::bid_sz,
+           level_data, stride, count);
+    Gather(level.ask_sz.Extend(count, chunk_size_), &BidAskPair::ask_sz,
+           level_data, stride, count);
+    Gather(level.bid_ct.Extend(count, chunk_size_), &BidAskPair::bid_ct,
+           level_data, stride, count);
+    Gather(level.ask_ct.Extend(count, chunk_size_), &BidAskPair::ask_ct,
+           level_data, stride, count);
+  }
+}
+
+namespace databento {
+template <>
+void ColumnarBuilder::AppendRun<MboMsg>(const std::uint8_t* data,
+                                        std::size_t stride,
+                                        std::size_t count) {
+  AppendHeaders(data, stride, count);
+  Gather(order_id_.Extend(count, chunk_size_), &MboMsg::order_id, data, stride,
+         count);
+  Gather(price_.Extend(count, chunk_size_), &MboMsg::price, data, stride,
+         count);
+  Gather(size_column_.Extend(count, chunk_size_), &MboMsg::size, data, stride,
+         count);
+  Gather(flags_.Extend(count, chunk_size_), &MboMsg::flags, data, stride,
+         count);
+  Gather(channel_id_.Extend(count, chunk_size_), &MboMsg::channel_id, data,
+         stride, count);
+  Gather(action_.Extend(count, chunk_size_), &MboMsg::action, data, stride,
+         count);
+  Gather(side_.Extend(count, chunk_size_), &MboMsg::side, data, stride, count);
+  Gather(ts_recv_.Extend(count, chunk_size_), &MboMsg::ts_recv, data, stride,
+         count);
+  Gather(ts_in_delta_.Extend(count, chunk_size_), &MboMsg::ts_in_delta, data,
+         stride, count);
+  Gather(sequence_.Extend(count, chunk_size_), &MboMsg::sequence, data, stride,
+         count);
+}
+
+template <>
+void ColumnarBuilder::AppendRun<TradeMsg>(const std::uint8_t* data,
+                                          std::size_t stride,
+                                          std::size_t count) {
+  AppendHeaders(data, stride, count);
+  AppendTradeFields<TradeMsg>(data, stride, count);
+}
+
+template <>
+void ColumnarBuilder::AppendRun<Mbp1Msg>(const std::uint8_t* data,
+                                         std::size_t stride,
+                                         std::size_t count) {
+  AppendHeaders(data, stride, count);
+  AppendTradeFields<Mbp1Msg>(data, stride, count);
+  AppendLevels<Mbp1Msg>(data, stride, count);
+}
+
+template <>
+void ColumnarBuilder::AppendRun<Mbp10Msg>(const std::uint8_t* data,
+                                          std::size_t stride,
+                                          std::size_t count) {
+  AppendHeaders(data, stride, count);
+  AppendTradeFields<Mbp10Msg>(data, stride, count);
+  AppendLevels<Mbp10Msg>(data, stride, count);
+}
+
+template <>
+void ColumnarBuilder::AppendRun<OhlcvMsg>(const std::uint8_t* data,
+                                          std::size_t stride,
+                                          std::size_t count) {
+  AppendHeaders(data, stride, count);
+  Gather(open_.Extend(count, chunk_size_), &OhlcvMsg::open, data, stride,
+         count);
+  Gather(high_.Extend(count, chunk_size_), &OhlcvMsg::high, data, stride,
+         count);
+  Gather(low_.Extend(count, chunk_size_), &OhlcvMsg::low, data, stride, count);
+  Gather(close_.Extend(count, chunk_size_), &OhlcvMsg::close, data, stride,
+         count);
+  Gather(volume_.Extend(count, chunk_size_), &OhlcvMsg::volume, data, stride,
+         count);
+}
+}  // namespace databento
+
+template <typename R>
+std::size_t ColumnarBuilder::AppendRecords(const std::uint8_t* data,
+                                           std::size_t size) {
+  std::size_t appended{};
+  std::size_t pos{};
+  while (pos < size) {
+    const auto& header = *reinterpret_cast<const RecordHeader*>(data + pos);
+    const auto stride = header.Size();
+    // Records with `ts_out` are longer than `R`
+    if (!R::HasRType(header.rtype) || stride < sizeof(R)) {
+      pos += stride;
+      continue;
+    }
+    // Find the run of records with the same rtype and length
+    const auto run_start = pos;
+    std::size_t count{};
+    while (pos < size) {
+      const auto& next = *reinterpret_cast<const RecordHeader*>(data + pos);
+      if (next.length != header.length || next.rtype != header.rtype) {
+        break;
+      }
+      pos += stride;
+      ++count;
+    }
+    AppendRun<R>(data + run_start, stride, count);
+    appended += count;
+  }
+  return appended;
+}
+
+std::size_t ColumnarBuilder::AppendBytes(const std::uint8_t* data,
+                                         std::size_t size) {
+  std::size_t appended{};
+  switch (schema_) {
+    case Schema::Mbo: {
+      appended = AppendRecords<MboMsg>(data, size);
+      break;
+    }
+    case Schema::Trades: {
+      appended = AppendRecords<TradeMsg>(data, size);
+      break;
+    }
+    case Schema::Mbp1:
+    case Schema::Tbbo: {
+      appended = AppendRecords<Mbp1Msg>(data, size);
+      break;
+    }
+    case Schema::Mbp10: {
+      appended = AppendRecords<Mbp10Msg>(data, size);
+      break;
+    }
+    default: {
+      // The constructor only accepts OHLCV schemas otherwise
+      appended = AppendRecords<OhlcvMsg>(data, size);
+      break;
+    }
+  }
+  row_count_ += appended;
+  return appended;
+}
+
+std::size_t ColumnarBuilder::Append(DbnDecoder* decoder) {
+  std::size_t appended{};
+  while (true) {
+    const auto batch = decoder->DecodeRecords();
+    if (batch.IsEmpty()) {
+      return appended;
+    }
+    appended += Append(batch);
+  }
+}
+
+std::size_t ColumnarBuilder::Append(const RecordBatch& batch) {
+  return AppendBytes(batch.Data(), batch.Size());
+}
+
+bool ColumnarBuilder::Append(const Record& record) {
+  return AppendBytes(reinterpret_cast<const std::uint8_t*>(&record.Header()),
+                     record.Size()) > 0;
+}
+
+void ColumnarBuilder::Clear() {
+  row_count_ = 0;
+  publisher_id_.Clear();
+  instrument_id_.Clear();
+  ts_event_.Clear();
+  order_id_.Clear();
+  price_.Clear();
+  size_column_.Clear();
+  flags_.Clear();
+  channel_id_.Clear();
+  action_.Clear();
+  side_.Clear();
+  depth_.Clear();
+  ts_recv_.Clear();
+  ts_in_delta_.Clear();
+  sequence_.Clear();
+  for (auto& level : levels_) {
+    level.bid_px.Clear();
+    level.ask_px.Clear();
+    level.bid_sz.Clear();
+    level.ask_sz.Clear();
+    level.bid_ct.Clear();
+    level.ask_ct.Clear();
+  }
+  open_.Clear();
+  high_.Clear();
+  low_.Clear();
+  close_.Clear();
+  volume_.Clear();
+}
@@ -2,7 +2,10 @@
 
 #include <algorithm>  // copy
 #include <cstdint>
-#include <limits>  // numeric_limits
+#include <cstring>  // memcpy
+#include <limits>   // numeric_limits
+#include <new>      // placement new
+#include <utility>  // declval
 
 #include "databento/fixed_price.hpp"  // FixedPx
 #include "stream_op_helper.hpp"       // MakeString, StreamOpBuilder
@@ -11,7 +14,8 @@ namespace databento {
 InstrumentDefMsgV2 InstrumentDefMsgV1::ToV2() const {
   InstrumentDefMsgV2 ret{
       RecordHeader{sizeof(InstrumentDefMsgV2) / RecordHeader::kLengthMultiplier,
-                   RType::InstrumentDef, hd.publisher_id, hd.instrument_id},
+                   RType::InstrumentDef, hd.publisher_id, hd.instrument_id,
+                   hd.ts_event},
       ts_recv,
       min_price_increment,
       display_factor,
@@ -95,7 +99,8 @@ InstrumentDefMsgV2 InstrumentDefMsgV1::ToV2() const {
 ErrorMsgV2 ErrorMsgV1::ToV2() const {
   ErrorMsgV2 ret{
       RecordHeader{sizeof(ErrorMsgV2) / RecordHeader::kLengthMultiplier,
-                   RType::Error, hd.publisher_id, hd.instrument_id},
+                   RType::Error, hd.publisher_id, hd.instrument_id,
+                   hd.ts_event},
       {},
       std::numeric_limits<std::uint8_t>::max(),
       std::numeric_limits<std::uint8_t>::max()};
@@ -106,7 +111,8 @@ ErrorMsgV2 ErrorMsgV1::ToV2() const {
 SymbolMappingMsgV2 SymbolMappingMsgV1::ToV2() const {
   SymbolMappingMsgV2 ret{
       RecordHeader{sizeof(SymbolMappingMsgV2) / RecordHeader::kLengthMultiplier,
-                   RType::SymbolMapping, hd.publisher_id, hd.instrument_id},
+                   RType::SymbolMapping, hd.publisher_id, hd.instrument_id,
+                   hd.ts_event},
       // invalid
       static_cast<SType>(std::numeric_limits<std::uint8_t>::max()),
       {},
@@ -125,13 +131,69 @@ SymbolMappingMsgV2 SymbolMappingMsgV1::ToV2() const {
 SystemMsgV2 SystemMsgV1::ToV2() const {
   SystemMsgV2 ret{
       RecordHeader{sizeof(SystemMsgV2) / RecordHeader::kLengthMultiplier,
-                   RType::System, hd.publisher_id, hd.instrument_id},
+                   RType::System, hd.publisher_id, hd.instrument_id,
+                   hd.ts_event},
       {},
       std::numeric_limits<std::uint8_t>::max()};
   std::copy(msg.begin(), msg.end(), ret.msg.begin());
   return ret;
 }
 
+namespace {
+// Upgrades the record at `v1_data` directly into `v2_data`.
+template <typename V1>
+void UpgradeRecord(const std::uint8_t* v1_data, std::uint8_t* v2_data) {
+  using V2 = decltype(std::declval<V1>().ToV2());
+  new (v2_data) V2{reinterpret_cast<const V1*>(v1_data)->ToV2()};
+}
+}  // namespace
+
+void UpgradeRecordsV1ToV2(const std::uint8_t* data, std::size_t size,
+                          std::vector<std::uint8_t>* output) {
+  // Size the output once up front so records are written directly to their
+  // final position
+  std::size_t output_size{};
+  for (std::size_t pos = 0; pos < size;) {
+    const auto& header = *reinterpret_cast<const RecordHeader*>(data + pos);
+    switch (header.rtype) {
+      case RType::InstrumentDef: {
+        output_size += sizeof(InstrumentDefMsgV2);
+        break;
+      }
+      case RType::SymbolMapping: {
+        output_size += sizeof(SymbolMappingMsgV2);
+        break;
+      }
+      default: {
+        output_size += header.Size();
+      }
+    }
+    pos += header.Size();
+  }
+  output->resize(output_size);
+  auto* out = output->data();
+  for (std::size_t pos = 0; pos < size;) {
+    const auto& header = *reinterpret_cast<const RecordHeader*>(data + pos);
+    switch (header.rtype) {
+      case RType::InstrumentDef: {
+        UpgradeRecord<InstrumentDefMsgV1>(data + pos, out);
+        out += sizeof(InstrumentDefMsgV2);
+        break;
+      }
+      case RType::SymbolMapping: {
+        UpgradeRecord<SymbolMappingMsgV1>(data + pos, out);
+        out += sizeof(SymbolMappingMsgV2);
+        break;
+      }
+      default: {
+        std::memcpy(out, data + pos, header.Size());
+        out += header.Size();
+      }
+    }
+    pos += header.Size();
+  }
+}
+
 bool operator==(const InstrumentDefMsgV1& lhs, const InstrumentDefMsgV1& rhs) {
   return lhs.hd == rhs.hd && lhs.ts_recv == rhs.ts_recv &&
          lhs.min_price_increment == rhs.min_price_increment &&
@@ -1,17 +1,21 @@
 #include "databento/dbn_decoder.hpp"
 
-#include <algorithm>  // copy
+#include <algorithm>  // copy, min
 #include <cstddef>
+#include <cstdint>  // uintptr_t
 #include <cstring>  // strncmp
-#include <limits>
+#include <sstream>  // ostringstream
+#include <utility>  // move
 #include <vector>
 
 #include "databento/compat.hpp"
 #include "databento/constants.hpp"
 #include "databento/datetime.hpp"
+#include "databento/detail/parallel_zstd_stream.hpp"
 #include "databento/detail/zstd_stream.hpp"
 #include "databento/enums.hpp"
 #include "databento/exceptions.hpp"
+#include "databento/metadata_view.hpp"
 #include "databento/record.hpp"
 
 using databento::DbnDecoder;
@@ -21,10 +25,8 @@ constexpr std::size_t kMagicSize = 4;
 constexpr std::uint32_t kZstdMagicNumber = 0xFD2FB528;
 constexpr auto kDbnPrefix = "DBN";
 constexpr std::size_t kFixedMetadataLen = 100;
-constexpr std::size_t kDatasetCstrLen = 16;
-constexpr std::size_t kReservedLen = 53;
-constexpr std::size_t kReservedLenV1 = 47;
-constexpr std::size_t kBufferCapacity = 8UL * 1024;
+// Maximum size of an in-memory batch
+constexpr std::size_t kMaxBatchSize = 8UL * 1024;
 
 template <typename T>
 T Consume(std::vector<std::uint8_t>::const_iterator& byte_it) {
@@ -33,21 +35,46 @@ T Consume(std::vector<std::uint8_t>::const_iterator& byte_it) {
   return res;
 }
 
-template <>
-std::uint8_t Consume(std::vector<std::uint8_t>::const_iterator& byte_it) {
-  const auto res = *byte_it;
-  byte_it += 1;
-  return res;
-}
-
 const char* Consume(std::vector<std::uint8_t>::const_iterator& byte_it,
                     const std::ptrdiff_t num_bytes) {
   const auto* pos = &*byte_it;
   byte_it += num_bytes;
   return reinterpret_cast<const char*>(pos);
 }
+
+// Reads from an in-memory buffer it doesn't own. Used for compressed in-memory
+// input, which can't be decoded in place.
+class BufferReader : public databento::IReadable {
+ public:
+  BufferReader(const std::uint8_t* data, std::size_t size)
+      : data_{data}, size_{size} {}
+
+  void ReadExact(std::uint8_t* buffer, std::size_t length) override {
+    if (size_ - pos_ < length) {
+      std::ostringstream err_msg;
+      err_msg << "Unexpected end of input, expected " << length
+              << " bytes, got " << size_ - pos_;
+      throw databento::DbnResponseError{err_msg.str()};
+    }
+    ReadSome(buffer, length);
+  }
+
+  std::size_t ReadSome(std::uint8_t* buffer, std::size_t max_length) override {
+    const auto read_size = std::min(max_length, size_ - pos_);
+    std::copy(data_ + pos_, data_ + pos_ + read_size, buffer);
+    pos_ += read_size;
+    return read_size;
+  }
+
+ private:
+  const std::uint8_t* data_;
+  std::size_t size_;
+  std::size_t pos_{};
+};
 }  // namespace
 
+constexpr std::size_t DbnDecoder::kDefaultBufferSize;
+
 DbnDecoder::DbnDecoder(detail::SharedChannel channel)
     : DbnDecoder(std::unique_ptr<IReadable>{
           new detail::SharedChannel{std::move(channel)}}) {}
@@ -61,15 +88,99 @@ DbnDecoder::DbnDecoder(std::unique_ptr<IReadable> input)
 
 DbnDecoder::DbnDecoder(std::unique_ptr<IReadable> input,
                        VersionUpgradePolicy upgrade_policy)
-    : input_{std::move(input)}, upgrade_policy_{upgrade_policy} {
-  read_buffer_.reserve(kBufferCapacity);
+    : DbnDecoder(std::move(input), upgrade_policy, kDefaultBufferSize) {}
+
+DbnDecoder::DbnDecoder(std::unique_ptr<IReadable> input,
+                       VersionUpgradePolicy upgrade_policy,
+                       std::size_t buffer_size)
+    : DbnDecoder(std::move(input), upgrade_policy, buffer_size, 0) {}
+
+DbnDecoder::DbnDecoder(std::unique_ptr<IReadable> input,
+                       VersionUpgradePolicy upgrade_policy,
+                       std::size_t buffer_size, std::size_t zstd_thread_count)
+    : upgrade_policy_{upgrade_policy}, input_{std::move(input)} {
+  if (buffer_size < detail::kMaxEncodedRecordLen) {
+    throw InvalidArgumentError{
+        "DbnDecoder::DbnDecoder", "buffer_size",
+        "Must be at least " + std::to_string(detail::kMaxEncodedRecordLen) +
+            " bytes"};
+  }
+  InitStream(buffer_size, zstd_thread_count);
+}
+
+DbnDecoder::DbnDecoder(std::unique_ptr<IReadable> input,
+                       const Metadata& metadata,
+                       VersionUpgradePolicy upgrade_policy)
+    : version_{metadata.version},
+      upgrade_policy_{upgrade_policy},
+      input_{std::move(input)},
+      record_buffer_{kDefaultBufferSize} {}
+
+DbnDecoder::DbnDecoder(const std::uint8_t* buffer, std::size_t size)
+    : DbnDecoder(buffer, size, VersionUpgradePolicy::AsIs) {}
+
+DbnDecoder::DbnDecoder(const std::uint8_t* buffer, std::size_t size,
+                       VersionUpgradePolicy upgrade_policy)
+    : upgrade_policy_{upgrade_policy},
+      in_memory_{buffer},
+      in_memory_size_{size} {
+  InitInMemory();
+}
+
+DbnDecoder::DbnDecoder(const std::uint8_t* buffer, std::size_t size,
+                       const Metadata& metadata,
+                       VersionUpgradePolicy upgrade_policy)
+    : version_{metadata.version},
+      upgrade_policy_{upgrade_policy},
+      in_memory_{buffer},
+      in_memory_size_{size} {}
+
+DbnDecoder::DbnDecoder(detail::MmapFile mmap_file)
+    : DbnDecoder(std::move(mmap_file), VersionUpgradePolicy::AsIs) {}
+
+DbnDecoder::DbnDecoder(detail::MmapFile mmap_file,
+                       VersionUpgradePolicy upgrade_policy)
+    : upgrade_policy_{upgrade_policy},
+      mmap_file_{std::move(mmap_file)},
+      in_memory_{mmap_file_.Data()},
+      in_memory_size_{mmap_file_.Size()} {
+  InitInMemory();
+}
+
+void DbnDecoder::InitInMemory() {
+  if (in_memory_size_ < kMagicSize) {
+    std::ostringstream err_msg;
+    err_msg << "Unexpected end of input, expected " << kMagicSize
+            << " bytes, got " << in_memory_size_;
+    throw DbnResponseError{err_msg.str()};
+  }
+  if (std::strncmp(reinterpret_cast<const char*>(in_memory_), kDbnPrefix, 3) ==
+      0) {
+    // Get into the same state as streamed input after detecting compression
+    buffer_idx_ = kMagicSize;
+    return;
+  }
+  // Compressed input can't be decoded in place so fall back to streaming it
+  input_.reset(new BufferReader{in_memory_, in_memory_size_});
+  in_memory_ = nullptr;
+  in_memory_size_ = 0;
+  InitStream(kDefaultBufferSize, 0);
+}
+
+void DbnDecoder::InitStream(std::size_t buffer_size,
+                            std::size_t zstd_thread_count) {
+  record_buffer_ = detail::RingBuffer{buffer_size};
   if (DetectCompression()) {
-    input_ = std::unique_ptr<detail::ZstdStream>(
-        new detail::ZstdStream(std::move(input_), std::move(read_buffer_)));
+    if (zstd_thread_count > 0) {
+      input_ = std::unique_ptr<detail::ParallelZstdStream>(
+          new detail::ParallelZstdStream(std::move(input_), zstd_thread_count,
+                                         std::move(read_buffer_)));
+    } else {
+      input_ = std::unique_ptr<detail::ZstdStream>(
+          new detail::ZstdStream(std::move(input_), std::move(read_buffer_)));
+    }
     // Reinitialize buffer and get it into the same state as uncompressed input
-    read_buffer_ = std::vector<std::uint8_t>();
-    read_buffer_.reserve(kBufferCapacity);
-    read_buffer_.resize(kMagicSize);
+    read_buffer_ = std::vector<std::uint8_t>(kMagicSize);
     input_->ReadExact(read_buffer_.data(), kMagicSize);
     auto read_buffer_it = read_buffer_.cbegin();
     if (std::strncmp(Consume(read_buffer_it, 3), kDbnPrefix, 3) != 0) {
@@ -97,76 +208,34 @@ std::pair<std::uint8_t, std::size_t> DbnDecoder::DecodeMetadataVersionAndSize(
 
 databento::Metadata DbnDecoder::DecodeMetadataFields(
     std::uint8_t version, const std::vector<std::uint8_t>& buffer) {
-  Metadata res;
-  res.version = version;
-  if (res.version > kDbnVersion) {
-    throw DbnResponseError{
-        "Can't decode newer version of DBN. Decoder version is " +
-        std::to_string(kDbnVersion) + ", input version is " +
-        std::to_string(res.version)};
-  }
-  auto read_buffer_it = buffer.cbegin();
-  res.dataset = std::string{Consume(read_buffer_it, kDatasetCstrLen)};
-  const auto raw_schema = Consume<std::uint16_t>(read_buffer_it);
-  if (raw_schema == std::numeric_limits<std::uint16_t>::max()) {
-    res.has_mixed_schema = true;
-    // must initialize
-    res.schema = Schema::Mbo;
-  } else {
-    res.has_mixed_schema = false;
-    res.schema = static_cast<Schema>(raw_schema);
-  }
-  res.start = UnixNanos{
-      std::chrono::nanoseconds{Consume<std::uint64_t>(read_buffer_it)}};
-  res.end = UnixNanos{
-      std::chrono::nanoseconds{Consume<std::uint64_t>(read_buffer_it)}};
-  res.limit = Consume<std::uint64_t>(read_buffer_it);
-  if (version == 1) {
-    // skip deprecated record_count
-    read_buffer_it += 8;
-  }
-  const auto raw_stype_in = Consume<std::uint8_t>(read_buffer_it);
-  if (raw_stype_in == std::numeric_limits<std::uint8_t>::max()) {
-    res.has_mixed_stype_in = true;
-    // must initialize
-    res.stype_in = SType::InstrumentId;
-  } else {
-    res.has_mixed_stype_in = false;
-    res.stype_in = static_cast<SType>(raw_stype_in);
-  }
-  res.stype_out = static_cast<SType>(Consume<std::uint8_t>(read_buffer_it));
-  res.ts_out = static_cast<bool>(Consume<std::uint8_t>(read_buffer_it));
-  if (version > 1) {
-    res.symbol_cstr_len =
-        static_cast<std::size_t>(Consume<std::uint16_t>(read_buffer_it));
-  } else {
-    res.symbol_cstr_len = kSymbolCstrLenV1;
-  }
-  // skip reserved
-  if (version == 1) {
-    read_buffer_it += ::kReservedLenV1;
-  } else {
-    read_buffer_it += ::kReservedLen;
-  }
+  return MetadataView{version, buffer}.ToMetadata();
+}
 
-  const auto schema_definition_length = Consume<std::uint32_t>(read_buffer_it);
-  if (schema_definition_length != 0) {
-    throw DbnResponseError{
-        "This version of dbn can't parse schema definitions"};
-  }
-  res.symbols = DbnDecoder::DecodeRepeatedSymbol(res.symbol_cstr_len,
-                                                 read_buffer_it, buffer.cend());
-  res.partial = DbnDecoder::DecodeRepeatedSymbol(res.symbol_cstr_len,
-                                                 read_buffer_it, buffer.cend());
-  res.not_found = DbnDecoder::DecodeRepeatedSymbol(
-      res.symbol_cstr_len, read_buffer_it, buffer.cend());
-  res.mappings = DbnDecoder::DecodeSymbolMappings(
-      res.symbol_cstr_len, read_buffer_it, buffer.cend());
+databento::Metadata DbnDecoder::DecodeMetadata() {
+  ReadMetadata();
+  return DbnDecoder::DecodeMetadataFields(version_, read_buffer_);
+}
 
-  return res;
+databento::MetadataView DbnDecoder::DecodeMetadataView() {
+  ReadMetadata();
+  // `read_buffer_` is only reused for unaligned in-memory batches, which
+  // reallocate it
+  return MetadataView{version_, std::move(read_buffer_)};
 }
 
-databento::Metadata DbnDecoder::DecodeMetadata() {
+void DbnDecoder::ReadMetadata() {
+  if (in_memory_ != nullptr) {
+    const auto version_and_size = DbnDecoder::DecodeMetadataVersionAndSize(
+        in_memory_, in_memory_size_);
+    version_ = version_and_size.first;
+    const auto metadata_end = 8 + version_and_size.second;
+    if (metadata_end > in_memory_size_) {
+      throw DbnResponseError{"Unexpected end of input while decoding metadata"};
+    }
+    read_buffer_.assign(in_memory_ + 8, in_memory_ + metadata_end);
+    buffer_idx_ = metadata_end;
+    return;
+  }
   // already read first 4 bytes detecting compression
   read_buffer_.resize(8);
   input_->ReadExact(&read_buffer_[4], 4);
@@ -175,8 +244,6 @@ databento::Metadata DbnDecoder::DecodeMetadata() {
   version_ = version_and_size.first;
   read_buffer_.resize(version_and_size.second);
   input_->ReadExact(read_buffer_.data(), read_buffer_.size());
-  buffer_idx_ = read_buffer_.size();
-  return DbnDecoder::DecodeMetadataFields(version_, read_buffer_);
 }
 
 databento::Record DbnDecoder::DecodeRecordCompat(
@@ -200,41 +267,205 @@ databento::Record DbnDecoder::DecodeRecordCompat(
 
 // assumes ParseMetadata has been called
 const databento::Record* DbnDecoder::DecodeRecord() {
-  // need some unread unread_bytes
-  const auto unread_bytes = read_buffer_.size() - buffer_idx_;
-  if (unread_bytes == 0) {
-    if (FillBuffer() == 0) {
+  if (in_memory_ != nullptr) {
+    return DecodeInMemoryRecord();
+  }
+  do {
+    while (!IsRecordBuffered()) {
+      if (FillBuffer() == 0) {
+        return nullptr;
+      }
+    }
+    current_record_ = Record{BufferRecordHeader()};
+    record_buffer_.Consume(current_record_.Size());
+  } while (IsFilteredOut(
+      reinterpret_cast<const std::uint8_t*>(&current_record_.Header())));
+  current_record_ = DbnDecoder::DecodeRecordCompat(
+      version_, upgrade_policy_, &compat_buffer_, current_record_);
+  return &current_record_;
+}
+
+const databento::Record* DbnDecoder::DecodeInMemoryRecord() {
+  const std::uint8_t* record_ptr;
+  std::size_t length;
+  do {
+    const auto unread_bytes = in_memory_size_ - buffer_idx_;
+    if (unread_bytes == 0) {
       return nullptr;
     }
-  }
-  // check length
-  while (read_buffer_.size() - buffer_idx_ < BufferRecordHeader()->Size()) {
-    if (FillBuffer() == 0) {
+    record_ptr = &in_memory_[buffer_idx_];
+    length = std::size_t{record_ptr[0]} * RecordHeader::kLengthMultiplier;
+    // incomplete record at the end of the input
+    if (length > unread_bytes) {
       return nullptr;
     }
+    if (length < sizeof(RecordHeader)) {
+      throw DbnResponseError{
+          "Record length is shorter than the record header"};
+    }
+    buffer_idx_ += length;
+  } while (IsFilteredOut(record_ptr));
+  if (reinterpret_cast<std::uintptr_t>(record_ptr) % alignof(RecordHeader) !=
+      0) {
+    std::copy(record_ptr, record_ptr + length, aligned_buffer_.begin());
+    record_ptr = aligned_buffer_.data();
   }
-  current_record_ = Record{BufferRecordHeader()};
-  buffer_idx_ += current_record_.Size();
+  // Records are never modified through the decoder
+  current_record_ = Record{reinterpret_cast<RecordHeader*>(
+      const_cast<std::uint8_t*>(record_ptr))};
   current_record_ = DbnDecoder::DecodeRecordCompat(
       version_, upgrade_policy_, &compat_buffer_, current_record_);
   return &current_record_;
 }
 
+databento::RecordBatch DbnDecoder::DecodeRecords() {
+  std::uint8_t* batch_start;
+  std::size_t unread_bytes;
+  std::size_t skip_size;
+  do {
+    if (in_memory_ != nullptr) {
+      // Records are never modified through the decoder
+      batch_start = const_cast<std::uint8_t*>(&in_memory_[buffer_idx_]);
+      // Limit the batch size so the batch is still in cache when the caller
+      // iterates over it
+      unread_bytes = std::min(in_memory_size_ - buffer_idx_, kMaxBatchSize);
+    } else {
+      // need at least one complete record
+      while (!IsRecordBuffered()) {
+        if (FillBuffer() == 0) {
+          return {};
+        }
+      }
+      batch_start = record_buffer_.ReadBegin();
+      unread_bytes = record_buffer_.ReadableSize();
+    }
+    // A batch can't contain records that are filtered out, so skip them here
+    skip_size = SkipSize(batch_start, unread_bytes);
+    if (in_memory_ != nullptr) {
+      buffer_idx_ += skip_size;
+    } else {
+      record_buffer_.Consume(skip_size);
+    }
+  } while (skip_size > 0);
+  bool needs_upgrade{};
+  const auto batch_size = BatchSize(batch_start, unread_bytes, &needs_upgrade);
+  if (batch_size == 0) {
+    // The next record is incomplete
+    if (DecodeRecord() == nullptr) {
+      return {};
+    }
+    return RecordBatch{
+        reinterpret_cast<std::uint8_t*>(&current_record_.Get<RecordHeader>()),
+        current_record_.Size()};
+  }
+  if (in_memory_ != nullptr &&
+      reinterpret_cast<std::uintptr_t>(batch_start) % alignof(RecordHeader) !=
+          0) {
+    // The metadata has already been decoded, so `read_buffer_` is free to use
+    read_buffer_.assign(batch_start, batch_start + batch_size);
+    batch_start = read_buffer_.data();
+  }
+  if (in_memory_ != nullptr) {
+    buffer_idx_ += batch_size;
+  } else {
+    record_buffer_.Consume(batch_size);
+  }
+  if (needs_upgrade) {
+    // Consumed records aren't overwritten until the buffer is filled again
+    UpgradeRecordsV1ToV2(batch_start, batch_size, &upgrade_buffer_);
+    return RecordBatch{upgrade_buffer_.data(), upgrade_buffer_.size()};
+  }
+  return RecordBatch{batch_start, batch_size};
+}
+
+bool DbnDecoder::IsFilteredOut(const std::uint8_t* buffer) {
+  if (filter_.IsEmpty()) {
+    return false;
+  }
+  RecordHeader header;
+  std::memcpy(&header, buffer, sizeof(header));
+  if (filter_.Matches(header)) {
+    ++filter_pass_count_;
+    return false;
+  }
+  ++filter_skip_count_;
+  return true;
+}
+
+std::size_t DbnDecoder::SkipSize(const std::uint8_t* buffer,
+                                 std::size_t size) {
+  if (filter_.IsEmpty()) {
+    return 0;
+  }
+  std::size_t skip_size = 0;
+  while (skip_size < size) {
+    const auto length =
+        std::size_t{buffer[skip_size]} * RecordHeader::kLengthMultiplier;
+    if (length > size - skip_size || length < sizeof(RecordHeader)) {
+      break;
+    }
+    RecordHeader header;
+    std::memcpy(&header, &buffer[skip_size], sizeof(header));
+    if (filter_.Matches(header)) {
+      break;
+    }
+    ++filter_skip_count_;
+    skip_size += length;
+  }
+  return skip_size;
+}
+
+std::size_t DbnDecoder::BatchSize(const std::uint8_t* buffer,
+                                  std::size_t size, bool* needs_upgrade) {
+  const bool will_upgrade =
+      version_ == 1 && upgrade_policy_ == VersionUpgradePolicy::Upgrade;
+  const bool is_filtered = !filter_.IsEmpty();
+  std::size_t batch_size = 0;
+  while (batch_size < size) {
+    // `length` and `rtype` are the first two bytes of the header. Read them
+    // directly because `buffer` may not be aligned
+    const auto length = std::size_t{buffer[batch_size]} *
+                        RecordHeader::kLengthMultiplier;
+    if (length > size - batch_size) {
+      break;
+    }
+    if (length < sizeof(RecordHeader)) {
+      throw DbnResponseError{"Record length is shorter than the record header"};
+    }
+    const auto rtype = static_cast<RType>(buffer[batch_size + 1]);
+    if (will_upgrade &&
+        (rtype == RType::InstrumentDef || rtype == RType::SymbolMapping)) {
+      *needs_upgrade = true;
+    }
+    if (is_filtered) {
+      // Counted when it's skipped in the next call to `DecodeRecords`
+      RecordHeader header;
+      std::memcpy(&header, &buffer[batch_size], sizeof(header));
+      if (!filter_.Matches(header)) {
+        break;
+      }
+      ++filter_pass_count_;
+    }
+    batch_size += length;
+  }
+  return batch_size;
+}
+
 size_t DbnDecoder::FillBuffer() {
-  // Shift data forward
-  std::copy(read_buffer_.cbegin() + static_cast<std::ptrdiff_t>(buffer_idx_),
-            read_buffer_.cend(), read_buffer_.begin());
-  const auto unread_size = read_buffer_.size() - buffer_idx_;
-  buffer_idx_ = 0;
-  read_buffer_.resize(kBufferCapacity);
-  const auto fill_size = input_->ReadSome(&read_buffer_[unread_size],
-                                          kBufferCapacity - unread_size);
-  read_buffer_.resize(unread_size + fill_size);
+  auto* const write_begin = record_buffer_.WriteBegin();
+  const auto fill_size =
+      input_->ReadSome(write_begin, record_buffer_.WritableSize());
+  record_buffer_.Fill(fill_size);
   return fill_size;
 }
 
 databento::RecordHeader* DbnDecoder::BufferRecordHeader() {
-  return reinterpret_cast<RecordHeader*>(&read_buffer_[buffer_idx_]);
+  return reinterpret_cast<RecordHeader*>(record_buffer_.ReadBegin());
+}
+
+bool DbnDecoder::IsRecordBuffered() {
+  const auto unread_bytes = record_buffer_.ReadableSize();
+  return unread_bytes > 0 && unread_bytes >= BufferRecordHeader()->Size();
 }
 
 bool DbnDecoder::DetectCompression() {
@@ -262,84 +493,3 @@ bool DbnDecoder::DetectCompression() {
       "Couldn't detect input type. It doesn't appear to be Zstd or "
       "DBN."};
 }
-
-std::string DbnDecoder::DecodeSymbol(
-    std::size_t symbol_cstr_len,
-    std::vector<std::uint8_t>::const_iterator& read_buffer_it) {
-  return std::string{
-      Consume(read_buffer_it, static_cast<std::ptrdiff_t>(symbol_cstr_len))};
-}
-
-std::vector<std::string> DbnDecoder::DecodeRepeatedSymbol(
-    std::size_t symbol_cstr_len,
-    std::vector<std::uint8_t>::const_iterator& read_buffer_it,
-    std::vector<std::uint8_t>::const_iterator read_buffer_end_it) {
-  if (read_buffer_it + sizeof(std::uint32_t) > read_buffer_end_it) {
-    throw DbnResponseError{
-        "Unexpected end of metadata buffer while parsing symbol"};
-  }
-  const auto count = std::size_t{Consume<std::uint32_t>(read_buffer_it)};
-  if (read_buffer_it + static_cast<std::ptrdiff_t>(count * symbol_cstr_len) >
-      read_buffer_end_it) {
-    throw DbnResponseError{
-        "Unexpected end of metadata buffer while parsing symbol"};
-  }
-  std::vector<std::string> res;
-  res.reserve(count);
-  for (std::size_t i = 0; i < count; ++i) {
-    res.emplace_back(DecodeSymbol(symbol_cstr_len, read_buffer_it));
-  }
-  return res;
-}
-
-std::vector<databento::SymbolMapping> DbnDecoder::DecodeSymbolMappings(
-    std::size_t symbol_cstr_len,
-    std::vector<std::uint8_t>::const_iterator& read_buffer_it,
-    std::vector<std::uint8_t>::const_iterator read_buffer_end_it) {
-  if (read_buffer_it + sizeof(std::uint32_t) > read_buffer_end_it) {
-    throw DbnResponseError{
-        "Unexpected end of metadata buffer while parsing mappings"};
-  }
-  const auto count = std::size_t{Consume<std::uint32_t>(read_buffer_it)};
-  std::vector<SymbolMapping> res;
-  res.reserve(count);
-  for (std::size_t i = 0; i < count; ++i) {
-    res.emplace_back(DbnDecoder::DecodeSymbolMapping(
-        symbol_cstr_len, read_buffer_it, read_buffer_end_it));
-  }
-  return res;
-}
-
-databento::SymbolMapping DbnDecoder::DecodeSymbolMapping(
-    std::size_t symbol_cstr_len,
-    std::vector<std::uint8_t>::const_iterator& read_buffer_it,
-    std::vector<std::uint8_t>::const_iterator read_buffer_end_it) {
-  const auto min_symbol_mapping_encoded_len =
-      static_cast<std::ptrdiff_t>(symbol_cstr_len + sizeof(std::uint32_t));
-  const auto mapping_encoded_len = sizeof(std::uint32_t) * 2 + symbol_cstr_len;
-
-  if (read_buffer_it + min_symbol_mapping_encoded_len > read_buffer_end_it) {
-    throw DbnResponseError{
-        "Unexpected end of metadata buffer while parsing symbol "
-        "mapping"};
-  }
-  SymbolMapping res;
-  res.raw_symbol = DecodeSymbol(symbol_cstr_len, read_buffer_it);
-  const auto interval_count =
-      std::size_t{Consume<std::uint32_t>(read_buffer_it)};
-  const auto read_size =
-      static_cast<std::ptrdiff_t>(interval_count * mapping_encoded_len);
-  if (read_buffer_it + read_size > read_buffer_end_it) {
-    throw DbnResponseError{
-        "Symbol mapping interval_count doesn't match size of buffer"};
-  }
-  res.intervals.reserve(interval_count);
-  for (std::size_t i = 0; i < interval_count; ++i) {
-    MappingInterval interval;
-    interval.start_date = Consume<std::uint32_t>(read_buffer_it);
-    interval.end_date = Consume<std::uint32_t>(read_buffer_it);
-    interval.symbol = DecodeSymbol(symbol_cstr_len, read_buffer_it);
-    res.intervals.emplace_back(std::move(interval));
-  }
-  return res;
-}
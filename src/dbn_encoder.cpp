@@ -0,0 +1,304 @@
+#include "databento/dbn_encoder.hpp"
+
+#include <algorithm>  // max
+#include <condition_variable>
+#include <cstring>    // memcpy
+#include <exception>  // exception_ptr, rethrow_exception
+#include <limits>
+#include <mutex>    // lock_guard, mutex, unique_lock
+#include <string>   // to_string
+#include <utility>  // move, swap
+
+#include "databento/compat.hpp"     // kSymbolCstrLenV1
+#include "databento/constants.hpp"  // kDbnVersion
+#include "databento/detail/scoped_thread.hpp"
+#include "databento/exceptions.hpp"
+
+using databento::DbnEncoder;
+
+namespace {
+constexpr auto kDbnPrefix = "DBN";
+constexpr std::size_t kDatasetCstrLen = 16;
+constexpr std::size_t kReservedLen = 53;
+constexpr std::size_t kReservedLenV1 = 47;
+// Written in place of the deprecated version 1 record count
+constexpr std::uint64_t kUnknownRecordCount =
+    std::numeric_limits<std::uint64_t>::max();
+
+template <typename T>
+void Append(std::vector<std::uint8_t>* buffer, T value) {
+  const auto* bytes = reinterpret_cast<const std::uint8_t*>(&value);
+  buffer->insert(buffer->end(), bytes, bytes + sizeof(T));
+}
+
+void AppendCStr(std::vector<std::uint8_t>* buffer, const std::string& str,
+                std::size_t cstr_len) {
+  if (str.size() >= cstr_len) {
+    throw databento::InvalidArgumentError{
+        "DbnEncoder::EncodeMetadata", "metadata",
+        "String '" + str + "' is too long to encode in " +
+            std::to_string(cstr_len) + " bytes"};
+  }
+  buffer->insert(buffer->end(), str.cbegin(), str.cend());
+  buffer->resize(buffer->size() + cstr_len - str.size());
+}
+
+void AppendRepeatedSymbol(std::vector<std::uint8_t>* buffer,
+                          const std::vector<std::string>& symbols,
+                          std::size_t symbol_cstr_len) {
+  Append(buffer, static_cast<std::uint32_t>(symbols.size()));
+  for (const auto& symbol : symbols) {
+    AppendCStr(buffer, symbol, symbol_cstr_len);
+  }
+}
+}  // namespace
+
+// Writes full buffers to the output on a background thread. At most one buffer
+// is in flight at a time.
+class DbnEncoder::Worker {
+ public:
+  explicit Worker(IWritable* output);
+  Worker(const Worker&) = delete;
+  Worker& operator=(const Worker&) = delete;
+  Worker(Worker&&) = delete;
+  Worker& operator=(Worker&&) = delete;
+  ~Worker();
+
+  // Waits for the previous buffer to be written, then takes the contents of
+  // `buffer` to write, leaving it empty. Rethrows any exception from writing a
+  // previous buffer.
+  void Write(std::vector<std::uint8_t>* buffer);
+  // Waits for any buffer in flight to be written. Rethrows any exception from
+  // writing it.
+  void Wait();
+
+ private:
+  // Must be called with `mutex_` locked
+  void WaitIdle(std::unique_lock<std::mutex>& lock);
+  void Work();
+
+  IWritable* output_;
+  // protects all other data members of this class
+  std::mutex mutex_;
+  // notified when a buffer is pushed, written, or on shutdown
+  std::condition_variable cv_;
+  // owned by the background thread while `has_pending_` is true
+  std::vector<std::uint8_t> pending_;
+  bool has_pending_{};
+  bool is_shutdown_{};
+  std::exception_ptr exception_ptr_{};
+  // must be destroyed first
+  detail::ScopedThread thread_;
+};
+
+DbnEncoder::Worker::Worker(IWritable* output)
+    : output_{output}, thread_{&Worker::Work, this} {}
+
+DbnEncoder::Worker::~Worker() {
+  {
+    const std::lock_guard<std::mutex> lock{mutex_};
+    is_shutdown_ = true;
+  }
+  cv_.notify_all();
+}
+
+void DbnEncoder::Worker::Write(std::vector<std::uint8_t>* buffer) {
+  {
+    std::unique_lock<std::mutex> lock{mutex_};
+    WaitIdle(lock);
+    // swap to keep reusing the capacity of both buffers
+    std::swap(pending_, *buffer);
+    has_pending_ = true;
+  }
+  buffer->clear();
+  cv_.notify_all();
+}
+
+void DbnEncoder::Worker::Wait() {
+  std::unique_lock<std::mutex> lock{mutex_};
+  WaitIdle(lock);
+}
+
+void DbnEncoder::Worker::WaitIdle(std::unique_lock<std::mutex>& lock) {
+  cv_.wait(lock, [this] { return !has_pending_; });
+  if (exception_ptr_) {
+    std::exception_ptr exception_ptr{};
+    std::swap(exception_ptr, exception_ptr_);
+    std::rethrow_exception(exception_ptr);
+  }
+}
+
+void DbnEncoder::Worker::Work() {
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock{mutex_};
+      cv_.wait(lock, [this] { return is_shutdown_ || has_pending_; });
+      if (!has_pending_) {
+        return;
+      }
+    }
+    std::exception_ptr exception_ptr{};
+    try {
+      output_->WriteAll(pending_.data(), pending_.size());
+    } catch (...) {
+      exception_ptr = std::current_exception();
+    }
+    {
+      const std::lock_guard<std::mutex> lock{mutex_};
+      exception_ptr_ = exception_ptr;
+      has_pending_ = false;
+    }
+    cv_.notify_all();
+  }
+}
+
+DbnEncoder::DbnEncoder(const Metadata& metadata,
+                       std::unique_ptr<IWritable> output)
+    : DbnEncoder{metadata, std::move(output), Compression::None} {}
+
+DbnEncoder::DbnEncoder(const Metadata& metadata,
+                       std::unique_ptr<IWritable> output,
+                       Compression compression)
+    : DbnEncoder{metadata, std::move(output), compression, kDefaultBufferSize,
+                 false} {}
+
+DbnEncoder::DbnEncoder(const Metadata& metadata,
+                       std::unique_ptr<IWritable> output,
+                       Compression compression, std::size_t buffer_size,
+                       bool use_background_thread)
+    : output_{std::move(output)},
+      buffer_size_{buffer_size},
+      buffer_{EncodeMetadata(metadata)} {
+  if (compression == Compression::Zstd) {
+    zstd_stream_ = new detail::ZstdCompressStream{std::move(output_)};
+    output_.reset(zstd_stream_);
+  }
+  if (use_background_thread) {
+    worker_.reset(new Worker{output_.get()});
+  }
+  buffer_.reserve(std::max(buffer_.size(), buffer_size_));
+}
+
+DbnEncoder::DbnEncoder(DbnEncoder&&) noexcept = default;
+
+DbnEncoder::~DbnEncoder() {
+  if (output_ && !is_finished_) {
+    try {
+      Finish();
+    } catch (...) {
+    }
+  }
+}
+
+std::vector<std::uint8_t> DbnEncoder::EncodeMetadata(const Metadata& metadata) {
+  const auto version = metadata.version;
+  if (version == 0 || version > kDbnVersion) {
+    throw InvalidArgumentError{
+        "DbnEncoder::EncodeMetadata", "metadata",
+        "Can't encode DBN version " + std::to_string(version)};
+  }
+  const auto symbol_cstr_len =
+      version == 1 ? kSymbolCstrLenV1 : metadata.symbol_cstr_len;
+  std::vector<std::uint8_t> res(kDbnPrefix, kDbnPrefix + 3);
+  res.emplace_back(version);
+  // length is filled in at the end
+  Append(&res, std::uint32_t{});
+  AppendCStr(&res, metadata.dataset, kDatasetCstrLen);
+  Append(&res, metadata.has_mixed_schema
+                   ? std::numeric_limits<std::uint16_t>::max()
+                   : static_cast<std::uint16_t>(metadata.schema));
+  Append(&res, metadata.start.time_since_epoch().count());
+  Append(&res, metadata.end.time_since_epoch().count());
+  Append(&res, metadata.limit);
+  if (version == 1) {
+    Append(&res, kUnknownRecordCount);
+  }
+  res.emplace_back(metadata.has_mixed_stype_in
+                       ? std::numeric_limits<std::uint8_t>::max()
+                       : static_cast<std::uint8_t>(metadata.stype_in));
+  res.emplace_back(static_cast<std::uint8_t>(metadata.stype_out));
+  res.emplace_back(static_cast<std::uint8_t>(metadata.ts_out));
+  if (version > 1) {
+    Append(&res, static_cast<std::uint16_t>(symbol_cstr_len));
+  }
+  res.resize(res.size() + (version == 1 ? kReservedLenV1 : kReservedLen));
+  // schema definition length
+  Append(&res, std::uint32_t{});
+  AppendRepeatedSymbol(&res, metadata.symbols, symbol_cstr_len);
+  AppendRepeatedSymbol(&res, metadata.partial, symbol_cstr_len);
+  AppendRepeatedSymbol(&res, metadata.not_found, symbol_cstr_len);
+  Append(&res, static_cast<std::uint32_t>(metadata.mappings.size()));
+  for (const auto& mapping : metadata.mappings) {
+    AppendCStr(&res, mapping.raw_symbol, symbol_cstr_len);
+    Append(&res, static_cast<std::uint32_t>(mapping.intervals.size()));
+    for (const auto& interval : mapping.intervals) {
+      Append(&res, interval.start_date);
+      Append(&res, interval.end_date);
+      AppendCStr(&res, interval.symbol, symbol_cstr_len);
+    }
+  }
+  const auto length = static_cast<std::uint32_t>(res.size() - 8);
+  std::memcpy(&res[4], &length, sizeof(length));
+  return res;
+}
+
+void DbnEncoder::EncodeRecord(const Record& record) {
+  Write(reinterpret_cast<const std::uint8_t*>(&record.Header()),
+        record.Size());
+}
+
+void DbnEncoder::EncodeRecords(const RecordBatch& batch) {
+  Write(batch.Data(), batch.Size());
+}
+
+void DbnEncoder::Flush() {
+  WriteBuffer();
+  if (worker_) {
+    worker_->Wait();
+  }
+  output_->Flush();
+}
+
+void DbnEncoder::Finish() {
+  if (is_finished_) {
+    return;
+  }
+  // set first so a failure isn't retried on destruction
+  is_finished_ = true;
+  WriteBuffer();
+  if (worker_) {
+    worker_->Wait();
+  }
+  if (zstd_stream_ != nullptr) {
+    zstd_stream_->EndFrame();
+  } else {
+    output_->Flush();
+  }
+}
+
+void DbnEncoder::Write(const std::uint8_t* data, std::size_t size) {
+  if (is_finished_) {
+    throw Exception{"Can't encode after DbnEncoder::Finish has been called"};
+  }
+  if (buffer_.size() + size > buffer_size_) {
+    WriteBuffer();
+    // too large to batch
+    if (size >= buffer_size_ && !worker_) {
+      output_->WriteAll(data, size);
+      return;
+    }
+  }
+  buffer_.insert(buffer_.end(), data, data + size);
+}
+
+void DbnEncoder::WriteBuffer() {
+  if (buffer_.empty()) {
+    return;
+  }
+  if (worker_) {
+    worker_->Write(&buffer_);
+  } else {
+    output_->WriteAll(buffer_.data(), buffer_.size());
+    buffer_.clear();
+  }
+}
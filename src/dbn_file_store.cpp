@@ -1,31 +1,71 @@
 #include "databento/dbn_file_store.hpp"
 
+#include <cstdint>
+#include <cstring>  // strncmp
+#include <fstream>  // ifstream
+#include <ios>      // ios
 #include <memory>   // unique_ptr
+#include <string>   // to_string
 #include <utility>  // move
+#include <vector>
 
+#include "databento/dbn_frame_index.hpp"
 #include "databento/detail/file_stream.hpp"
+#include "databento/detail/mmap_file.hpp"
+#include "databento/detail/zstd_stream.hpp"
+#include "databento/exceptions.hpp"
 #include "databento/ireadable.hpp"
 
 using databento::DbnFileStore;
 
 DbnFileStore::DbnFileStore(const std::string& file_path)
-    : parser_{detail::FileStream{file_path}} {}
+    : file_path_{file_path},
+      upgrade_policy_{VersionUpgradePolicy::AsIs},
+      parser_{detail::FileStream{file_path}} {}
 
 DbnFileStore::DbnFileStore(const std::string& file_path,
                            VersionUpgradePolicy upgrade_policy)
-    : parser_{std::unique_ptr<IReadable>{new detail::FileStream{file_path}},
+    : file_path_{file_path},
+      upgrade_policy_{upgrade_policy},
+      parser_{std::unique_ptr<IReadable>{new detail::FileStream{file_path}},
               upgrade_policy} {}
 
+DbnFileStore::DbnFileStore(const std::string& file_path,
+                           VersionUpgradePolicy upgrade_policy,
+                           ReadMode read_mode)
+    : file_path_{file_path},
+      upgrade_policy_{upgrade_policy},
+      parser_{MakeDecoder(file_path, upgrade_policy, read_mode)} {}
+
+DbnFileStore::DbnFileStore(const std::string& file_path,
+                           VersionUpgradePolicy upgrade_policy,
+                           std::size_t buffer_size)
+    : file_path_{file_path},
+      upgrade_policy_{upgrade_policy},
+      parser_{std::unique_ptr<IReadable>{new detail::FileStream{file_path}},
+              upgrade_policy, buffer_size} {}
+
+DbnFileStore::DbnFileStore(const std::string& file_path,
+                           VersionUpgradePolicy upgrade_policy,
+                           std::size_t buffer_size,
+                           std::size_t zstd_thread_count)
+    : file_path_{file_path},
+      upgrade_policy_{upgrade_policy},
+      parser_{std::unique_ptr<IReadable>{new detail::FileStream{file_path}},
+              upgrade_policy, buffer_size, zstd_thread_count} {}
+
 void DbnFileStore::Replay(const MetadataCallback& metadata_callback,
                           const RecordCallback& record_callback) {
   auto metadata = parser_.DecodeMetadata();
   if (metadata_callback) {
     metadata_callback(std::move(metadata));
   }
-  const databento::Record* record;
-  while ((record = parser_.DecodeRecord()) != nullptr) {
-    if (record_callback(*record) == KeepGoing::Stop) {
-      break;
+  RecordBatch batch;
+  while (!(batch = parser_.DecodeRecords()).IsEmpty()) {
+    for (const Record record : batch) {
+      if (record_callback(record) == KeepGoing::Stop) {
+        return;
+      }
     }
   }
 }
@@ -33,3 +73,265 @@ void DbnFileStore::Replay(const MetadataCallback& metadata_callback,
 void DbnFileStore::Replay(const RecordCallback& record_callback) {
   Replay({}, record_callback);
 }
+
+void DbnFileStore::Replay(const DateTimeRange<UnixNanos>& datetime_range,
+                          const MetadataCallback& metadata_callback,
+                          const RecordCallback& record_callback) {
+  auto metadata = parser_.DecodeMetadata();
+  bool is_past_end = false;
+  auto seeked_decoder =
+      MakeIndexedDecoder(metadata, datetime_range.start, &is_past_end);
+  if (!seeked_decoder && !is_past_end) {
+    const auto* layout = FindLayout();
+    std::uint64_t index;
+    // Otherwise there are records of other sizes or rtypes and the file is
+    // scanned linearly
+    if (layout != nullptr &&
+        LowerBound(*layout, datetime_range.start, &index)) {
+      is_past_end = index == layout->record_count;
+      if (!is_past_end) {
+        seeked_decoder = MakeFixedDecoder(*layout, index);
+      }
+    }
+  }
+  if (metadata_callback) {
+    metadata_callback(std::move(metadata));
+  }
+  if (is_past_end) {
+    return;
+  }
+  DbnDecoder& decoder = seeked_decoder ? *seeked_decoder : parser_;
+  const bool has_end = datetime_range.end.time_since_epoch().count() != 0;
+  RecordBatch batch;
+  while (!(batch = decoder.DecodeRecords()).IsEmpty()) {
+    for (const Record record : batch) {
+      const auto index_ts = record.IndexTs();
+      if (index_ts < datetime_range.start) {
+        continue;
+      }
+      // Records are sorted by index timestamp
+      if (has_end && index_ts >= datetime_range.end) {
+        return;
+      }
+      if (record_callback(record) == KeepGoing::Stop) {
+        return;
+      }
+    }
+  }
+}
+
+void DbnFileStore::Replay(const DateTimeRange<UnixNanos>& datetime_range,
+                          const RecordCallback& record_callback) {
+  Replay(datetime_range, {}, record_callback);
+}
+
+std::uint64_t DbnFileStore::RecordCount() {
+  return GetLayout("RecordCount").record_count;
+}
+
+std::uint64_t DbnFileStore::FindRecord(UnixNanos ts) {
+  const auto& layout = GetLayout("FindRecord");
+  std::uint64_t index;
+  if (!LowerBound(layout, ts, &index)) {
+    throw DbnResponseError{
+        "Single-schema file doesn't consist of records of the same size and "
+        "rtype"};
+  }
+  return index;
+}
+
+databento::Record DbnFileStore::DecodeRecordAt(std::uint64_t index) {
+  const auto& layout = GetLayout("DecodeRecordAt");
+  if (index >= layout.record_count) {
+    throw InvalidArgumentError{
+        "DbnFileStore::DecodeRecordAt", "index",
+        "Out of range for file with " + std::to_string(layout.record_count) +
+            " records"};
+  }
+  return DbnDecoder::DecodeRecordCompat(layout.metadata.version,
+                                        upgrade_policy_, &compat_buffer_,
+                                        ReadRecord(layout, index));
+}
+
+void DbnFileStore::ReplayFrom(std::uint64_t index,
+                              const RecordCallback& record_callback) {
+  const auto& layout = GetLayout("ReplayFrom");
+  if (index > layout.record_count) {
+    throw InvalidArgumentError{
+        "DbnFileStore::ReplayFrom", "index",
+        "Out of range for file with " + std::to_string(layout.record_count) +
+            " records"};
+  }
+  if (index < layout.record_count) {
+    // Check the decoder won't start mid-record
+    ReadRecord(layout, index);
+  }
+  const auto decoder = MakeFixedDecoder(layout, index);
+  RecordBatch batch;
+  while (!(batch = decoder->DecodeRecords()).IsEmpty()) {
+    for (const Record record : batch) {
+      if (record_callback(record) == KeepGoing::Stop) {
+        return;
+      }
+    }
+  }
+}
+
+databento::DbnDecoder DbnFileStore::MakeDecoder(
+    const std::string& file_path, VersionUpgradePolicy upgrade_policy,
+    ReadMode read_mode) {
+  if (read_mode == ReadMode::MemoryMap) {
+    return DbnDecoder{detail::MmapFile{file_path}, upgrade_policy};
+  }
+  return DbnDecoder{
+      std::unique_ptr<IReadable>{new detail::FileStream{file_path}},
+      upgrade_policy};
+}
+
+std::unique_ptr<databento::DbnDecoder> DbnFileStore::MakeIndexedDecoder(
+    const Metadata& metadata, UnixNanos start, bool* is_past_end) const {
+  const auto index_path = DbnFrameIndex::SidecarPath(file_path_);
+  if (!std::ifstream{index_path}.good()) {
+    return nullptr;
+  }
+  const auto index = DbnFrameIndex::Read(index_path);
+  std::ifstream file{file_path_, std::ios::binary | std::ios::ate};
+  if (static_cast<std::uint64_t>(file.tellg()) != index.FileSize()) {
+    // The file has changed since it was indexed
+    return nullptr;
+  }
+  const auto* entry = index.FindStart(start);
+  if (entry == nullptr) {
+    *is_past_end = true;
+    return nullptr;
+  }
+  std::unique_ptr<detail::FileStream> file_stream{
+      new detail::FileStream{file_path_}};
+  file_stream->Seek(entry->compressed_offset);
+  std::unique_ptr<IReadable> input{
+      new detail::ZstdStream{std::move(file_stream)}};
+  // Skip the end of a record that began in an earlier frame
+  const auto skip_size = entry->record_offset - entry->uncompressed_offset;
+  if (skip_size > 0) {
+    std::vector<std::uint8_t> skipped(skip_size);
+    input->ReadExact(skipped.data(), skipped.size());
+  }
+  return std::unique_ptr<DbnDecoder>{
+      new DbnDecoder{std::move(input), metadata, upgrade_policy_}};
+}
+
+const DbnFileStore::FixedLayout* DbnFileStore::FindLayout() {
+  if (is_layout_found_) {
+    return layout_.get();
+  }
+  is_layout_found_ = true;
+  std::unique_ptr<detail::FileStream> stream{
+      new detail::FileStream{file_path_}};
+  std::vector<std::uint8_t> buffer(8);
+  if (stream->ReadSome(buffer.data(), buffer.size()) != buffer.size() ||
+      // Compressed or not DBN
+      std::strncmp(reinterpret_cast<const char*>(buffer.data()), "DBN", 3) !=
+          0) {
+    return nullptr;
+  }
+  const auto version_and_size =
+      DbnDecoder::DecodeMetadataVersionAndSize(buffer.data(), buffer.size());
+  buffer.resize(version_and_size.second);
+  stream->ReadExact(buffer.data(), buffer.size());
+  std::unique_ptr<FixedLayout> layout{new FixedLayout{
+      DbnDecoder::DecodeMetadataFields(version_and_size.first, buffer),
+      8 + std::uint64_t{version_and_size.second}, 0, RType{}, 0}};
+  if (layout->metadata.has_mixed_schema) {
+    return nullptr;
+  }
+  std::ifstream file{file_path_, std::ios::binary | std::ios::ate};
+  const auto file_size = static_cast<std::uint64_t>(file.tellg());
+  if (file_size > layout->records_offset) {
+    // Use the encoded length rather than the schema so older DBN versions with
+    // different record sizes are supported
+    std::uint8_t length_and_rtype[2];
+    stream->ReadExact(length_and_rtype, sizeof(length_and_rtype));
+    layout->record_size =
+        std::size_t{length_and_rtype[0]} * RecordHeader::kLengthMultiplier;
+    layout->rtype = static_cast<RType>(length_and_rtype[1]);
+  } else {
+    layout->record_size = Record::SizeOfSchema(layout->metadata.schema);
+  }
+  const auto records_size = file_size - layout->records_offset;
+  if (layout->record_size < sizeof(RecordHeader) ||
+      layout->record_size > record_buffer_.size() ||
+      records_size % layout->record_size != 0) {
+    has_irregular_size_ = true;
+    return nullptr;
+  }
+  layout->record_count = records_size / layout->record_size;
+  seek_stream_ = std::move(stream);
+  layout_ = std::move(layout);
+  return layout_.get();
+}
+
+const DbnFileStore::FixedLayout& DbnFileStore::GetLayout(
+    const char* method_name) {
+  const auto* layout = FindLayout();
+  if (layout == nullptr && has_irregular_size_) {
+    throw DbnResponseError{
+        "Single-schema file doesn't consist of records of the same size"};
+  }
+  if (layout == nullptr) {
+    throw InvalidArgumentError{
+        std::string{"DbnFileStore::"} + method_name, "file_path",
+        "Must be an uncompressed DBN file with a single schema"};
+  }
+  return *layout;
+}
+
+std::unique_ptr<databento::DbnDecoder> DbnFileStore::MakeFixedDecoder(
+    const FixedLayout& layout, std::uint64_t index) const {
+  std::unique_ptr<detail::FileStream> file_stream{
+      new detail::FileStream{file_path_}};
+  file_stream->Seek(layout.records_offset + index * layout.record_size);
+  return std::unique_ptr<DbnDecoder>{
+      new DbnDecoder{std::move(file_stream), layout.metadata, upgrade_policy_}};
+}
+
+databento::RecordHeader* DbnFileStore::TryReadRecord(
+    const FixedLayout& layout, std::uint64_t index) {
+  seek_stream_->Seek(layout.records_offset + index * layout.record_size);
+  seek_stream_->ReadExact(record_buffer_.data(), layout.record_size);
+  auto* header = reinterpret_cast<RecordHeader*>(record_buffer_.data());
+  if (header->Size() != layout.record_size || header->rtype != layout.rtype) {
+    return nullptr;
+  }
+  return header;
+}
+
+databento::Record DbnFileStore::ReadRecord(const FixedLayout& layout,
+                                           std::uint64_t index) {
+  auto* header = TryReadRecord(layout, index);
+  if (header == nullptr) {
+    throw DbnResponseError{
+        "Record at index " + std::to_string(index) +
+        " has a different size or rtype than the first record"};
+  }
+  return Record{header};
+}
+
+bool DbnFileStore::LowerBound(const FixedLayout& layout, UnixNanos ts,
+                              std::uint64_t* index) {
+  std::uint64_t low = 0;
+  std::uint64_t high = layout.record_count;
+  while (low < high) {
+    const auto mid = low + (high - low) / 2;
+    auto* header = TryReadRecord(layout, mid);
+    if (header == nullptr) {
+      return false;
+    }
+    if (Record{header}.IndexTs() < ts) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  *index = low;
+  return true;
+}
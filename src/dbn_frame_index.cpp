@@ -0,0 +1,285 @@
+#include "databento/dbn_frame_index.hpp"
+
+#include <zstd.h>
+
+#include <algorithm>  // copy, find_if, min
+#include <array>
+#include <chrono>  // nanoseconds
+#include <cstddef>
+#include <cstdint>  // uintptr_t
+#include <cstring>  // memcpy, strncmp
+#include <fstream>  // ifstream, ofstream
+#include <ios>      // ios, streamsize
+#include <memory>   // unique_ptr
+#include <tuple>    // tie
+
+#include "databento/detail/file_stream.hpp"
+#include "databento/detail/record_limits.hpp"  // kMaxEncodedRecordLen
+#include "databento/exceptions.hpp"
+#include "databento/record.hpp"
+
+using databento::DbnFrameIndex;
+using databento::detail::kMaxEncodedRecordLen;
+
+namespace {
+constexpr auto kMagic = "DBNFIDX";
+constexpr std::size_t kMagicSize = 7;
+constexpr std::uint8_t kFormatVersion = 1;
+constexpr auto kDbnPrefix = "DBN";
+
+void WriteU64(std::ofstream& stream, std::uint64_t value) {
+  stream.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+std::uint64_t ReadU64(std::ifstream& stream) {
+  std::uint64_t value{};
+  stream.read(reinterpret_cast<char*>(&value), sizeof(value));
+  if (stream.gcount() != sizeof(value)) {
+    throw databento::DbnResponseError{
+        "Unexpected end of DBN frame index file"};
+  }
+  return value;
+}
+
+void WriteTs(std::ofstream& stream, databento::UnixNanos ts) {
+  WriteU64(stream, ts.time_since_epoch().count());
+}
+
+databento::UnixNanos ReadTs(std::ifstream& stream) {
+  return databento::UnixNanos{std::chrono::nanoseconds{ReadU64(stream)}};
+}
+
+// Incrementally indexes the records in decompressed DBN data.
+class RecordIndexer {
+ public:
+  explicit RecordIndexer(std::vector<DbnFrameIndex::Entry>* entries)
+      : entries_{entries} {}
+
+  // Returns the offset of the end of the decompressed data seen so far.
+  std::uint64_t EndOffset() const { return offset_ + buffer_.size(); }
+  bool HasMetadata() const { return metadata_end_ != 0; }
+  std::vector<std::uint8_t>* Buffer() { return &buffer_; }
+  // Indexes all complete records in the buffer and removes them from it.
+  void Index();
+
+ private:
+  void IndexRecord(std::uint64_t record_offset, const databento::Record& rec);
+
+  std::vector<DbnFrameIndex::Entry>* entries_;
+  // Decompressed data yet to be indexed. Once the metadata has been skipped,
+  // begins at a record boundary.
+  std::vector<std::uint8_t> buffer_;
+  // Offset of `buffer_` in the decompressed data
+  std::uint64_t offset_{};
+  std::uint64_t metadata_end_{};
+  // For records that aren't 8-byte aligned
+  alignas(databento::RecordHeader)
+      std::array<std::uint8_t, kMaxEncodedRecordLen> aligned_buffer_{};
+};
+
+void RecordIndexer::Index() {
+  if (metadata_end_ == 0) {
+    if (buffer_.size() < 8) {
+      return;
+    }
+    if (std::strncmp(reinterpret_cast<const char*>(buffer_.data()),
+                     kDbnPrefix, 3) != 0) {
+      throw databento::DbnResponseError{"Missing DBN prefix"};
+    }
+    std::uint32_t metadata_len;
+    std::memcpy(&metadata_len, &buffer_[4], sizeof(metadata_len));
+    metadata_end_ = 8 + std::uint64_t{metadata_len};
+  }
+  std::size_t pos = 0;
+  if (offset_ < metadata_end_) {
+    pos = static_cast<std::size_t>(
+        std::min<std::uint64_t>(metadata_end_ - offset_, buffer_.size()));
+  }
+  while (offset_ + pos >= metadata_end_ && pos < buffer_.size()) {
+    const auto length =
+        std::size_t{buffer_[pos]} * databento::RecordHeader::kLengthMultiplier;
+    if (length < sizeof(databento::RecordHeader)) {
+      throw databento::DbnResponseError{
+          "Record length is shorter than the record header"};
+    }
+    if (length > buffer_.size() - pos) {
+      break;
+    }
+    auto* record_ptr = &buffer_[pos];
+    if (reinterpret_cast<std::uintptr_t>(record_ptr) %
+            alignof(databento::RecordHeader) !=
+        0) {
+      std::copy(record_ptr, record_ptr + length, aligned_buffer_.begin());
+      record_ptr = aligned_buffer_.data();
+    }
+    IndexRecord(offset_ + pos, databento::Record{reinterpret_cast<
+                                   databento::RecordHeader*>(record_ptr)});
+    pos += length;
+  }
+  buffer_.erase(buffer_.begin(),
+                buffer_.begin() + static_cast<std::ptrdiff_t>(pos));
+  offset_ += pos;
+}
+
+void RecordIndexer::IndexRecord(std::uint64_t record_offset,
+                                const databento::Record& rec) {
+  // A record belongs to the frame it begins in, which is usually the last
+  auto entry_it = entries_->rbegin();
+  while (entry_it->uncompressed_offset > record_offset) {
+    ++entry_it;
+  }
+  auto& entry = *entry_it;
+  const auto ts_event = rec.Header().ts_event;
+  const auto ts_recv = rec.IndexTs();
+  if (entry.record_count == 0) {
+    entry.record_offset = record_offset;
+    entry.first_ts_event = ts_event;
+    entry.first_ts_recv = ts_recv;
+  }
+  entry.last_ts_event = ts_event;
+  entry.last_ts_recv = ts_recv;
+  ++entry.record_count;
+}
+}  // namespace
+
+DbnFrameIndex DbnFrameIndex::Build(const std::string& file_path) {
+  detail::FileStream input{file_path};
+  const std::unique_ptr<ZSTD_DStream, std::size_t (*)(ZSTD_DStream*)>
+      z_dstream{::ZSTD_createDStream(), ::ZSTD_freeDStream};
+  std::vector<std::uint8_t> in_buffer(::ZSTD_DStreamInSize());
+  ZSTD_inBuffer z_in_buffer{in_buffer.data(), 0, 0};
+  // Offset of `in_buffer` in the file
+  std::uint64_t in_offset = 0;
+  DbnFrameIndex res;
+  RecordIndexer indexer{&res.entries_};
+  auto* out_buffer = indexer.Buffer();
+  bool is_frame_done = true;
+  while (true) {
+    if (z_in_buffer.pos == z_in_buffer.size) {
+      in_offset += z_in_buffer.size;
+      const auto read_size = input.ReadSome(in_buffer.data(), in_buffer.size());
+      if (read_size == 0) {
+        break;
+      }
+      z_in_buffer = {in_buffer.data(), read_size, 0};
+    }
+    if (is_frame_done) {
+      ::ZSTD_initDStream(z_dstream.get());
+      Entry entry{};
+      entry.compressed_offset = in_offset + z_in_buffer.pos;
+      entry.uncompressed_offset = indexer.EndOffset();
+      // Updated once a record is found
+      entry.record_offset = entry.uncompressed_offset;
+      res.entries_.emplace_back(entry);
+      is_frame_done = false;
+    }
+    const auto out_pos = out_buffer->size();
+    out_buffer->resize(out_pos + ::ZSTD_DStreamOutSize());
+    ZSTD_outBuffer z_out_buffer{out_buffer->data(), out_buffer->size(),
+                                out_pos};
+    const auto remaining =
+        ::ZSTD_decompressStream(z_dstream.get(), &z_out_buffer, &z_in_buffer);
+    if (::ZSTD_isError(remaining)) {
+      throw DbnResponseError{std::string{"Zstd error decompressing: "} +
+                             ::ZSTD_getErrorName(remaining)};
+    }
+    out_buffer->resize(z_out_buffer.pos);
+    is_frame_done = remaining == 0;
+    indexer.Index();
+  }
+  if (!is_frame_done) {
+    throw DbnResponseError{
+        "Reached end of input with an incomplete Zstd frame"};
+  }
+  if (!indexer.HasMetadata()) {
+    throw DbnResponseError{"Missing DBN metadata"};
+  }
+  res.file_size_ = in_offset;
+  return res;
+}
+
+DbnFrameIndex DbnFrameIndex::Read(const std::string& index_path) {
+  std::ifstream stream{index_path, std::ios::binary};
+  if (!stream.good()) {
+    throw InvalidArgumentError{"DbnFrameIndex::Read", "index_path",
+                               "Non-existent or invalid file"};
+  }
+  std::array<char, kMagicSize + 1> header{};
+  stream.read(header.data(), static_cast<std::streamsize>(header.size()));
+  if (stream.gcount() != static_cast<std::streamsize>(header.size()) ||
+      std::strncmp(header.data(), kMagic, kMagicSize) != 0) {
+    throw DbnResponseError{"Not a DBN frame index file"};
+  }
+  const auto version = static_cast<std::uint8_t>(header[kMagicSize]);
+  if (version != kFormatVersion) {
+    throw DbnResponseError{"Unsupported DBN frame index version " +
+                           std::to_string(version)};
+  }
+  DbnFrameIndex res;
+  res.file_size_ = ReadU64(stream);
+  const auto entry_count = ReadU64(stream);
+  // Guard against allocating based on a corrupt count
+  res.entries_.reserve(
+      static_cast<std::size_t>(std::min<std::uint64_t>(entry_count, 1 << 16)));
+  for (std::uint64_t i = 0; i < entry_count; ++i) {
+    Entry entry;
+    entry.compressed_offset = ReadU64(stream);
+    entry.uncompressed_offset = ReadU64(stream);
+    entry.record_offset = ReadU64(stream);
+    entry.record_count = ReadU64(stream);
+    entry.first_ts_event = ReadTs(stream);
+    entry.last_ts_event = ReadTs(stream);
+    entry.first_ts_recv = ReadTs(stream);
+    entry.last_ts_recv = ReadTs(stream);
+    res.entries_.emplace_back(entry);
+  }
+  return res;
+}
+
+std::string DbnFrameIndex::SidecarPath(const std::string& file_path) {
+  return file_path + ".idx";
+}
+
+void DbnFrameIndex::Write(const std::string& index_path) const {
+  std::ofstream stream{index_path, std::ios::binary | std::ios::trunc};
+  if (!stream.good()) {
+    throw InvalidArgumentError{"DbnFrameIndex::Write", "index_path",
+                               "Unable to open file for writing"};
+  }
+  stream.write(kMagic, kMagicSize);
+  stream.put(static_cast<char>(kFormatVersion));
+  WriteU64(stream, file_size_);
+  WriteU64(stream, entries_.size());
+  for (const auto& entry : entries_) {
+    WriteU64(stream, entry.compressed_offset);
+    WriteU64(stream, entry.uncompressed_offset);
+    WriteU64(stream, entry.record_offset);
+    WriteU64(stream, entry.record_count);
+    WriteTs(stream, entry.first_ts_event);
+    WriteTs(stream, entry.last_ts_event);
+    WriteTs(stream, entry.first_ts_recv);
+    WriteTs(stream, entry.last_ts_recv);
+  }
+  if (!stream.good()) {
+    throw InvalidArgumentError{"DbnFrameIndex::Write", "index_path",
+                               "Error writing file"};
+  }
+}
+
+const DbnFrameIndex::Entry* DbnFrameIndex::FindStart(UnixNanos start) const {
+  const auto entry_it =
+      std::find_if(entries_.cbegin(), entries_.cend(), [start](const Entry& e) {
+        return e.record_count > 0 && e.last_ts_recv >= start;
+      });
+  return entry_it == entries_.cend() ? nullptr : &*entry_it;
+}
+
+bool databento::operator==(const DbnFrameIndex::Entry& lhs,
+                           const DbnFrameIndex::Entry& rhs) {
+  return std::tie(lhs.compressed_offset, lhs.uncompressed_offset,
+                  lhs.record_offset, lhs.record_count, lhs.first_ts_event,
+                  lhs.last_ts_event, lhs.first_ts_recv, lhs.last_ts_recv) ==
+         std::tie(rhs.compressed_offset, rhs.uncompressed_offset,
+                  rhs.record_offset, rhs.record_count, rhs.first_ts_event,
+                  rhs.last_ts_event, rhs.first_ts_recv, rhs.last_ts_recv);
+}
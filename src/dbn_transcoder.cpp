@@ -0,0 +1,96 @@
+#include "databento/dbn_transcoder.hpp"
+
+#include <algorithm>  // max, min
+#include <atomic>
+#include <exception>  // current_exception, exception_ptr, rethrow_exception
+#include <memory>     // unique_ptr
+#include <mutex>      // lock_guard, mutex
+#include <thread>     // hardware_concurrency
+
+#include "databento/constants.hpp"    // kDbnVersion, kSymbolCstrLen
+#include "databento/dbn_decoder.hpp"  // DbnDecoder
+#include "databento/dbn_encoder.hpp"  // DbnEncoder
+#include "databento/detail/file_stream.hpp"    // FileStream, OutFileStream
+#include "databento/detail/scoped_thread.hpp"  // ScopedThread
+#include "databento/exceptions.hpp"            // InvalidArgumentError
+
+using databento::DbnTranscoder;
+
+DbnTranscoder::DbnTranscoder()
+    : DbnTranscoder{
+          std::max<std::size_t>(std::thread::hardware_concurrency(), 1)} {}
+
+DbnTranscoder::DbnTranscoder(std::size_t thread_count)
+    : thread_count_{thread_count} {
+  if (thread_count_ == 0) {
+    throw InvalidArgumentError{"DbnTranscoder::DbnTranscoder", "thread_count",
+                               "Must be greater than 0"};
+  }
+}
+
+std::uint64_t DbnTranscoder::TranscodeFile(const Job& job) {
+  DbnDecoder decoder{
+      std::unique_ptr<IReadable>{new detail::FileStream{job.input_path}},
+      VersionUpgradePolicy::Upgrade};
+  auto metadata = decoder.DecodeMetadata();
+  metadata.version = kDbnVersion;
+  metadata.symbol_cstr_len = kSymbolCstrLen;
+  // Compress on a background thread so it overlaps with decoding
+  DbnEncoder encoder{
+      metadata,
+      std::unique_ptr<IWritable>{new detail::OutFileStream{job.output_path}},
+      job.output_compression, DbnEncoder::kDefaultBufferSize,
+      job.output_compression == Compression::Zstd};
+  std::uint64_t record_count{};
+  while (true) {
+    const auto batch = decoder.DecodeRecords();
+    if (batch.IsEmpty()) {
+      break;
+    }
+    encoder.EncodeRecords(batch);
+    for (auto it = batch.begin(); it != batch.end(); ++it) {
+      ++record_count;
+    }
+  }
+  encoder.Finish();
+  return record_count;
+}
+
+std::uint64_t DbnTranscoder::Transcode(const std::vector<Job>& jobs) const {
+  std::atomic<std::size_t> next_job{0};
+  std::atomic<bool> has_failed{false};
+  std::atomic<std::uint64_t> record_count{0};
+  std::mutex mutex;
+  std::exception_ptr exception;
+  const auto work = [&] {
+    while (!has_failed.load(std::memory_order_relaxed)) {
+      const auto job_idx = next_job.fetch_add(1);
+      if (job_idx >= jobs.size()) {
+        return;
+      }
+      try {
+        record_count += TranscodeFile(jobs[job_idx]);
+      } catch (...) {
+        const std::lock_guard<std::mutex> lock{mutex};
+        if (!exception) {
+          exception = std::current_exception();
+        }
+        has_failed = true;
+      }
+    }
+  };
+  {
+    // The calling thread is one of the workers
+    const auto worker_count = std::min(thread_count_, jobs.size());
+    std::vector<detail::ScopedThread> threads;
+    for (std::size_t i = 1; i < worker_count; ++i) {
+      threads.emplace_back(work);
+    }
+    work();
+    // Joined on destruction
+  }
+  if (exception) {
+    std::rethrow_exception(exception);
+  }
+  return record_count;
+}
@@ -1,11 +1,13 @@
 #include "databento/detail/file_stream.hpp"
 
-#include <ios>  // ios, streamsize
+#include <ios>  // ios, streamoff, streamsize
 #include <sstream>
+#include <string>  // to_string
 
 #include "databento/exceptions.hpp"
 
 using databento::detail::FileStream;
+using databento::detail::OutFileStream;
 
 FileStream::FileStream(const std::string& file_path)
     : stream_{file_path, std::ios::binary} {
@@ -30,3 +32,39 @@ std::size_t FileStream::ReadSome(std::uint8_t* buffer, std::size_t max_length) {
                static_cast<std::streamsize>(max_length));
   return static_cast<std::size_t>(stream_.gcount());
 }
+
+void FileStream::Seek(std::uint64_t offset) {
+  // Clear any end-of-file state from previous reads
+  stream_.clear();
+  stream_.seekg(static_cast<std::streamoff>(offset));
+  if (stream_.fail()) {
+    throw InvalidArgumentError{"FileStream::Seek", "offset",
+                               "Unable to seek to offset " +
+                                   std::to_string(offset)};
+  }
+}
+
+OutFileStream::OutFileStream(const std::string& file_path)
+    : stream_{file_path, std::ios::binary | std::ios::trunc} {
+  if (stream_.fail()) {
+    throw InvalidArgumentError{"OutFileStream", "file_path",
+                               "Unable to open file for writing"};
+  }
+}
+
+void OutFileStream::WriteAll(const std::uint8_t* buffer, std::size_t length) {
+  stream_.write(reinterpret_cast<const char*>(buffer),
+                static_cast<std::streamsize>(length));
+  if (stream_.fail()) {
+    std::ostringstream err_msg;
+    err_msg << "Failed to write " << length << " bytes to file";
+    throw DbnResponseError{err_msg.str()};
+  }
+}
+
+void OutFileStream::Flush() {
+  stream_.flush();
+  if (stream_.fail()) {
+    throw DbnResponseError{"Failed to flush file"};
+  }
+}
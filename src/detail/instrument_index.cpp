@@ -0,0 +1,70 @@
+#include "databento/detail/instrument_index.hpp"
+
+using databento::detail::InstrumentIndex;
+
+namespace {
+constexpr std::size_t kMinTableCapacity = 16;
+}  // namespace
+
+std::size_t databento::detail::TableCapacity(std::size_t count) {
+  auto res = kMinTableCapacity;
+  while (res * 3 < count * 4) {
+    res *= 2;
+  }
+  return res;
+}
+
+constexpr std::uint32_t InstrumentIndex::kNotFound;
+
+std::uint32_t InstrumentIndex::Find(std::uint64_t instrument_id) const {
+  if (table_.empty()) {
+    return kNotFound;
+  }
+  const auto& slot = table_[FindSlot(instrument_id)];
+  return slot.index_slot == 0 ? kNotFound : slot.index_slot - 1;
+}
+
+std::uint32_t InstrumentIndex::Insert(std::uint64_t instrument_id) {
+  // Keep the load factor at or below 3/4
+  if ((size_ + 1) * 4 > table_.size() * 3) {
+    Rehash(TableCapacity(size_ + 1));
+  }
+  auto& slot = table_[FindSlot(instrument_id)];
+  if (slot.index_slot == 0) {
+    slot.instrument_id = instrument_id;
+    slot.index_slot = static_cast<std::uint32_t>(++size_);
+  }
+  return slot.index_slot - 1;
+}
+
+void InstrumentIndex::Reserve(std::size_t count) {
+  const auto capacity = TableCapacity(count);
+  if (capacity > table_.size()) {
+    Rehash(capacity);
+  }
+}
+
+void InstrumentIndex::Clear() {
+  size_ = 0;
+  table_.clear();
+}
+
+std::size_t InstrumentIndex::FindSlot(std::uint64_t instrument_id) const {
+  const auto mask = table_.size() - 1;
+  auto idx = std::size_t{HashId(instrument_id)} & mask;
+  while (table_[idx].index_slot != 0 &&
+         table_[idx].instrument_id != instrument_id) {
+    idx = (idx + 1) & mask;
+  }
+  return idx;
+}
+
+void InstrumentIndex::Rehash(std::size_t capacity) {
+  std::vector<Slot> prev_table(capacity);
+  prev_table.swap(table_);
+  for (const auto& slot : prev_table) {
+    if (slot.index_slot != 0) {
+      table_[FindSlot(slot.instrument_id)] = slot;
+    }
+  }
+}
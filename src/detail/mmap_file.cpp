@@ -0,0 +1,124 @@
+#include "databento/detail/mmap_file.hpp"
+
+#ifdef _WIN32
+#include <windows.h>  // CreateFileA, CreateFileMappingA, MapViewOfFile
+#else
+#include <fcntl.h>     // open, O_RDONLY
+#include <sys/mman.h>  // madvise, mmap, munmap
+#include <sys/stat.h>  // fstat
+#include <unistd.h>    // close
+#endif
+
+#include <utility>  // swap
+
+#include "databento/exceptions.hpp"
+
+using databento::detail::MmapFile;
+
+namespace {
+constexpr auto kMethodName = "MmapFile::MmapFile";
+}  // namespace
+
+#ifdef _WIN32
+MmapFile::MmapFile(const std::string& file_path) {
+  const HANDLE file =
+      ::CreateFileA(file_path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                    OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    throw InvalidArgumentError{kMethodName, "file_path",
+                               "Non-existent or invalid file"};
+  }
+  LARGE_INTEGER file_size{};
+  if (!::GetFileSizeEx(file, &file_size)) {
+    ::CloseHandle(file);
+    throw InvalidArgumentError{kMethodName, "file_path",
+                               "Unable to determine file size"};
+  }
+  size_ = static_cast<std::size_t>(file_size.QuadPart);
+  if (size_ == 0) {
+    ::CloseHandle(file);
+    return;
+  }
+  // Copy-on-write so records can be modified in place without affecting the
+  // underlying file
+  const HANDLE mapping =
+      ::CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+  ::CloseHandle(file);
+  if (mapping == nullptr) {
+    throw InvalidArgumentError{kMethodName, "file_path",
+                               "Unable to memory map file"};
+  }
+  void* view = ::MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+  // The view keeps a reference to the mapping
+  ::CloseHandle(mapping);
+  if (view == nullptr) {
+    throw InvalidArgumentError{kMethodName, "file_path",
+                               "Unable to memory map file"};
+  }
+  data_ = static_cast<std::uint8_t*>(view);
+}
+
+void MmapFile::Close() {
+  if (data_ != nullptr) {
+    ::UnmapViewOfFile(data_);
+    data_ = nullptr;
+  }
+  size_ = 0;
+}
+#else
+MmapFile::MmapFile(const std::string& file_path) {
+  const int fd = ::open(file_path.c_str(), O_RDONLY);
+  if (fd == -1) {
+    throw InvalidArgumentError{kMethodName, "file_path",
+                               "Non-existent or invalid file"};
+  }
+  struct stat file_stat {};
+  if (::fstat(fd, &file_stat) == -1) {
+    ::close(fd);
+    throw InvalidArgumentError{kMethodName, "file_path",
+                               "Unable to determine file size"};
+  }
+  size_ = static_cast<std::size_t>(file_stat.st_size);
+  if (size_ == 0) {
+    ::close(fd);
+    return;
+  }
+  // Copy-on-write so records can be modified in place without affecting the
+  // underlying file
+  void* addr =
+      ::mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  // The mapping keeps a reference to the file
+  ::close(fd);
+  if (addr == MAP_FAILED) {
+    size_ = 0;
+    throw InvalidArgumentError{kMethodName, "file_path",
+                               "Unable to memory map file"};
+  }
+  // Files are typically decoded front to back, so hint to the kernel to read
+  // ahead aggressively. Failure is harmless.
+  ::madvise(addr, size_, MADV_SEQUENTIAL);
+  data_ = static_cast<std::uint8_t*>(addr);
+}
+
+void MmapFile::Close() {
+  if (data_ != nullptr) {
+    ::munmap(data_, size_);
+    data_ = nullptr;
+  }
+  size_ = 0;
+}
+#endif
+
+MmapFile::MmapFile(MmapFile&& other) noexcept
+    : data_{other.data_}, size_{other.size_} {
+  other.data_ = nullptr;
+  other.size_ = 0;
+}
+
+MmapFile& MmapFile::operator=(MmapFile&& rhs) noexcept {
+  std::swap(data_, rhs.data_);
+  std::swap(size_, rhs.size_);
+  return *this;
+}
+
+MmapFile::~MmapFile() { Close(); }
@@ -0,0 +1,332 @@
+#include "databento/detail/parallel_zstd_stream.hpp"
+
+#include <zstd.h>
+#include <zstd_errors.h>  // ZSTD_getErrorCode
+
+#include <algorithm>  // copy, max, min
+#include <condition_variable>
+#include <deque>
+#include <exception>  // exception
+#include <mutex>
+#include <sstream>  // ostringstream
+#include <string>
+#include <utility>  // move
+
+#include "databento/detail/scoped_thread.hpp"
+#include "databento/detail/zstd_stream.hpp"
+#include "databento/exceptions.hpp"
+
+namespace databento {
+namespace detail {
+namespace {
+// Minimum number of bytes to read from the input at a time
+constexpr std::size_t kMinReadSize = 128 * 1024;
+
+void CheckZstdError(std::size_t result) {
+  if (::ZSTD_isError(result)) {
+    throw DbnResponseError{std::string{"Zstd error decompressing: "} +
+                           ::ZSTD_getErrorName(result)};
+  }
+}
+
+// The largest possible frame header, `ZSTD_FRAMEHEADERSIZE_MAX`, which is
+// only available with `ZSTD_STATIC_LINKING_ONLY`
+constexpr std::size_t kMaxFrameHeaderSize = 18;
+
+// `output` is sized from the content size in the frame header, which
+// `ReadFrame` has already checked.
+void DecompressFrame(ZSTD_DCtx* d_ctx, const std::vector<std::uint8_t>& frame,
+                     std::vector<std::uint8_t>* output) {
+  const auto content_size =
+      ::ZSTD_getFrameContentSize(frame.data(), frame.size());
+  if (content_size == ZSTD_CONTENTSIZE_UNKNOWN ||
+      content_size == ZSTD_CONTENTSIZE_ERROR ||
+      content_size > ParallelZstdStream::kMaxFrameContentSize) {
+    throw DbnResponseError{"Unexpected Zstd frame content size"};
+  }
+  output->resize(static_cast<std::size_t>(content_size));
+  const auto size = ::ZSTD_decompressDCtx(d_ctx, output->data(), output->size(),
+                                          frame.data(), frame.size());
+  CheckZstdError(size);
+  output->resize(size);
+}
+}  // namespace
+
+// Decompresses frames on worker threads while keeping them in the order they
+// were pushed.
+class ParallelZstdStream::Pool {
+ public:
+  explicit Pool(std::size_t thread_count);
+  Pool(const Pool&) = delete;
+  Pool& operator=(const Pool&) = delete;
+  Pool(Pool&&) = delete;
+  Pool& operator=(Pool&&) = delete;
+  ~Pool();
+
+  void Push(std::vector<std::uint8_t>&& frame);
+  std::size_t Size();
+  // Waits for the oldest frame to be decompressed and returns its output.
+  // Returns `nullptr` if there are no frames.
+  const std::vector<std::uint8_t>* WaitFront();
+  void PopFront();
+
+ private:
+  struct Frame {
+    std::vector<std::uint8_t> compressed;
+    std::vector<std::uint8_t> decompressed;
+    std::string error;
+    bool is_done{};
+  };
+
+  void Work();
+
+  // protects all other data members of this class
+  std::mutex mutex_;
+  // notified when a frame is pushed or on shutdown
+  std::condition_variable work_cv_;
+  // notified when a frame has been decompressed
+  std::condition_variable done_cv_;
+  // all frames in flight in the order they were pushed
+  std::deque<std::unique_ptr<Frame>> frames_;
+  // frames yet to be picked up by a worker
+  std::deque<Frame*> jobs_;
+  bool is_shutdown_{};
+  // must be destroyed first
+  std::vector<ScopedThread> threads_;
+};
+
+ParallelZstdStream::Pool::Pool(std::size_t thread_count) {
+  threads_.reserve(thread_count);
+  for (std::size_t i = 0; i < thread_count; ++i) {
+    threads_.emplace_back(&Pool::Work, this);
+  }
+}
+
+ParallelZstdStream::Pool::~Pool() {
+  {
+    const std::lock_guard<std::mutex> lock{mutex_};
+    is_shutdown_ = true;
+  }
+  work_cv_.notify_all();
+  threads_.clear();
+}
+
+void ParallelZstdStream::Pool::Push(std::vector<std::uint8_t>&& frame) {
+  {
+    const std::lock_guard<std::mutex> lock{mutex_};
+    std::unique_ptr<Frame> job{new Frame{}};
+    job->compressed = std::move(frame);
+    jobs_.emplace_back(job.get());
+    frames_.emplace_back(std::move(job));
+  }
+  work_cv_.notify_one();
+}
+
+std::size_t ParallelZstdStream::Pool::Size() {
+  const std::lock_guard<std::mutex> lock{mutex_};
+  return frames_.size();
+}
+
+const std::vector<std::uint8_t>* ParallelZstdStream::Pool::WaitFront() {
+  std::unique_lock<std::mutex> lock{mutex_};
+  if (frames_.empty()) {
+    return nullptr;
+  }
+  const Frame& front = *frames_.front();
+  done_cv_.wait(lock, [&front] { return front.is_done; });
+  if (!front.error.empty()) {
+    throw DbnResponseError{front.error};
+  }
+  return &front.decompressed;
+}
+
+void ParallelZstdStream::Pool::PopFront() {
+  const std::lock_guard<std::mutex> lock{mutex_};
+  frames_.pop_front();
+}
+
+void ParallelZstdStream::Pool::Work() {
+  const std::unique_ptr<ZSTD_DCtx, std::size_t (*)(ZSTD_DCtx*)> d_ctx{
+      ::ZSTD_createDCtx(), ::ZSTD_freeDCtx};
+  while (true) {
+    Frame* frame;
+    {
+      std::unique_lock<std::mutex> lock{mutex_};
+      work_cv_.wait(lock, [this] { return is_shutdown_ || !jobs_.empty(); });
+      if (is_shutdown_) {
+        return;
+      }
+      frame = jobs_.front();
+      jobs_.pop_front();
+    }
+    std::string error;
+    try {
+      DecompressFrame(d_ctx.get(), frame->compressed, &frame->decompressed);
+    } catch (const std::exception& exc) {
+      error = exc.what();
+    }
+    // free memory early
+    frame->compressed = {};
+    {
+      const std::lock_guard<std::mutex> lock{mutex_};
+      frame->error = std::move(error);
+      frame->is_done = true;
+    }
+    done_cv_.notify_one();
+  }
+}
+
+constexpr std::size_t ParallelZstdStream::kMaxFrameContentSize;
+
+ParallelZstdStream::ParallelZstdStream(std::unique_ptr<IReadable> input,
+                                       std::size_t thread_count)
+    : ParallelZstdStream{std::move(input), thread_count, {}} {}
+
+ParallelZstdStream::ParallelZstdStream(std::unique_ptr<IReadable> input,
+                                       std::size_t thread_count,
+                                       std::vector<std::uint8_t>&& in_buffer)
+    : input_{std::move(input)},
+      in_buffer_{std::move(in_buffer)},
+      // Enough to keep every worker busy while the oldest frame is read
+      max_queued_{thread_count * 2} {
+  if (thread_count == 0) {
+    throw InvalidArgumentError{"ParallelZstdStream::ParallelZstdStream",
+                               "thread_count", "Must be at least 1"};
+  }
+  pool_.reset(new Pool{thread_count});
+}
+
+ParallelZstdStream::~ParallelZstdStream() = default;
+
+void ParallelZstdStream::ReadExact(std::uint8_t* buffer, std::size_t length) {
+  std::size_t size{};
+  std::size_t read_size;
+  do {
+    read_size = ReadSome(&buffer[size], length - size);
+    size += read_size;
+  } while (size < length && read_size > 0);
+  // check for end of stream without obtaining `length` bytes
+  if (size < length) {
+    std::ostringstream err_msg;
+    err_msg << "Reached end of Zstd stream without " << length
+            << " bytes, only " << size << " bytes available";
+    throw DbnResponseError{err_msg.str()};
+  }
+}
+
+std::size_t ParallelZstdStream::ReadSome(std::uint8_t* buffer,
+                                         std::size_t max_length) {
+  while (true) {
+    if (stream_) {
+      return stream_->ReadSome(buffer, max_length);
+    }
+    QueueFrames();
+    const auto* output = pool_->WaitFront();
+    if (output == nullptr) {
+      if (!is_unbounded_) {
+        return 0;
+      }
+      // All earlier frames have been read, so continue from the unbounded
+      // frame
+      in_buffer_.erase(
+          in_buffer_.begin(),
+          in_buffer_.begin() + static_cast<std::ptrdiff_t>(in_buffer_pos_));
+      in_buffer_pos_ = 0;
+      stream_.reset(new ZstdStream{std::move(input_), std::move(in_buffer_)});
+      continue;
+    }
+    const auto read_size = std::min(max_length, output->size() - out_pos_);
+    const auto* read_begin = output->data() + out_pos_;
+    std::copy(read_begin, read_begin + read_size, buffer);
+    out_pos_ += read_size;
+    if (out_pos_ == output->size()) {
+      pool_->PopFront();
+      out_pos_ = 0;
+    }
+    // Skippable frames have no output
+    if (read_size > 0 || max_length == 0) {
+      return read_size;
+    }
+  }
+}
+
+void ParallelZstdStream::QueueFrames() {
+  while (!is_input_done_ && pool_->Size() < max_queued_) {
+    std::vector<std::uint8_t> frame;
+    switch (ReadFrame(&frame)) {
+      case FrameResult::Frame: {
+        pool_->Push(std::move(frame));
+        break;
+      }
+      case FrameResult::Unbounded: {
+        is_unbounded_ = true;
+        is_input_done_ = true;
+        return;
+      }
+      case FrameResult::End: {
+        is_input_done_ = true;
+        return;
+      }
+    }
+  }
+}
+
+ParallelZstdStream::FrameResult ParallelZstdStream::ReadFrame(
+    std::vector<std::uint8_t>* frame) {
+  // Check the header before buffering the whole frame
+  while (in_buffer_.size() - in_buffer_pos_ < kMaxFrameHeaderSize &&
+         ReadInput()) {
+  }
+  if (in_buffer_pos_ == in_buffer_.size()) {
+    return FrameResult::End;
+  }
+  const auto content_size =
+      ::ZSTD_getFrameContentSize(&in_buffer_[in_buffer_pos_],
+                                 in_buffer_.size() - in_buffer_pos_);
+  if (content_size == ZSTD_CONTENTSIZE_ERROR) {
+    throw DbnResponseError{"Invalid or incomplete Zstd frame header"};
+  }
+  if (content_size == ZSTD_CONTENTSIZE_UNKNOWN ||
+      content_size > kMaxFrameContentSize) {
+    return FrameResult::Unbounded;
+  }
+  while (true) {
+    const auto* unread = in_buffer_.data() + in_buffer_pos_;
+    const auto unread_size = in_buffer_.size() - in_buffer_pos_;
+    const auto frame_size = ::ZSTD_findFrameCompressedSize(unread, unread_size);
+    if (!::ZSTD_isError(frame_size)) {
+      frame->assign(unread, unread + frame_size);
+      in_buffer_pos_ += frame_size;
+      return FrameResult::Frame;
+    }
+    if (::ZSTD_getErrorCode(frame_size) != ZSTD_error_srcSize_wrong) {
+      throw DbnResponseError{std::string{"Zstd error finding frame: "} +
+                             ::ZSTD_getErrorName(frame_size)};
+    }
+    // A valid frame of this content size can't be larger, but a skippable
+    // frame's payload can be, so bound what's buffered and stream the rest
+    if (unread_size > ::ZSTD_compressBound(kMaxFrameContentSize)) {
+      return FrameResult::Unbounded;
+    }
+    if (!ReadInput()) {
+      throw DbnResponseError{
+          "Reached end of input with an incomplete Zstd frame"};
+    }
+  }
+}
+
+bool ParallelZstdStream::ReadInput() {
+  in_buffer_.erase(
+      in_buffer_.begin(),
+      in_buffer_.begin() + static_cast<std::ptrdiff_t>(in_buffer_pos_));
+  in_buffer_pos_ = 0;
+  const auto unread_size = in_buffer_.size();
+  // Grow geometrically so large frames aren't rescanned too many times
+  const auto read_size = std::max(kMinReadSize, unread_size);
+  in_buffer_.resize(unread_size + read_size);
+  const auto fill_size = input_->ReadSome(&in_buffer_[unread_size], read_size);
+  in_buffer_.resize(unread_size + fill_size);
+  return fill_size > 0;
+}
+}  // namespace detail
+}  // namespace databento
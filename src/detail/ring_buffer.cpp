@@ -0,0 +1,126 @@
+#include "databento/detail/ring_buffer.hpp"
+
+#ifdef __linux__
+#include <sys/mman.h>  // memfd_create, mmap, munmap
+#include <unistd.h>    // close, ftruncate, sysconf
+#endif
+
+#include <algorithm>  // copy
+#include <utility>    // swap
+
+using databento::detail::RingBuffer;
+
+RingBuffer::RingBuffer(std::size_t min_capacity) {
+  const auto page_size = PageSize();
+  capacity_ = (min_capacity + page_size - 1) / page_size * page_size;
+#ifdef __linux__
+  // Map the same anonymous file twice back to back. Any failure falls back to
+  // an unmirrored buffer.
+  const int fd = ::memfd_create("databento-ring-buffer", MFD_CLOEXEC);
+  if (fd != -1) {
+    if (::ftruncate(fd, static_cast<off_t>(capacity_)) == 0) {
+      // Reserve the full address range first so both halves are adjacent
+      void* addr = ::mmap(nullptr, capacity_ * 2, PROT_NONE,
+                          MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (addr != MAP_FAILED) {
+        auto* const base = static_cast<std::uint8_t*>(addr);
+        if (::mmap(base, capacity_, PROT_READ | PROT_WRITE,
+                   MAP_SHARED | MAP_FIXED, fd, 0) != MAP_FAILED &&
+            ::mmap(base + capacity_, capacity_, PROT_READ | PROT_WRITE,
+                   MAP_SHARED | MAP_FIXED, fd, 0) != MAP_FAILED) {
+          mirror_ = base;
+          data_ = base;
+        } else {
+          ::munmap(addr, capacity_ * 2);
+        }
+      }
+    }
+    // The mappings keep a reference to the file
+    ::close(fd);
+  }
+#endif
+  if (mirror_ == nullptr) {
+    storage_.resize(capacity_);
+    data_ = storage_.data();
+  }
+}
+
+RingBuffer::RingBuffer(RingBuffer&& other) noexcept
+    : data_{other.data_},
+      capacity_{other.capacity_},
+      read_pos_{other.read_pos_},
+      write_pos_{other.write_pos_},
+      mirror_{other.mirror_},
+      storage_{std::move(other.storage_)} {
+  other.data_ = nullptr;
+  other.capacity_ = 0;
+  other.read_pos_ = 0;
+  other.write_pos_ = 0;
+  other.mirror_ = nullptr;
+}
+
+RingBuffer& RingBuffer::operator=(RingBuffer&& rhs) noexcept {
+  std::swap(data_, rhs.data_);
+  std::swap(capacity_, rhs.capacity_);
+  std::swap(read_pos_, rhs.read_pos_);
+  std::swap(write_pos_, rhs.write_pos_);
+  std::swap(mirror_, rhs.mirror_);
+  std::swap(storage_, rhs.storage_);
+  return *this;
+}
+
+RingBuffer::~RingBuffer() { Unmap(); }
+
+void RingBuffer::Consume(std::size_t length) {
+  read_pos_ += length;
+  if (mirror_ != nullptr) {
+    // Keep the read position within the first mapping. The write position
+    // may point into the second.
+    if (read_pos_ >= capacity_) {
+      read_pos_ -= capacity_;
+      write_pos_ -= capacity_;
+    }
+  } else if (read_pos_ == write_pos_) {
+    // Nothing to move
+    read_pos_ = 0;
+    write_pos_ = 0;
+  }
+}
+
+std::uint8_t* RingBuffer::WriteBegin() {
+  // Only move unread data once less than half of the buffer remains at the end
+  // so it happens at most once every half buffer
+  if (mirror_ == nullptr && read_pos_ > 0 &&
+      capacity_ - write_pos_ < capacity_ / 2) {
+    std::copy(data_ + read_pos_, data_ + write_pos_, data_);
+    write_pos_ -= read_pos_;
+    read_pos_ = 0;
+  }
+  return data_ + write_pos_;
+}
+
+std::size_t RingBuffer::WritableSize() const {
+  if (mirror_ != nullptr) {
+    return capacity_ - ReadableSize();
+  }
+  return capacity_ - write_pos_;
+}
+
+std::size_t RingBuffer::PageSize() {
+#ifdef __linux__
+  const auto page_size = ::sysconf(_SC_PAGESIZE);
+  if (page_size > 0) {
+    return static_cast<std::size_t>(page_size);
+  }
+#endif
+  return 4096;
+}
+
+void RingBuffer::Unmap() {
+#ifdef __linux__
+  if (mirror_ != nullptr) {
+    ::munmap(mirror_, capacity_ * 2);
+    mirror_ = nullptr;
+  }
+#endif
+}
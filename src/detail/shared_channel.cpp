@@ -1,26 +1,36 @@
 #include "databento/detail/shared_channel.hpp"
 
+#include <algorithm>  // min
+#include <atomic>
 #include <condition_variable>
+#include <cstring>  // memcpy
 #include <memory>
 #include <mutex>
-#include <sstream>  // stringstream
-#include <vector>
+#include <sstream>  // ostringstream
+#include <thread>   // this_thread
 
-#include "databento/exceptions.hpp"  // DbnResponseError
+#include "databento/exceptions.hpp"  // DbnResponseError, InvalidArgumentError
+
+namespace {
+// How many times a thread yields while waiting before it parks
+constexpr std::size_t kSpinCount = 1024;
+}  // namespace
 
 namespace databento {
 namespace detail {
 class SharedChannel::Channel {
  public:
-  Channel() = default;
+  explicit Channel(std::size_t capacity);
   Channel(const Channel&) = delete;
   Channel& operator=(const Channel&) = delete;
   Channel(Channel&&) = delete;
   Channel& operator=(Channel&&) = delete;
-  ~Channel();
+  ~Channel() = default;
 
+  std::size_t Capacity() const { return capacity_; }
   void Write(const std::uint8_t* data, std::size_t length);
   void Finish();
+  void Close();
   // Read exactly `length` bytes
   void ReadExact(std::uint8_t* buffer, std::size_t length);
   // Read at most `length` bytes. Returns the number of bytes read. Will only
@@ -28,21 +38,58 @@ class SharedChannel::Channel {
   std::size_t ReadSome(std::uint8_t* buffer, std::size_t length);
 
  private:
-  std::size_t Size();
-
-  // protects all other data members of this class
-  std::mutex mutex_;
-  // could use eofbit, but seekg clears this
-  bool is_finished_{false};
-  std::condition_variable cv_;
-  std::stringstream stream_;
+  static constexpr std::size_t kCacheLineSize = 64;
+
+  // Writer only. Waits for free space, returning its size, or 0 once the
+  // channel is closed.
+  std::size_t AwaitWritable();
+  // Reader only. Waits for unread data, returning its size, or 0 once the
+  // channel is finished and all data has been read.
+  std::size_t AwaitReadable();
+  // Reader only. Copies out and consumes `length` readable bytes.
+  void Consume(std::uint8_t* buffer, std::size_t length);
+  // Yields until `is_ready` returns true, parking once done spinning.
+  template <typename F>
+  void Await(std::atomic<bool>* is_parked, const F& is_ready);
+  // Wakes the other thread if it's parked. Must be called after publishing
+  // the change it's waiting on.
+  void Unpark(const std::atomic<bool>& is_parked);
+
+  const std::size_t capacity_;
+  std::unique_ptr<std::uint8_t[]> data_;
+  std::atomic<bool> is_finished_{false};
+  std::atomic<bool> is_closed_{false};
+  // Positions only ever increase. Each is written by one thread and padded
+  // onto its own cache line. Padding is used instead of `alignas` because
+  // C++11 `new` doesn't support over-aligned types.
+  std::uint8_t writer_padding_[kCacheLineSize]{};
+  std::atomic<std::uint64_t> write_pos_{};
+  // Writer's last-seen `read_pos_`
+  std::uint64_t cached_read_pos_{};
+  std::uint8_t reader_padding_[kCacheLineSize]{};
+  std::atomic<std::uint64_t> read_pos_{};
+  // Reader's last-seen `write_pos_`
+  std::uint64_t cached_write_pos_{};
+  std::uint8_t end_padding_[kCacheLineSize]{};
+  // Only used by a thread that's done spinning and the thread waking it
+  std::mutex park_mutex_;
+  std::condition_variable park_cv_;
+  std::atomic<bool> is_writer_parked_{false};
+  std::atomic<bool> is_reader_parked_{false};
 };
 }  // namespace detail
 }  // namespace databento
 
 using databento::detail::SharedChannel;
 
-SharedChannel::SharedChannel() : channel_{std::make_shared<Channel>()} {}
+constexpr std::size_t SharedChannel::kDefaultCapacity;
+
+SharedChannel::SharedChannel() : SharedChannel{kDefaultCapacity} {}
+
+SharedChannel::SharedChannel(std::size_t capacity)
+    : channel_{std::make_shared<Channel>(capacity)} {}
+
+std::size_t SharedChannel::Capacity() const { return channel_->Capacity(); }
 
 void SharedChannel::Write(const std::uint8_t* data, std::size_t length) {
   channel_->Write(data, length);
@@ -50,6 +97,8 @@ void SharedChannel::Write(const std::uint8_t* data, std::size_t length) {
 
 void SharedChannel::Finish() { channel_->Finish(); }
 
+void SharedChannel::Close() { channel_->Close(); }
+
 void SharedChannel::ReadExact(std::uint8_t* buffer, std::size_t length) {
   channel_->ReadExact(buffer, length);
 }
@@ -61,54 +110,137 @@ std::size_t SharedChannel::ReadSome(std::uint8_t* buffer,
   return channel_->ReadSome(buffer, max_length);
 }
 
-SharedChannel::Channel::~Channel() { Finish(); }
+SharedChannel::Channel::Channel(std::size_t capacity)
+    : capacity_{capacity}, data_{new std::uint8_t[capacity]} {
+  if (capacity_ == 0) {
+    throw InvalidArgumentError{"SharedChannel::SharedChannel", "capacity",
+                               "Must be greater than 0"};
+  }
+}
 
 void SharedChannel::Channel::Write(const std::uint8_t* data,
                                    std::size_t length) {
-  const std::lock_guard<std::mutex> lock{mutex_};
-  stream_.write(reinterpret_cast<const char*>(data),
-                static_cast<std::streamsize>(length));
-  cv_.notify_one();
+  while (length > 0) {
+    const auto writable = AwaitWritable();
+    if (writable == 0) {
+      return;
+    }
+    const auto write_size = std::min(writable, length);
+    const auto write_pos = write_pos_.load(std::memory_order_relaxed);
+    const std::size_t offset = write_pos % capacity_;
+    const auto first_size = std::min(write_size, capacity_ - offset);
+    std::memcpy(&data_[offset], data, first_size);
+    std::memcpy(&data_[0], data + first_size, write_size - first_size);
+    write_pos_.store(write_pos + write_size, std::memory_order_release);
+    Unpark(is_reader_parked_);
+    data += write_size;
+    length -= write_size;
+  }
 }
 
 void SharedChannel::Channel::Finish() {
-  const std::lock_guard<std::mutex> lock{mutex_};
-  is_finished_ = true;
-  cv_.notify_one();
+  is_finished_.store(true, std::memory_order_release);
+  Unpark(is_reader_parked_);
+}
+
+void SharedChannel::Channel::Close() {
+  is_closed_.store(true, std::memory_order_release);
+  Unpark(is_writer_parked_);
 }
 
 void SharedChannel::Channel::ReadExact(std::uint8_t* buffer,
                                        std::size_t length) {
-  std::unique_lock<std::mutex> lock{mutex_};
-  cv_.wait(lock, [this, length] { return Size() >= length || is_finished_; });
-  if (Size() < length) {
-    std::ostringstream err_msg;
-    err_msg << "Reached end of the stream with only " << Size()
-            << " bytes remaining";
-    throw DbnResponseError{err_msg.str()};
+  // Read in pieces so `length` can exceed the capacity
+  std::size_t read_size{};
+  while (read_size < length) {
+    const auto readable = AwaitReadable();
+    if (readable == 0) {
+      std::ostringstream err_msg;
+      err_msg << "Reached end of the stream with only " << read_size
+              << " bytes remaining";
+      throw DbnResponseError{err_msg.str()};
+    }
+    const auto size = std::min(readable, length - read_size);
+    Consume(buffer + read_size, size);
+    read_size += size;
   }
-  stream_.read(reinterpret_cast<char*>(buffer),
-               static_cast<std::streamsize>(length));
 }
 
 std::size_t SharedChannel::Channel::ReadSome(std::uint8_t* buffer,
                                              std::size_t length) {
-  std::unique_lock<std::mutex> lock{mutex_};
-  cv_.wait(lock, [this] { return Size() > 0 || is_finished_; });
-  if (Size() == 0) {
+  const auto read_size = std::min(AwaitReadable(), length);
+  Consume(buffer, read_size);
+  return read_size;
+}
+
+std::size_t SharedChannel::Channel::AwaitWritable() {
+  const auto write_pos = write_pos_.load(std::memory_order_relaxed);
+  if (write_pos - cached_read_pos_ == capacity_) {
+    cached_read_pos_ = read_pos_.load(std::memory_order_acquire);
+    if (write_pos - cached_read_pos_ == capacity_) {
+      Await(&is_writer_parked_, [this, write_pos] {
+        return write_pos - read_pos_.load(std::memory_order_acquire) <
+                   capacity_ ||
+               is_closed_.load(std::memory_order_acquire);
+      });
+      cached_read_pos_ = read_pos_.load(std::memory_order_acquire);
+    }
+  }
+  if (is_closed_.load(std::memory_order_acquire)) {
     return 0;
   }
-  stream_.read(reinterpret_cast<char*>(buffer),
-               static_cast<std::streamsize>(std::min(Size(), length)));
-  return static_cast<std::size_t>(stream_.gcount());
+  return capacity_ - (write_pos - cached_read_pos_);
+}
+
+std::size_t SharedChannel::Channel::AwaitReadable() {
+  const auto read_pos = read_pos_.load(std::memory_order_relaxed);
+  if (read_pos == cached_write_pos_) {
+    cached_write_pos_ = write_pos_.load(std::memory_order_acquire);
+    if (read_pos == cached_write_pos_) {
+      Await(&is_reader_parked_, [this, read_pos] {
+        return write_pos_.load(std::memory_order_acquire) != read_pos ||
+               is_finished_.load(std::memory_order_acquire);
+      });
+      // Reloaded after `is_finished_` so all writes are visible
+      cached_write_pos_ = write_pos_.load(std::memory_order_acquire);
+    }
+  }
+  return cached_write_pos_ - read_pos;
 }
 
-// lock_ must be held to call this method
-std::size_t SharedChannel::Channel::Size() {
-  const auto pos = stream_.tellg();
-  stream_.seekg(0, std::ios::end);
-  const auto remaining = stream_.tellg() - pos;
-  // reset state
-  stream_.seekg(pos, std::ios::beg);
-  return static_cast<std::size_t>(remaining);
+void SharedChannel::Channel::Consume(std::uint8_t* buffer,
+                                     std::size_t length) {
+  const auto read_pos = read_pos_.load(std::memory_order_relaxed);
+  const std::size_t offset = read_pos % capacity_;
+  const auto first_size = std::min(length, capacity_ - offset);
+  std::memcpy(buffer, &data_[offset], first_size);
+  std::memcpy(buffer + first_size, &data_[0], length - first_size);
+  read_pos_.store(read_pos + length, std::memory_order_release);
+  Unpark(is_writer_parked_);
+}
+
+template <typename F>
+void SharedChannel::Channel::Await(std::atomic<bool>* is_parked,
+                                   const F& is_ready) {
+  for (std::size_t i = 0; i < kSpinCount; ++i) {
+    if (is_ready()) {
+      return;
+    }
+    std::this_thread::yield();
+  }
+  std::unique_lock<std::mutex> lock{park_mutex_};
+  is_parked->store(true, std::memory_order_relaxed);
+  // Pairs with the fence in `Unpark`: either the other thread sees this
+  // thread is parked, or this thread sees the change it's waiting on
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  park_cv_.wait(lock, is_ready);
+  is_parked->store(false, std::memory_order_relaxed);
+}
+
+void SharedChannel::Channel::Unpark(const std::atomic<bool>& is_parked) {
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (is_parked.load(std::memory_order_relaxed)) {
+    const std::lock_guard<std::mutex> lock{park_mutex_};
+    park_cv_.notify_all();
+  }
 }
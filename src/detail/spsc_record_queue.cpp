@@ -0,0 +1,84 @@
+#include "databento/detail/spsc_record_queue.hpp"
+
+#include <cstring>  // memcpy
+#include <string>   // to_string
+
+#include "databento/detail/record_limits.hpp"  // kMaxEncodedRecordLen
+#include "databento/exceptions.hpp"
+
+using databento::detail::SpscRecordQueue;
+
+namespace {
+// A length of 0 is never valid for a record, so it marks the space left at the
+// end of the buffer when a record is stored at the start instead
+constexpr std::uint8_t kWrapMarker = 0;
+}  // namespace
+
+SpscRecordQueue::SpscRecordQueue(std::size_t capacity)
+    : capacity_{SlotSize(capacity)},
+      storage_{new std::uint64_t[capacity_ / 8]},
+      data_{reinterpret_cast<std::uint8_t*>(storage_.get())} {
+  if (capacity_ < 2 * SlotSize(kMaxEncodedRecordLen)) {
+    throw InvalidArgumentError{
+        "SpscRecordQueue::SpscRecordQueue", "capacity",
+        "Must fit at least two records of the maximum length, " +
+            std::to_string(2 * SlotSize(kMaxEncodedRecordLen)) + " bytes"};
+  }
+}
+
+std::size_t SpscRecordQueue::Size() const {
+  const auto read_pos = read_pos_.load(std::memory_order_acquire);
+  const auto write_pos = write_pos_.load(std::memory_order_acquire);
+  return write_pos > read_pos ? write_pos - read_pos : 0;
+}
+
+bool SpscRecordQueue::TryPush(const Record& record) {
+  const auto size = record.Size();
+  const auto slot_size = SlotSize(size);
+  auto write_pos = write_pos_.load(std::memory_order_relaxed);
+  auto offset = write_pos % capacity_;
+  // Space skipped at the end of the buffer
+  const auto skip_size =
+      capacity_ - offset < slot_size ? capacity_ - offset : 0;
+  const auto needed = skip_size + slot_size;
+  if (write_pos + needed - cached_read_pos_ > capacity_) {
+    cached_read_pos_ = read_pos_.load(std::memory_order_acquire);
+    if (write_pos + needed - cached_read_pos_ > capacity_) {
+      return false;
+    }
+  }
+  if (skip_size > 0) {
+    data_[offset] = kWrapMarker;
+    write_pos += skip_size;
+    offset = 0;
+  }
+  std::memcpy(&data_[offset], &record.Header(), size);
+  write_pos_.store(write_pos + slot_size, std::memory_order_release);
+  return true;
+}
+
+const databento::Record* SpscRecordQueue::Front() {
+  auto read_pos = read_pos_.load(std::memory_order_relaxed);
+  if (read_pos == cached_write_pos_) {
+    cached_write_pos_ = write_pos_.load(std::memory_order_acquire);
+    if (read_pos == cached_write_pos_) {
+      return nullptr;
+    }
+  }
+  auto offset = read_pos % capacity_;
+  if (data_[offset] == kWrapMarker) {
+    // The record was stored at the start of the buffer, which the producer
+    // published along with the marker
+    read_pos += capacity_ - offset;
+    read_pos_.store(read_pos, std::memory_order_release);
+    offset = 0;
+  }
+  front_ = Record{reinterpret_cast<RecordHeader*>(&data_[offset])};
+  return &front_;
+}
+
+void SpscRecordQueue::Pop() {
+  const auto read_pos = read_pos_.load(std::memory_order_relaxed);
+  read_pos_.store(read_pos + SlotSize(front_.Size()),
+                  std::memory_order_release);
+}
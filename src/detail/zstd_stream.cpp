@@ -5,6 +5,7 @@
 
 #include "databento/exceptions.hpp"
 
+using databento::detail::ZstdCompressStream;
 using databento::detail::ZstdStream;
 
 ZstdStream::ZstdStream(std::unique_ptr<IReadable> input)
@@ -20,9 +21,14 @@ ZstdStream::ZstdStream(std::unique_ptr<IReadable> input,
 
 void ZstdStream::ReadExact(std::uint8_t* buffer, std::size_t length) {
   std::size_t size{};
-  do {
-    size += ReadSome(&buffer[size], length - size);
-  } while (size < length && read_suggestion_ != 0);
+  while (size < length) {
+    // may continue into the next frame
+    const auto read_size = ReadSome(&buffer[size], length - size);
+    if (read_size == 0) {
+      break;
+    }
+    size += read_size;
+  }
   // check for end of stream without obtaining `length` bytes
   if (size < length) {
     std::ostringstream err_msg;
@@ -64,3 +70,56 @@ size_t ZstdStream::ReadSome(std::uint8_t* buffer, std::size_t max_length) {
   } while (z_out_buffer.pos == 0 && read_size > 0);
   return z_out_buffer.pos;
 }
+
+ZstdCompressStream::ZstdCompressStream(std::unique_ptr<IWritable> output)
+    : ZstdCompressStream{std::move(output), ZSTD_CLEVEL_DEFAULT} {}
+
+ZstdCompressStream::ZstdCompressStream(std::unique_ptr<IWritable> output,
+                                       int compression_level)
+    : output_{std::move(output)},
+      z_cctx_{::ZSTD_createCCtx(), ::ZSTD_freeCCtx},
+      out_buffer_(::ZSTD_CStreamOutSize()) {
+  const auto res = ::ZSTD_CCtx_setParameter(
+      z_cctx_.get(), ZSTD_c_compressionLevel, compression_level);
+  if (::ZSTD_isError(res)) {
+    throw InvalidArgumentError{"ZstdCompressStream::ZstdCompressStream",
+                               "compression_level", ::ZSTD_getErrorName(res)};
+  }
+}
+
+void ZstdCompressStream::WriteAll(const std::uint8_t* buffer,
+                                  std::size_t length) {
+  Compress(buffer, length, ZSTD_e_continue);
+}
+
+void ZstdCompressStream::Flush() {
+  Compress(nullptr, 0, ZSTD_e_flush);
+  output_->Flush();
+}
+
+void ZstdCompressStream::EndFrame() {
+  Compress(nullptr, 0, ZSTD_e_end);
+  output_->Flush();
+}
+
+void ZstdCompressStream::Compress(const std::uint8_t* buffer,
+                                  std::size_t length,
+                                  ZSTD_EndDirective directive) {
+  ZSTD_inBuffer z_in_buffer{buffer, length, 0};
+  std::size_t remaining;
+  do {
+    ZSTD_outBuffer z_out_buffer{out_buffer_.data(), out_buffer_.size(), 0};
+    remaining = ::ZSTD_compressStream2(z_cctx_.get(), &z_out_buffer,
+                                       &z_in_buffer, directive);
+    if (::ZSTD_isError(remaining)) {
+      throw DbnResponseError{std::string{"Zstd error compressing: "} +
+                             ::ZSTD_getErrorName(remaining)};
+    }
+    if (z_out_buffer.pos > 0) {
+      output_->WriteAll(out_buffer_.data(), z_out_buffer.pos);
+    }
+    // With `ZSTD_e_continue`, `remaining` is only a hint and all input has
+    // been consumed once `pos` reaches `size`
+  } while (directive == ZSTD_e_continue ? z_in_buffer.pos < z_in_buffer.size
+                                        : remaining != 0);
+}
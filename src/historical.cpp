@@ -901,15 +901,21 @@ void Historical::TimeseriesGetRange(const HttplibParams& params,
     if (metadata_callback) {
       metadata_callback(std::move(metadata));
     }
-    const Record* record;
-    while ((record = dbn_decoder.DecodeRecord()) != nullptr) {
-      if (record_callback(*record) == KeepGoing::Stop) {
-        should_continue = false;
-        break;
+    RecordBatch batch;
+    while (should_continue &&
+           !(batch = dbn_decoder.DecodeRecords()).IsEmpty()) {
+      for (const Record record : batch) {
+        if (record_callback(record) == KeepGoing::Stop) {
+          should_continue = false;
+          break;
+        }
       }
     }
+    // unblock the stream thread if it's waiting for space in the channel
+    channel.Close();
   } catch (const std::exception& exc) {
     should_continue = false;
+    channel.Close();
     // wait for thread to finish before checking for exceptions
     stream.Join();
     // check if there's an exception from stream thread. Thread safe because
@@ -919,6 +925,13 @@ void Historical::TimeseriesGetRange(const HttplibParams& params,
     }
     // otherwise rethrow original exception
     throw;
+  } catch (...) {
+    // A callback threw something else. The channel must still be closed or
+    // the stream thread could block forever on a full channel while `stream`
+    // joins it.
+    should_continue = false;
+    channel.Close();
+    throw;
   }
 }
 
@@ -4,6 +4,7 @@
 
 #include <algorithm>  // copy
 #include <cctype>     // tolower
+#include <chrono>     // steady_clock
 #include <cstddef>    // ptrdiff_t
 #include <cstdlib>
 #include <ios>  //hex, setfill, setw
@@ -120,29 +121,49 @@ const databento::Record& LiveBlocking::NextRecord() { return *NextRecord({}); }
 
 const databento::Record* LiveBlocking::NextRecord(
     std::chrono::milliseconds timeout) {
-  // need some unread_bytes
-  const auto unread_bytes = buffer_size_ - buffer_idx_;
-  if (unread_bytes == 0) {
-    const auto read_res = FillBuffer(timeout);
+  // Filtered-out records can keep arriving, so each read only waits for the
+  // time remaining
+  const bool has_timeout = timeout.count() != 0;
+  const auto deadline = std::chrono::steady_clock::now() + timeout;
+  // Returns false if the deadline passes before more data is read
+  const auto fill_buffer = [this, has_timeout, deadline] {
+    std::chrono::milliseconds read_timeout{};
+    if (has_timeout) {
+      const auto remaining = deadline - std::chrono::steady_clock::now();
+      if (remaining <= std::chrono::steady_clock::duration::zero()) {
+        return false;
+      }
+      // Round up so a remainder under a millisecond isn't 0, i.e. no timeout
+      read_timeout =
+          std::chrono::duration_cast<std::chrono::milliseconds>(remaining);
+      if (read_timeout < remaining) {
+        ++read_timeout;
+      }
+    }
+    const auto read_res = FillBuffer(read_timeout);
     if (read_res.status == detail::TcpClient::Status::Timeout) {
-      return nullptr;
+      return false;
     }
     if (read_res.status == detail::TcpClient::Status::Closed) {
       throw DbnResponseError{"Gateway closed the session"};
     }
-  }
-  // check length
-  while (buffer_size_ - buffer_idx_ < BufferRecordHeader()->Size()) {
-    const auto read_res = FillBuffer(timeout);
-    if (read_res.status == detail::TcpClient::Status::Timeout) {
+    return true;
+  };
+  do {
+    // need some unread_bytes
+    const auto unread_bytes = buffer_size_ - buffer_idx_;
+    if (unread_bytes == 0 && !fill_buffer()) {
       return nullptr;
     }
-    if (read_res.status == detail::TcpClient::Status::Closed) {
-      throw DbnResponseError{"Gateway closed the session"};
+    // check length
+    while (buffer_size_ - buffer_idx_ < BufferRecordHeader()->Size()) {
+      if (!fill_buffer()) {
+        return nullptr;
+      }
     }
-  }
-  current_record_ = Record{BufferRecordHeader()};
-  buffer_idx_ += current_record_.Size();
+    current_record_ = Record{BufferRecordHeader()};
+    buffer_idx_ += current_record_.Size();
+  } while (IsFilteredOut(current_record_.Header()));
   current_record_ = DbnDecoder::DecodeRecordCompat(
       version_, upgrade_policy_, &compat_buffer_, current_record_);
   return &current_record_;
@@ -150,6 +171,24 @@ const databento::Record* LiveBlocking::NextRecord(
 
 void LiveBlocking::Stop() { client_.Close(); }
 
+bool LiveBlocking::IsFilteredOut(const RecordHeader& header) {
+  if (filter_.IsEmpty()) {
+    return false;
+  }
+  // Gateway errors, heartbeats, and symbol mappings always pass so they're
+  // never silently lost
+  if (header.rtype == RType::Error || header.rtype == RType::System ||
+      header.rtype == RType::SymbolMapping) {
+    return false;
+  }
+  if (filter_.Matches(header)) {
+    ++filter_pass_count_;
+    return false;
+  }
+  ++filter_skip_count_;
+  return true;
+}
+
 void LiveBlocking::Reconnect() {
   client_ = detail::TcpClient{gateway_, port_};
   session_id_ = this->Authenticate();
@@ -0,0 +1,339 @@
+#include "databento/live_recorder.hpp"
+
+#include <atomic>
+#include <chrono>  // milliseconds, nanoseconds, seconds, steady_clock
+#include <deque>
+#include <exception>  // current_exception, exception_ptr, rethrow_exception
+#include <mutex>      // lock_guard, mutex
+#include <sstream>
+#include <string>   // to_string
+#include <thread>   // this_thread
+#include <utility>  // move, swap
+
+#include "databento/constants.hpp"           // kDbnVersion, kSymbolCstrLen
+#include "databento/datetime.hpp"            // UnixNanos
+#include "databento/dbn_encoder.hpp"         // DbnEncoder
+#include "databento/detail/file_stream.hpp"  // OutFileStream
+#include "databento/detail/scoped_thread.hpp"      // ScopedThread
+#include "databento/detail/spsc_record_queue.hpp"  // SpscRecordQueue
+#include "databento/exceptions.hpp"                // InvalidArgumentError
+#include "databento/log.hpp"                       // ILogReceiver, LogLevel
+
+using databento::LiveRecorder;
+
+namespace {
+// How long the writer thread sleeps when the queue is empty
+constexpr std::chrono::milliseconds kPollInterval{1};
+// How often the writer thread flushes the current file while it's idle
+constexpr std::chrono::seconds kFlushInterval{1};
+}  // namespace
+
+struct LiveRecorder::Impl {
+  struct MetadataChange {
+    // The number of records pushed before the metadata was received
+    std::uint64_t record_index;
+    Metadata metadata;
+  };
+
+  Impl(ILogReceiver* receiver, std::string prefix, Compression compress,
+       std::uint64_t file_size_limit, std::chrono::nanoseconds file_duration,
+       std::size_t queue_capacity)
+      : log_receiver{receiver},
+        path_prefix{std::move(prefix)},
+        compression{compress},
+        max_file_size{file_size_limit},
+        max_file_duration{file_duration},
+        queue{queue_capacity} {}
+
+  void Push(const Record& record);
+  void Write();
+  void ApplyMetadataChanges();
+  void WriteRecord(const Record& record);
+  bool ShouldRotate(const Record& record, UnixNanos index_ts) const;
+  void StartFile(UnixNanos index_ts);
+  void FinishFile();
+
+  ILogReceiver* log_receiver;
+  const std::string path_prefix;
+  const Compression compression;
+  const std::uint64_t max_file_size;
+  const std::chrono::nanoseconds max_file_duration;
+  detail::SpscRecordQueue queue;
+
+  // Only accessed by the receiving thread
+  bool has_metadata{};
+  std::uint64_t pushed_count{};
+
+  // Counters
+  std::atomic<std::uint64_t> record_count{};
+  std::atomic<std::uint64_t> dropped_count{};
+  std::atomic<std::size_t> max_queue_depth{};
+
+  // Set when the writer thread should stop once the queue is empty
+  std::atomic<bool> is_stopping{};
+  // Set when the writer thread stopped due to an exception
+  std::atomic<bool> is_failed{};
+  // Incremented after a change is queued so the writer thread only needs to
+  // lock `mutex` when there's a change
+  std::atomic<std::size_t> metadata_change_count{};
+  // protects `metadata_changes`, `file_paths`, and `exception_ptr`
+  mutable std::mutex mutex;
+  std::deque<MetadataChange> metadata_changes;
+  std::vector<std::string> file_paths;
+  std::exception_ptr exception_ptr{};
+
+  // Only accessed by the writer thread
+  std::size_t applied_change_count{};
+  std::uint64_t popped_count{};
+  Metadata metadata{};
+  std::unique_ptr<DbnEncoder> encoder;
+  std::uint64_t file_size{};
+  std::uint64_t file_record_count{};
+  UnixNanos file_end{};
+  bool has_unflushed{};
+  std::chrono::steady_clock::time_point last_flush{};
+
+  // Must be destroyed first
+  detail::ScopedThread thread;
+};
+
+void LiveRecorder::Impl::Push(const Record& record) {
+  if (!has_metadata || is_stopping.load(std::memory_order_relaxed) ||
+      is_failed.load(std::memory_order_relaxed) || !queue.TryPush(record)) {
+    dropped_count.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  ++pushed_count;
+  // Only this thread writes `max_queue_depth`
+  const auto depth = queue.Size();
+  if (depth > max_queue_depth.load(std::memory_order_relaxed)) {
+    max_queue_depth.store(depth, std::memory_order_relaxed);
+  }
+}
+
+void LiveRecorder::Impl::Write() {
+  try {
+    while (true) {
+      const Record* record = queue.Front();
+      if (record == nullptr) {
+        if (is_stopping.load(std::memory_order_acquire)) {
+          // Check again in case records were pushed right before stopping
+          record = queue.Front();
+          if (record == nullptr) {
+            break;
+          }
+        } else {
+          const auto now = std::chrono::steady_clock::now();
+          if (has_unflushed && now - last_flush >= kFlushInterval) {
+            encoder->Flush();
+            has_unflushed = false;
+            last_flush = now;
+          }
+          std::this_thread::sleep_for(kPollInterval);
+          continue;
+        }
+      }
+      if (metadata_change_count.load(std::memory_order_acquire) >
+          applied_change_count) {
+        ApplyMetadataChanges();
+      }
+      WriteRecord(*record);
+      queue.Pop();
+      ++popped_count;
+    }
+    FinishFile();
+  } catch (...) {
+    is_failed.store(true, std::memory_order_relaxed);
+    {
+      const std::lock_guard<std::mutex> lock{mutex};
+      exception_ptr = std::current_exception();
+    }
+    try {
+      std::rethrow_exception(exception_ptr);
+    } catch (const std::exception& exc) {
+      std::ostringstream log_ss;
+      log_ss << "[LiveRecorder::Write] Stopped recording after exception: "
+             << exc.what();
+      log_receiver->Receive(LogLevel::Error, log_ss.str());
+    } catch (...) {
+      log_receiver->Receive(
+          LogLevel::Error,
+          "[LiveRecorder::Write] Stopped recording after unknown exception");
+    }
+  }
+}
+
+void LiveRecorder::Impl::ApplyMetadataChanges() {
+  while (true) {
+    Metadata next;
+    {
+      const std::lock_guard<std::mutex> lock{mutex};
+      if (metadata_changes.empty() ||
+          metadata_changes.front().record_index > popped_count) {
+        return;
+      }
+      next = std::move(metadata_changes.front().metadata);
+      metadata_changes.pop_front();
+    }
+    // Not holding the lock so the receiving thread isn't blocked on writing
+    FinishFile();
+    metadata = std::move(next);
+    ++applied_change_count;
+  }
+}
+
+void LiveRecorder::Impl::WriteRecord(const Record& record) {
+  const auto index_ts = record.IndexTs();
+  if (encoder && ShouldRotate(record, index_ts)) {
+    FinishFile();
+  }
+  if (!encoder) {
+    StartFile(index_ts);
+  }
+  encoder->EncodeRecord(record);
+  file_size += record.Size();
+  ++file_record_count;
+  has_unflushed = true;
+  record_count.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool LiveRecorder::Impl::ShouldRotate(const Record& record,
+                                      UnixNanos index_ts) const {
+  return (max_file_size > 0 && file_record_count > 0 &&
+          file_size + record.Size() > max_file_size) ||
+         (max_file_duration.count() > 0 && index_ts >= file_end);
+}
+
+void LiveRecorder::Impl::StartFile(UnixNanos index_ts) {
+  std::string file_path =
+      path_prefix + '.' + std::to_string(file_paths.size()) + ".dbn";
+  if (compression == Compression::Zstd) {
+    file_path += ".zst";
+  }
+  Metadata file_metadata = metadata;
+  file_metadata.start = index_ts;
+  if (max_file_duration.count() > 0) {
+    const auto duration =
+        static_cast<std::uint64_t>(max_file_duration.count());
+    const auto window_end =
+        (index_ts.time_since_epoch().count() / duration + 1) * duration;
+    file_end = UnixNanos{UnixNanos::duration{window_end}};
+    file_metadata.end = file_end;
+  }
+  encoder.reset(new DbnEncoder{
+      file_metadata,
+      std::unique_ptr<IWritable>{new detail::OutFileStream{file_path}},
+      compression});
+  file_size = DbnEncoder::EncodeMetadata(file_metadata).size();
+  file_record_count = 0;
+  const std::lock_guard<std::mutex> lock{mutex};
+  file_paths.emplace_back(std::move(file_path));
+}
+
+void LiveRecorder::Impl::FinishFile() {
+  if (encoder) {
+    encoder->Finish();
+    encoder.reset();
+    has_unflushed = false;
+  }
+}
+
+LiveRecorder::LiveRecorder(ILogReceiver* log_receiver, std::string path_prefix,
+                           Compression compression)
+    : LiveRecorder{log_receiver,
+                   std::move(path_prefix),
+                   compression,
+                   0,
+                   std::chrono::nanoseconds{},
+                   kDefaultQueueCapacity} {}
+
+LiveRecorder::LiveRecorder(ILogReceiver* log_receiver, std::string path_prefix,
+                           Compression compression,
+                           std::uint64_t max_file_size,
+                           std::chrono::nanoseconds max_file_duration,
+                           std::size_t queue_capacity)
+    : impl_{new Impl{log_receiver, std::move(path_prefix), compression,
+                     max_file_size, max_file_duration, queue_capacity}} {
+  if (log_receiver == nullptr) {
+    throw InvalidArgumentError{"LiveRecorder::LiveRecorder", "log_receiver",
+                               "Must not be null"};
+  }
+  // Safe to pass raw pointer because the thread cannot outlive `impl_`
+  impl_->thread = detail::ScopedThread{&Impl::Write, impl_.get()};
+}
+
+LiveRecorder::~LiveRecorder() {
+  try {
+    Stop();
+  } catch (...) {
+  }
+}
+
+void LiveRecorder::Start(LiveThreaded* client) {
+  const auto upgrade_policy = client->UpgradePolicy();
+  client->Start(
+      [this, upgrade_policy](Metadata&& metadata) {
+        if (upgrade_policy == VersionUpgradePolicy::Upgrade &&
+            metadata.version < kDbnVersion) {
+          metadata.version = kDbnVersion;
+          metadata.symbol_cstr_len = kSymbolCstrLen;
+        }
+        OnMetadata(std::move(metadata));
+      },
+      [this](const Record& record) { return OnRecord(record); });
+}
+
+void LiveRecorder::OnMetadata(Metadata metadata) {
+  {
+    const std::lock_guard<std::mutex> lock{impl_->mutex};
+    impl_->metadata_changes.emplace_back(
+        Impl::MetadataChange{impl_->pushed_count, std::move(metadata)});
+  }
+  impl_->metadata_change_count.fetch_add(1, std::memory_order_release);
+  impl_->has_metadata = true;
+}
+
+databento::KeepGoing LiveRecorder::OnRecord(const Record& record) {
+  impl_->Push(record);
+  return KeepGoing::Continue;
+}
+
+void LiveRecorder::Stop() {
+  impl_->is_stopping.store(true, std::memory_order_release);
+  if (impl_->thread.Joinable()) {
+    impl_->thread.Join();
+  }
+  // Now the only consumer. Count any records pushed after the writer thread
+  // stopped or failed.
+  while (impl_->queue.Front() != nullptr) {
+    impl_->queue.Pop();
+    impl_->dropped_count.fetch_add(1, std::memory_order_relaxed);
+  }
+  std::exception_ptr exception_ptr{};
+  {
+    const std::lock_guard<std::mutex> lock{impl_->mutex};
+    std::swap(exception_ptr, impl_->exception_ptr);
+  }
+  if (exception_ptr) {
+    std::rethrow_exception(exception_ptr);
+  }
+}
+
+std::uint64_t LiveRecorder::RecordCount() const {
+  return impl_->record_count.load(std::memory_order_relaxed);
+}
+
+std::uint64_t LiveRecorder::DroppedCount() const {
+  return impl_->dropped_count.load(std::memory_order_relaxed);
+}
+
+std::size_t LiveRecorder::QueueDepth() const { return impl_->queue.Size(); }
+
+std::size_t LiveRecorder::MaxQueueDepth() const {
+  return impl_->max_queue_depth.load(std::memory_order_relaxed);
+}
+
+std::vector<std::string> LiveRecorder::FilePaths() const {
+  const std::lock_guard<std::mutex> lock{impl_->mutex};
+  return impl_->file_paths;
+}
@@ -0,0 +1,387 @@
+#include "databento/mbo_book.hpp"
+
+#include <algorithm>  // fill, lower_bound, max, min
+#include <limits>     // numeric_limits
+
+#include "databento/constants.hpp"                // kUndefPrice
+#include "databento/detail/instrument_index.hpp"  // HashId
+#include "databento/flag_set.hpp"
+
+using databento::MboBook;
+using databento::MboBookEngine;
+
+namespace {
+constexpr std::uint32_t kNoIndex = std::numeric_limits<std::uint32_t>::max();
+constexpr std::size_t kMinTableCapacity = 64;
+
+bool HasFlag(databento::FlagSet flags, databento::FlagSet::Repr flag) {
+  return (flags & flag).Any();
+}
+
+databento::BidAskPair EmptyLevel() {
+  return databento::BidAskPair{
+      databento::kUndefPrice, databento::kUndefPrice, 0, 0, 0, 0};
+}
+}  // namespace
+
+void MboBook::Apply(const MboMsg& mbo) {
+  last_update_ = mbo.ts_recv;
+  switch (mbo.action) {
+    case Action::Add: {
+      Add(mbo);
+      break;
+    }
+    case Action::Cancel: {
+      Cancel(mbo);
+      break;
+    }
+    case Action::Modify: {
+      Modify(mbo);
+      break;
+    }
+    case Action::Clear: {
+      Clear();
+      break;
+    }
+    // Trades and fills are followed by cancels of the filled orders
+    case Action::Trade:  // fallthrough
+    case Action::Fill:   // fallthrough
+    default: {
+      break;
+    }
+  }
+  is_consistent_ = HasFlag(mbo.flags, FlagSet::kLast);
+  if (HasFlag(mbo.flags, FlagSet::kSnapshot)) {
+    in_snapshot_ = !is_consistent_;
+  }
+}
+
+void MboBook::Clear() {
+  order_count_ = 0;
+  bids_.clear();
+  asks_.clear();
+  orders_.clear();
+  free_orders_.clear();
+  levels_.clear();
+  free_levels_.clear();
+  std::fill(order_table_.begin(), order_table_.end(), OrderSlot{});
+}
+
+databento::BidAskPair MboBook::Bbo() const {
+  BidAskPair res;
+  Snapshot(&res, 1);
+  return res;
+}
+
+std::size_t MboBook::Snapshot(BidAskPair* levels,
+                              std::size_t level_count) const {
+  const auto bid_count = std::min(level_count, bids_.size());
+  const auto ask_count = std::min(level_count, asks_.size());
+  for (std::size_t i = 0; i < level_count; ++i) {
+    auto& pair = levels[i];
+    pair = EmptyLevel();
+    if (i < bid_count) {
+      const auto& level = levels_[bids_[bids_.size() - 1 - i].level];
+      pair.bid_px = level.price;
+      pair.bid_sz = level.size;
+      pair.bid_ct = level.count;
+    }
+    if (i < ask_count) {
+      const auto& level = levels_[asks_[asks_.size() - 1 - i].level];
+      pair.ask_px = level.price;
+      pair.ask_sz = level.size;
+      pair.ask_ct = level.count;
+    }
+  }
+  return std::max(bid_count, ask_count);
+}
+
+std::vector<databento::BidAskPair> MboBook::Snapshot(
+    std::size_t level_count) const {
+  std::vector<BidAskPair> res(level_count);
+  Snapshot(res.data(), level_count);
+  return res;
+}
+
+void MboBook::Add(const MboMsg& mbo) {
+  if (mbo.side != Side::Bid && mbo.side != Side::Ask) {
+    return;
+  }
+  if (HasFlag(mbo.flags, FlagSet::kTob)) {
+    // The new top of book; an undefined price means the side is empty
+    ClearSide(mbo.side);
+    if (mbo.price != kUndefPrice) {
+      NewOrder(mbo.order_id, mbo.side, mbo.price, mbo.size);
+      ++order_count_;
+    }
+    return;
+  }
+  const auto order_idx = FindOrder(mbo.order_id);
+  if (order_idx != kNoIndex) {
+    // Duplicate add
+    RemoveOrder(order_idx);
+  }
+  AddOrder(mbo.order_id, mbo.side, mbo.price, mbo.size);
+}
+
+void MboBook::Cancel(const MboMsg& mbo) {
+  const auto order_idx = FindOrder(mbo.order_id);
+  if (order_idx == kNoIndex) {
+    return;
+  }
+  auto& order = orders_[order_idx];
+  if (mbo.size >= order.size) {
+    RemoveOrder(order_idx);
+  } else {
+    order.size -= mbo.size;
+    levels_[order.level].size -= mbo.size;
+  }
+}
+
+void MboBook::Modify(const MboMsg& mbo) {
+  const auto order_idx = FindOrder(mbo.order_id);
+  if (order_idx == kNoIndex) {
+    // Modifying an order from before the start of the data
+    if (mbo.side == Side::Bid || mbo.side == Side::Ask) {
+      AddOrder(mbo.order_id, mbo.side, mbo.price, mbo.size);
+    }
+    return;
+  }
+  auto& order = orders_[order_idx];
+  auto& level = levels_[order.level];
+  if (mbo.size == 0) {
+    RemoveOrder(order_idx);
+  } else if (level.price != mbo.price) {
+    // Loses priority
+    const auto side = level.side;
+    RemoveOrder(order_idx);
+    AddOrder(mbo.order_id, side, mbo.price, mbo.size);
+  } else if (mbo.size > order.size) {
+    // Loses priority
+    level.size += mbo.size - order.size;
+    order.size = mbo.size;
+    const auto level_idx = order.level;
+    UnlinkOrder(order_idx);
+    LinkOrder(order_idx, level_idx);
+  } else {
+    level.size -= order.size - mbo.size;
+    order.size = mbo.size;
+  }
+}
+
+void MboBook::ClearSide(Side side) {
+  auto& side_levels = SideLevels(side);
+  while (!side_levels.empty()) {
+    // Removing the last order removes the level
+    const auto& level = levels_[side_levels.back().level];
+    RemoveOrder(level.head);
+  }
+}
+
+void MboBook::AddOrder(std::uint64_t order_id, Side side, std::int64_t price,
+                       std::uint32_t size) {
+  const auto order_idx = NewOrder(order_id, side, price, size);
+  orders_[order_idx].is_indexed = true;
+  InsertOrderSlot(order_id, order_idx);
+  ++order_count_;
+}
+
+std::uint32_t MboBook::NewOrder(std::uint64_t order_id, Side side,
+                                std::int64_t price, std::uint32_t size) {
+  const auto level_idx = FindOrInsertLevel(side, price);
+  std::uint32_t order_idx;
+  if (free_orders_.empty()) {
+    order_idx = static_cast<std::uint32_t>(orders_.size());
+    orders_.emplace_back();
+  } else {
+    order_idx = free_orders_.back();
+    free_orders_.pop_back();
+  }
+  auto& order = orders_[order_idx];
+  order.order_id = order_id;
+  order.size = size;
+  order.is_indexed = false;
+  LinkOrder(order_idx, level_idx);
+  levels_[level_idx].size += size;
+  return order_idx;
+}
+
+void MboBook::RemoveOrder(std::uint32_t order_idx) {
+  const auto& order = orders_[order_idx];
+  const auto level_idx = order.level;
+  auto& level = levels_[level_idx];
+  level.size -= order.size;
+  if (order.is_indexed) {
+    EraseOrderSlot(order.order_id);
+  }
+  UnlinkOrder(order_idx);
+  free_orders_.push_back(order_idx);
+  --order_count_;
+  if (level.count == 0) {
+    RemoveLevel(level_idx);
+  }
+}
+
+void MboBook::LinkOrder(std::uint32_t order_idx, std::uint32_t level_idx) {
+  auto& level = levels_[level_idx];
+  auto& order = orders_[order_idx];
+  order.level = level_idx;
+  order.prev = level.tail;
+  order.next = kNoIndex;
+  if (level.tail == kNoIndex) {
+    level.head = order_idx;
+  } else {
+    orders_[level.tail].next = order_idx;
+  }
+  level.tail = order_idx;
+  ++level.count;
+}
+
+void MboBook::UnlinkOrder(std::uint32_t order_idx) {
+  const auto& order = orders_[order_idx];
+  auto& level = levels_[order.level];
+  if (order.prev == kNoIndex) {
+    level.head = order.next;
+  } else {
+    orders_[order.prev].next = order.next;
+  }
+  if (order.next == kNoIndex) {
+    level.tail = order.prev;
+  } else {
+    orders_[order.next].prev = order.prev;
+  }
+  --level.count;
+}
+
+std::uint32_t MboBook::FindOrInsertLevel(Side side, std::int64_t price) {
+  auto& side_levels = SideLevels(side);
+  // Bids ascending and asks descending so the best price is at the back
+  const auto it =
+      side == Side::Bid
+          ? std::lower_bound(side_levels.begin(), side_levels.end(), price,
+                             [](const LevelRef& ref, std::int64_t px) {
+                               return ref.price < px;
+                             })
+          : std::lower_bound(side_levels.begin(), side_levels.end(), price,
+                             [](const LevelRef& ref, std::int64_t px) {
+                               return ref.price > px;
+                             });
+  if (it != side_levels.end() && it->price == price) {
+    return it->level;
+  }
+  std::uint32_t level_idx;
+  if (free_levels_.empty()) {
+    level_idx = static_cast<std::uint32_t>(levels_.size());
+    levels_.emplace_back();
+  } else {
+    level_idx = free_levels_.back();
+    free_levels_.pop_back();
+  }
+  levels_[level_idx] = Level{price, 0, 0, kNoIndex, kNoIndex, side};
+  side_levels.insert(it, LevelRef{price, level_idx});
+  return level_idx;
+}
+
+void MboBook::RemoveLevel(std::uint32_t level_idx) {
+  const auto& level = levels_[level_idx];
+  auto& side_levels = SideLevels(level.side);
+  // Search from the back since most changes are near the top of the book
+  for (auto it = side_levels.end(); it != side_levels.begin();) {
+    --it;
+    if (it->level == level_idx) {
+      side_levels.erase(it);
+      break;
+    }
+  }
+  free_levels_.push_back(level_idx);
+}
+
+std::uint32_t MboBook::FindOrder(std::uint64_t order_id) const {
+  if (order_table_.empty()) {
+    return kNoIndex;
+  }
+  const auto slot = order_table_[FindOrderSlot(order_id)].order_slot;
+  return slot == 0 ? kNoIndex : slot - 1;
+}
+
+std::size_t MboBook::FindOrderSlot(std::uint64_t order_id) const {
+  const auto mask = order_table_.size() - 1;
+  auto idx = std::size_t{detail::HashId(order_id)} & mask;
+  while (order_table_[idx].order_slot != 0 &&
+         order_table_[idx].order_id != order_id) {
+    idx = (idx + 1) & mask;
+  }
+  return idx;
+}
+
+void MboBook::InsertOrderSlot(std::uint64_t order_id,
+                              std::uint32_t order_idx) {
+  // Keep the load factor at or below 3/4
+  if ((order_count_ + 1) * 4 > order_table_.size() * 3) {
+    RehashOrders(order_table_.empty() ? kMinTableCapacity
+                                      : order_table_.size() * 2);
+  }
+  order_table_[FindOrderSlot(order_id)] = OrderSlot{order_id, order_idx + 1};
+}
+
+void MboBook::EraseOrderSlot(std::uint64_t order_id) {
+  const auto mask = order_table_.size() - 1;
+  auto hole = FindOrderSlot(order_id);
+  if (order_table_[hole].order_slot == 0) {
+    return;
+  }
+  // Shift back later entries of the probe sequence so lookups don't stop at
+  // the hole
+  for (auto idx = (hole + 1) & mask; order_table_[idx].order_slot != 0;
+       idx = (idx + 1) & mask) {
+    const auto home =
+        std::size_t{detail::HashId(order_table_[idx].order_id)} & mask;
+    if (((idx - home) & mask) >= ((idx - hole) & mask)) {
+      order_table_[hole] = order_table_[idx];
+      hole = idx;
+    }
+  }
+  order_table_[hole] = OrderSlot{};
+}
+
+void MboBook::RehashOrders(std::size_t capacity) {
+  std::vector<OrderSlot> prev_table(capacity);
+  prev_table.swap(order_table_);
+  for (const auto& slot : prev_table) {
+    if (slot.order_slot != 0) {
+      order_table_[FindOrderSlot(slot.order_id)] = slot;
+    }
+  }
+}
+
+const MboBook& MboBookEngine::Apply(const MboMsg& mbo) {
+  auto& book = books_[Key(mbo.hd.instrument_id, mbo.hd.publisher_id)];
+  book.Apply(mbo);
+  return book;
+}
+
+void MboBookEngine::OnRecord(const Record& record) {
+  if (record.Holds<MboMsg>()) {
+    Apply(record.Get<MboMsg>());
+  }
+}
+
+const MboBook* MboBookEngine::Find(std::uint32_t instrument_id,
+                                   std::uint16_t publisher_id) const {
+  const auto it = books_.find(Key(instrument_id, publisher_id));
+  return it == books_.end() ? nullptr : &it->second;
+}
+
+databento::RecordCallback MboBookEngine::Bind(BookCallback callback) {
+  return [this, callback](const Record& record) {
+    if (!record.Holds<MboMsg>()) {
+      return KeepGoing::Continue;
+    }
+    const auto& mbo = record.Get<MboMsg>();
+    const auto& book = Apply(mbo);
+    if (!book.IsConsistent()) {
+      return KeepGoing::Continue;
+    }
+    return callback(mbo, book);
+  };
+}
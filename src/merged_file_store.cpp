@@ -0,0 +1,212 @@
+#include "databento/merged_file_store.hpp"
+
+#include <algorithm>  // make_heap, pop_heap, push_heap
+#include <atomic>
+#include <cstdint>
+#include <exception>  // current_exception, exception_ptr, rethrow_exception
+
+#include "databento/dbn_decoder.hpp"               // DbnDecoder
+#include "databento/detail/file_stream.hpp"        // FileStream
+#include "databento/detail/scoped_thread.hpp"      // ScopedThread
+#include "databento/detail/spin_wait.hpp"          // Wait
+#include "databento/detail/spsc_record_queue.hpp"  // SpscRecordQueue
+#include "databento/exceptions.hpp"                // InvalidArgumentError
+#include "databento/ireadable.hpp"                 // IReadable
+
+using databento::MergedFileStore;
+
+namespace {
+std::uint64_t IndexTs(const databento::Record& record) {
+  return record.IndexTs().time_since_epoch().count();
+}
+}  // namespace
+
+struct MergedFileStore::Impl {
+  struct Source {
+    Source(const std::string& path, VersionUpgradePolicy upgrade_policy,
+           std::size_t queue_capacity)
+        : file_path{path},
+          decoder{std::unique_ptr<IReadable>{new detail::FileStream{path}},
+                  upgrade_policy},
+          metadata{decoder.DecodeMetadata()},
+          queue{queue_capacity} {}
+
+    const std::string file_path;
+    DbnDecoder decoder;
+    const Metadata metadata;
+    detail::SpscRecordQueue queue;
+    // Set by the reader thread once it won't push any more records
+    std::atomic<bool> is_done{};
+    // Only accessed by the replaying thread once `is_done` is set
+    std::exception_ptr exception_ptr{};
+    // Must be destroyed first
+    detail::ScopedThread thread;
+  };
+
+  struct HeapEntry {
+    std::uint64_t index_ts;
+    std::size_t file_idx;
+  };
+
+  ~Impl() { Stop(); }
+
+  void Read(Source* source);
+  bool Push(Source* source, const Record& record);
+  // Waits for the next record from `source`. Returns `nullptr` once all its
+  // records have been replayed.
+  const Record* Front(Source& source);
+  void Stop();
+
+  // Set when the reader threads should stop early
+  std::atomic<bool> is_stopping{};
+  std::vector<std::unique_ptr<Source>> sources;
+};
+
+void MergedFileStore::Impl::Read(Source* source) {
+  try {
+    RecordBatch batch;
+    while (!is_stopping.load(std::memory_order_relaxed) &&
+           !(batch = source->decoder.DecodeRecords()).IsEmpty()) {
+      for (const Record record : batch) {
+        if (!Push(source, record)) {
+          break;
+        }
+      }
+    }
+  } catch (...) {
+    source->exception_ptr = std::current_exception();
+  }
+  source->is_done.store(true, std::memory_order_release);
+}
+
+bool MergedFileStore::Impl::Push(Source* source, const Record& record) {
+  std::size_t wait_count{};
+  while (!source->queue.TryPush(record)) {
+    if (is_stopping.load(std::memory_order_relaxed)) {
+      return false;
+    }
+    detail::Wait(&wait_count);
+  }
+  return true;
+}
+
+const databento::Record* MergedFileStore::Impl::Front(Source& source) {
+  std::size_t wait_count{};
+  while (true) {
+    const Record* record = source.queue.Front();
+    if (record != nullptr) {
+      return record;
+    }
+    if (source.is_done.load(std::memory_order_acquire)) {
+      // Check again in case records were pushed right before finishing
+      record = source.queue.Front();
+      if (record == nullptr && source.exception_ptr) {
+        Stop();
+        std::rethrow_exception(source.exception_ptr);
+      }
+      return record;
+    }
+    detail::Wait(&wait_count);
+  }
+}
+
+void MergedFileStore::Impl::Stop() {
+  is_stopping.store(true, std::memory_order_relaxed);
+  for (auto& source : sources) {
+    if (source->thread.Joinable()) {
+      source->thread.Join();
+    }
+  }
+}
+
+constexpr std::size_t MergedFileStore::kDefaultQueueCapacity;
+
+MergedFileStore::MergedFileStore(const std::vector<std::string>& file_paths)
+    : MergedFileStore{file_paths, VersionUpgradePolicy::AsIs,
+                      kDefaultQueueCapacity} {}
+
+MergedFileStore::MergedFileStore(const std::vector<std::string>& file_paths,
+                                 VersionUpgradePolicy upgrade_policy)
+    : MergedFileStore{file_paths, upgrade_policy, kDefaultQueueCapacity} {}
+
+MergedFileStore::MergedFileStore(const std::vector<std::string>& file_paths,
+                                 VersionUpgradePolicy upgrade_policy,
+                                 std::size_t queue_capacity)
+    : impl_{new Impl{}} {
+  if (file_paths.empty()) {
+    throw InvalidArgumentError{"MergedFileStore::MergedFileStore",
+                               "file_paths", "Must not be empty"};
+  }
+  impl_->sources.reserve(file_paths.size());
+  for (const auto& file_path : file_paths) {
+    impl_->sources.emplace_back(
+        new Impl::Source{file_path, upgrade_policy, queue_capacity});
+  }
+}
+
+MergedFileStore::MergedFileStore(MergedFileStore&&) noexcept = default;
+MergedFileStore& MergedFileStore::operator=(MergedFileStore&&) noexcept =
+    default;
+MergedFileStore::~MergedFileStore() = default;
+
+std::size_t MergedFileStore::FileCount() const {
+  return impl_->sources.size();
+}
+
+const std::string& MergedFileStore::FilePath(std::size_t file_idx) const {
+  return impl_->sources[file_idx]->file_path;
+}
+
+const databento::Metadata& MergedFileStore::FileMetadata(
+    std::size_t file_idx) const {
+  return impl_->sources[file_idx]->metadata;
+}
+
+void MergedFileStore::Replay(const MergedRecordCallback& record_callback) {
+  auto& sources = impl_->sources;
+  for (auto& source : sources) {
+    // Safe to pass raw pointers because the threads cannot outlive `impl_`
+    source->thread =
+        detail::ScopedThread{&Impl::Read, impl_.get(), source.get()};
+  }
+  // Orders the heap so the earliest record is at the front
+  const auto is_later = [](const Impl::HeapEntry& lhs,
+                           const Impl::HeapEntry& rhs) {
+    return lhs.index_ts != rhs.index_ts ? lhs.index_ts > rhs.index_ts
+                                        : lhs.file_idx > rhs.file_idx;
+  };
+  std::vector<Impl::HeapEntry> heap;
+  heap.reserve(sources.size());
+  for (std::size_t i = 0; i < sources.size(); ++i) {
+    const Record* record = impl_->Front(*sources[i]);
+    if (record != nullptr) {
+      heap.push_back(Impl::HeapEntry{IndexTs(*record), i});
+    }
+  }
+  std::make_heap(heap.begin(), heap.end(), is_later);
+  while (!heap.empty()) {
+    std::pop_heap(heap.begin(), heap.end(), is_later);
+    auto& entry = heap.back();
+    auto& source = *sources[entry.file_idx];
+    const auto keep_going =
+        record_callback(*source.queue.Front(), entry.file_idx);
+    source.queue.Pop();
+    if (keep_going == KeepGoing::Stop) {
+      break;
+    }
+    const Record* next = impl_->Front(source);
+    if (next == nullptr) {
+      heap.pop_back();
+    } else {
+      entry.index_ts = IndexTs(*next);
+      std::push_heap(heap.begin(), heap.end(), is_later);
+    }
+  }
+  impl_->Stop();
+}
+
+void MergedFileStore::Replay(const RecordCallback& record_callback) {
+  Replay([&record_callback](const Record& record, std::size_t) {
+    return record_callback(record);
+  });
+}
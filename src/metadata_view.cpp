@@ -0,0 +1,228 @@
+#include "databento/metadata_view.hpp"
+
+#include <cstring>  // memchr, memcpy, strnlen
+#include <limits>   // numeric_limits
+#include <string>   // to_string
+#include <utility>  // make_pair, move
+
+#include "databento/compat.hpp"      // kSymbolCstrLenV1
+#include "databento/constants.hpp"   // kDbnVersion
+#include "databento/exceptions.hpp"  // DbnResponseError
+
+using databento::MetadataView;
+
+namespace {
+constexpr std::size_t kDatasetCstrLen = 16;
+constexpr std::size_t kReservedLen = 53;
+constexpr std::size_t kReservedLenV1 = 47;
+
+template <typename T>
+T Load(const std::uint8_t* data) {
+  T res;
+  std::memcpy(&res, data, sizeof(res));
+  return res;
+}
+
+std::string ToSymbol(const char* symbol, std::size_t symbol_cstr_len) {
+  return std::string{symbol, ::strnlen(symbol, symbol_cstr_len)};
+}
+
+// Throws if the fixed-width symbol at `symbol` isn't null-terminated, so the
+// views can hand it out as a C string.
+void CheckTerminated(const std::uint8_t* symbol, std::size_t symbol_cstr_len,
+                     const char* context) {
+  if (std::memchr(symbol, '\0', symbol_cstr_len) == nullptr) {
+    throw databento::DbnResponseError{
+        std::string{"Unterminated "} + context + " in metadata buffer"};
+  }
+}
+
+// Reads the metadata buffer, checking each read is within bounds.
+class MetadataReader {
+ public:
+  MetadataReader(const std::uint8_t* data, std::size_t size)
+      : pos_{data}, end_{data + size} {}
+
+  const std::uint8_t* Pos() const { return pos_; }
+
+  const std::uint8_t* Consume(std::size_t size, const char* context) {
+    if (static_cast<std::size_t>(end_ - pos_) < size) {
+      throw databento::DbnResponseError{
+          std::string{"Unexpected end of metadata buffer while parsing "} +
+          context};
+    }
+    const auto* res = pos_;
+    pos_ += size;
+    return res;
+  }
+
+  template <typename T>
+  T Consume(const char* context) {
+    return Load<T>(Consume(sizeof(T), context));
+  }
+
+ private:
+  const std::uint8_t* pos_;
+  const std::uint8_t* end_;
+};
+
+MetadataView::SymbolList ConsumeSymbols(MetadataReader& reader,
+                                        std::size_t symbol_cstr_len) {
+  const auto count = std::size_t{reader.Consume<std::uint32_t>("symbol")};
+  const auto* data = reader.Consume(count * symbol_cstr_len, "symbol");
+  for (std::size_t i = 0; i < count; ++i) {
+    CheckTerminated(data + i * symbol_cstr_len, symbol_cstr_len, "symbol");
+  }
+  return MetadataView::SymbolList{data, count, symbol_cstr_len};
+}
+
+MetadataView::MappingList ConsumeMappings(MetadataReader& reader,
+                                          std::size_t symbol_cstr_len) {
+  const auto count = std::size_t{reader.Consume<std::uint32_t>("mappings")};
+  const auto* data = reader.Pos();
+  const auto interval_len = 2 * sizeof(std::uint32_t) + symbol_cstr_len;
+  for (std::size_t i = 0; i < count; ++i) {
+    CheckTerminated(reader.Consume(symbol_cstr_len, "symbol mapping"),
+                    symbol_cstr_len, "symbol mapping raw symbol");
+    const auto interval_count =
+        std::size_t{reader.Consume<std::uint32_t>("symbol mapping")};
+    const auto* intervals = reader.Consume(interval_count * interval_len,
+                                           "symbol mapping intervals");
+    for (std::size_t j = 0; j < interval_count; ++j) {
+      CheckTerminated(intervals + j * interval_len + 2 * sizeof(std::uint32_t),
+                      symbol_cstr_len, "symbol mapping interval symbol");
+    }
+  }
+  return MetadataView::MappingList{data, reader.Pos(), count,
+                                   symbol_cstr_len};
+}
+}  // namespace
+
+std::uint32_t MetadataView::IntervalView::StartDate() const {
+  return Load<std::uint32_t>(data_);
+}
+
+std::uint32_t MetadataView::IntervalView::EndDate() const {
+  return Load<std::uint32_t>(data_ + sizeof(std::uint32_t));
+}
+
+MetadataView::IntervalList MetadataView::MappingView::Intervals() const {
+  const auto* count_data = data_ + symbol_cstr_len_;
+  return IntervalList{count_data + sizeof(std::uint32_t),
+                      Load<std::uint32_t>(count_data),
+                      2 * sizeof(std::uint32_t) + symbol_cstr_len_};
+}
+
+databento::SymbolMapping MetadataView::MappingView::ToSymbolMapping() const {
+  SymbolMapping res;
+  res.raw_symbol = ToSymbol(RawSymbol(), symbol_cstr_len_);
+  const auto intervals = Intervals();
+  res.intervals.reserve(intervals.Size());
+  for (const auto interval : intervals) {
+    res.intervals.emplace_back(MappingInterval{
+        interval.StartDate(), interval.EndDate(),
+        ToSymbol(interval.Symbol(), symbol_cstr_len_)});
+  }
+  return res;
+}
+
+std::size_t MetadataView::MappingView::EncodedSize() const {
+  const auto interval_count =
+      std::size_t{Load<std::uint32_t>(data_ + symbol_cstr_len_)};
+  return symbol_cstr_len_ + sizeof(std::uint32_t) +
+         interval_count * (2 * sizeof(std::uint32_t) + symbol_cstr_len_);
+}
+
+MetadataView::MetadataView(std::uint8_t version,
+                           std::vector<std::uint8_t> buffer)
+    : version_{version}, buffer_{std::move(buffer)} {
+  if (version_ > kDbnVersion) {
+    throw DbnResponseError{
+        "Can't decode newer version of DBN. Decoder version is " +
+        std::to_string(kDbnVersion) + ", input version is " +
+        std::to_string(version_)};
+  }
+  Decode();
+}
+
+void MetadataView::Decode() {
+  MetadataReader reader{buffer_.data(), buffer_.size()};
+  const auto* dataset =
+      reinterpret_cast<const char*>(reader.Consume(kDatasetCstrLen, "dataset"));
+  dataset_ = ToSymbol(dataset, kDatasetCstrLen);
+  const auto raw_schema = reader.Consume<std::uint16_t>("schema");
+  if (raw_schema == std::numeric_limits<std::uint16_t>::max()) {
+    has_mixed_schema_ = true;
+    // must initialize
+    schema_ = Schema::Mbo;
+  } else {
+    has_mixed_schema_ = false;
+    schema_ = static_cast<Schema>(raw_schema);
+  }
+  start_ = UnixNanos{
+      std::chrono::nanoseconds{reader.Consume<std::uint64_t>("start")}};
+  end_ =
+      UnixNanos{std::chrono::nanoseconds{reader.Consume<std::uint64_t>("end")}};
+  limit_ = reader.Consume<std::uint64_t>("limit");
+  if (version_ == 1) {
+    // skip deprecated record_count
+    reader.Consume(sizeof(std::uint64_t), "record_count");
+  }
+  const auto raw_stype_in = reader.Consume<std::uint8_t>("stype_in");
+  if (raw_stype_in == std::numeric_limits<std::uint8_t>::max()) {
+    has_mixed_stype_in_ = true;
+    // must initialize
+    stype_in_ = SType::InstrumentId;
+  } else {
+    has_mixed_stype_in_ = false;
+    stype_in_ = static_cast<SType>(raw_stype_in);
+  }
+  stype_out_ = static_cast<SType>(reader.Consume<std::uint8_t>("stype_out"));
+  ts_out_ = reader.Consume<std::uint8_t>("ts_out") != 0;
+  if (version_ > 1) {
+    symbol_cstr_len_ = static_cast<std::size_t>(
+        reader.Consume<std::uint16_t>("symbol_cstr_len"));
+  } else {
+    symbol_cstr_len_ = kSymbolCstrLenV1;
+  }
+  reader.Consume(version_ == 1 ? kReservedLenV1 : kReservedLen, "reserved");
+  const auto schema_definition_length =
+      reader.Consume<std::uint32_t>("schema_definition_length");
+  if (schema_definition_length != 0) {
+    throw DbnResponseError{
+        "This version of dbn can't parse schema definitions"};
+  }
+  symbols_ = ConsumeSymbols(reader, symbol_cstr_len_);
+  partial_ = ConsumeSymbols(reader, symbol_cstr_len_);
+  not_found_ = ConsumeSymbols(reader, symbol_cstr_len_);
+  mappings_ = ConsumeMappings(reader, symbol_cstr_len_);
+}
+
+databento::Metadata MetadataView::ToMetadata() const {
+  Metadata res;
+  res.version = version_;
+  res.dataset = dataset_;
+  res.has_mixed_schema = has_mixed_schema_;
+  res.schema = schema_;
+  res.start = start_;
+  res.end = end_;
+  res.limit = limit_;
+  res.has_mixed_stype_in = has_mixed_stype_in_;
+  res.stype_in = stype_in_;
+  res.stype_out = stype_out_;
+  res.ts_out = ts_out_;
+  res.symbol_cstr_len = symbol_cstr_len_;
+  for (const auto& list : {std::make_pair(&symbols_, &res.symbols),
+                           std::make_pair(&partial_, &res.partial),
+                           std::make_pair(&not_found_, &res.not_found)}) {
+    list.second->reserve(list.first->Size());
+    for (const auto* symbol : *list.first) {
+      list.second->emplace_back(ToSymbol(symbol, symbol_cstr_len_));
+    }
+  }
+  res.mappings.reserve(mappings_.Size());
+  for (const auto mapping : mappings_) {
+    res.mappings.emplace_back(mapping.ToSymbolMapping());
+  }
+  return res;
+}
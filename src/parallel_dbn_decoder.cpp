@@ -0,0 +1,447 @@
+#include "databento/parallel_dbn_decoder.hpp"
+
+#include <algorithm>  // max, min, unique
+#include <atomic>
+#include <cstring>    // strncmp
+#include <exception>  // current_exception, exception_ptr, rethrow_exception
+#include <limits>     // numeric_limits
+#include <memory>     // unique_ptr
+#include <mutex>      // lock_guard, mutex
+#include <utility>    // move
+#include <vector>
+
+#include "databento/detail/record_limits.hpp"      // kMaxEncodedRecordLen
+#include "databento/detail/scoped_thread.hpp"      // ScopedThread
+#include "databento/detail/spin_wait.hpp"          // Wait
+#include "databento/detail/spsc_record_queue.hpp"  // SpscRecordQueue
+#include "databento/exceptions.hpp"  // DbnResponseError, InvalidArgumentError
+
+using databento::ParallelDbnDecoder;
+using databento::detail::kMaxEncodedRecordLen;
+
+namespace {
+constexpr std::size_t kChunksPerThread = 4;
+// How many consecutive records with valid headers identify a record boundary
+// in a file with mixed schemas
+constexpr std::size_t kSyncRecordCount = 16;
+constexpr std::uint64_t kInvalidOffset =
+    std::numeric_limits<std::uint64_t>::max();
+// The end count of a chunk that hasn't been fully decoded
+constexpr std::uint64_t kUnknownCount =
+    std::numeric_limits<std::uint64_t>::max();
+std::size_t RecordLength(const std::uint8_t* data, std::uint64_t offset) {
+  return std::size_t{data[offset]} * databento::RecordHeader::kLengthMultiplier;
+}
+
+bool IsKnownRType(std::uint8_t rtype) {
+  switch (rtype) {
+    case databento::RType::Mbp0:
+    case databento::RType::Mbp1:
+    case databento::RType::Mbp10:
+    case databento::RType::OhlcvDeprecated:
+    case databento::RType::Ohlcv1S:
+    case databento::RType::Ohlcv1M:
+    case databento::RType::Ohlcv1H:
+    case databento::RType::Ohlcv1D:
+    case databento::RType::InstrumentDef:
+    case databento::RType::Imbalance:
+    case databento::RType::Error:
+    case databento::RType::SymbolMapping:
+    case databento::RType::System:
+    case databento::RType::Statistics:
+    case databento::RType::Mbo:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Returns whether the bytes at `offset` look like the start of a run of
+// records: each has a known rtype and records of the same rtype have the same
+// length. A run can be cut short by `end`.
+bool IsRecordRun(const std::uint8_t* data, std::uint64_t offset,
+                 std::uint64_t end) {
+  std::uint8_t rtypes[kSyncRecordCount];
+  std::size_t lengths[kSyncRecordCount];
+  for (std::size_t i = 0; i < kSyncRecordCount && offset < end; ++i) {
+    const auto length = RecordLength(data, offset);
+    if (length < sizeof(databento::RecordHeader) || offset + length > end) {
+      return false;
+    }
+    rtypes[i] = data[offset + 1];
+    lengths[i] = length;
+    if (!IsKnownRType(rtypes[i])) {
+      return false;
+    }
+    for (std::size_t j = 0; j < i; ++j) {
+      if (rtypes[j] == rtypes[i] && lengths[j] != lengths[i]) {
+        return false;
+      }
+    }
+    offset += length;
+  }
+  return true;
+}
+
+// Returns the offset of the first record run within the maximum record length
+// of `offset`, or `offset` if there's none. Only offsets a multiple of the
+// length multiplier from `offset` are checked.
+std::uint64_t FindRecordRun(const std::uint8_t* data, std::uint64_t offset,
+                            std::uint64_t end) {
+  const auto scan_end =
+      std::min<std::uint64_t>(end, offset + kMaxEncodedRecordLen);
+  for (auto candidate = offset; candidate < scan_end;
+       candidate += databento::RecordHeader::kLengthMultiplier) {
+    if (IsRecordRun(data, candidate, end)) {
+      return candidate;
+    }
+  }
+  return offset;
+}
+
+// Follows record lengths from `offset` and returns the offset of the first
+// record at or after `target`, `end` if the records before `end` are
+// incomplete, or `kInvalidOffset` if a record is shorter than its header.
+std::uint64_t FollowRecords(const std::uint8_t* data, std::uint64_t offset,
+                            std::uint64_t target, std::uint64_t end) {
+  while (offset < target) {
+    const auto length = RecordLength(data, offset);
+    if (length < sizeof(databento::RecordHeader)) {
+      return kInvalidOffset;
+    }
+    if (offset + length > end) {
+      return end;
+    }
+    offset += length;
+  }
+  return offset;
+}
+
+// Calls `task` with each index in `[0, task_count)` across up to
+// `thread_count` threads. Once a task throws, no more tasks are started and
+// `is_failed` is set. Rethrows the first exception.
+template <typename F>
+void RunParallel(std::size_t thread_count, std::size_t task_count,
+                 const F& task) {
+  std::atomic<std::size_t> next_task{};
+  std::atomic<bool> is_failed{};
+  std::mutex mutex;
+  std::exception_ptr exception_ptr{};
+  const auto work = [&] {
+    std::size_t task_idx;
+    while (!is_failed.load(std::memory_order_relaxed) &&
+           (task_idx = next_task.fetch_add(1, std::memory_order_relaxed)) <
+               task_count) {
+      try {
+        task(task_idx, is_failed);
+      } catch (...) {
+        const std::lock_guard<std::mutex> lock{mutex};
+        if (!exception_ptr) {
+          exception_ptr = std::current_exception();
+        }
+        is_failed.store(true, std::memory_order_relaxed);
+      }
+    }
+  };
+  {
+    std::vector<databento::detail::ScopedThread> threads;
+    const auto worker_count = std::min(thread_count, task_count);
+    threads.reserve(worker_count);
+    for (std::size_t i = 0; i < worker_count; ++i) {
+      threads.emplace_back(work);
+    }
+  }
+  if (exception_ptr) {
+    std::rethrow_exception(exception_ptr);
+  }
+}
+
+// Decodes the chunks assigned to one thread when replaying in order: every
+// chunk whose index modulo the thread count is the thread's index.
+struct OrderedWorker {
+  explicit OrderedWorker(std::size_t queue_capacity) : queue{queue_capacity} {}
+
+  databento::detail::SpscRecordQueue queue;
+  // Set once the thread won't push any more records
+  std::atomic<bool> is_done{};
+  // Only accessed by the replaying thread once `is_done` is set
+  std::exception_ptr exception_ptr{};
+  // Only accessed by the replaying thread
+  std::uint64_t popped_count{};
+  // Must be destroyed first
+  databento::detail::ScopedThread thread;
+};
+
+// The state of an in-order replay shared with the worker threads.
+struct OrderedReplay {
+  OrderedReplay(std::size_t worker_count, std::size_t chunk_count)
+      : chunk_end_counts{new std::atomic<std::uint64_t>[chunk_count]} {
+    for (std::size_t i = 0; i < chunk_count; ++i) {
+      chunk_end_counts[i].store(kUnknownCount, std::memory_order_relaxed);
+    }
+    workers.reserve(worker_count);
+    for (std::size_t i = 0; i < worker_count; ++i) {
+      workers.emplace_back(new OrderedWorker{
+          databento::ParallelDbnDecoder::kDefaultQueueCapacity});
+    }
+  }
+  // Stops the worker threads before the state they reference is destroyed,
+  // such as when the replay is stopped early.
+  ~OrderedReplay() {
+    is_stopping.store(true, std::memory_order_relaxed);
+    for (auto& worker : workers) {
+      if (worker->thread.Joinable()) {
+        worker->thread.Join();
+      }
+    }
+  }
+
+  // Pushes `record` to the queue of `worker`, waiting while it's full.
+  // Returns false if the replay was stopped.
+  bool Push(OrderedWorker* worker, const databento::Record& record) {
+    std::size_t wait_count{};
+    while (!worker->queue.TryPush(record)) {
+      if (is_stopping.load(std::memory_order_relaxed)) {
+        return false;
+      }
+      databento::detail::Wait(&wait_count);
+    }
+    return true;
+  }
+  // The number of records pushed by the worker by the end of the chunk at
+  // `chunk_idx`, or `kUnknownCount` if it hasn't been fully decoded.
+  std::uint64_t ChunkEndCount(std::size_t chunk_idx) const {
+    return chunk_end_counts[chunk_idx].load(std::memory_order_acquire);
+  }
+
+  std::atomic<bool> is_stopping{};
+  std::unique_ptr<std::atomic<std::uint64_t>[]> chunk_end_counts;
+  std::vector<std::unique_ptr<OrderedWorker>> workers;
+};
+}  // namespace
+
+constexpr std::size_t ParallelDbnDecoder::kDefaultQueueCapacity;
+
+ParallelDbnDecoder::ParallelDbnDecoder(const std::string& file_path,
+                                       std::size_t thread_count)
+    : ParallelDbnDecoder{file_path, VersionUpgradePolicy::AsIs, thread_count} {
+}
+
+ParallelDbnDecoder::ParallelDbnDecoder(const std::string& file_path,
+                                       VersionUpgradePolicy upgrade_policy,
+                                       std::size_t thread_count)
+    : ParallelDbnDecoder{file_path, upgrade_policy, thread_count,
+                         thread_count * kChunksPerThread} {}
+
+ParallelDbnDecoder::ParallelDbnDecoder(const std::string& file_path,
+                                       VersionUpgradePolicy upgrade_policy,
+                                       std::size_t thread_count,
+                                       std::size_t chunk_count)
+    : mmap_file_{file_path},
+      upgrade_policy_{upgrade_policy},
+      thread_count_{thread_count} {
+  if (thread_count == 0) {
+    throw InvalidArgumentError{"ParallelDbnDecoder::ParallelDbnDecoder",
+                               "thread_count", "Must be greater than 0"};
+  }
+  if (chunk_count == 0) {
+    throw InvalidArgumentError{"ParallelDbnDecoder::ParallelDbnDecoder",
+                               "chunk_count", "Must be greater than 0"};
+  }
+  const auto* data = mmap_file_.Data();
+  if (mmap_file_.Size() < 8 ||
+      std::strncmp(reinterpret_cast<const char*>(data), "DBN", 3) != 0) {
+    throw InvalidArgumentError{"ParallelDbnDecoder::ParallelDbnDecoder",
+                               "file_path", "Must be an uncompressed DBN file"};
+  }
+  const auto version_and_size =
+      DbnDecoder::DecodeMetadataVersionAndSize(data, mmap_file_.Size());
+  const auto records_offset = 8 + std::uint64_t{version_and_size.second};
+  if (records_offset > mmap_file_.Size()) {
+    throw DbnResponseError{"Unexpected end of input while decoding metadata"};
+  }
+  metadata_ = DbnDecoder::DecodeMetadataFields(
+      version_and_size.first,
+      std::vector<std::uint8_t>(data + 8, data + records_offset));
+  // Single-schema files can still contain symbol mapping, system, and error
+  // records, e.g. from `LiveRecorder`
+  if (metadata_.has_mixed_schema ||
+      !FindChunkOffsets(records_offset, chunk_count)) {
+    FindMixedChunkOffsets(records_offset, chunk_count);
+  }
+  // Drop empty chunks
+  chunk_offsets_.erase(
+      std::unique(chunk_offsets_.begin(), chunk_offsets_.end()),
+      chunk_offsets_.end());
+}
+
+void ParallelDbnDecoder::ReplayChunks(
+    const ChunkRecordCallback& record_callback) {
+  RunParallel(thread_count_, ChunkCount(),
+              [this, &record_callback](std::size_t chunk_idx,
+                                       const std::atomic<bool>& is_failed) {
+                auto decoder = ChunkDecoder(chunk_idx);
+                RecordBatch batch;
+                while (!is_failed.load(std::memory_order_relaxed) &&
+                       !(batch = decoder.DecodeRecords()).IsEmpty()) {
+                  for (const Record record : batch) {
+                    if (record_callback(record, chunk_idx) ==
+                        KeepGoing::Stop) {
+                      return;
+                    }
+                  }
+                }
+              });
+}
+
+void ParallelDbnDecoder::Replay(const RecordCallback& record_callback) {
+  const auto chunk_count = ChunkCount();
+  const auto worker_count = std::min(thread_count_, chunk_count);
+  OrderedReplay state{worker_count, chunk_count};
+  for (std::size_t i = 0; i < worker_count; ++i) {
+    OrderedWorker* worker = state.workers[i].get();
+    // Safe to capture references because the threads cannot outlive `state`
+    worker->thread = detail::ScopedThread{[this, &state, worker, worker_count,
+                                           chunk_count, i] {
+      try {
+        std::uint64_t pushed_count{};
+        for (auto chunk_idx = i; chunk_idx < chunk_count;
+             chunk_idx += worker_count) {
+          auto decoder = ChunkDecoder(chunk_idx);
+          RecordBatch batch;
+          while (!(batch = decoder.DecodeRecords()).IsEmpty()) {
+            for (const Record record : batch) {
+              if (!state.Push(worker, record)) {
+                worker->is_done.store(true, std::memory_order_release);
+                return;
+              }
+              ++pushed_count;
+            }
+          }
+          state.chunk_end_counts[chunk_idx].store(pushed_count,
+                                                  std::memory_order_release);
+        }
+      } catch (...) {
+        worker->exception_ptr = std::current_exception();
+      }
+      worker->is_done.store(true, std::memory_order_release);
+    }};
+  }
+  for (std::size_t chunk_idx = 0; chunk_idx < chunk_count; ++chunk_idx) {
+    auto& worker = *state.workers[chunk_idx % worker_count];
+    std::size_t wait_count{};
+    // The worker's queue only holds records of this chunk until all of them
+    // have been popped
+    while (worker.popped_count != state.ChunkEndCount(chunk_idx)) {
+      const Record* record = worker.queue.Front();
+      if (record == nullptr) {
+        // Check again in case records were pushed right before failing
+        if (worker.is_done.load(std::memory_order_acquire) &&
+            worker.queue.Front() == nullptr &&
+            worker.popped_count != state.ChunkEndCount(chunk_idx)) {
+          std::rethrow_exception(worker.exception_ptr);
+        }
+        detail::Wait(&wait_count);
+        continue;
+      }
+      wait_count = 0;
+      const auto keep_going = record_callback(*record);
+      worker.queue.Pop();
+      ++worker.popped_count;
+      if (keep_going == KeepGoing::Stop) {
+        return;
+      }
+    }
+  }
+}
+
+bool ParallelDbnDecoder::FindChunkOffsets(std::uint64_t records_offset,
+                                          std::size_t chunk_count) {
+  const auto* data = mmap_file_.Data();
+  const auto file_size = std::uint64_t{mmap_file_.Size()};
+  const auto records_size = file_size - records_offset;
+  std::vector<std::uint64_t> offsets;
+  offsets.reserve(chunk_count + 1);
+  offsets.push_back(records_offset);
+  if (records_size > 0) {
+    // Use the encoded length rather than the schema so older DBN versions with
+    // different record sizes are supported
+    const auto record_size = RecordLength(data, records_offset);
+    const auto rtype = data[records_offset + 1];
+    if (record_size < sizeof(RecordHeader) ||
+        records_size % record_size != 0) {
+      return false;
+    }
+    const auto record_count = records_size / record_size;
+    for (std::size_t i = 1; i < chunk_count; ++i) {
+      const auto offset =
+          records_offset + record_count * i / chunk_count * record_size;
+      // Only the record at each chunk boundary is checked. If its length or
+      // rtype differs from the first record's, the computed offset may not be
+      // a record boundary, so fall back to scanning for one
+      if (RecordLength(data, offset) != record_size ||
+          data[offset + 1] != rtype) {
+        return false;
+      }
+      offsets.push_back(offset);
+    }
+  }
+  offsets.push_back(file_size);
+  chunk_offsets_ = std::move(offsets);
+  return true;
+}
+
+void ParallelDbnDecoder::FindMixedChunkOffsets(std::uint64_t records_offset,
+                                               std::size_t chunk_count) {
+  const auto* data = mmap_file_.Data();
+  const auto file_size = std::uint64_t{mmap_file_.Size()};
+  const auto records_size = file_size - records_offset;
+  // Split evenly, keeping offsets relative to the first record a multiple of
+  // the length multiplier
+  std::vector<std::uint64_t> targets(chunk_count + 1);
+  for (std::size_t i = 0; i < chunk_count; ++i) {
+    const auto relative_offset = records_size * i / chunk_count;
+    targets[i] = records_offset + relative_offset -
+                 relative_offset % RecordHeader::kLengthMultiplier;
+  }
+  targets[chunk_count] = file_size;
+  // Guess the start of each chunk by scanning for a run of records, then
+  // follow the record lengths from there to the next chunk in parallel
+  std::vector<std::uint64_t> starts(chunk_count);
+  std::vector<std::uint64_t> ends(chunk_count);
+  RunParallel(thread_count_, chunk_count,
+              [&](std::size_t chunk_idx, const std::atomic<bool>&) {
+                starts[chunk_idx] =
+                    chunk_idx == 0
+                        ? records_offset
+                        : FindRecordRun(data, targets[chunk_idx], file_size);
+                ends[chunk_idx] =
+                    FollowRecords(data, starts[chunk_idx],
+                                  targets[chunk_idx + 1], file_size);
+              });
+  // The first chunk starts at a record, so each chunk's end is valid if its
+  // start is the previous chunk's end. Otherwise the guess was wrong and the
+  // records are followed again from the correct start.
+  chunk_offsets_.reserve(chunk_count + 1);
+  chunk_offsets_.push_back(records_offset);
+  for (std::size_t i = 0; i < chunk_count; ++i) {
+    auto end = ends[i];
+    if (starts[i] != chunk_offsets_[i]) {
+      end = FollowRecords(data, chunk_offsets_[i],
+                          std::max(targets[i + 1], chunk_offsets_[i]),
+                          file_size);
+    }
+    if (end == kInvalidOffset) {
+      throw DbnResponseError{"Record length is shorter than the record header"};
+    }
+    chunk_offsets_.push_back(end);
+  }
+}
+
+databento::DbnDecoder ParallelDbnDecoder::ChunkDecoder(
+    std::size_t chunk_idx) const {
+  const auto start = chunk_offsets_[chunk_idx];
+  return DbnDecoder{mmap_file_.Data() + start,
+                    chunk_offsets_[chunk_idx + 1] - start, metadata_,
+                    upgrade_policy_};
+}
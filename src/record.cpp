@@ -10,12 +10,36 @@
 using databento::Record;
 using databento::RecordHeader;
 
-std::size_t RecordHeader::Size() const {
-  return static_cast<size_t>(length) * kLengthMultiplier;
+databento::UnixNanos Record::IndexTs() const {
+  switch (RType()) {
+    case RType::Mbo: {
+      return Get<MboMsg>().IndexTs();
+    }
+    case RType::Mbp0: {
+      return Get<TradeMsg>().IndexTs();
+    }
+    case RType::Mbp1: {
+      return Get<Mbp1Msg>().IndexTs();
+    }
+    case RType::Mbp10: {
+      return Get<Mbp10Msg>().IndexTs();
+    }
+    case RType::InstrumentDef: {
+      // `ts_recv` is at the same offset in version 1
+      return Get<InstrumentDefMsg>().IndexTs();
+    }
+    case RType::Imbalance: {
+      return Get<ImbalanceMsg>().IndexTs();
+    }
+    case RType::Statistics: {
+      return Get<StatMsg>().IndexTs();
+    }
+    default: {
+      return Header().ts_event;
+    }
+  }
 }
 
-std::size_t Record::Size() const { return record_->Size(); }
-
 std::size_t Record::SizeOfSchema(const Schema schema) {
   switch (schema) {
     case Schema::Mbo: {
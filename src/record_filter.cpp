@@ -0,0 +1,36 @@
+#include "databento/record_filter.hpp"
+
+#include <limits>  // numeric_limits
+
+using databento::RecordFilter;
+
+constexpr std::uint32_t RecordFilter::kMaxBitmapInstrumentId;
+
+RecordFilter& RecordFilter::AddRType(RType rtype) {
+  has_rtypes_ = true;
+  SetBit(rtypes_.data(), rtype);
+  return *this;
+}
+
+RecordFilter& RecordFilter::AddInstrumentId(std::uint32_t instrument_id) {
+  has_instrument_ids_ = true;
+  if (instrument_id < kMaxBitmapInstrumentId) {
+    if (instrument_id / 64 >= instrument_id_bitmap_.size()) {
+      instrument_id_bitmap_.resize(instrument_id / 64 + 1);
+    }
+    SetBit(instrument_id_bitmap_.data(), instrument_id);
+  } else {
+    instrument_id_set_.emplace(instrument_id);
+  }
+  return *this;
+}
+
+RecordFilter& RecordFilter::AddPublisherId(std::uint16_t publisher_id) {
+  if (!has_publisher_ids_) {
+    has_publisher_ids_ = true;
+    publisher_ids_.resize(
+        (std::size_t{std::numeric_limits<std::uint16_t>::max()} + 1) / 64);
+  }
+  SetBit(publisher_ids_.data(), publisher_id);
+  return *this;
+}
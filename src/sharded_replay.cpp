@@ -0,0 +1,183 @@
+#include "databento/sharded_replay.hpp"
+
+#include <atomic>
+#include <exception>  // current_exception, exception_ptr, rethrow_exception
+#include <utility>    // move, swap
+#include <vector>
+
+#include "databento/dbn_file_store.hpp"            // DbnFileStore
+#include "databento/detail/instrument_index.hpp"   // HashId
+#include "databento/detail/scoped_thread.hpp"      // ScopedThread
+#include "databento/detail/spin_wait.hpp"          // Wait
+#include "databento/detail/spsc_record_queue.hpp"  // SpscRecordQueue
+#include "databento/exceptions.hpp"                // InvalidArgumentError
+
+using databento::ShardedReplay;
+
+struct ShardedReplay::Impl {
+  struct Shard {
+    Shard(RecordCallback cb, std::size_t queue_capacity)
+        : callback{std::move(cb)}, queue{queue_capacity} {}
+
+    RecordCallback callback;
+    detail::SpscRecordQueue queue;
+    // Only accessed by the dispatching thread
+    std::uint64_t pushed_count{};
+    // Includes records skipped after the callback stopped
+    std::atomic<std::uint64_t> processed_count{};
+    // Set once the callback returns `KeepGoing::Stop` or throws
+    std::atomic<bool> is_done{};
+    // Only accessed by the dispatching thread once the record that set it has
+    // been processed
+    std::exception_ptr exception_ptr{};
+    // Must be destroyed first
+    detail::ScopedThread thread;
+  };
+
+  // Stops the worker threads once they've processed the queued records.
+  ~Impl() { StopWorkers(); }
+
+  void Work(Shard* shard);
+  void StopWorkers();
+
+  // Set when the worker threads should stop once their queues are empty
+  std::atomic<bool> is_stopping{};
+  // Set when any callback throws
+  std::atomic<bool> is_failed{};
+  // The number of shards whose callback has stopped
+  std::atomic<std::size_t> done_count{};
+  std::vector<std::unique_ptr<Shard>> shards;
+};
+
+void ShardedReplay::Impl::Work(Shard* shard) {
+  std::size_t wait_count{};
+  while (true) {
+    const Record* record = shard->queue.Front();
+    if (record == nullptr) {
+      if (is_stopping.load(std::memory_order_acquire)) {
+        // Check again in case records were pushed right before stopping
+        record = shard->queue.Front();
+        if (record == nullptr) {
+          break;
+        }
+      } else {
+        detail::Wait(&wait_count);
+        continue;
+      }
+    }
+    wait_count = 0;
+    // Only this thread writes `is_done`
+    if (!shard->is_done.load(std::memory_order_relaxed)) {
+      try {
+        if (shard->callback(*record) == KeepGoing::Stop) {
+          shard->is_done.store(true, std::memory_order_relaxed);
+          done_count.fetch_add(1, std::memory_order_relaxed);
+        }
+      } catch (...) {
+        shard->exception_ptr = std::current_exception();
+        shard->is_done.store(true, std::memory_order_relaxed);
+        done_count.fetch_add(1, std::memory_order_relaxed);
+        is_failed.store(true, std::memory_order_relaxed);
+      }
+    }
+    shard->queue.Pop();
+    // Releases `exception_ptr` to the dispatching thread
+    shard->processed_count.fetch_add(1, std::memory_order_release);
+  }
+}
+
+void ShardedReplay::Impl::StopWorkers() {
+  is_stopping.store(true, std::memory_order_release);
+  for (auto& shard : shards) {
+    if (shard->thread.Joinable()) {
+      shard->thread.Join();
+    }
+  }
+}
+
+constexpr std::size_t ShardedReplay::kDefaultQueueCapacity;
+
+ShardedReplay::ShardedReplay(std::size_t shard_count,
+                             const ShardCallbackFactory& callback_factory)
+    : ShardedReplay{shard_count, callback_factory, kDefaultQueueCapacity} {}
+
+ShardedReplay::ShardedReplay(std::size_t shard_count,
+                             const ShardCallbackFactory& callback_factory,
+                             std::size_t queue_capacity)
+    : impl_{new Impl{}} {
+  if (shard_count == 0) {
+    throw InvalidArgumentError{"ShardedReplay::ShardedReplay", "shard_count",
+                               "Must be greater than 0"};
+  }
+  impl_->shards.reserve(shard_count);
+  for (std::size_t i = 0; i < shard_count; ++i) {
+    impl_->shards.emplace_back(
+        new Impl::Shard{callback_factory(i), queue_capacity});
+  }
+  for (auto& shard : impl_->shards) {
+    // Safe to pass raw pointers because the threads cannot outlive `impl_`
+    shard->thread = detail::ScopedThread{&Impl::Work, impl_.get(), shard.get()};
+  }
+}
+
+ShardedReplay::~ShardedReplay() = default;
+
+std::size_t ShardedReplay::ShardCount() const { return impl_->shards.size(); }
+
+std::size_t ShardedReplay::ShardOf(std::uint32_t instrument_id) const {
+  // The 32-bit hash is scaled to the shard count without a division
+  const std::uint64_t hash = detail::HashId(instrument_id);
+  return (hash * impl_->shards.size()) >> 32;
+}
+
+void ShardedReplay::Replay(DbnFileStore& file_store,
+                           const MetadataCallback& metadata_callback) {
+  file_store.Replay(metadata_callback,
+                    [this](const Record& record) { return OnRecord(record); });
+  Flush();
+}
+
+void ShardedReplay::Replay(DbnFileStore& file_store) {
+  Replay(file_store, {});
+}
+
+databento::KeepGoing ShardedReplay::OnRecord(const Record& record) {
+  if (impl_->is_failed.load(std::memory_order_relaxed) ||
+      impl_->is_stopping.load(std::memory_order_relaxed)) {
+    return KeepGoing::Stop;
+  }
+  auto& shard = *impl_->shards[ShardOf(record.Header().instrument_id)];
+  // Workers always drain their queues, even once their callback has stopped
+  std::size_t wait_count{};
+  while (!shard.queue.TryPush(record)) {
+    detail::Wait(&wait_count);
+  }
+  ++shard.pushed_count;
+  return impl_->done_count.load(std::memory_order_relaxed) ==
+                 impl_->shards.size()
+             ? KeepGoing::Stop
+             : KeepGoing::Continue;
+}
+
+void ShardedReplay::Flush() {
+  std::exception_ptr exception_ptr{};
+  for (auto& shard : impl_->shards) {
+    std::size_t wait_count{};
+    while (shard->processed_count.load(std::memory_order_acquire) !=
+           shard->pushed_count) {
+      detail::Wait(&wait_count);
+    }
+    if (!exception_ptr && shard->exception_ptr) {
+      std::swap(exception_ptr, shard->exception_ptr);
+    }
+  }
+  if (exception_ptr) {
+    std::rethrow_exception(exception_ptr);
+  }
+}
+
+void ShardedReplay::Stop() {
+  // Workers process all queued records before stopping
+  impl_->StopWorkers();
+  Flush();
+}
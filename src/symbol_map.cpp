@@ -1,8 +1,81 @@
 #include "databento/symbol_map.hpp"
 
+#include <algorithm>  // max, sort, upper_bound
+#include <cerrno>     // errno
+#include <cstdlib>    // strtoul
+#include <cstring>    // memcmp, memcpy, strlen, strnlen
+#include <limits>     // numeric_limits
+#include <string>     // to_string
+#include <tuple>      // tie
+#include <utility>    // make_pair, move, pair
+
 #include "databento/compat.hpp"
+#include "databento/exceptions.hpp"  // InvalidArgumentError
 
+using databento::FlatPitSymbolMap;
 using databento::PitSymbolMap;
+using databento::TsSymbolMap;
+
+namespace {
+constexpr std::size_t kArenaChunkSize = 64 * 1024;
+
+// Dispatches symbol mapping records to `symbol_map`.
+template <typename SymbolMap>
+void OnSymbolMappingRecord(SymbolMap& symbol_map,
+                           const databento::Record& record) {
+  if (record.RType() == databento::RType::SymbolMapping) {
+    // Version compat
+    if (record.Header().Size() >= sizeof(databento::SymbolMappingMsgV2)) {
+      symbol_map.OnSymbolMapping(record.Get<databento::SymbolMappingMsgV2>());
+    } else {
+      symbol_map.OnSymbolMapping(record.Get<databento::SymbolMappingMsgV1>());
+    }
+  }
+}
+
+// 32-bit FNV-1a
+std::uint32_t HashSymbol(const char* symbol, std::size_t length) {
+  std::uint32_t res = 2166136261U;
+  for (std::size_t i = 0; i < length; ++i) {
+    res ^= static_cast<std::uint32_t>(static_cast<unsigned char>(symbol[i]));
+    res *= 16777619U;
+  }
+  return res;
+}
+
+// Converts the UNIX timestamp to its UTC date as a YYYYMMDD integer.
+std::uint32_t ToDateInt(databento::UnixNanos ts) {
+  constexpr std::uint64_t kNanosPerDay = 24ULL * 60 * 60 * 1000000000;
+  // Civil from days: https://howardhinnant.github.io/date_algorithms.html
+  const auto days = ts.time_since_epoch().count() / kNanosPerDay + 719468;
+  const auto era = days / 146097;
+  const auto day_of_era = days - era * 146097;
+  const auto year_of_era =
+      (day_of_era - day_of_era / 1460 + day_of_era / 36524 -
+       day_of_era / 146096) /
+      365;
+  const auto day_of_year =
+      day_of_era - (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+  const auto month_index = (5 * day_of_year + 2) / 153;
+  const auto day = day_of_year - (153 * month_index + 2) / 5 + 1;
+  const auto month = month_index < 10 ? month_index + 3 : month_index - 9;
+  const auto year = year_of_era + era * 400 + (month <= 2 ? 1 : 0);
+  return static_cast<std::uint32_t>(year * 10000 + month * 100 + day);
+}
+
+std::uint32_t ParseInstrumentId(const std::string& str) {
+  char* end{};
+  errno = 0;
+  const auto res = std::strtoul(str.c_str(), &end, 10);
+  if (str.empty() || *end != '\0' || errno != 0 ||
+      res > std::numeric_limits<std::uint32_t>::max()) {
+    throw databento::InvalidArgumentError{
+        "TsSymbolMap::OnMetadata", "metadata",
+        "Invalid instrument ID '" + str + "' in symbol mappings"};
+  }
+  return static_cast<std::uint32_t>(res);
+}
+}  // namespace
 
 template <typename SymbolMappingRec>
 void PitSymbolMap::OnSymbolMapping(const SymbolMappingRec& symbol_mapping) {
@@ -16,14 +89,276 @@ void PitSymbolMap::OnSymbolMapping(const SymbolMappingRec& symbol_mapping) {
 }
 
 void PitSymbolMap::OnRecord(const Record& record) {
-  if (record.RType() == RType::SymbolMapping) {
-    // Version compat
-    if (record.Header().Size() >= sizeof(SymbolMappingMsgV2)) {
-      OnSymbolMapping(record.Get<SymbolMappingMsgV2>());
-    } else {
-      OnSymbolMapping(record.Get<SymbolMappingMsgV1>());
+  OnSymbolMappingRecord(*this, record);
+}
+
+FlatPitSymbolMap::FlatPitSymbolMap(std::size_t instrument_count) {
+  Reserve(instrument_count);
+}
+
+FlatPitSymbolMap::FlatPitSymbolMap(FlatPitSymbolMap&& other) noexcept
+    : instrument_index_{std::move(other.instrument_index_)},
+      instruments_{std::move(other.instruments_)},
+      symbol_table_{std::move(other.symbol_table_)},
+      symbols_{std::move(other.symbols_)},
+      arena_chunks_{std::move(other.arena_chunks_)},
+      arena_pos_{other.arena_pos_},
+      arena_end_{other.arena_end_} {
+  other.Clear();
+}
+
+FlatPitSymbolMap& FlatPitSymbolMap::operator=(FlatPitSymbolMap&& rhs) noexcept {
+  if (this != &rhs) {
+    instrument_index_ = std::move(rhs.instrument_index_);
+    instruments_ = std::move(rhs.instruments_);
+    symbol_table_ = std::move(rhs.symbol_table_);
+    symbols_ = std::move(rhs.symbols_);
+    arena_chunks_ = std::move(rhs.arena_chunks_);
+    arena_pos_ = rhs.arena_pos_;
+    arena_end_ = rhs.arena_end_;
+    rhs.Clear();
+  }
+  return *this;
+}
+
+void FlatPitSymbolMap::Reserve(std::size_t instrument_count) {
+  instrument_index_.Reserve(instrument_count);
+  instruments_.reserve(instrument_count);
+  const auto capacity = detail::TableCapacity(instrument_count);
+  if (capacity > symbol_table_.size()) {
+    RehashSymbols(capacity);
+  }
+  symbols_.reserve(instrument_count);
+}
+
+const char* FlatPitSymbolMap::Find(std::uint32_t instrument_id) const {
+  const auto idx = instrument_index_.Find(instrument_id);
+  if (idx == detail::InstrumentIndex::kNotFound) {
+    return nullptr;
+  }
+  return symbols_[instruments_[idx].symbol_idx].data;
+}
+
+const std::uint32_t* FlatPitSymbolMap::FindInstrumentId(
+    const char* symbol) const {
+  if (symbol_table_.empty()) {
+    return nullptr;
+  }
+  const auto length = std::strlen(symbol);
+  const auto slot =
+      symbol_table_[FindSymbolSlot(symbol, length, HashSymbol(symbol, length))];
+  if (slot == 0 || !symbols_[slot - 1].is_mapped) {
+    return nullptr;
+  }
+  return &symbols_[slot - 1].instrument_id;
+}
+
+const std::uint32_t* FlatPitSymbolMap::FindInstrumentId(
+    const std::string& symbol) const {
+  return FindInstrumentId(symbol.c_str());
+}
+
+void FlatPitSymbolMap::Insert(std::uint32_t instrument_id, const char* symbol,
+                              std::size_t length) {
+  const auto symbol_idx = Intern(symbol, length);
+  const auto idx = instrument_index_.Insert(instrument_id);
+  if (idx == instruments_.size()) {
+    instruments_.push_back(Instrument{instrument_id, symbol_idx});
+  } else {
+    auto& instrument = instruments_[idx];
+    // The previous symbol no longer maps to this instrument
+    auto& prev = symbols_[instrument.symbol_idx];
+    if (prev.instrument_id == instrument_id) {
+      prev.is_mapped = false;
     }
+    instrument.symbol_idx = symbol_idx;
   }
+  auto& interned = symbols_[symbol_idx];
+  interned.instrument_id = instrument_id;
+  interned.is_mapped = true;
+}
+
+void FlatPitSymbolMap::Clear() {
+  instrument_index_.Clear();
+  instruments_.clear();
+  symbol_table_.clear();
+  symbols_.clear();
+  arena_chunks_.clear();
+  arena_pos_ = nullptr;
+  arena_end_ = nullptr;
+}
+
+PitSymbolMap::Store FlatPitSymbolMap::ToStore() const {
+  PitSymbolMap::Store res;
+  res.reserve(instruments_.size());
+  for (const auto& instrument : instruments_) {
+    const auto& symbol = symbols_[instrument.symbol_idx];
+    res.emplace(instrument.instrument_id,
+                std::string{symbol.data, symbol.length});
+  }
+  return res;
+}
+
+void FlatPitSymbolMap::OnRecord(const Record& record) {
+  OnSymbolMappingRecord(*this, record);
+}
+
+template <typename SymbolMappingRec>
+void FlatPitSymbolMap::OnSymbolMapping(const SymbolMappingRec& symbol_mapping) {
+  const auto& symbol = symbol_mapping.stype_out_symbol;
+  Insert(symbol_mapping.hd.instrument_id, symbol.data(),
+         ::strnlen(symbol.data(), symbol.size()));
+}
+
+std::size_t FlatPitSymbolMap::FindSymbolSlot(const char* symbol,
+                                             std::size_t length,
+                                             std::uint32_t hash) const {
+  const auto mask = symbol_table_.size() - 1;
+  for (auto idx = std::size_t{hash} & mask;; idx = (idx + 1) & mask) {
+    const auto slot = symbol_table_[idx];
+    if (slot == 0) {
+      return idx;
+    }
+    const auto& interned = symbols_[slot - 1];
+    if (interned.hash == hash && interned.length == length &&
+        std::memcmp(interned.data, symbol, length) == 0) {
+      return idx;
+    }
+  }
+}
+
+std::uint32_t FlatPitSymbolMap::Intern(const char* symbol, std::size_t length) {
+  if ((symbols_.size() + 1) * 4 > symbol_table_.size() * 3) {
+    RehashSymbols(detail::TableCapacity(symbols_.size() + 1));
+  }
+  const auto hash = HashSymbol(symbol, length);
+  auto& slot = symbol_table_[FindSymbolSlot(symbol, length, hash)];
+  if (slot == 0) {
+    symbols_.push_back(Symbol{StoreSymbol(symbol, length),
+                              static_cast<std::uint32_t>(length), hash, 0,
+                              false});
+    slot = static_cast<std::uint32_t>(symbols_.size());
+  }
+  return slot - 1;
+}
+
+const char* FlatPitSymbolMap::StoreSymbol(const char* symbol,
+                                          std::size_t length) {
+  // Include null terminator
+  const auto size = length + 1;
+  if (static_cast<std::size_t>(arena_end_ - arena_pos_) < size) {
+    const auto chunk_size = std::max(size, kArenaChunkSize);
+    arena_chunks_.emplace_back(new char[chunk_size]);
+    arena_pos_ = arena_chunks_.back().get();
+    arena_end_ = arena_pos_ + chunk_size;
+  }
+  auto* res = arena_pos_;
+  std::memcpy(res, symbol, length);
+  res[length] = '\0';
+  arena_pos_ += size;
+  return res;
+}
+
+void FlatPitSymbolMap::RehashSymbols(std::size_t capacity) {
+  std::vector<std::uint32_t> prev_table(capacity);
+  prev_table.swap(symbol_table_);
+  for (const auto slot : prev_table) {
+    if (slot != 0) {
+      const auto& interned = symbols_[slot - 1];
+      symbol_table_[FindSymbolSlot(interned.data, interned.length,
+                                   interned.hash)] = slot;
+    }
+  }
+}
+
+TsSymbolMap::TsSymbolMap(const Metadata& metadata) { OnMetadata(metadata); }
+
+const std::string* TsSymbolMap::Find(std::uint32_t date,
+                                     std::uint32_t instrument_id) const {
+  // The last interval starting on or before `date`
+  const auto it = std::upper_bound(
+      intervals_.begin(), intervals_.end(), std::make_pair(instrument_id, date),
+      [](const std::pair<std::uint32_t, std::uint32_t>& key,
+         const Interval& interval) {
+        return key < std::make_pair(interval.instrument_id,
+                                    interval.start_date);
+      });
+  if (it == intervals_.begin()) {
+    return nullptr;
+  }
+  const auto& interval = *(it - 1);
+  if (interval.instrument_id != instrument_id || date >= interval.end_date) {
+    return nullptr;
+  }
+  return &symbols_[interval.symbol_idx];
+}
+
+const std::string* TsSymbolMap::Find(UnixNanos ts,
+                                     std::uint32_t instrument_id) const {
+  return Find(ToDateInt(ts), instrument_id);
+}
+
+const std::string& TsSymbolMap::At(const Record& record) const {
+  const auto* symbol = Find(record.IndexTs(), record.Header().instrument_id);
+  if (symbol == nullptr) {
+    throw InvalidArgumentError{
+        "TsSymbolMap::At", "record",
+        "No symbol mapping for instrument ID " +
+            std::to_string(record.Header().instrument_id) + " on " +
+            ToIso8601(record.IndexTs())};
+  }
+  return *symbol;
+}
+
+void TsSymbolMap::OnMetadata(const Metadata& metadata) {
+  intervals_.clear();
+  symbols_.clear();
+  // With instrument IDs as input, the raw symbol is the instrument ID
+  const bool is_inverse =
+      !metadata.has_mixed_stype_in && metadata.stype_in == SType::InstrumentId;
+  // Only used while building
+  std::unordered_map<std::string, std::uint32_t> symbol_indices;
+  const auto intern = [this, &symbol_indices](const std::string& symbol) {
+    const auto res = symbol_indices.emplace(
+        symbol, static_cast<std::uint32_t>(symbols_.size()));
+    if (res.second) {
+      symbols_.emplace_back(symbol);
+    }
+    return res.first->second;
+  };
+  for (const auto& mapping : metadata.mappings) {
+    for (const auto& interval : mapping.intervals) {
+      // Empty when the symbol didn't resolve
+      if (interval.symbol.empty()) {
+        continue;
+      }
+      if (is_inverse) {
+        intervals_.push_back(Interval{ParseInstrumentId(mapping.raw_symbol),
+                                      interval.start_date, interval.end_date,
+                                      intern(interval.symbol)});
+      } else {
+        intervals_.push_back(Interval{ParseInstrumentId(interval.symbol),
+                                      interval.start_date, interval.end_date,
+                                      intern(mapping.raw_symbol)});
+      }
+    }
+  }
+  std::sort(intervals_.begin(), intervals_.end(),
+            [](const Interval& lhs, const Interval& rhs) {
+              return std::tie(lhs.instrument_id, lhs.start_date) <
+                     std::tie(rhs.instrument_id, rhs.start_date);
+            });
+  intervals_.shrink_to_fit();
+  symbols_.shrink_to_fit();
+}
+
+databento::RecordCallback TsSymbolMap::Bind(
+    SymbolRecordCallback callback) const {
+  return [this, callback](const Record& record) {
+    static const std::string kUnmapped;
+    const auto* symbol = Find(record.IndexTs(), record.Header().instrument_id);
+    return callback(record, symbol == nullptr ? kUnmapped : *symbol);
+  };
 }
 
 // Explicit instantiation
@@ -31,3 +366,7 @@ template void PitSymbolMap::OnSymbolMapping(
     const SymbolMappingMsgV1& symbol_mapping);
 template void PitSymbolMap::OnSymbolMapping(
     const SymbolMappingMsgV2& symbol_mapping);
+template void FlatPitSymbolMap::OnSymbolMapping(
+    const SymbolMappingMsgV1& symbol_mapping);
+template void FlatPitSymbolMap::OnSymbolMapping(
+    const SymbolMappingMsgV2& symbol_mapping);
@@ -0,0 +1,264 @@
+#include "databento/tick_ladder_book.hpp"
+
+#include <algorithm>  // copy, copy_backward, fill, max, min
+#include <limits>     // numeric_limits
+
+#include "databento/constants.hpp"   // kUndefPrice
+#include "databento/exceptions.hpp"  // InvalidArgumentError
+
+using databento::TickLadderBook;
+
+namespace {
+constexpr std::size_t kNoLevel = std::numeric_limits<std::size_t>::max();
+
+databento::BidAskPair EmptyLevel() {
+  return databento::BidAskPair{
+      databento::kUndefPrice, databento::kUndefPrice, 0, 0, 0, 0};
+}
+
+std::int64_t SidePrice(const databento::BidAskPair& pair,
+                       databento::Side side) {
+  return side == databento::Side::Bid ? pair.bid_px : pair.ask_px;
+}
+}  // namespace
+
+constexpr std::size_t TickLadderBook::kDefaultTickCount;
+
+TickLadderBook::TickLadderBook(std::int64_t tick_size, std::size_t tick_count)
+    : tick_size_{tick_size}, best_bid_{kNoLevel}, best_ask_{kNoLevel} {
+  if (tick_size_ <= 0) {
+    throw InvalidArgumentError{"TickLadderBook::TickLadderBook", "tick_size",
+                               "Must be positive"};
+  }
+  if (tick_count < 2) {
+    throw InvalidArgumentError{"TickLadderBook::TickLadderBook", "tick_count",
+                               "Must be at least 2"};
+  }
+  bids_.resize(tick_count);
+  asks_.resize(tick_count);
+}
+
+TickLadderBook::TickLadderBook(const InstrumentDefMsg& definition,
+                               std::size_t tick_count)
+    : TickLadderBook{definition.min_price_increment, tick_count} {}
+
+void TickLadderBook::Apply(const Mbp1Msg& mbp) {
+  ApplyLevels(mbp.levels.data(), mbp.levels.size());
+}
+
+void TickLadderBook::Apply(const Mbp10Msg& mbp) {
+  ApplyLevels(mbp.levels.data(), mbp.levels.size());
+}
+
+void TickLadderBook::ApplyLevels(const BidAskPair* levels,
+                                 std::size_t level_count) {
+  ApplySide(Side::Bid, levels, level_count);
+  ApplySide(Side::Ask, levels, level_count);
+}
+
+void TickLadderBook::SetLevel(Side side, std::int64_t price,
+                              std::uint32_t size, std::uint32_t count) {
+  if ((side != Side::Bid && side != Side::Ask) || price == kUndefPrice) {
+    return;
+  }
+  auto idx = ToIndex(price);
+  if (idx == kNoLevel) {
+    if (size == 0) {
+      return;
+    }
+    if (!IsBetter(side, price)) {
+      ++dropped_count_;
+      return;
+    }
+    Recenter(price);
+    idx = ToIndex(price);
+  }
+  SideLevels(side)[idx] = Level{size, size == 0 ? 0 : count};
+  if (side == Side::Bid) {
+    if (size > 0) {
+      if (best_bid_ == kNoLevel || idx > best_bid_) {
+        best_bid_ = idx;
+      }
+    } else if (idx == best_bid_) {
+      best_bid_ = idx == 0 ? kNoLevel : FindBidAtOrBelow(idx - 1);
+    }
+  } else {
+    if (size > 0) {
+      if (best_ask_ == kNoLevel || idx < best_ask_) {
+        best_ask_ = idx;
+      }
+    } else if (idx == best_ask_) {
+      best_ask_ = FindAskAtOrAbove(idx + 1);
+    }
+  }
+}
+
+void TickLadderBook::Clear() {
+  ClearSide(Side::Bid);
+  ClearSide(Side::Ask);
+}
+
+TickLadderBook::Level TickLadderBook::DepthAt(Side side,
+                                              std::int64_t price) const {
+  if ((side != Side::Bid && side != Side::Ask) || price == kUndefPrice) {
+    return Level{};
+  }
+  const auto idx = ToIndex(price);
+  return idx == kNoLevel ? Level{} : SideLevels(side)[idx];
+}
+
+databento::BidAskPair TickLadderBook::Bbo() const {
+  BidAskPair res;
+  Snapshot(&res, 1);
+  return res;
+}
+
+std::size_t TickLadderBook::Snapshot(BidAskPair* levels,
+                                     std::size_t level_count) const {
+  std::fill(levels, levels + level_count, EmptyLevel());
+  std::size_t bid_count = 0;
+  for (auto idx = best_bid_; bid_count < level_count && idx != kNoLevel;
+       idx = idx == 0 ? kNoLevel : FindBidAtOrBelow(idx - 1)) {
+    auto& pair = levels[bid_count++];
+    pair.bid_px = ToPrice(idx);
+    pair.bid_sz = bids_[idx].size;
+    pair.bid_ct = bids_[idx].count;
+  }
+  std::size_t ask_count = 0;
+  for (auto idx = best_ask_; ask_count < level_count && idx != kNoLevel;
+       idx = FindAskAtOrAbove(idx + 1)) {
+    auto& pair = levels[ask_count++];
+    pair.ask_px = ToPrice(idx);
+    pair.ask_sz = asks_[idx].size;
+    pair.ask_ct = asks_[idx].count;
+  }
+  return std::max(bid_count, ask_count);
+}
+
+std::vector<databento::BidAskPair> TickLadderBook::Snapshot(
+    std::size_t level_count) const {
+  std::vector<BidAskPair> res(level_count);
+  Snapshot(res.data(), level_count);
+  return res;
+}
+
+bool TickLadderBook::IsEmpty() const {
+  return best_bid_ == kNoLevel && best_ask_ == kNoLevel;
+}
+
+std::size_t TickLadderBook::ToIndex(std::int64_t price) const {
+  if (price < base_price_) {
+    return kNoLevel;
+  }
+  // Unsigned to avoid overflow
+  const auto offset = (static_cast<std::uint64_t>(price) -
+                       static_cast<std::uint64_t>(base_price_)) /
+                      static_cast<std::uint64_t>(tick_size_);
+  return offset < bids_.size() ? static_cast<std::size_t>(offset) : kNoLevel;
+}
+
+std::int64_t TickLadderBook::ToPrice(std::size_t idx) const {
+  return base_price_ + static_cast<std::int64_t>(idx) * tick_size_;
+}
+
+bool TickLadderBook::IsBetter(Side side, std::int64_t price) const {
+  if (side == Side::Bid) {
+    return best_bid_ == kNoLevel || price > ToPrice(best_bid_);
+  }
+  return best_ask_ == kNoLevel || price < ToPrice(best_ask_);
+}
+
+void TickLadderBook::Recenter(std::int64_t price) {
+  const auto half_width =
+      static_cast<std::int64_t>(bids_.size() / 2) * tick_size_;
+  if (IsEmpty()) {
+    base_price_ = price - half_width;
+    return;
+  }
+  // Shift by whole ticks to keep the existing levels aligned
+  const auto shift = (price - half_width - base_price_) / tick_size_;
+  const auto tick_count = static_cast<std::int64_t>(bids_.size());
+  for (auto* levels : {&bids_, &asks_}) {
+    if (shift >= tick_count || shift <= -tick_count) {
+      std::fill(levels->begin(), levels->end(), Level{});
+    } else if (shift > 0) {
+      std::copy(levels->begin() + shift, levels->end(), levels->begin());
+      std::fill(levels->end() - shift, levels->end(), Level{});
+    } else if (shift < 0) {
+      std::copy_backward(levels->begin(), levels->end() + shift,
+                         levels->end());
+      std::fill(levels->begin(), levels->begin() - shift, Level{});
+    }
+  }
+  base_price_ += shift * tick_size_;
+  best_bid_ = FindBidAtOrBelow(bids_.size() - 1);
+  best_ask_ = FindAskAtOrAbove(0);
+}
+
+void TickLadderBook::ApplySide(Side side, const BidAskPair* levels,
+                               std::size_t level_count) {
+  std::size_t defined_count = 0;
+  while (defined_count < level_count &&
+         SidePrice(levels[defined_count], side) != kUndefPrice) {
+    ++defined_count;
+  }
+  if (defined_count < level_count) {
+    // The levels describe the whole side
+    ClearSide(side);
+  } else if (defined_count > 0) {
+    // The levels describe the side up to the worst one, so remove any levels
+    // at or better than it
+    const auto worst = SidePrice(levels[defined_count - 1], side);
+    if (side == Side::Bid) {
+      if (best_bid_ != kNoLevel && worst <= ToPrice(best_bid_)) {
+        const auto first = worst < base_price_ ? 0 : ToIndex(worst);
+        std::fill(bids_.begin() + static_cast<std::ptrdiff_t>(first),
+                  bids_.begin() + static_cast<std::ptrdiff_t>(best_bid_ + 1),
+                  Level{});
+        best_bid_ = first == 0 ? kNoLevel : FindBidAtOrBelow(first - 1);
+      }
+    } else if (best_ask_ != kNoLevel && worst >= ToPrice(best_ask_)) {
+      const auto last = std::min(ToIndex(worst), asks_.size() - 1);
+      std::fill(asks_.begin() + static_cast<std::ptrdiff_t>(best_ask_),
+                asks_.begin() + static_cast<std::ptrdiff_t>(last + 1),
+                Level{});
+      best_ask_ = FindAskAtOrAbove(last + 1);
+    }
+  }
+  for (std::size_t i = 0; i < defined_count; ++i) {
+    const auto& pair = levels[i];
+    if (side == Side::Bid) {
+      SetLevel(side, pair.bid_px, pair.bid_sz, pair.bid_ct);
+    } else {
+      SetLevel(side, pair.ask_px, pair.ask_sz, pair.ask_ct);
+    }
+  }
+}
+
+void TickLadderBook::ClearSide(Side side) {
+  auto& levels = SideLevels(side);
+  std::fill(levels.begin(), levels.end(), Level{});
+  if (side == Side::Bid) {
+    best_bid_ = kNoLevel;
+  } else {
+    best_ask_ = kNoLevel;
+  }
+}
+
+std::size_t TickLadderBook::FindBidAtOrBelow(std::size_t idx) const {
+  for (auto i = idx + 1; i > 0; --i) {
+    if (bids_[i - 1].size > 0) {
+      return i - 1;
+    }
+  }
+  return kNoLevel;
+}
+
+std::size_t TickLadderBook::FindAskAtOrAbove(std::size_t idx) const {
+  for (auto i = idx; i < asks_.size(); ++i) {
+    if (asks_[i].size > 0) {
+      return i;
+    }
+  }
+  return kNoLevel;
+}
@@ -0,0 +1,195 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <utility>  // move
+#include <vector>
+
+#include "databento/bar_builder.hpp"
+#include "databento/datetime.hpp"
+#include "databento/dbn.hpp"
+#include "databento/dbn_encoder.hpp"
+#include "databento/dbn_file_store.hpp"
+#include "databento/detail/file_stream.hpp"
+#include "databento/enums.hpp"
+#include "databento/exceptions.hpp"
+#include "databento/iwritable.hpp"
+#include "databento/record.hpp"
+#include "databento/timeseries.hpp"
+#include "temp_file.hpp"
+
+namespace databento {
+namespace test {
+class BarBuilderTests : public testing::Test {
+ protected:
+  static UnixNanos Millis(std::int64_t count) {
+    return UnixNanos{std::chrono::milliseconds{count}};
+  }
+
+  static TradeMsg GenTrade(std::uint32_t instrument_id, UnixNanos ts_event,
+                           std::int64_t price, std::uint32_t size) {
+    TradeMsg res{};
+    res.hd = RecordHeader{sizeof(TradeMsg) / RecordHeader::kLengthMultiplier,
+                          RType::Mbp0, 1, instrument_id, ts_event};
+    res.price = price;
+    res.size = size;
+    res.action = Action::Trade;
+    return res;
+  }
+
+  static void CheckBar(const OhlcvMsg& bar, std::uint32_t instrument_id,
+                       UnixNanos ts_event, std::int64_t open,
+                       std::int64_t high, std::int64_t low, std::int64_t close,
+                       std::uint64_t volume) {
+    EXPECT_EQ(bar.hd.instrument_id, instrument_id);
+    EXPECT_EQ(bar.hd.ts_event, ts_event);
+    EXPECT_EQ(bar.open, open);
+    EXPECT_EQ(bar.high, high);
+    EXPECT_EQ(bar.low, low);
+    EXPECT_EQ(bar.close, close);
+    EXPECT_EQ(bar.volume, volume);
+  }
+
+  BarBuilder::BarCallback Collect() {
+    return [this](const OhlcvMsg& bar) { bars_.emplace_back(bar); };
+  }
+
+  std::vector<OhlcvMsg> bars_;
+};
+
+TEST_F(BarBuilderTests, TestInvalidArguments) {
+  ASSERT_THROW(BarBuilder::TimeBars(std::chrono::nanoseconds{0}, Collect()),
+               InvalidArgumentError);
+  ASSERT_THROW(BarBuilder::VolumeBars(0, Collect()), InvalidArgumentError);
+}
+
+TEST_F(BarBuilderTests, TestTimeBars) {
+  auto target = BarBuilder::TimeBars(std::chrono::milliseconds{250}, Collect());
+  target.OnTrade(1, 1, Millis(1010), 100, 1);
+  target.OnTrade(2, 1, Millis(1020), 500, 5);
+  target.OnTrade(1, 1, Millis(1100), 103, 2);
+  target.OnTrade(1, 1, Millis(1200), 99, 3);
+  target.OnTrade(1, 1, Millis(1249), 101, 4);
+  EXPECT_TRUE(bars_.empty());
+  EXPECT_EQ(target.InstrumentCount(), 2);
+  // Closes the bar of instrument 1 only
+  target.OnTrade(1, 1, Millis(1250), 102, 1);
+  ASSERT_EQ(bars_.size(), 1);
+  CheckBar(bars_[0], 1, Millis(1000), 100, 103, 99, 101, 10);
+  EXPECT_EQ(bars_[0].hd.rtype, RType::OhlcvDeprecated);
+  // A late trade is added to the open bar
+  target.OnTrade(1, 1, Millis(1240), 104, 1);
+  // Intervals without trades are skipped
+  target.OnTrade(1, 1, Millis(2000), 98, 2);
+  ASSERT_EQ(bars_.size(), 2);
+  CheckBar(bars_[1], 1, Millis(1250), 102, 104, 102, 104, 2);
+
+  target.Flush(Millis(1999));
+  ASSERT_EQ(bars_.size(), 3);
+  CheckBar(bars_[2], 2, Millis(1000), 500, 500, 500, 500, 5);
+  target.Flush(Millis(2249));
+  EXPECT_EQ(bars_.size(), 3);
+  target.FlushAll();
+  ASSERT_EQ(bars_.size(), 4);
+  CheckBar(bars_[3], 1, Millis(2000), 98, 98, 98, 98, 2);
+  target.FlushAll();
+  EXPECT_EQ(bars_.size(), 4);
+
+  auto second_bars = BarBuilder::TimeBars(std::chrono::seconds{1}, Collect());
+  second_bars.OnTrade(1, 1, Millis(1000), 100, 1);
+  second_bars.FlushAll();
+  ASSERT_EQ(bars_.size(), 5);
+  EXPECT_EQ(bars_[4].hd.rtype, RType::Ohlcv1S);
+}
+
+TEST_F(BarBuilderTests, TestVolumeBars) {
+  auto target = BarBuilder::VolumeBars(10, Collect());
+  target.OnTrade(1, 1, Millis(1), 100, 4);
+  target.OnTrade(1, 1, Millis(2), 105, 5);
+  target.Flush(Millis(1000000));
+  EXPECT_TRUE(bars_.empty());
+  // Exceeds the volume
+  target.OnTrade(1, 1, Millis(3), 95, 3);
+  ASSERT_EQ(bars_.size(), 1);
+  CheckBar(bars_[0], 1, Millis(1), 100, 105, 95, 95, 12);
+  target.OnTrade(1, 1, Millis(4), 96, 10);
+  ASSERT_EQ(bars_.size(), 2);
+  CheckBar(bars_[1], 1, Millis(4), 96, 96, 96, 96, 10);
+  target.OnTrade(1, 1, Millis(5), 97, 1);
+  target.FlushAll();
+  ASSERT_EQ(bars_.size(), 3);
+  CheckBar(bars_[2], 1, Millis(5), 97, 97, 97, 97, 1);
+}
+
+TEST_F(BarBuilderTests, TestPublishersHaveSeparateBars) {
+  auto target = BarBuilder::TimeBars(std::chrono::seconds{1}, Collect());
+  target.OnTrade(1, 1, Millis(100), 100, 1);
+  target.OnTrade(1, 2, Millis(200), 200, 2);
+  target.OnTrade(1, 1, Millis(300), 101, 3);
+  EXPECT_EQ(target.InstrumentCount(), 2);
+  target.FlushAll();
+  ASSERT_EQ(bars_.size(), 2);
+  CheckBar(bars_[0], 1, Millis(0), 100, 101, 100, 101, 4);
+  EXPECT_EQ(bars_[0].hd.publisher_id, 1);
+  CheckBar(bars_[1], 1, Millis(0), 200, 200, 200, 200, 2);
+  EXPECT_EQ(bars_[1].hd.publisher_id, 2);
+}
+
+TEST_F(BarBuilderTests, TestOnRecordIgnoresNonTrades) {
+  auto target = BarBuilder::VolumeBars(1, Collect());
+  auto trade = GenTrade(1, Millis(1), 100, 1);
+  target.OnRecord(Record{&trade.hd});
+  Mbp1Msg mbp{};
+  mbp.hd = RecordHeader{sizeof(Mbp1Msg) / RecordHeader::kLengthMultiplier,
+                        RType::Mbp1, 1, 2, Millis(2)};
+  mbp.price = 200;
+  mbp.size = 1;
+  mbp.action = Action::Add;
+  target.OnRecord(Record{&mbp.hd});
+  mbp.action = Action::Trade;
+  target.OnRecord(Record{&mbp.hd});
+  ASSERT_EQ(bars_.size(), 2);
+  CheckBar(bars_[0], 1, Millis(1), 100, 100, 100, 100, 1);
+  CheckBar(bars_[1], 2, Millis(2), 200, 200, 200, 200, 1);
+}
+
+TEST_F(BarBuilderTests, TestReplayAndEncode) {
+  DbnFileStore store{TEST_BUILD_DIR "/data/test_data.trades.dbn"};
+  Metadata metadata;
+  std::uint64_t trade_volume{};
+  auto target = BarBuilder::TimeBars(std::chrono::seconds{1}, Collect());
+  store.Replay([&metadata](Metadata&& m) { metadata = std::move(m); },
+               [&target, &trade_volume](const Record& record) {
+                 trade_volume += record.Get<TradeMsg>().size;
+                 target.OnRecord(record);
+                 return KeepGoing::Continue;
+               });
+  target.FlushAll();
+  ASSERT_FALSE(bars_.empty());
+  std::uint64_t bar_volume{};
+  for (const auto& bar : bars_) {
+    bar_volume += bar.volume;
+  }
+  EXPECT_EQ(bar_volume, trade_volume);
+
+  const TempFile temp_file{testing::TempDir() + "/bars.ohlcv-1s.dbn"};
+  metadata.schema = Schema::Ohlcv1S;
+  {
+    DbnEncoder encoder{metadata,
+                       std::unique_ptr<IWritable>{
+                           new detail::OutFileStream{temp_file.Path()}}};
+    for (const auto& bar : bars_) {
+      encoder.EncodeRecord(bar);
+    }
+    encoder.Finish();
+  }
+  std::vector<OhlcvMsg> decoded;
+  DbnFileStore{temp_file.Path()}.Replay([&decoded](const Record& record) {
+    decoded.emplace_back(record.Get<OhlcvMsg>());
+    return KeepGoing::Continue;
+  });
+  EXPECT_EQ(decoded, bars_);
+}
+}  // namespace test
+}  // namespace databento
@@ -0,0 +1,196 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>  // max, min
+#include <cmath>      // isnan
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "databento/column_kernels.hpp"
+#include "databento/datetime.hpp"
+#include "databento/exceptions.hpp"
+#include "databento/flag_set.hpp"
+
+namespace databento {
+namespace test {
+class ColumnKernelsTests : public testing::TestWithParam<KernelIsa> {
+ protected:
+  // Not a multiple of any vector width to test the remainder
+  static constexpr std::size_t kCount = 1003;
+
+  void SetUp() override {
+    if (!ColumnKernels::IsSupported(GetParam())) {
+      GTEST_SKIP() << "Not supported by this CPU";
+    }
+    target_.reset(new ColumnKernels{GetParam()});
+    std::mt19937_64 gen{42};
+    std::uniform_int_distribution<std::int64_t> price_dist{-1000, 1000};
+    std::uniform_int_distribution<std::uint32_t> small_dist{0, 20};
+    for (std::size_t i = 0; i < kCount; ++i) {
+      prices_.emplace_back(price_dist(gen));
+      sizes_.emplace_back(small_dist(gen));
+      instrument_ids_.emplace_back(small_dist(gen));
+      flags_.emplace_back(static_cast<std::uint8_t>(gen()));
+      // Crosses the sign bit
+      timestamps_.emplace_back(std::uint64_t{1} << 63 | gen() % 1000);
+      mask_.emplace_back(static_cast<std::uint8_t>(gen() % 3));
+    }
+    // Extremes
+    prices_[7] = std::numeric_limits<std::int64_t>::max();
+    prices_[8] = std::numeric_limits<std::int64_t>::min();
+    timestamps_[9] = 0;
+    timestamps_[10] = std::numeric_limits<std::uint64_t>::max();
+  }
+
+  std::unique_ptr<ColumnKernels> target_;
+  std::vector<std::int64_t> prices_;
+  std::vector<std::uint32_t> sizes_;
+  std::vector<std::uint32_t> instrument_ids_;
+  std::vector<std::uint8_t> flags_;
+  std::vector<std::uint64_t> timestamps_;
+  // Nonzero values other than 1 are also selected
+  std::vector<std::uint8_t> mask_;
+  std::vector<std::uint8_t> res_ = std::vector<std::uint8_t>(kCount, 0xFF);
+};
+
+constexpr std::size_t ColumnKernelsTests::kCount;
+
+INSTANTIATE_TEST_SUITE_P(
+    AllIsas, ColumnKernelsTests,
+    testing::Values(KernelIsa::Scalar, KernelIsa::Sse42, KernelIsa::Avx2),
+    [](const testing::TestParamInfo<KernelIsa>& test_info) {
+      // Names can't contain '.'
+      auto name = std::string{ToString(test_info.param)};
+      name.erase(std::remove(name.begin(), name.end(), '.'), name.end());
+      return name;
+    });
+
+TEST_P(ColumnKernelsTests, TestRangeMask) {
+  target_->RangeMask(prices_.data(), kCount, -100, 250, res_.data());
+  for (std::size_t i = 0; i < kCount; ++i) {
+    EXPECT_EQ(res_[i], prices_[i] >= -100 && prices_[i] <= 250) << i;
+  }
+  target_->RangeMask(prices_.data(), kCount,
+                     std::numeric_limits<std::int64_t>::min(),
+                     std::numeric_limits<std::int64_t>::max(), res_.data());
+  EXPECT_EQ(target_->CountMask(res_.data(), kCount), kCount);
+}
+
+TEST_P(ColumnKernelsTests, TestTimeRangeMask) {
+  const auto start = (std::uint64_t{1} << 63) + 200;
+  const auto end = (std::uint64_t{1} << 63) + 700;
+  target_->TimeRangeMask(timestamps_.data(), kCount,
+                         UnixNanos{UnixNanos::duration{start}},
+                         UnixNanos{UnixNanos::duration{end}}, res_.data());
+  for (std::size_t i = 0; i < kCount; ++i) {
+    EXPECT_EQ(res_[i], timestamps_[i] >= start && timestamps_[i] < end) << i;
+  }
+  EXPECT_EQ(res_[9], 0);
+  EXPECT_EQ(res_[10], 0);
+}
+
+TEST_P(ColumnKernelsTests, TestInstrumentIdMask) {
+  // Compared and binary searched
+  for (const auto& ids : {std::vector<std::uint32_t>{3, 5, 19},
+                          std::vector<std::uint32_t>{20, 0, 1, 2, 3, 4, 5, 6,
+                                                     7, 8, 9, 10, 11, 12, 13,
+                                                     14, 15}}) {
+    target_->InstrumentIdMask(instrument_ids_.data(), kCount, ids,
+                              res_.data());
+    for (std::size_t i = 0; i < kCount; ++i) {
+      bool is_match = false;
+      for (const auto id : ids) {
+        is_match = is_match || instrument_ids_[i] == id;
+      }
+      EXPECT_EQ(res_[i], is_match) << i;
+    }
+  }
+  target_->InstrumentIdMask(instrument_ids_.data(), kCount, {}, res_.data());
+  EXPECT_EQ(target_->CountMask(res_.data(), kCount), 0);
+}
+
+TEST_P(ColumnKernelsTests, TestFlagMask) {
+  const FlagSet flags = FlagSet::kLast | FlagSet::kBadTsRecv;
+  target_->FlagMask(flags_.data(), kCount, flags, res_.data());
+  for (std::size_t i = 0; i < kCount; ++i) {
+    EXPECT_EQ(res_[i], (flags_[i] & static_cast<std::uint8_t>(flags)) != 0)
+        << i;
+  }
+}
+
+TEST_P(ColumnKernelsTests, TestAndMask) {
+  target_->FlagMask(flags_.data(), kCount, FlagSet::kLast, res_.data());
+  const auto flag_mask = res_;
+  target_->AndMask(mask_.data(), kCount, res_.data());
+  std::size_t expected_count{};
+  for (std::size_t i = 0; i < kCount; ++i) {
+    const bool expected = flag_mask[i] != 0 && mask_[i] != 0;
+    EXPECT_EQ(res_[i], expected) << i;
+    expected_count += expected;
+  }
+  EXPECT_EQ(target_->CountMask(res_.data(), kCount), expected_count);
+}
+
+TEST_P(ColumnKernelsTests, TestReductions) {
+  std::size_t count{};
+  std::int64_t sum{};
+  std::uint64_t size_sum{};
+  auto min = std::numeric_limits<std::int64_t>::max();
+  auto max = std::numeric_limits<std::int64_t>::min();
+  double notional{};
+  // Exclude the extremes so the sum doesn't overflow
+  mask_[7] = 0;
+  mask_[8] = 0;
+  for (std::size_t i = 0; i < kCount; ++i) {
+    if (mask_[i] != 0) {
+      ++count;
+      sum += prices_[i];
+      size_sum += sizes_[i];
+      min = std::min(min, prices_[i]);
+      max = std::max(max, prices_[i]);
+      notional += static_cast<double>(prices_[i]) * sizes_[i];
+    }
+  }
+  EXPECT_EQ(target_->CountMask(mask_.data(), kCount), count);
+  EXPECT_EQ(target_->Sum(prices_.data(), mask_.data(), kCount), sum);
+  EXPECT_EQ(target_->Sum(sizes_.data(), mask_.data(), kCount), size_sum);
+  EXPECT_EQ(target_->Min(prices_.data(), mask_.data(), kCount), min);
+  EXPECT_EQ(target_->Max(prices_.data(), mask_.data(), kCount), max);
+  EXPECT_DOUBLE_EQ(
+      target_->Vwap(prices_.data(), sizes_.data(), mask_.data(), kCount),
+      notional / static_cast<double>(size_sum));
+  // Extremes
+  mask_[7] = 1;
+  mask_[8] = 1;
+  EXPECT_EQ(target_->Min(prices_.data(), mask_.data(), kCount),
+            std::numeric_limits<std::int64_t>::min());
+  EXPECT_EQ(target_->Max(prices_.data(), mask_.data(), kCount),
+            std::numeric_limits<std::int64_t>::max());
+}
+
+TEST_P(ColumnKernelsTests, TestReductionsNoneSelected) {
+  const std::vector<std::uint8_t> none(kCount, 0);
+  EXPECT_EQ(target_->CountMask(none.data(), kCount), 0);
+  EXPECT_EQ(target_->Sum(prices_.data(), none.data(), kCount), 0);
+  EXPECT_EQ(target_->Min(prices_.data(), none.data(), kCount),
+            std::numeric_limits<std::int64_t>::max());
+  EXPECT_EQ(target_->Max(prices_.data(), none.data(), kCount),
+            std::numeric_limits<std::int64_t>::min());
+  EXPECT_TRUE(std::isnan(
+      target_->Vwap(prices_.data(), sizes_.data(), none.data(), kCount)));
+}
+
+TEST(ColumnKernelsIsaTests, TestBestIsa) {
+  const ColumnKernels target;
+  EXPECT_EQ(target.Isa(), ColumnKernels::BestIsa());
+  EXPECT_TRUE(ColumnKernels::IsSupported(KernelIsa::Scalar));
+  if (!ColumnKernels::IsSupported(KernelIsa::Avx2)) {
+    ASSERT_THROW(ColumnKernels{KernelIsa::Avx2}, InvalidArgumentError);
+  }
+}
+}  // namespace test
+}  // namespace databento
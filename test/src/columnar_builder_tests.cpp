@@ -0,0 +1,212 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>  // memcpy
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "databento/columnar_builder.hpp"
+#include "databento/dbn_decoder.hpp"
+#include "databento/dbn_file_store.hpp"
+#include "databento/detail/file_stream.hpp"
+#include "databento/enums.hpp"
+#include "databento/exceptions.hpp"
+#include "databento/ireadable.hpp"
+#include "databento/record.hpp"
+
+namespace databento {
+namespace test {
+class ColumnarBuilderTests : public testing::Test {
+ protected:
+  // Decodes the file at `file_path` into `target_` and returns its records.
+  std::vector<std::vector<std::uint8_t>> Build(const std::string& file_path,
+                                               Schema schema) {
+    target_.reset(new ColumnarBuilder{schema, 16});
+    DbnDecoder decoder{
+        std::unique_ptr<IReadable>{new detail::FileStream{file_path}}};
+    decoder.DecodeMetadata();
+    const auto appended = target_->Append(&decoder);
+    EXPECT_EQ(appended, target_->RowCount());
+
+    std::vector<std::vector<std::uint8_t>> records;
+    DbnFileStore{file_path}.Replay([&records](const Record& record) {
+      const auto* data =
+          reinterpret_cast<const std::uint8_t*>(&record.Header());
+      records.emplace_back(data, data + record.Size());
+      return KeepGoing::Continue;
+    });
+    EXPECT_EQ(records.size(), target_->RowCount());
+    return records;
+  }
+
+  template <typename R>
+  static const R& As(const std::vector<std::uint8_t>& record) {
+    return *reinterpret_cast<const R*>(record.data());
+  }
+
+  void CheckHeader(std::size_t row, const RecordHeader& hd) {
+    EXPECT_EQ(target_->PublisherId()[row], hd.publisher_id);
+    EXPECT_EQ(target_->InstrumentId()[row], hd.instrument_id);
+    EXPECT_EQ(target_->TsEvent()[row], hd.ts_event.time_since_epoch().count());
+  }
+
+  template <typename R>
+  void CheckTradeFields(std::size_t row, const R& rec) {
+    CheckHeader(row, rec.hd);
+    EXPECT_EQ(target_->Price()[row], rec.price);
+    EXPECT_EQ(target_->Size()[row], rec.size);
+    EXPECT_EQ(target_->Action()[row], static_cast<char>(rec.action));
+    EXPECT_EQ(target_->Side()[row], static_cast<char>(rec.side));
+    EXPECT_EQ(target_->Flags()[row], static_cast<std::uint8_t>(rec.flags));
+    EXPECT_EQ(target_->Depth()[row], rec.depth);
+    EXPECT_EQ(target_->TsRecv()[row], rec.ts_recv.time_since_epoch().count());
+    EXPECT_EQ(target_->TsInDelta()[row], rec.ts_in_delta.count());
+    EXPECT_EQ(target_->Sequence()[row], rec.sequence);
+  }
+
+  template <typename R>
+  void CheckLevels(std::size_t row, const R& rec) {
+    ASSERT_EQ(target_->LevelCount(), rec.levels.size());
+    for (std::size_t i = 0; i < rec.levels.size(); ++i) {
+      EXPECT_EQ(target_->BidPx(i)[row], rec.levels[i].bid_px);
+      EXPECT_EQ(target_->AskPx(i)[row], rec.levels[i].ask_px);
+      EXPECT_EQ(target_->BidSz(i)[row], rec.levels[i].bid_sz);
+      EXPECT_EQ(target_->AskSz(i)[row], rec.levels[i].ask_sz);
+      EXPECT_EQ(target_->BidCt(i)[row], rec.levels[i].bid_ct);
+      EXPECT_EQ(target_->AskCt(i)[row], rec.levels[i].ask_ct);
+    }
+  }
+
+  std::unique_ptr<ColumnarBuilder> target_;
+};
+
+TEST_F(ColumnarBuilderTests, TestUnsupportedSchema) {
+  ASSERT_THROW(ColumnarBuilder{Schema::Definition}, InvalidArgumentError);
+  ASSERT_THROW((ColumnarBuilder{Schema::Mbo, 0}), InvalidArgumentError);
+}
+
+TEST_F(ColumnarBuilderTests, TestMbo) {
+  const auto records =
+      Build(TEST_BUILD_DIR "/data/test_data.mbo.dbn.zst", Schema::Mbo);
+  ASSERT_FALSE(records.empty());
+  for (std::size_t row = 0; row < records.size(); ++row) {
+    const auto& rec = As<MboMsg>(records[row]);
+    CheckHeader(row, rec.hd);
+    EXPECT_EQ(target_->OrderId()[row], rec.order_id);
+    EXPECT_EQ(target_->Price()[row], rec.price);
+    EXPECT_EQ(target_->Size()[row], rec.size);
+    EXPECT_EQ(target_->Flags()[row], static_cast<std::uint8_t>(rec.flags));
+    EXPECT_EQ(target_->ChannelId()[row], rec.channel_id);
+    EXPECT_EQ(target_->Action()[row], static_cast<char>(rec.action));
+    EXPECT_EQ(target_->Side()[row], static_cast<char>(rec.side));
+    EXPECT_EQ(target_->TsInDelta()[row], rec.ts_in_delta.count());
+    EXPECT_EQ(target_->Sequence()[row], rec.sequence);
+  }
+  // Only the MBO columns are filled
+  EXPECT_TRUE(target_->Depth().IsEmpty());
+  EXPECT_TRUE(target_->Open().IsEmpty());
+  EXPECT_EQ(target_->LevelCount(), 0);
+}
+
+TEST_F(ColumnarBuilderTests, TestTrades) {
+  const auto records =
+      Build(TEST_BUILD_DIR "/data/test_data.trades.dbn", Schema::Trades);
+  ASSERT_FALSE(records.empty());
+  for (std::size_t row = 0; row < records.size(); ++row) {
+    CheckTradeFields(row, As<TradeMsg>(records[row]));
+  }
+  EXPECT_TRUE(target_->OrderId().IsEmpty());
+}
+
+TEST_F(ColumnarBuilderTests, TestMbp1) {
+  const auto records =
+      Build(TEST_BUILD_DIR "/data/test_data.mbp-1.dbn", Schema::Mbp1);
+  ASSERT_FALSE(records.empty());
+  for (std::size_t row = 0; row < records.size(); ++row) {
+    const auto& rec = As<Mbp1Msg>(records[row]);
+    CheckTradeFields(row, rec);
+    CheckLevels(row, rec);
+  }
+}
+
+TEST_F(ColumnarBuilderTests, TestMbp10) {
+  const auto records =
+      Build(TEST_BUILD_DIR "/data/test_data.mbp-10.dbn.zst", Schema::Mbp10);
+  ASSERT_FALSE(records.empty());
+  for (std::size_t row = 0; row < records.size(); ++row) {
+    const auto& rec = As<Mbp10Msg>(records[row]);
+    CheckTradeFields(row, rec);
+    CheckLevels(row, rec);
+  }
+}
+
+TEST_F(ColumnarBuilderTests, TestOhlcv) {
+  const auto records =
+      Build(TEST_BUILD_DIR "/data/test_data.ohlcv-1s.dbn", Schema::Ohlcv1S);
+  ASSERT_FALSE(records.empty());
+  for (std::size_t row = 0; row < records.size(); ++row) {
+    const auto& rec = As<OhlcvMsg>(records[row]);
+    CheckHeader(row, rec.hd);
+    EXPECT_EQ(target_->Open()[row], rec.open);
+    EXPECT_EQ(target_->High()[row], rec.high);
+    EXPECT_EQ(target_->Low()[row], rec.low);
+    EXPECT_EQ(target_->Close()[row], rec.close);
+    EXPECT_EQ(target_->Volume()[row], rec.volume);
+  }
+  EXPECT_TRUE(target_->Price().IsEmpty());
+}
+
+TEST_F(ColumnarBuilderTests, TestGrowAndSkip) {
+  constexpr std::size_t kChunkSize = 100;
+  ColumnarBuilder target{Schema::Trades, kChunkSize};
+  // Trades interleaved with an MBO record, which is skipped
+  std::vector<std::uint8_t> buffer;
+  const auto push = [&buffer](const RecordHeader& hd) {
+    const auto* data = reinterpret_cast<const std::uint8_t*>(&hd);
+    buffer.insert(buffer.end(), data, data + hd.Size());
+  };
+  for (std::uint32_t i = 0; i < 250; ++i) {
+    TradeMsg trade{};
+    trade.hd.length = sizeof(TradeMsg) / RecordHeader::kLengthMultiplier;
+    trade.hd.rtype = RType::Mbp0;
+    trade.hd.instrument_id = i;
+    trade.price = i * 10;
+    push(trade.hd);
+    if (i % 100 == 50) {
+      MboMsg mbo{};
+      mbo.hd.length = sizeof(MboMsg) / RecordHeader::kLengthMultiplier;
+      mbo.hd.rtype = RType::Mbo;
+      push(mbo.hd);
+    }
+  }
+  // Copy to 8-byte aligned storage
+  std::vector<std::uint64_t> aligned(buffer.size() / 8);
+  std::memcpy(aligned.data(), buffer.data(), buffer.size());
+  const RecordBatch batch{reinterpret_cast<std::uint8_t*>(aligned.data()),
+                          buffer.size()};
+  EXPECT_EQ(target.Append(batch), 250);
+  ASSERT_EQ(target.RowCount(), 250);
+  EXPECT_EQ(target.Price().Capacity() % kChunkSize, 0);
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(target.Price().Data()) %
+                Column<std::int64_t>::kAlignment,
+            0);
+  for (std::uint32_t i = 0; i < 250; ++i) {
+    EXPECT_EQ(target.InstrumentId()[i], i);
+    EXPECT_EQ(target.Price()[i], i * 10);
+  }
+  // A single record
+  const Record record{reinterpret_cast<RecordHeader*>(aligned.data())};
+  EXPECT_TRUE(target.Append(record));
+  EXPECT_EQ(target.RowCount(), 251);
+  EXPECT_EQ(target.InstrumentId()[250], 0);
+
+  const auto capacity = target.Price().Capacity();
+  target.Clear();
+  EXPECT_EQ(target.RowCount(), 0);
+  EXPECT_TRUE(target.Price().IsEmpty());
+  EXPECT_EQ(target.Price().Capacity(), capacity);
+}
+}  // namespace test
+}  // namespace databento
@@ -1,4 +1,5 @@
 #include <gtest/gtest.h>
+#include <zstd.h>
 
 #include <cstddef>
 #include <cstdint>
@@ -12,12 +13,14 @@
 #include "databento/dbn.hpp"
 #include "databento/dbn_decoder.hpp"
 #include "databento/detail/file_stream.hpp"
+#include "databento/detail/mmap_file.hpp"
 #include "databento/detail/scoped_thread.hpp"
 #include "databento/detail/shared_channel.hpp"
 #include "databento/enums.hpp"
 #include "databento/exceptions.hpp"
 #include "databento/ireadable.hpp"
 #include "databento/record.hpp"
+#include "databento/record_filter.hpp"
 
 namespace databento {
 namespace test {
@@ -60,6 +63,17 @@ class DbnDecoderTests : public testing::Test {
         upgrade_policy});
   }
 
+  static std::vector<std::uint8_t> ReadFileBytes(const std::string& file_path) {
+    std::ifstream input_file{file_path, std::ios::binary | std::ios::ate};
+    EXPECT_TRUE(input_file.good());
+    const auto size = static_cast<std::size_t>(input_file.tellg());
+    input_file.seekg(0, std::ios::beg);
+    std::vector<std::uint8_t> buffer(size);
+    input_file.read(reinterpret_cast<char*>(buffer.data()),
+                    static_cast<std::streamsize>(size));
+    return buffer;
+  }
+
   static void AssertMappings(const std::vector<SymbolMapping>& mappings) {
     ASSERT_EQ(mappings.size(), 1);
     const auto& mapping = mappings.at(0);
@@ -138,6 +152,322 @@ TEST_F(DbnDecoderTests, TestDecodeDefinitionUpgrade) {
   AssertDefEq<InstrumentDefMsgV2>(ch_record2, f_record2);
 }
 
+TEST_F(DbnDecoderTests, TestDecodeMemoryMappedMatchesStream) {
+  for (const auto* schema_str :
+       {"mbo", "mbp-1", "mbp-10", "tbbo", "trades", "ohlcv-1s", "ohlcv-1h",
+        "definition", "imbalance", "statistics"}) {
+    for (const auto* extension : {".dbn", ".dbn.zst"}) {
+      for (const auto* version_str : {".v1", ""}) {
+        const std::string file_path = TEST_BUILD_DIR "/data/test_data." +
+                                      std::string{schema_str} + version_str +
+                                      extension;
+        SCOPED_TRACE(file_path);
+        DbnDecoder stream_target{
+            std::unique_ptr<IReadable>{new detail::FileStream{file_path}},
+            VersionUpgradePolicy::Upgrade};
+        DbnDecoder mmap_target{detail::MmapFile{file_path},
+                               VersionUpgradePolicy::Upgrade};
+        EXPECT_EQ(stream_target.DecodeMetadata(), mmap_target.DecodeMetadata());
+        std::size_t record_count{};
+        const Record* stream_record;
+        while ((stream_record = stream_target.DecodeRecord()) != nullptr) {
+          const Record* mmap_record = mmap_target.DecodeRecord();
+          ASSERT_NE(mmap_record, nullptr);
+          ASSERT_EQ(stream_record->Size(), mmap_record->Size());
+          EXPECT_EQ(std::memcmp(&stream_record->Header(),
+                                &mmap_record->Header(), stream_record->Size()),
+                    0);
+          ++record_count;
+        }
+        EXPECT_EQ(mmap_target.DecodeRecord(), nullptr);
+        EXPECT_GT(record_count, 0);
+      }
+    }
+  }
+}
+
+TEST_F(DbnDecoderTests, TestDecodeRecordsMatchesDecodeRecord) {
+  for (const auto* schema_str :
+       {"mbo", "mbp-10", "trades", "definition", "statistics"}) {
+    for (const auto* extension : {".dbn", ".dbn.zst"}) {
+      for (const auto* version_str : {".v1", ""}) {
+        for (const auto upgrade_policy :
+             {VersionUpgradePolicy::AsIs, VersionUpgradePolicy::Upgrade}) {
+          const std::string file_path = TEST_BUILD_DIR "/data/test_data." +
+                                        std::string{schema_str} +
+                                        version_str + extension;
+          SCOPED_TRACE(file_path);
+          DbnDecoder record_target{
+              std::unique_ptr<IReadable>{new detail::FileStream{file_path}},
+              upgrade_policy};
+          DbnDecoder stream_target{
+              std::unique_ptr<IReadable>{new detail::FileStream{file_path}},
+              upgrade_policy};
+          DbnDecoder mmap_target{detail::MmapFile{file_path}, upgrade_policy};
+          record_target.DecodeMetadata();
+          stream_target.DecodeMetadata();
+          mmap_target.DecodeMetadata();
+          std::vector<std::vector<std::uint8_t>> expected;
+          const Record* record;
+          while ((record = record_target.DecodeRecord()) != nullptr) {
+            const auto* bytes =
+                reinterpret_cast<const std::uint8_t*>(&record->Header());
+            expected.emplace_back(bytes, bytes + record->Size());
+          }
+          ASSERT_FALSE(expected.empty());
+          for (auto* target : {&stream_target, &mmap_target}) {
+            std::size_t i = 0;
+            RecordBatch batch;
+            while (!(batch = target->DecodeRecords()).IsEmpty()) {
+              for (const Record batch_record : batch) {
+                ASSERT_LT(i, expected.size());
+                const auto* bytes = reinterpret_cast<const std::uint8_t*>(
+                    &batch_record.Header());
+                EXPECT_EQ(std::vector<std::uint8_t>(
+                              bytes, bytes + batch_record.Size()),
+                          expected[i]);
+                ++i;
+              }
+            }
+            EXPECT_EQ(i, expected.size());
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST_F(DbnDecoderTests, TestDecodeRecordsUpgradesWholeBatch) {
+  const std::string file_path =
+      TEST_BUILD_DIR "/data/test_data.definition.v1.dbn";
+  DbnDecoder as_is_target{detail::MmapFile{file_path},
+                          VersionUpgradePolicy::AsIs};
+  DbnDecoder target{detail::MmapFile{file_path},
+                    VersionUpgradePolicy::Upgrade};
+  as_is_target.DecodeMetadata();
+  target.DecodeMetadata();
+  const auto v1_batch = as_is_target.DecodeRecords();
+  const auto batch = target.DecodeRecords();
+  ASSERT_FALSE(batch.IsEmpty());
+  // Both definitions are upgraded in the same batch
+  EXPECT_EQ(batch.Size(), 2 * sizeof(InstrumentDefMsgV2));
+  auto v1_it = v1_batch.begin();
+  for (const Record record : batch) {
+    ASSERT_NE(v1_it, v1_batch.end());
+    const auto& v1_def = (*v1_it).Get<InstrumentDefMsgV1>();
+    ASSERT_TRUE(record.Holds<InstrumentDefMsgV2>());
+    const auto& def = record.Get<InstrumentDefMsgV2>();
+    EXPECT_EQ(def, v1_def.ToV2());
+    EXPECT_EQ(def.hd.ts_event, v1_def.hd.ts_event);
+    EXPECT_STREQ(def.RawSymbol(), v1_def.RawSymbol());
+    ++v1_it;
+  }
+  EXPECT_TRUE(target.DecodeRecords().IsEmpty());
+}
+
+TEST_F(DbnDecoderTests, TestDecodeInMemoryIsZeroCopy) {
+  const auto file_bytes =
+      ReadFileBytes(TEST_BUILD_DIR "/data/test_data.mbo.dbn");
+  const auto metadata_len =
+      DbnDecoder::DecodeMetadataVersionAndSize(file_bytes.data(),
+                                               file_bytes.size())
+          .second +
+      8;
+  // Offset the input so the first record is 8-byte aligned
+  const auto offset = (8 - metadata_len % 8) % 8;
+  std::vector<std::uint64_t> aligned_storage(file_bytes.size() / 8 + 2);
+  auto* buffer = reinterpret_cast<std::uint8_t*>(aligned_storage.data());
+  std::copy(file_bytes.cbegin(), file_bytes.cend(), buffer + offset);
+  const auto* buffer_end = buffer + offset + file_bytes.size();
+
+  DbnDecoder target{buffer + offset, file_bytes.size()};
+  const Metadata metadata = target.DecodeMetadata();
+  EXPECT_EQ(metadata.schema, Schema::Mbo);
+  std::size_t record_count{};
+  const Record* record;
+  while ((record = target.DecodeRecord()) != nullptr) {
+    const auto* record_ptr =
+        reinterpret_cast<const std::uint8_t*>(&record->Header());
+    EXPECT_GE(record_ptr, buffer + offset + metadata_len);
+    EXPECT_LT(record_ptr, buffer_end);
+    ASSERT_TRUE(record->Holds<MboMsg>());
+    EXPECT_EQ(record->Get<MboMsg>().hd.instrument_id, 5482);
+    ++record_count;
+  }
+  EXPECT_EQ(record_count, 2);
+}
+
+TEST_F(DbnDecoderTests, TestDecodeInMemoryTruncated) {
+  auto file_bytes = ReadFileBytes(TEST_BUILD_DIR "/data/test_data.mbo.dbn");
+  // Cut off part of the last record
+  file_bytes.resize(file_bytes.size() - 8);
+  DbnDecoder target{file_bytes.data(), file_bytes.size()};
+  target.DecodeMetadata();
+  ASSERT_NE(target.DecodeRecord(), nullptr);
+  ASSERT_EQ(target.DecodeRecord(), nullptr);
+}
+
+TEST_F(DbnDecoderTests, TestDecodeWrapsAroundBuffer) {
+  auto file_bytes = ReadFileBytes(TEST_BUILD_DIR "/data/test_data.mbp-10.dbn");
+  const auto metadata_end =
+      8 + DbnDecoder::DecodeMetadataVersionAndSize(file_bytes.data(),
+                                                   file_bytes.size())
+              .second;
+  // Repeat the records so they wrap around the smallest buffer many times
+  const std::vector<std::uint8_t> records{
+      file_bytes.cbegin() + static_cast<std::ptrdiff_t>(metadata_end),
+      file_bytes.cend()};
+  for (int i = 0; i < 50; ++i) {
+    file_bytes.insert(file_bytes.end(), records.cbegin(), records.cend());
+  }
+  channel_.Write(file_bytes.data(), file_bytes.size());
+  channel_.Finish();
+  DbnDecoder target{
+      std::unique_ptr<IReadable>{new detail::SharedChannel{channel_}},
+      VersionUpgradePolicy::AsIs, 1024};
+  DbnDecoder in_memory_target{file_bytes.data(), file_bytes.size()};
+  target.DecodeMetadata();
+  in_memory_target.DecodeMetadata();
+  std::size_t record_count = 0;
+  const Record* expected;
+  while ((expected = in_memory_target.DecodeRecord()) != nullptr) {
+    const auto* record = target.DecodeRecord();
+    ASSERT_NE(record, nullptr);
+    ASSERT_EQ(reinterpret_cast<std::uintptr_t>(&record->Header()) % 8, 0);
+    EXPECT_EQ(record->Get<Mbp10Msg>(), expected->Get<Mbp10Msg>());
+    ++record_count;
+  }
+  EXPECT_EQ(target.DecodeRecord(), nullptr);
+  EXPECT_EQ(record_count, records.size() / sizeof(Mbp10Msg) * 51);
+}
+
+TEST_F(DbnDecoderTests, TestDecodeFiltered) {
+  auto file_bytes = ReadFileBytes(TEST_BUILD_DIR "/data/test_data.mbo.dbn");
+  file_bytes.resize(8 + DbnDecoder::DecodeMetadataVersionAndSize(
+                            file_bytes.data(), file_bytes.size())
+                            .second);
+  const auto filter = RecordFilter{}
+                          .AddRType(RType::Mbo)
+                          .AddInstrumentId(1)
+                          .AddInstrumentId(3)
+                          .AddInstrumentId(100000000)
+                          .AddPublisherId(1);
+  std::vector<std::uint64_t> expected_order_ids;
+  constexpr std::size_t kRecordCount = 2000;
+  for (std::size_t i = 0; i < kRecordCount; ++i) {
+    std::vector<std::uint8_t> bytes;
+    MboMsg mbo{};
+    mbo.hd.length = sizeof(MboMsg) / RecordHeader::kLengthMultiplier;
+    mbo.hd.rtype = RType::Mbo;
+    mbo.hd.publisher_id = static_cast<std::uint16_t>(1 + i % 2);
+    mbo.hd.instrument_id =
+        i % 7 == 0 ? 100000000 : static_cast<std::uint32_t>(i % 5);
+    mbo.order_id = i;
+    if (i % 3 == 0) {
+      // A trade with the same header, which should be filtered out
+      TradeMsg trade{};
+      trade.hd = mbo.hd;
+      trade.hd.length = sizeof(TradeMsg) / RecordHeader::kLengthMultiplier;
+      trade.hd.rtype = RType::Mbp0;
+      const auto* trade_bytes = reinterpret_cast<const std::uint8_t*>(&trade);
+      file_bytes.insert(file_bytes.end(), trade_bytes,
+                        trade_bytes + sizeof(trade));
+    }
+    if (filter.Matches(mbo.hd)) {
+      expected_order_ids.emplace_back(i);
+    }
+    const auto* mbo_bytes = reinterpret_cast<const std::uint8_t*>(&mbo);
+    file_bytes.insert(file_bytes.end(), mbo_bytes, mbo_bytes + sizeof(mbo));
+  }
+  const std::uint64_t total_count = kRecordCount + (kRecordCount + 2) / 3;
+  ASSERT_FALSE(expected_order_ids.empty());
+  ASSERT_LT(expected_order_ids.size(), kRecordCount / 2);
+
+  channel_.Write(file_bytes.data(), file_bytes.size());
+  channel_.Finish();
+  DbnDecoder stream_target{
+      std::unique_ptr<IReadable>{new detail::SharedChannel{channel_}},
+      VersionUpgradePolicy::AsIs, 1024};
+  DbnDecoder in_memory_target{file_bytes.data(), file_bytes.size()};
+  DbnDecoder batch_target{file_bytes.data(), file_bytes.size()};
+  for (auto* target : {&stream_target, &in_memory_target, &batch_target}) {
+    target->SetFilter(filter);
+    target->DecodeMetadata();
+    std::vector<std::uint64_t> order_ids;
+    if (target == &batch_target) {
+      RecordBatch batch;
+      while (!(batch = target->DecodeRecords()).IsEmpty()) {
+        for (const Record record : batch) {
+          ASSERT_TRUE(record.Holds<MboMsg>());
+          order_ids.emplace_back(record.Get<MboMsg>().order_id);
+        }
+      }
+    } else {
+      const Record* record;
+      while ((record = target->DecodeRecord()) != nullptr) {
+        ASSERT_TRUE(record->Holds<MboMsg>());
+        order_ids.emplace_back(record->Get<MboMsg>().order_id);
+      }
+    }
+    EXPECT_EQ(order_ids, expected_order_ids);
+    EXPECT_EQ(target->FilterPassCount(), expected_order_ids.size());
+    EXPECT_EQ(target->FilterSkipCount(),
+              total_count - expected_order_ids.size());
+  }
+}
+
+TEST_F(DbnDecoderTests, TestBufferSizeTooSmall) {
+  ASSERT_THROW(
+      (DbnDecoder{std::unique_ptr<IReadable>{new detail::FileStream{
+                      TEST_BUILD_DIR "/data/test_data.mbo.dbn"}},
+                  VersionUpgradePolicy::AsIs, 100}),
+      InvalidArgumentError);
+}
+
+TEST_F(DbnDecoderTests, TestDecodeParallelZstd) {
+  const auto file_bytes =
+      ReadFileBytes(TEST_BUILD_DIR "/data/test_data.mbo.dbn");
+  // Compress the metadata and each record in a separate frame
+  const auto metadata_end =
+      8 + DbnDecoder::DecodeMetadataVersionAndSize(file_bytes.data(),
+                                                   file_bytes.size())
+              .second;
+  std::vector<std::size_t> frame_ends{metadata_end};
+  while (frame_ends.back() < file_bytes.size()) {
+    frame_ends.emplace_back(frame_ends.back() + sizeof(MboMsg));
+  }
+  std::vector<std::uint8_t> compressed;
+  std::size_t frame_start = 0;
+  for (const auto frame_end : frame_ends) {
+    const auto frame_size = frame_end - frame_start;
+    const auto compressed_size = compressed.size();
+    compressed.resize(compressed_size + ::ZSTD_compressBound(frame_size));
+    const auto res = ::ZSTD_compress(
+        &compressed[compressed_size], compressed.size() - compressed_size,
+        &file_bytes[frame_start], frame_size, 1);
+    ASSERT_FALSE(::ZSTD_isError(res));
+    compressed.resize(compressed_size + res);
+    frame_start = frame_end;
+  }
+  channel_.Write(compressed.data(), compressed.size());
+  channel_.Finish();
+  DbnDecoder target{
+      std::unique_ptr<IReadable>{new detail::SharedChannel{channel_}},
+      VersionUpgradePolicy::AsIs, DbnDecoder::kDefaultBufferSize, 4};
+  DbnDecoder expected_target{file_bytes.data(), file_bytes.size()};
+  EXPECT_EQ(target.DecodeMetadata(), expected_target.DecodeMetadata());
+  std::size_t record_count = 0;
+  const Record* expected;
+  while ((expected = expected_target.DecodeRecord()) != nullptr) {
+    const auto* record = target.DecodeRecord();
+    ASSERT_NE(record, nullptr);
+    EXPECT_EQ(record->Get<MboMsg>(), expected->Get<MboMsg>());
+    ++record_count;
+  }
+  EXPECT_EQ(target.DecodeRecord(), nullptr);
+  EXPECT_EQ(record_count, frame_ends.size() - 1);
+}
+
 class DbnDecoderSchemaTests
     : public DbnDecoderTests,
       public testing::WithParamInterface<std::pair<const char*, std::uint8_t>> {
@@ -0,0 +1,268 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>  // copy_n, equal, remove
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>  // ifstream
+#include <iterator>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "databento/compat.hpp"
+#include "databento/datetime.hpp"
+#include "databento/dbn.hpp"
+#include "databento/dbn_decoder.hpp"
+#include "databento/dbn_encoder.hpp"
+#include "databento/dbn_file_store.hpp"
+#include "databento/detail/file_stream.hpp"
+#include "databento/enums.hpp"
+#include "databento/exceptions.hpp"
+#include "databento/iwritable.hpp"
+#include "databento/record.hpp"
+#include "temp_file.hpp"
+
+namespace databento {
+namespace test {
+namespace {
+class VectorWriter : public IWritable {
+ public:
+  explicit VectorWriter(std::vector<std::uint8_t>* buffer) : buffer_{buffer} {}
+
+  void WriteAll(const std::uint8_t* buffer, std::size_t length) override {
+    buffer_->insert(buffer_->end(), buffer, buffer + length);
+  }
+  void Flush() override {}
+
+ private:
+  std::vector<std::uint8_t>* buffer_;
+};
+
+std::vector<std::uint8_t> ReadFileBytes(const std::string& file_path) {
+  std::ifstream stream{file_path, std::ios::binary};
+  return {std::istreambuf_iterator<char>{stream},
+          std::istreambuf_iterator<char>{}};
+}
+
+std::vector<std::uint8_t> Encode(const std::string& file_path,
+                                 Compression compression,
+                                 std::size_t buffer_size,
+                                 bool use_background_thread) {
+  DbnDecoder decoder{
+      std::unique_ptr<IReadable>{new detail::FileStream{file_path}},
+      VersionUpgradePolicy::AsIs};
+  std::vector<std::uint8_t> res;
+  DbnEncoder target{decoder.DecodeMetadata(),
+                    std::unique_ptr<IWritable>{new VectorWriter{&res}},
+                    compression, buffer_size, use_background_thread};
+  const Record* record;
+  while ((record = decoder.DecodeRecord()) != nullptr) {
+    target.EncodeRecord(*record);
+  }
+  target.Finish();
+  return res;
+}
+
+// Checks `actual` decodes to the same metadata and records as `expected`.
+void ExpectSameDbn(const std::vector<std::uint8_t>& expected,
+                   const std::vector<std::uint8_t>& actual) {
+  DbnDecoder expected_decoder{expected.data(), expected.size(),
+                              VersionUpgradePolicy::AsIs};
+  DbnDecoder actual_decoder{actual.data(), actual.size(),
+                            VersionUpgradePolicy::AsIs};
+  EXPECT_EQ(actual_decoder.DecodeMetadata(), expected_decoder.DecodeMetadata());
+  std::size_t record_count{};
+  while (true) {
+    const Record* expected_record = expected_decoder.DecodeRecord();
+    const Record* actual_record = actual_decoder.DecodeRecord();
+    if (expected_record == nullptr) {
+      EXPECT_EQ(actual_record, nullptr);
+      break;
+    }
+    ASSERT_NE(actual_record, nullptr) << "Missing record " << record_count;
+    ASSERT_EQ(actual_record->Size(), expected_record->Size());
+    const auto* expected_bytes =
+        reinterpret_cast<const std::uint8_t*>(&expected_record->Header());
+    const auto* actual_bytes =
+        reinterpret_cast<const std::uint8_t*>(&actual_record->Header());
+    EXPECT_TRUE(std::equal(expected_bytes,
+                           expected_bytes + expected_record->Size(),
+                           actual_bytes))
+        << "Record " << record_count << " differs";
+    ++record_count;
+  }
+}
+}  // namespace
+
+class DbnEncoderFileTests
+    : public testing::TestWithParam<std::tuple<const char*, std::uint8_t>> {
+ protected:
+  std::string FilePath() const {
+    const char* version_str = std::get<1>(GetParam()) == 1 ? ".v1" : "";
+    return TEST_BUILD_DIR "/data/test_data." +
+           std::string{std::get<0>(GetParam())} + version_str + ".dbn";
+  }
+};
+
+INSTANTIATE_TEST_SUITE_P(
+    TestFiles, DbnEncoderFileTests,
+    testing::Combine(testing::Values("definition", "imbalance", "mbo", "mbp-1",
+                                     "mbp-10", "ohlcv-1d", "ohlcv-1h",
+                                     "ohlcv-1m", "ohlcv-1s", "statistics",
+                                     "tbbo", "trades"),
+                     testing::Values(1, 2)),
+    [](const testing::TestParamInfo<std::tuple<const char*, std::uint8_t>>&
+           test_info) {
+      std::string name = std::get<0>(test_info.param);
+      name.erase(std::remove(name.begin(), name.end(), '-'), name.end());
+      return name + "DBNv" + std::to_string(std::get<1>(test_info.param));
+    });
+
+TEST_P(DbnEncoderFileTests, TestRoundTrip) {
+  auto expected = ReadFileBytes(FilePath());
+  const auto encoded = Encode(FilePath(), Compression::None,
+                              DbnEncoder::kDefaultBufferSize, false);
+  ASSERT_EQ(encoded.size(), expected.size());
+  if (std::get<1>(GetParam()) == 1) {
+    // The deprecated record count isn't decoded into `Metadata`, so it's
+    // written as unknown
+    constexpr std::size_t kRecordCountOffset = 8 + 16 + 2 + 3 * 8;
+    std::copy_n(&encoded[kRecordCountOffset], 8, &expected[kRecordCountOffset]);
+  }
+  EXPECT_EQ(encoded, expected);
+}
+
+TEST_P(DbnEncoderFileTests, TestRoundTripZstd) {
+  const auto expected = ReadFileBytes(FilePath());
+  const auto encoded = Encode(FilePath(), Compression::Zstd,
+                              DbnEncoder::kDefaultBufferSize, false);
+  ASSERT_GE(encoded.size(), 4);
+  // Zstd magic number
+  EXPECT_EQ(encoded[0], 0x28);
+  EXPECT_EQ(encoded[1], 0xB5);
+  EXPECT_EQ(encoded[2], 0x2F);
+  EXPECT_EQ(encoded[3], 0xFD);
+  ExpectSameDbn(expected, encoded);
+}
+
+TEST_P(DbnEncoderFileTests, TestRoundTripBackgroundThread) {
+  // Small enough for every file to take multiple buffers
+  constexpr std::size_t kBufferSize = 256;
+  const auto expected =
+      Encode(FilePath(), Compression::None, kBufferSize, false);
+  EXPECT_EQ(Encode(FilePath(), Compression::None, kBufferSize, true),
+            expected);
+  ExpectSameDbn(expected,
+                Encode(FilePath(), Compression::Zstd, kBufferSize, true));
+}
+
+TEST(DbnEncoderTests, TestEncodeRecords) {
+  const std::string file_path = TEST_BUILD_DIR "/data/test_data.mbp-10.dbn";
+  DbnDecoder decoder{
+      std::unique_ptr<IReadable>{new detail::FileStream{file_path}},
+      VersionUpgradePolicy::AsIs};
+  std::vector<std::uint8_t> encoded;
+  {
+    DbnEncoder target{decoder.DecodeMetadata(),
+                      std::unique_ptr<IWritable>{new VectorWriter{&encoded}}};
+    RecordBatch batch;
+    while (!(batch = decoder.DecodeRecords()).IsEmpty()) {
+      target.EncodeRecords(batch);
+    }
+    // finished on destruction
+  }
+  EXPECT_EQ(encoded, ReadFileBytes(file_path));
+}
+
+TEST(DbnEncoderTests, TestEncodeMetadata) {
+  const Metadata metadata{kDbnVersion,
+                          "GLBX.MDP3",
+                          true,
+                          Schema::Mbo,
+                          UnixNanos{std::chrono::nanoseconds{1}},
+                          UnixNanos{std::chrono::nanoseconds{2}},
+                          100,
+                          false,
+                          SType::RawSymbol,
+                          SType::InstrumentId,
+                          true,
+                          kSymbolCstrLen,
+                          {"ESZ3", "NQZ3"},
+                          {"ESH4"},
+                          {"ESM4", "NQM4"},
+                          {SymbolMapping{"ESZ3",
+                                         {MappingInterval{20231101, 20231102,
+                                                          "5482"},
+                                          MappingInterval{20231102, 20231103,
+                                                          "5483"}}},
+                           SymbolMapping{"NQZ3", {}}}};
+  const auto encoded = DbnEncoder::EncodeMetadata(metadata);
+  DbnDecoder decoder{encoded.data(), encoded.size()};
+  EXPECT_EQ(decoder.DecodeMetadata(), metadata);
+  EXPECT_EQ(decoder.DecodeRecord(), nullptr);
+
+  Metadata metadata_v1 = metadata;
+  metadata_v1.version = 1;
+  metadata_v1.symbol_cstr_len = kSymbolCstrLenV1;
+  const auto encoded_v1 = DbnEncoder::EncodeMetadata(metadata_v1);
+  EXPECT_LT(encoded_v1.size(), encoded.size());
+  DbnDecoder decoder_v1{encoded_v1.data(), encoded_v1.size()};
+  EXPECT_EQ(decoder_v1.DecodeMetadata(), metadata_v1);
+}
+
+TEST(DbnEncoderTests, TestEncodeMetadataInvalid) {
+  Metadata metadata{};
+  metadata.version = kDbnVersion + 1;
+  metadata.symbol_cstr_len = kSymbolCstrLen;
+  EXPECT_THROW(DbnEncoder::EncodeMetadata(metadata), InvalidArgumentError);
+  metadata.version = kDbnVersion;
+  metadata.symbols.emplace_back(kSymbolCstrLen, 'A');
+  EXPECT_THROW(DbnEncoder::EncodeMetadata(metadata), InvalidArgumentError);
+}
+
+TEST(DbnEncoderTests, TestEncodeAfterFinish) {
+  Metadata metadata{};
+  metadata.version = kDbnVersion;
+  metadata.symbol_cstr_len = kSymbolCstrLen;
+  std::vector<std::uint8_t> encoded;
+  DbnEncoder target{metadata,
+                    std::unique_ptr<IWritable>{new VectorWriter{&encoded}}};
+  target.Finish();
+  EXPECT_EQ(encoded, DbnEncoder::EncodeMetadata(metadata));
+  MboMsg mbo{};
+  mbo.hd.length = sizeof(mbo) / RecordHeader::kLengthMultiplier;
+  mbo.hd.rtype = RType::Mbo;
+  EXPECT_THROW(target.EncodeRecord(mbo), Exception);
+}
+
+TEST(DbnEncoderTests, TestEncodeFile) {
+  const std::string file_path = TEST_BUILD_DIR "/data/test_data.trades.dbn";
+  const TempFile temp_file{TEST_BUILD_DIR "/data/encoder_test.dbn.zst"};
+  std::size_t record_count{};
+  {
+    DbnDecoder decoder{
+        std::unique_ptr<IReadable>{new detail::FileStream{file_path}},
+        VersionUpgradePolicy::AsIs};
+    DbnEncoder target{decoder.DecodeMetadata(),
+                      std::unique_ptr<IWritable>{
+                          new detail::OutFileStream{temp_file.Path()}},
+                      Compression::Zstd};
+    const Record* record;
+    while ((record = decoder.DecodeRecord()) != nullptr) {
+      target.EncodeRecord(*record);
+      ++record_count;
+    }
+    target.Finish();
+  }
+  ASSERT_GT(record_count, 0);
+  std::size_t replayed_count{};
+  DbnFileStore{temp_file.Path()}.Replay([&replayed_count](const Record&) {
+    ++replayed_count;
+    return KeepGoing::Continue;
+  });
+  EXPECT_EQ(replayed_count, record_count);
+}
+}  // namespace test
+}  // namespace databento
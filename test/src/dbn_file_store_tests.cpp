@@ -0,0 +1,233 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <ios>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "databento/compat.hpp"
+#include "databento/datetime.hpp"
+#include "databento/dbn_file_store.hpp"
+#include "databento/enums.hpp"
+#include "databento/exceptions.hpp"
+#include "databento/record.hpp"
+#include "temp_file.hpp"
+
+namespace databento {
+namespace test {
+namespace {
+constexpr std::size_t kRecordCount = 101;
+
+// Pairs of records share a timestamp
+UnixNanos TsRecv(std::size_t i) {
+  return UnixNanos{std::chrono::nanoseconds{1000 + (i / 2) * 10}};
+}
+
+std::vector<std::uint8_t> ReadFile(const std::string& path) {
+  std::ifstream stream{path, std::ios::binary};
+  return {std::istreambuf_iterator<char>{stream},
+          std::istreambuf_iterator<char>{}};
+}
+
+void WriteFile(const std::string& path, const std::vector<std::uint8_t>& data) {
+  std::ofstream stream{path, std::ios::binary | std::ios::trunc};
+  stream.write(reinterpret_cast<const char*>(data.data()),
+               static_cast<std::streamsize>(data.size()));
+}
+
+// Writes an uncompressed DBN file with `kRecordCount` MBO records and
+// `system_count` system records before the MBO record at `system_idx`, like a
+// live gateway would send.
+void WriteMboFile(const std::string& path, std::size_t system_idx = 0,
+                  std::size_t system_count = 0) {
+  auto data = ReadFile(TEST_BUILD_DIR "/data/test_data.mbo.dbn");
+  std::uint32_t metadata_len;
+  std::memcpy(&metadata_len, &data[4], sizeof(metadata_len));
+  data.resize(8 + metadata_len);
+  for (std::size_t i = 0; i < kRecordCount; ++i) {
+    if (i == system_idx) {
+      for (std::size_t j = 0; j < system_count; ++j) {
+        SystemMsg system{};
+        system.hd.length = sizeof(SystemMsg) / RecordHeader::kLengthMultiplier;
+        system.hd.rtype = RType::System;
+        system.hd.ts_event = TsRecv(i);
+        const auto* bytes = reinterpret_cast<const std::uint8_t*>(&system);
+        data.insert(data.end(), bytes, bytes + sizeof(system));
+      }
+    }
+    MboMsg mbo{};
+    mbo.hd.length = sizeof(MboMsg) / RecordHeader::kLengthMultiplier;
+    mbo.hd.rtype = RType::Mbo;
+    mbo.hd.instrument_id = 5482;
+    mbo.hd.ts_event = TsRecv(i) - std::chrono::nanoseconds{1};
+    mbo.ts_recv = TsRecv(i);
+    mbo.order_id = i;
+    const auto* bytes = reinterpret_cast<const std::uint8_t*>(&mbo);
+    data.insert(data.end(), bytes, bytes + sizeof(mbo));
+  }
+  WriteFile(path, data);
+}
+
+std::vector<std::uint64_t> ReplayOrderIds(
+    DbnFileStore* target, const DateTimeRange<UnixNanos>& datetime_range) {
+  std::vector<std::uint64_t> res;
+  target->Replay(datetime_range, [&res](const Record& record) {
+    if (record.Holds<MboMsg>()) {
+      res.emplace_back(record.Get<MboMsg>().order_id);
+    }
+    return KeepGoing::Continue;
+  });
+  return res;
+}
+
+std::vector<std::uint64_t> Range(std::uint64_t begin, std::uint64_t end) {
+  std::vector<std::uint64_t> res;
+  for (auto i = begin; i < end; ++i) {
+    res.emplace_back(i);
+  }
+  return res;
+}
+}  // namespace
+
+class DbnFileStoreSeekTests : public testing::Test {
+ protected:
+  void SetUp() override { WriteMboFile(file_.Path()); }
+
+  const TempFile file_{testing::TempDir() + "/seek.mbo.dbn"};
+};
+
+TEST_F(DbnFileStoreSeekTests, TestRecordCount) {
+  DbnFileStore target{file_.Path()};
+  EXPECT_EQ(target.RecordCount(), kRecordCount);
+  DbnFileStore test_data{TEST_BUILD_DIR "/data/test_data.mbo.dbn"};
+  std::uint64_t expected = 0;
+  DbnFileStore{TEST_BUILD_DIR "/data/test_data.mbo.dbn"}.Replay(
+      [&expected](const Record&) {
+        ++expected;
+        return KeepGoing::Continue;
+      });
+  EXPECT_EQ(test_data.RecordCount(), expected);
+}
+
+TEST_F(DbnFileStoreSeekTests, TestRecordCountNoRecords) {
+  DbnFileStore target{TEST_BUILD_DIR "/data/test_data.ohlcv-1d.dbn"};
+  EXPECT_EQ(target.RecordCount(), 0);
+  EXPECT_EQ(target.FindRecord(UnixNanos{}), 0);
+}
+
+TEST_F(DbnFileStoreSeekTests, TestDecodeRecordAt) {
+  DbnFileStore target{file_.Path()};
+  for (const std::uint64_t index : {0U, 50U, 3U, 100U}) {
+    const auto record = target.DecodeRecordAt(index);
+    ASSERT_TRUE(record.Holds<MboMsg>());
+    EXPECT_EQ(record.Get<MboMsg>().order_id, index);
+    EXPECT_EQ(record.Get<MboMsg>().ts_recv, TsRecv(index));
+  }
+  ASSERT_THROW(target.DecodeRecordAt(kRecordCount), InvalidArgumentError);
+}
+
+TEST_F(DbnFileStoreSeekTests, TestDecodeRecordAtUpgrade) {
+  DbnFileStore target{TEST_BUILD_DIR "/data/test_data.definition.v1.dbn",
+                      VersionUpgradePolicy::Upgrade};
+  ASSERT_GT(target.RecordCount(), 0);
+  const auto record = target.DecodeRecordAt(0);
+  ASSERT_TRUE(record.Holds<InstrumentDefMsg>());
+  EXPECT_EQ(record.Size(), sizeof(InstrumentDefMsg));
+  DbnFileStore as_is{TEST_BUILD_DIR "/data/test_data.definition.v1.dbn"};
+  EXPECT_EQ(as_is.DecodeRecordAt(0).Size(), sizeof(InstrumentDefMsgV1));
+}
+
+TEST_F(DbnFileStoreSeekTests, TestFindRecord) {
+  DbnFileStore target{file_.Path()};
+  EXPECT_EQ(target.FindRecord(UnixNanos{}), 0);
+  EXPECT_EQ(target.FindRecord(TsRecv(0)), 0);
+  // Finds the first of the records with the same timestamp
+  EXPECT_EQ(target.FindRecord(TsRecv(41)), 40);
+  EXPECT_EQ(target.FindRecord(TsRecv(41) + std::chrono::nanoseconds{1}), 42);
+  EXPECT_EQ(target.FindRecord(TsRecv(kRecordCount - 1)), kRecordCount - 1);
+  EXPECT_EQ(target.FindRecord(TsRecv(kRecordCount + 1)), kRecordCount);
+}
+
+TEST_F(DbnFileStoreSeekTests, TestReplayFrom) {
+  DbnFileStore target{file_.Path()};
+  std::vector<std::uint64_t> order_ids;
+  target.ReplayFrom(90, [&order_ids](const Record& record) {
+    order_ids.emplace_back(record.Get<MboMsg>().order_id);
+    return KeepGoing::Continue;
+  });
+  EXPECT_EQ(order_ids, Range(90, kRecordCount));
+  order_ids.clear();
+  target.ReplayFrom(kRecordCount, [&order_ids](const Record& record) {
+    order_ids.emplace_back(record.Get<MboMsg>().order_id);
+    return KeepGoing::Continue;
+  });
+  EXPECT_TRUE(order_ids.empty());
+  ASSERT_THROW(target.ReplayFrom(kRecordCount + 1,
+                                 [](const Record&) { return KeepGoing::Stop; }),
+               InvalidArgumentError);
+}
+
+TEST_F(DbnFileStoreSeekTests, TestReplayWindow) {
+  DbnFileStore target{file_.Path()};
+  EXPECT_EQ(ReplayOrderIds(&target, {TsRecv(21), TsRecv(60)}), Range(20, 60));
+  DbnFileStore open_ended{file_.Path()};
+  EXPECT_EQ(ReplayOrderIds(&open_ended, {TsRecv(97), UnixNanos{}}),
+            Range(96, kRecordCount));
+  DbnFileStore past_end{file_.Path()};
+  EXPECT_TRUE(
+      ReplayOrderIds(&past_end, {TsRecv(kRecordCount + 1), UnixNanos{}})
+          .empty());
+}
+
+TEST_F(DbnFileStoreSeekTests, TestReplayWindowIrregularSize) {
+  WriteMboFile(file_.Path(), 30, 1);
+  DbnFileStore target{file_.Path()};
+  // Falls back to scanning
+  EXPECT_EQ(ReplayOrderIds(&target, {TsRecv(21), TsRecv(60)}), Range(20, 60));
+  DbnFileStore seek_target{file_.Path()};
+  ASSERT_THROW(seek_target.RecordCount(), DbnResponseError);
+}
+
+TEST_F(DbnFileStoreSeekTests, TestReplayWindowMixedRTypes) {
+  // Seven system records take up the space of 40 MBO records, so the file size
+  // is still a multiple of the MBO record size, and they cover the record the
+  // binary search reads first
+  WriteMboFile(file_.Path(), 60, 7);
+  DbnFileStore target{file_.Path()};
+  EXPECT_EQ(ReplayOrderIds(&target, {TsRecv(21), TsRecv(80)}), Range(20, 80));
+  DbnFileStore seek_target{file_.Path()};
+  EXPECT_EQ(seek_target.RecordCount(), kRecordCount + 40);
+  ASSERT_THROW(seek_target.FindRecord(TsRecv(21)), DbnResponseError);
+  ASSERT_THROW(seek_target.DecodeRecordAt(80), DbnResponseError);
+  ASSERT_THROW(seek_target.ReplayFrom(
+                   80, [](const Record&) { return KeepGoing::Continue; }),
+               DbnResponseError);
+}
+
+TEST_F(DbnFileStoreSeekTests, TestTruncatedFile) {
+  auto data = ReadFile(file_.Path());
+  data.pop_back();
+  WriteFile(file_.Path(), data);
+  DbnFileStore target{file_.Path()};
+  ASSERT_THROW(target.RecordCount(), DbnResponseError);
+}
+
+TEST_F(DbnFileStoreSeekTests, TestCompressed) {
+  DbnFileStore target{TEST_BUILD_DIR "/data/test_data.mbo.dbn.zst"};
+  ASSERT_THROW(target.RecordCount(), InvalidArgumentError);
+  ASSERT_THROW(target.FindRecord(UnixNanos{}), InvalidArgumentError);
+  // Still replays without seeking
+  std::size_t count = 0;
+  target.Replay({UnixNanos{}, UnixNanos{}}, [&count](const Record&) {
+    ++count;
+    return KeepGoing::Continue;
+  });
+  EXPECT_GT(count, 0);
+}
+}  // namespace test
+}  // namespace databento
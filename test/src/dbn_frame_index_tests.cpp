@@ -0,0 +1,240 @@
+#include <gtest/gtest.h>
+#include <zstd.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <ios>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "databento/constants.hpp"
+#include "databento/datetime.hpp"
+#include "databento/dbn_file_store.hpp"
+#include "databento/dbn_frame_index.hpp"
+#include "databento/enums.hpp"
+#include "databento/exceptions.hpp"
+#include "databento/record.hpp"
+#include "temp_file.hpp"
+
+namespace databento {
+namespace test {
+namespace {
+constexpr std::size_t kRecordCount = 100;
+// Not a multiple of the record size so records span frames
+constexpr std::size_t kFrameSize = 500;
+
+UnixNanos TsRecv(std::size_t i) {
+  return UnixNanos{std::chrono::nanoseconds{1000 + i * 10}};
+}
+
+std::vector<std::uint8_t> ReadFile(const std::string& path) {
+  std::ifstream stream{path, std::ios::binary};
+  return {std::istreambuf_iterator<char>{stream},
+          std::istreambuf_iterator<char>{}};
+}
+
+void WriteFile(const std::string& path, const std::vector<std::uint8_t>& data) {
+  std::ofstream stream{path, std::ios::binary | std::ios::trunc};
+  stream.write(reinterpret_cast<const char*>(data.data()),
+               static_cast<std::streamsize>(data.size()));
+}
+
+void AppendFrame(const std::uint8_t* data, std::size_t size,
+                 std::vector<std::uint8_t>* out) {
+  const auto out_pos = out->size();
+  out->resize(out_pos + ::ZSTD_compressBound(size));
+  const auto frame_size =
+      ::ZSTD_compress(&(*out)[out_pos], out->size() - out_pos, data, size, 1);
+  ASSERT_FALSE(::ZSTD_isError(frame_size));
+  out->resize(out_pos + frame_size);
+}
+
+// Writes a multi-frame Zstd-compressed DBN file with `kRecordCount` MBO
+// records. Returns the offsets of the frames in the compressed file.
+std::vector<std::uint64_t> WriteMultiFrameFile(const std::string& path) {
+  auto metadata = ReadFile(TEST_BUILD_DIR "/data/test_data.mbo.dbn");
+  std::uint32_t metadata_len;
+  std::memcpy(&metadata_len, &metadata[4], sizeof(metadata_len));
+  metadata.resize(8 + metadata_len);
+
+  std::vector<std::uint8_t> records;
+  for (std::size_t i = 0; i < kRecordCount; ++i) {
+    MboMsg mbo{};
+    mbo.hd.length = sizeof(MboMsg) / RecordHeader::kLengthMultiplier;
+    mbo.hd.rtype = RType::Mbo;
+    mbo.hd.instrument_id = 5482;
+    mbo.hd.ts_event = TsRecv(i) - std::chrono::nanoseconds{1};
+    mbo.ts_recv = TsRecv(i);
+    mbo.order_id = i;
+    const auto* bytes = reinterpret_cast<const std::uint8_t*>(&mbo);
+    records.insert(records.end(), bytes, bytes + sizeof(mbo));
+  }
+
+  std::vector<std::uint64_t> frame_offsets{0};
+  std::vector<std::uint8_t> compressed;
+  AppendFrame(metadata.data(), metadata.size(), &compressed);
+  for (std::size_t pos = 0; pos < records.size(); pos += kFrameSize) {
+    frame_offsets.emplace_back(compressed.size());
+    AppendFrame(&records[pos], std::min(kFrameSize, records.size() - pos),
+                &compressed);
+  }
+  WriteFile(path, compressed);
+  return frame_offsets;
+}
+
+std::vector<std::uint64_t> ReplayOrderIds(
+    DbnFileStore* target, const DateTimeRange<UnixNanos>& datetime_range) {
+  std::vector<std::uint64_t> res;
+  target->Replay(datetime_range, [&res](const Record& record) {
+    res.emplace_back(record.Get<MboMsg>().order_id);
+    return KeepGoing::Continue;
+  });
+  return res;
+}
+
+std::vector<std::uint64_t> Range(std::uint64_t begin, std::uint64_t end) {
+  std::vector<std::uint64_t> res;
+  for (auto i = begin; i < end; ++i) {
+    res.emplace_back(i);
+  }
+  return res;
+}
+}  // namespace
+
+class DbnFrameIndexTests : public testing::Test {
+ protected:
+  const TempFile file_{testing::TempDir() + "/multi-frame.mbo.dbn.zst"};
+  const std::vector<std::uint64_t> frame_offsets_{
+      WriteMultiFrameFile(file_.Path())};
+};
+
+TEST_F(DbnFrameIndexTests, TestBuild) {
+  const auto target = DbnFrameIndex::Build(file_.Path());
+  EXPECT_EQ(target.FileSize(), ReadFile(file_.Path()).size());
+  const auto& entries = target.Entries();
+  ASSERT_EQ(entries.size(), frame_offsets_.size());
+  // Metadata frame
+  EXPECT_EQ(entries[0].compressed_offset, 0);
+  EXPECT_EQ(entries[0].uncompressed_offset, 0);
+  EXPECT_EQ(entries[0].record_count, 0);
+
+  const auto records_begin = entries[1].uncompressed_offset;
+  std::uint64_t record_count = 0;
+  for (std::size_t i = 1; i < entries.size(); ++i) {
+    SCOPED_TRACE(i);
+    const auto& entry = entries[i];
+    EXPECT_EQ(entry.compressed_offset, frame_offsets_[i]);
+    EXPECT_EQ(entry.uncompressed_offset, records_begin + (i - 1) * kFrameSize);
+    ASSERT_GT(entry.record_count, 0);
+    // Index of the first record beginning in the frame
+    const auto first =
+        (entry.uncompressed_offset - records_begin + sizeof(MboMsg) - 1) /
+        sizeof(MboMsg);
+    EXPECT_EQ(entry.record_offset, records_begin + first * sizeof(MboMsg));
+    EXPECT_EQ(first, record_count);
+    EXPECT_EQ(entry.first_ts_recv, TsRecv(first));
+    EXPECT_EQ(entry.first_ts_event,
+              TsRecv(first) - std::chrono::nanoseconds{1});
+    const auto last = first + entry.record_count - 1;
+    EXPECT_EQ(entry.last_ts_recv, TsRecv(last));
+    EXPECT_EQ(entry.last_ts_event, TsRecv(last) - std::chrono::nanoseconds{1});
+    record_count += entry.record_count;
+  }
+  EXPECT_EQ(record_count, kRecordCount);
+}
+
+TEST_F(DbnFrameIndexTests, TestWriteRead) {
+  const auto expected = DbnFrameIndex::Build(file_.Path());
+  const TempFile index_file{DbnFrameIndex::SidecarPath(file_.Path())};
+  expected.Write(index_file.Path());
+  const auto target = DbnFrameIndex::Read(index_file.Path());
+  EXPECT_EQ(target.FileSize(), expected.FileSize());
+  EXPECT_EQ(target.Entries(), expected.Entries());
+}
+
+TEST_F(DbnFrameIndexTests, TestReadInvalid) {
+  ASSERT_THROW(DbnFrameIndex::Read(file_.Path()), DbnResponseError);
+  ASSERT_THROW(DbnFrameIndex::Read(testing::TempDir() + "/missing.idx"),
+               InvalidArgumentError);
+}
+
+TEST_F(DbnFrameIndexTests, TestBuildUncompressed) {
+  ASSERT_THROW(DbnFrameIndex::Build(TEST_BUILD_DIR "/data/test_data.mbo.dbn"),
+               DbnResponseError);
+}
+
+TEST_F(DbnFrameIndexTests, TestFindStart) {
+  const auto target = DbnFrameIndex::Build(file_.Path());
+  const auto& entries = target.Entries();
+  EXPECT_EQ(target.FindStart(UnixNanos{}), &entries[1]);
+  EXPECT_EQ(target.FindStart(entries[3].first_ts_recv), &entries[3]);
+  EXPECT_EQ(target.FindStart(entries[3].last_ts_recv), &entries[3]);
+  EXPECT_EQ(target.FindStart(entries[3].last_ts_recv +
+                             std::chrono::nanoseconds{1}),
+            &entries[4]);
+  EXPECT_EQ(target.FindStart(TsRecv(kRecordCount)), nullptr);
+}
+
+TEST_F(DbnFrameIndexTests, TestReplayWindow) {
+  DbnFileStore unindexed{file_.Path()};
+  EXPECT_EQ(ReplayOrderIds(&unindexed, {TsRecv(30), TsRecv(60)}),
+            Range(30, 60));
+
+  const TempFile index_file{DbnFrameIndex::SidecarPath(file_.Path())};
+  DbnFrameIndex::Build(file_.Path()).Write(index_file.Path());
+  DbnFileStore target{file_.Path()};
+  EXPECT_EQ(ReplayOrderIds(&target, {TsRecv(30), TsRecv(60)}), Range(30, 60));
+  DbnFileStore open_ended{file_.Path()};
+  EXPECT_EQ(ReplayOrderIds(&open_ended, {TsRecv(95), UnixNanos{}}),
+            Range(95, kRecordCount));
+  DbnFileStore past_end{file_.Path()};
+  bool has_metadata = false;
+  past_end.Replay(
+      {TsRecv(kRecordCount), UnixNanos{}},
+      [&has_metadata](Metadata metadata) {
+        has_metadata = true;
+        EXPECT_EQ(metadata.schema, Schema::Mbo);
+      },
+      [](const Record&) {
+        ADD_FAILURE() << "Unexpected record";
+        return KeepGoing::Stop;
+      });
+  EXPECT_TRUE(has_metadata);
+}
+
+TEST_F(DbnFrameIndexTests, TestReplayWindowSkipsFrames) {
+  const TempFile index_file{DbnFrameIndex::SidecarPath(file_.Path())};
+  DbnFrameIndex::Build(file_.Path()).Write(index_file.Path());
+  // Corrupt the first record frame without changing the file size. If the
+  // index is used, the frame is never decompressed
+  auto data = ReadFile(file_.Path());
+  for (auto i = frame_offsets_[1]; i < frame_offsets_[2]; ++i) {
+    data[i] = 0xFF;
+  }
+  WriteFile(file_.Path(), data);
+  DbnFileStore target{file_.Path()};
+  EXPECT_EQ(ReplayOrderIds(&target, {TsRecv(50), TsRecv(55)}), Range(50, 55));
+  DbnFileStore unwindowed{file_.Path()};
+  ASSERT_THROW(ReplayOrderIds(&unwindowed, {UnixNanos{}, UnixNanos{}}),
+               DbnResponseError);
+}
+
+TEST_F(DbnFrameIndexTests, TestReplayWindowIgnoresStaleIndex) {
+  const TempFile index_file{DbnFrameIndex::SidecarPath(file_.Path())};
+  DbnFrameIndex::Build(file_.Path()).Write(index_file.Path());
+  // Prepend an empty frame so all offsets in the index are wrong
+  std::vector<std::uint8_t> data;
+  AppendFrame(nullptr, 0, &data);
+  const auto rest = ReadFile(file_.Path());
+  data.insert(data.end(), rest.begin(), rest.end());
+  WriteFile(file_.Path(), data);
+  DbnFileStore target{file_.Path()};
+  EXPECT_EQ(ReplayOrderIds(&target, {TsRecv(50), TsRecv(55)}), Range(50, 55));
+}
+}  // namespace test
+}  // namespace databento
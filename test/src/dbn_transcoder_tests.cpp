@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "databento/compat.hpp"
+#include "databento/constants.hpp"
+#include "databento/dbn.hpp"
+#include "databento/dbn_decoder.hpp"
+#include "databento/dbn_transcoder.hpp"
+#include "databento/detail/file_stream.hpp"
+#include "databento/enums.hpp"
+#include "databento/exceptions.hpp"
+#include "databento/ireadable.hpp"
+#include "databento/record.hpp"
+#include "temp_file.hpp"
+
+namespace databento {
+namespace test {
+class DbnTranscoderTests : public testing::Test {
+ protected:
+  struct Decoded {
+    Metadata metadata;
+    std::vector<std::vector<std::uint8_t>> records;
+  };
+
+  static Decoded Decode(const std::string& file_path,
+                        VersionUpgradePolicy upgrade_policy) {
+    DbnDecoder decoder{
+        std::unique_ptr<IReadable>{new detail::FileStream{file_path}},
+        upgrade_policy};
+    Decoded res{decoder.DecodeMetadata(), {}};
+    const Record* record;
+    while ((record = decoder.DecodeRecord()) != nullptr) {
+      const auto* bytes =
+          reinterpret_cast<const std::uint8_t*>(&record->Header());
+      res.records.emplace_back(bytes, bytes + record->Size());
+    }
+    return res;
+  }
+
+  // Checks the output of transcoding `input_path` matches upgrading it while
+  // decoding.
+  static void CheckTranscoded(const std::string& input_path,
+                              const std::string& output_path) {
+    SCOPED_TRACE(input_path);
+    auto expected = Decode(input_path, VersionUpgradePolicy::Upgrade);
+    expected.metadata.version = kDbnVersion;
+    expected.metadata.symbol_cstr_len = kSymbolCstrLen;
+    const auto actual = Decode(output_path, VersionUpgradePolicy::AsIs);
+    EXPECT_EQ(actual.metadata, expected.metadata);
+    ASSERT_FALSE(actual.records.empty());
+    EXPECT_EQ(actual.records, expected.records);
+  }
+};
+
+TEST_F(DbnTranscoderTests, TestInvalidThreadCount) {
+  ASSERT_THROW(DbnTranscoder{0}, InvalidArgumentError);
+  EXPECT_GT(DbnTranscoder{}.ThreadCount(), 0);
+}
+
+TEST_F(DbnTranscoderTests, TestTranscodeFile) {
+  const std::string input_path =
+      TEST_BUILD_DIR "/data/test_data.definition.v1.dbn";
+  const TempFile output{testing::TempDir() + "/transcode.definition.dbn"};
+  const auto record_count = DbnTranscoder::TranscodeFile(
+      {input_path, output.Path(), Compression::None});
+  EXPECT_EQ(record_count, 2);
+  CheckTranscoded(input_path, output.Path());
+  const auto decoded = Decode(output.Path(), VersionUpgradePolicy::AsIs);
+  EXPECT_EQ(decoded.metadata.version, 2);
+  EXPECT_EQ(decoded.metadata.symbol_cstr_len, kSymbolCstrLen);
+  for (const auto& record : decoded.records) {
+    EXPECT_EQ(record.size(), sizeof(InstrumentDefMsgV2));
+  }
+}
+
+TEST_F(DbnTranscoderTests, TestTranscodeParallel) {
+  const std::vector<std::string> inputs{
+      TEST_BUILD_DIR "/data/test_data.definition.v1.dbn.zst",
+      TEST_BUILD_DIR "/data/test_data.mbo.v1.dbn.zst",
+      TEST_BUILD_DIR "/data/test_data.trades.v1.dbn",
+      // Already the current version
+      TEST_BUILD_DIR "/data/test_data.mbp-10.dbn.zst"};
+  std::vector<TempFile> outputs;
+  // Moved-from files can't be removed
+  outputs.reserve(inputs.size());
+  std::vector<DbnTranscoder::Job> jobs;
+  std::uint64_t expected_count{};
+  for (std::size_t i = 0; i < inputs.size(); ++i) {
+    outputs.emplace_back(testing::TempDir() + "/transcode." +
+                         std::to_string(i) + ".dbn.zst");
+    jobs.push_back({inputs[i], outputs.back().Path(), Compression::Zstd});
+    expected_count +=
+        Decode(inputs[i], VersionUpgradePolicy::Upgrade).records.size();
+  }
+  const DbnTranscoder target{2};
+  EXPECT_EQ(target.Transcode(jobs), expected_count);
+  for (std::size_t i = 0; i < inputs.size(); ++i) {
+    CheckTranscoded(inputs[i], outputs[i].Path());
+  }
+}
+
+TEST_F(DbnTranscoderTests, TestTranscodeMissingInput) {
+  const TempFile output{testing::TempDir() + "/transcode.trades.dbn"};
+  const DbnTranscoder target{2};
+  ASSERT_THROW(
+      target.Transcode(
+          {{TEST_BUILD_DIR "/data/test_data.trades.v1.dbn", output.Path(),
+            Compression::None},
+           {TEST_BUILD_DIR "/data/missing.dbn",
+            testing::TempDir() + "/transcode.missing.dbn", Compression::None}}),
+      InvalidArgumentError);
+}
+}  // namespace test
+}  // namespace databento
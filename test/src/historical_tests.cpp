@@ -18,6 +18,7 @@
 #include "databento/log.hpp"
 #include "databento/metadata.hpp"
 #include "databento/record.hpp"
+#include "databento/record_visitor.hpp"
 #include "databento/symbology.hpp"  // kAllSymbols
 #include "databento/timeseries.hpp"
 #include "mock/mock_http_server.hpp"
@@ -644,6 +645,41 @@ TEST_F(HistoricalTests, TestTimeseriesGetRange_Basic) {
   EXPECT_EQ(mbo_records.size(), 2);
 }
 
+TEST_F(HistoricalTests, TestTimeseriesGetRange_Visitor) {
+  mock_server_.MockStreamDbn("/v0/timeseries.get_range",
+                             {{"dataset", dataset::kGlbxMdp3},
+                              {"symbols", "ESH1"},
+                              {"schema", "mbo"},
+                              {"start", "1609160400000711344"},
+                              {"end", "1609160800000711344"},
+                              {"encoding", "dbn"},
+                              {"stype_in", "raw_symbol"},
+                              {"stype_out", "instrument_id"},
+                              {"limit", "2"}},
+                             TEST_BUILD_DIR "/data/test_data.mbo.dbn.zst");
+  const auto port = mock_server_.ListenOnThread();
+
+  databento::Historical target{logger_.get(), kApiKey, "localhost",
+                               static_cast<std::uint16_t>(port)};
+  struct Visitor : RecordVisitor<Visitor> {
+    void OnMetadata(Metadata&& metadata) { limit = metadata.limit; }
+    KeepGoing OnMbo(const MboMsg& mbo) {
+      mbo_records.emplace_back(mbo);
+      return KeepGoing::Continue;
+    }
+    std::uint64_t limit{};
+    std::vector<MboMsg> mbo_records;
+  } visitor;
+  target.TimeseriesGetRange(
+      dataset::kGlbxMdp3,
+      {UnixNanos{std::chrono::nanoseconds{1609160400000711344}},
+       UnixNanos{std::chrono::nanoseconds{1609160800000711344}}},
+      {"ESH1"}, Schema::Mbo, SType::RawSymbol, SType::InstrumentId, 2,
+      visitor);
+  EXPECT_EQ(visitor.limit, 2);
+  EXPECT_EQ(visitor.mbo_records.size(), 2);
+}
+
 TEST_F(HistoricalTests, TestTimeseriesGetRange_NoMetadataCallback) {
   mock_server_.MockStreamDbn("/v0/timeseries.get_range",
                              {{"dataset", dataset::kGlbxMdp3},
@@ -715,6 +751,24 @@ TEST_F(HistoricalTests, TestTimeseriesGetRange_CallbackException) {
       std::logic_error);
 }
 
+TEST_F(HistoricalTests, TestTimeseriesGetRange_CallbackNonStdException) {
+  mock_server_.MockStreamDbn("/v0/timeseries.get_range", {},
+                             TEST_BUILD_DIR "/data/test_data.mbo.dbn.zst");
+  const auto port = mock_server_.ListenOnThread();
+
+  databento::Historical target{logger_.get(), kApiKey, "localhost",
+                               static_cast<std::uint16_t>(port)};
+  ASSERT_THROW(
+      target.TimeseriesGetRange(
+          dataset::kGlbxMdp3,
+          {UnixNanos{std::chrono::nanoseconds{1609160400000711344}},
+           UnixNanos{std::chrono::nanoseconds{1609160800000711344}}},
+          {"ESH1"}, Schema::Mbo, SType::RawSymbol, SType::InstrumentId, 2,
+          [](Metadata&&) {},
+          [](const Record&) -> KeepGoing { throw 42; }),
+      int);
+}
+
 TEST_F(HistoricalTests, TestTimeseriesGetRangeCancellation) {
   mock_server_.MockStreamDbn("/v0/timeseries.get_range", {},
                              TEST_BUILD_DIR "/data/test_data.mbo.dbn.zst");
@@ -0,0 +1,47 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+#include "databento/detail/instrument_index.hpp"
+
+namespace databento {
+namespace detail {
+namespace test {
+TEST(InstrumentIndexTests, TestInsertAndFind) {
+  InstrumentIndex target;
+  EXPECT_TRUE(target.IsEmpty());
+  EXPECT_EQ(target.Find(1), InstrumentIndex::kNotFound);
+  // Enough to rehash several times
+  for (std::uint32_t i = 0; i < 1000; ++i) {
+    ASSERT_EQ(target.Insert(i * 31), i);
+  }
+  EXPECT_EQ(target.Size(), 1000);
+  for (std::uint32_t i = 0; i < 1000; ++i) {
+    ASSERT_EQ(target.Find(i * 31), i);
+    // Existing IDs keep their index
+    ASSERT_EQ(target.Insert(i * 31), i);
+  }
+  EXPECT_EQ(target.Size(), 1000);
+  EXPECT_EQ(target.Find(1), InstrumentIndex::kNotFound);
+  target.Clear();
+  EXPECT_EQ(target.Find(0), InstrumentIndex::kNotFound);
+  EXPECT_EQ(target.Insert(62), 0);
+}
+
+TEST(InstrumentIndexTests, TestReserve) {
+  InstrumentIndex target;
+  target.Reserve(1000);
+  EXPECT_TRUE(target.IsEmpty());
+  EXPECT_EQ(target.Find(1), InstrumentIndex::kNotFound);
+  for (std::uint32_t i = 0; i < 1000; ++i) {
+    ASSERT_EQ(target.Insert(i), i);
+  }
+  // Reserving less than the size keeps the entries
+  target.Reserve(10);
+  for (std::uint32_t i = 0; i < 1000; ++i) {
+    ASSERT_EQ(target.Find(i), i);
+  }
+}
+}  // namespace test
+}  // namespace detail
+}  // namespace databento
@@ -1,11 +1,13 @@
 #include <gtest/gtest.h>
 #include <openssl/sha.h>  //  SHA256_DIGEST_LENGTH
 
+#include <algorithm>  // copy
 #include <atomic>
 #include <chrono>  // milliseconds
 #include <condition_variable>
 #include <memory>
 #include <mutex>   // lock_guard, mutex, unique_lock
+#include <string>
 #include <thread>  // this_thread
 #include <vector>
 
@@ -16,7 +18,10 @@
 #include "databento/live_blocking.hpp"
 #include "databento/log.hpp"
 #include "databento/record.hpp"
+#include "databento/record_filter.hpp"
+#include "databento/record_visitor.hpp"
 #include "databento/symbology.hpp"
+#include "databento/timeseries.hpp"
 #include "databento/with_ts_out.hpp"
 #include "mock/mock_lsg_server.hpp"  // MockLsgServer
 
@@ -147,6 +152,117 @@ TEST_F(LiveBlockingTests, TestNextRecord) {
   }
 }
 
+TEST_F(LiveBlockingTests, TestNextRecordVisitor) {
+  constexpr auto kTsOut = false;
+  constexpr OhlcvMsg kRec{DummyHeader<OhlcvMsg>(RType::Ohlcv1M), 1, 2, 3, 4, 5};
+  const mock::MockLsgServer mock_server{
+      dataset::kXnasItch, kTsOut, [kRec](mock::MockLsgServer& self) {
+        self.Accept();
+        self.Authenticate();
+        self.SendRecord(kRec);
+        self.SendRecord(kRec);
+      }};
+
+  struct Visitor : RecordVisitor<Visitor> {
+    KeepGoing OnOhlcv(const OhlcvMsg& ohlcv) {
+      last = ohlcv;
+      ++call_count;
+      return call_count < 2 ? KeepGoing::Continue : KeepGoing::Stop;
+    }
+    OhlcvMsg last{};
+    std::size_t call_count{};
+  } visitor;
+  LiveBlocking target{
+      logger_.get(),      kKey,   dataset::kXnasItch,    kLocalhost,
+      mock_server.Port(), kTsOut, VersionUpgradePolicy{}};
+  EXPECT_EQ(target.NextRecord(visitor), KeepGoing::Continue);
+  EXPECT_EQ(target.NextRecord(visitor), KeepGoing::Stop);
+  EXPECT_EQ(visitor.call_count, 2);
+  EXPECT_EQ(visitor.last, kRec);
+}
+
+TEST_F(LiveBlockingTests, TestNextRecordFilter) {
+  constexpr auto kTsOut = false;
+  constexpr OhlcvMsg kOhlcv{DummyHeader<OhlcvMsg>(RType::Ohlcv1M), 1, 2, 3, 4,
+                            5};
+  constexpr TradeMsg kTrade{DummyHeader<TradeMsg>(RType::Mbp0),
+                            1,
+                            2,
+                            Action::Add,
+                            Side::Bid,
+                            {},
+                            1,
+                            UnixNanos{},
+                            TimeDeltaNanos{},
+                            10};
+  OhlcvMsg other_instrument = kOhlcv;
+  other_instrument.hd.instrument_id = 2;
+  OhlcvMsg last = kOhlcv;
+  last.open = 6;
+  const mock::MockLsgServer mock_server{
+      dataset::kXnasItch, kTsOut,
+      [kOhlcv, kTrade, other_instrument, last](mock::MockLsgServer& self) {
+        self.Accept();
+        self.Authenticate();
+        self.SendRecord(kTrade);
+        self.SendRecord(other_instrument);
+        self.SendRecord(kOhlcv);
+        self.SendRecord(kTrade);
+        self.SendRecord(last);
+      }};
+
+  LiveBlocking target{
+      logger_.get(),      kKey,   dataset::kXnasItch,    kLocalhost,
+      mock_server.Port(), kTsOut, VersionUpgradePolicy{}};
+  target.SetFilter(RecordFilter{}
+                       .AddRType(RType::Ohlcv1M)
+                       .AddInstrumentId(kOhlcv.hd.instrument_id));
+  ASSERT_FALSE(target.Filter().IsEmpty());
+  const auto& rec1 = target.NextRecord();
+  ASSERT_TRUE(rec1.Holds<OhlcvMsg>());
+  EXPECT_EQ(rec1.Get<OhlcvMsg>(), kOhlcv);
+  EXPECT_EQ(target.FilterPassCount(), 1);
+  EXPECT_EQ(target.FilterSkipCount(), 2);
+  const auto& rec2 = target.NextRecord();
+  ASSERT_TRUE(rec2.Holds<OhlcvMsg>());
+  EXPECT_EQ(rec2.Get<OhlcvMsg>(), last);
+  EXPECT_EQ(target.FilterPassCount(), 2);
+  EXPECT_EQ(target.FilterSkipCount(), 3);
+}
+
+TEST_F(LiveBlockingTests, TestNextRecordFilterPassesGatewayRecords) {
+  constexpr auto kTsOut = false;
+  constexpr OhlcvMsg kOhlcv{DummyHeader<OhlcvMsg>(RType::Ohlcv1M), 1, 2, 3, 4,
+                            5};
+  ErrorMsg error{DummyHeader<ErrorMsg>(RType::Error), {}, 0, 0};
+  const std::string err_text = "Subscription limit exceeded";
+  std::copy(err_text.begin(), err_text.end(), error.err.begin());
+  // Neither the rtype nor the instrument ID match the filter
+  error.hd.instrument_id = 2;
+  const mock::MockLsgServer mock_server{
+      dataset::kXnasItch, kTsOut, [kOhlcv, error](mock::MockLsgServer& self) {
+        self.Accept();
+        self.Authenticate();
+        self.SendRecord(error);
+        self.SendRecord(kOhlcv);
+      }};
+
+  LiveBlocking target{
+      logger_.get(),      kKey,   dataset::kXnasItch,    kLocalhost,
+      mock_server.Port(), kTsOut, VersionUpgradePolicy{}};
+  target.SetFilter(RecordFilter{}
+                       .AddRType(RType::Ohlcv1M)
+                       .AddInstrumentId(kOhlcv.hd.instrument_id));
+  const auto& rec1 = target.NextRecord();
+  ASSERT_TRUE(rec1.Holds<ErrorMsg>());
+  EXPECT_EQ(std::string{rec1.Get<ErrorMsg>().Err()}, err_text);
+  const auto& rec2 = target.NextRecord();
+  ASSERT_TRUE(rec2.Holds<OhlcvMsg>());
+  EXPECT_EQ(rec2.Get<OhlcvMsg>(), kOhlcv);
+  EXPECT_EQ(target.FilterPassCount(), 1);
+  EXPECT_EQ(target.FilterSkipCount(), 0);
+}
+
 TEST_F(LiveBlockingTests, TestNextRecordTimeout) {
   constexpr std::chrono::milliseconds kTimeout{50};
   constexpr auto kTsOut = false;
@@ -214,6 +330,51 @@ TEST_F(LiveBlockingTests, TestNextRecordTimeout) {
   EXPECT_EQ(rec->Get<Mbp1Msg>(), kRec);
 }
 
+TEST_F(LiveBlockingTests, TestNextRecordTimeoutWithFilter) {
+  constexpr std::chrono::milliseconds kTimeout{50};
+  constexpr auto kTsOut = false;
+  constexpr OhlcvMsg kOhlcv{DummyHeader<OhlcvMsg>(RType::Ohlcv1M), 1, 2, 3, 4,
+                            5};
+  constexpr TradeMsg kTrade{DummyHeader<TradeMsg>(RType::Mbp0),
+                            1,
+                            2,
+                            Action::Add,
+                            Side::Bid,
+                            {},
+                            1,
+                            UnixNanos{},
+                            TimeDeltaNanos{},
+                            10};
+  std::atomic<bool> has_timed_out{false};
+  const mock::MockLsgServer mock_server{
+      dataset::kXnasItch, kTsOut,
+      [kOhlcv, kTrade, &has_timed_out](mock::MockLsgServer& self) {
+        self.Accept();
+        self.Authenticate();
+        // Keep sending filtered-out records for much longer than the timeout
+        for (int i = 0; i < 100 && !has_timed_out; ++i) {
+          self.SendRecord(kTrade);
+          std::this_thread::sleep_for(std::chrono::milliseconds{10});
+        }
+        self.SendRecord(kOhlcv);
+      }};
+
+  LiveBlocking target{
+      logger_.get(),      kKey,   dataset::kXnasItch,    kLocalhost,
+      mock_server.Port(), kTsOut, VersionUpgradePolicy{}};
+  target.SetFilter(RecordFilter{}.AddRType(RType::Ohlcv1M));
+  const auto start = std::chrono::steady_clock::now();
+  const auto* rec = target.NextRecord(kTimeout);
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+  EXPECT_EQ(rec, nullptr) << "Did not timeout when expected";
+  EXPECT_LT(elapsed, 10 * kTimeout);
+  EXPECT_GT(target.FilterSkipCount(), 0);
+  has_timed_out = true;
+  const auto& rec2 = target.NextRecord();
+  ASSERT_TRUE(rec2.Holds<OhlcvMsg>());
+  EXPECT_EQ(rec2.Get<OhlcvMsg>(), kOhlcv);
+}
+
 TEST_F(LiveBlockingTests, TestNextRecordPartialRead) {
   constexpr auto kTsOut = false;
   constexpr MboMsg kRec{DummyHeader<MboMsg>(RType::Mbo),
@@ -0,0 +1,265 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>  // this_thread
+#include <vector>
+
+#include "databento/constants.hpp"
+#include "databento/datetime.hpp"
+#include "databento/dbn.hpp"
+#include "databento/dbn_encoder.hpp"
+#include "databento/dbn_file_store.hpp"
+#include "databento/enums.hpp"
+#include "databento/exceptions.hpp"
+#include "databento/live_recorder.hpp"
+#include "databento/live_threaded.hpp"
+#include "databento/log.hpp"
+#include "databento/record.hpp"
+#include "databento/timeseries.hpp"
+#include "mock/mock_lsg_server.hpp"
+#include "temp_file.hpp"
+
+namespace databento {
+namespace test {
+class LiveRecorderTests : public testing::Test {
+ protected:
+  static constexpr auto kPathPrefix = TEST_BUILD_DIR "/data/recorder_test";
+
+  static Metadata MakeMetadata(std::string dataset) {
+    Metadata metadata{};
+    metadata.version = kDbnVersion;
+    metadata.dataset = std::move(dataset);
+    metadata.schema = Schema::Mbo;
+    metadata.stype_in = SType::RawSymbol;
+    metadata.stype_out = SType::InstrumentId;
+    metadata.symbol_cstr_len = kSymbolCstrLen;
+    return metadata;
+  }
+
+  static MboMsg MakeMbo(std::uint64_t order_id, UnixNanos ts_recv) {
+    MboMsg mbo{};
+    mbo.hd.length = sizeof(MboMsg) / RecordHeader::kLengthMultiplier;
+    mbo.hd.rtype = RType::Mbo;
+    mbo.order_id = order_id;
+    mbo.ts_recv = ts_recv;
+    return mbo;
+  }
+
+  static UnixNanos Ts(std::uint64_t millis) {
+    return UnixNanos{std::chrono::milliseconds{millis}};
+  }
+
+  // Creates a `TempFile` for each file the recorder is expected to write.
+  static std::vector<std::unique_ptr<TempFile>> ExpectFiles(
+      std::size_t count, const char* extension) {
+    std::vector<std::unique_ptr<TempFile>> res;
+    for (std::size_t i = 0; i < count; ++i) {
+      res.emplace_back(new TempFile{std::string{kPathPrefix} + '.' +
+                                    std::to_string(i) + extension});
+    }
+    return res;
+  }
+
+  static std::vector<std::string> Paths(
+      const std::vector<std::unique_ptr<TempFile>>& files) {
+    std::vector<std::string> res;
+    for (const auto& file : files) {
+      res.emplace_back(file->Path());
+    }
+    return res;
+  }
+
+  // Replays the file at `file_path`, returning its metadata and order IDs.
+  static std::pair<Metadata, std::vector<std::uint64_t>> ReadFile(
+      const std::string& file_path) {
+    std::pair<Metadata, std::vector<std::uint64_t>> res;
+    DbnFileStore{file_path}.Replay(
+        [&res](Metadata&& metadata) { res.first = std::move(metadata); },
+        [&res](const Record& record) {
+          EXPECT_TRUE(record.Holds<MboMsg>());
+          res.second.emplace_back(record.Get<MboMsg>().order_id);
+          return KeepGoing::Continue;
+        });
+    return res;
+  }
+
+  std::unique_ptr<ILogReceiver> logger_{new NullLogReceiver};
+};
+
+constexpr const char* LiveRecorderTests::kPathPrefix;
+
+TEST_F(LiveRecorderTests, TestRecord) {
+  const auto files = ExpectFiles(1, ".dbn");
+  LiveRecorder target{logger_.get(), kPathPrefix, Compression::None};
+  const auto metadata = MakeMetadata(dataset::kGlbxMdp3);
+  target.OnMetadata(metadata);
+  std::vector<std::uint64_t> expected;
+  for (std::uint64_t i = 0; i < 100; ++i) {
+    auto mbo = MakeMbo(i, Ts(1000 + i));
+    EXPECT_EQ(target.OnRecord(Record{&mbo.hd}), KeepGoing::Continue);
+    expected.emplace_back(i);
+  }
+  target.Stop();
+  EXPECT_EQ(target.RecordCount(), 100);
+  EXPECT_EQ(target.DroppedCount(), 0);
+  EXPECT_EQ(target.QueueDepth(), 0);
+  EXPECT_GE(target.MaxQueueDepth(), sizeof(MboMsg));
+  ASSERT_EQ(target.FilePaths(), Paths(files));
+
+  const auto res = ReadFile(files[0]->Path());
+  Metadata expected_metadata = metadata;
+  expected_metadata.start = Ts(1000);
+  EXPECT_EQ(res.first, expected_metadata);
+  EXPECT_EQ(res.second, expected);
+}
+
+TEST_F(LiveRecorderTests, TestRotateBySize) {
+  constexpr std::size_t kRecordsPerFile = 10;
+  const auto metadata = MakeMetadata(dataset::kXnasItch);
+  const auto max_file_size = DbnEncoder::EncodeMetadata(metadata).size() +
+                             kRecordsPerFile * sizeof(MboMsg);
+  const auto files = ExpectFiles(10, ".dbn.zst");
+  LiveRecorder target{logger_.get(),
+                      kPathPrefix,
+                      Compression::Zstd,
+                      max_file_size,
+                      std::chrono::nanoseconds{},
+                      LiveRecorder::kDefaultQueueCapacity};
+  target.OnMetadata(metadata);
+  for (std::uint64_t i = 0; i < 100; ++i) {
+    auto mbo = MakeMbo(i, Ts(i));
+    target.OnRecord(Record{&mbo.hd});
+  }
+  target.Stop();
+  ASSERT_EQ(target.FilePaths(), Paths(files));
+  for (std::size_t i = 0; i < files.size(); ++i) {
+    const auto res = ReadFile(files[i]->Path());
+    EXPECT_EQ(res.first.start, Ts(i * kRecordsPerFile));
+    ASSERT_EQ(res.second.size(), kRecordsPerFile);
+    EXPECT_EQ(res.second.front(), i * kRecordsPerFile);
+    EXPECT_EQ(res.second.back(), (i + 1) * kRecordsPerFile - 1);
+  }
+}
+
+TEST_F(LiveRecorderTests, TestRotateByTime) {
+  const auto files = ExpectFiles(3, ".dbn");
+  LiveRecorder target{logger_.get(),
+                      kPathPrefix,
+                      Compression::None,
+                      0,
+                      std::chrono::seconds{1},
+                      LiveRecorder::kDefaultQueueCapacity};
+  target.OnMetadata(MakeMetadata(dataset::kXnasItch));
+  // Windows are aligned to the epoch, so the first file only covers 0.5s
+  const std::vector<std::uint64_t> ts_millis{10500, 10999, 11000,
+                                             11001, 11999, 13500};
+  for (std::uint64_t i = 0; i < ts_millis.size(); ++i) {
+    auto mbo = MakeMbo(i, Ts(ts_millis[i]));
+    target.OnRecord(Record{&mbo.hd});
+  }
+  target.Stop();
+  ASSERT_EQ(target.FilePaths(), Paths(files));
+
+  auto res = ReadFile(files[0]->Path());
+  EXPECT_EQ(res.first.start, Ts(10500));
+  EXPECT_EQ(res.first.end, Ts(11000));
+  EXPECT_EQ(res.second, (std::vector<std::uint64_t>{0, 1}));
+  res = ReadFile(files[1]->Path());
+  EXPECT_EQ(res.first.start, Ts(11000));
+  EXPECT_EQ(res.first.end, Ts(12000));
+  EXPECT_EQ(res.second, (std::vector<std::uint64_t>{2, 3, 4}));
+  res = ReadFile(files[2]->Path());
+  EXPECT_EQ(res.first.start, Ts(13500));
+  EXPECT_EQ(res.first.end, Ts(14000));
+  EXPECT_EQ(res.second, std::vector<std::uint64_t>{5});
+}
+
+TEST_F(LiveRecorderTests, TestNewMetadataStartsFile) {
+  const auto files = ExpectFiles(2, ".dbn");
+  LiveRecorder target{logger_.get(), kPathPrefix, Compression::None};
+  target.OnMetadata(MakeMetadata(dataset::kGlbxMdp3));
+  for (std::uint64_t i = 0; i < 3; ++i) {
+    auto mbo = MakeMbo(i, Ts(i));
+    target.OnRecord(Record{&mbo.hd});
+  }
+  target.OnMetadata(MakeMetadata(dataset::kXnasItch));
+  for (std::uint64_t i = 3; i < 5; ++i) {
+    auto mbo = MakeMbo(i, Ts(i));
+    target.OnRecord(Record{&mbo.hd});
+  }
+  target.Stop();
+  ASSERT_EQ(target.FilePaths(), Paths(files));
+
+  auto res = ReadFile(files[0]->Path());
+  EXPECT_EQ(res.first.dataset, dataset::kGlbxMdp3);
+  EXPECT_EQ(res.second, (std::vector<std::uint64_t>{0, 1, 2}));
+  res = ReadFile(files[1]->Path());
+  EXPECT_EQ(res.first.dataset, dataset::kXnasItch);
+  EXPECT_EQ(res.second, (std::vector<std::uint64_t>{3, 4}));
+}
+
+TEST_F(LiveRecorderTests, TestDropped) {
+  const auto files = ExpectFiles(1, ".dbn");
+  LiveRecorder target{logger_.get(), kPathPrefix, Compression::None};
+  auto mbo = MakeMbo(1, Ts(1));
+  // Before metadata
+  target.OnRecord(Record{&mbo.hd});
+  EXPECT_EQ(target.DroppedCount(), 1);
+  target.OnMetadata(MakeMetadata(dataset::kGlbxMdp3));
+  target.OnRecord(Record{&mbo.hd});
+  target.Stop();
+  // After stopping
+  target.OnRecord(Record{&mbo.hd});
+  target.OnRecord(Record{&mbo.hd});
+  EXPECT_EQ(target.RecordCount(), 1);
+  EXPECT_EQ(target.DroppedCount(), 3);
+}
+
+TEST_F(LiveRecorderTests, TestNullLogReceiver) {
+  ASSERT_THROW((LiveRecorder{nullptr, kPathPrefix, Compression::None}),
+               InvalidArgumentError);
+}
+
+TEST_F(LiveRecorderTests, TestLiveThreaded) {
+  constexpr auto kTsOut = false;
+  constexpr std::size_t kRecordCount = 50;
+  const auto files = ExpectFiles(1, ".dbn");
+  const mock::MockLsgServer mock_server{
+      dataset::kGlbxMdp3, kTsOut, [](mock::MockLsgServer& self) {
+        self.Accept();
+        self.Authenticate();
+        self.Start();
+        for (std::uint64_t i = 0; i < kRecordCount; ++i) {
+          self.SendRecord(MakeMbo(i, Ts(i)));
+        }
+      }};
+  LiveRecorder target{logger_.get(), kPathPrefix, Compression::None};
+  {
+    LiveThreaded client{logger_.get(),
+                        "32-character-with-lots-of-filler",
+                        dataset::kGlbxMdp3,
+                        "127.0.0.1",
+                        mock_server.Port(),
+                        kTsOut,
+                        VersionUpgradePolicy::AsIs};
+    target.Start(&client);
+    while (target.RecordCount() < kRecordCount) {
+      std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+  }
+  target.Stop();
+  EXPECT_EQ(target.DroppedCount(), 0);
+  ASSERT_EQ(target.FilePaths(), Paths(files));
+  const auto res = ReadFile(files[0]->Path());
+  // The mock gateway sends version 1 metadata
+  EXPECT_EQ(res.first.version, 1);
+  EXPECT_EQ(res.first.dataset, dataset::kGlbxMdp3);
+  ASSERT_EQ(res.second.size(), kRecordCount);
+  EXPECT_EQ(res.second.back(), kRecordCount - 1);
+}
+}  // namespace test
+}  // namespace databento
@@ -16,6 +16,7 @@
 #include "databento/live_threaded.hpp"
 #include "databento/log.hpp"
 #include "databento/record.hpp"
+#include "databento/record_visitor.hpp"
 #include "databento/symbology.hpp"
 #include "databento/timeseries.hpp"
 #include "gtest/gtest.h"
@@ -72,6 +73,56 @@ TEST_F(LiveThreadedTests, TestBasic) {
   target.BlockForStop();
 }
 
+TEST_F(LiveThreadedTests, TestVisitor) {
+  const MboMsg kRec{DummyHeader<MboMsg>(RType::Mbo),
+                    1,
+                    2,
+                    3,
+                    0,
+                    4,
+                    Action::Add,
+                    Side::Bid,
+                    UnixNanos{},
+                    TimeDeltaNanos{},
+                    100};
+  const mock::MockLsgServer mock_server{dataset::kGlbxMdp3, kTsOut,
+                                        [&kRec](mock::MockLsgServer& self) {
+                                          self.Accept();
+                                          self.Authenticate();
+                                          self.Start();
+                                          self.SendRecord(kRec);
+                                          self.SendRecord(kRec);
+                                        }};
+
+  class Visitor : public RecordVisitor<Visitor> {
+   public:
+    explicit Visitor(const MboMsg& expected) : expected_{expected} {}
+
+    void OnMetadata(Metadata&& metadata) {
+      EXPECT_EQ(mbo_count, 0);
+      dataset = std::move(metadata.dataset);
+    }
+    KeepGoing OnMbo(const MboMsg& mbo) {
+      EXPECT_EQ(mbo, expected_);
+      ++mbo_count;
+      return mbo_count < 2 ? KeepGoing::Continue : KeepGoing::Stop;
+    }
+
+    std::string dataset;
+    std::uint32_t mbo_count{};
+
+   private:
+    const MboMsg& expected_;
+  } visitor{kRec};
+  LiveThreaded target{
+      logger_.get(),      kKey,   dataset::kGlbxMdp3,    kLocalhost,
+      mock_server.Port(), kTsOut, VersionUpgradePolicy{}};
+  target.Start(visitor);
+  target.BlockForStop();
+  EXPECT_EQ(visitor.dataset, dataset::kGlbxMdp3);
+  EXPECT_EQ(visitor.mbo_count, 2);
+}
+
 TEST_F(LiveThreadedTests, TestTimeoutRecovery) {
   const MboMsg kRec{DummyHeader<MboMsg>(RType::Mbo),
                     1,
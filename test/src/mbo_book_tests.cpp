@@ -0,0 +1,300 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>  // min
+#include <cstddef>
+#include <cstdint>
+#include <functional>  // greater
+#include <iterator>    // advance
+#include <map>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include "databento/constants.hpp"
+#include "databento/dbn_file_store.hpp"
+#include "databento/enums.hpp"
+#include "databento/flag_set.hpp"
+#include "databento/mbo_book.hpp"
+#include "databento/record.hpp"
+#include "databento/timeseries.hpp"
+
+namespace databento {
+namespace test {
+class MboBookTests : public testing::Test {
+ protected:
+  static MboMsg GenMbo(Action action, Side side, std::uint64_t order_id,
+                       std::int64_t price, std::uint32_t size,
+                       FlagSet flags = FlagSet::kLast) {
+    MboMsg res{};
+    res.hd.rtype = RType::Mbo;
+    res.hd.length = sizeof(MboMsg) / RecordHeader::kLengthMultiplier;
+    res.hd.instrument_id = 1;
+    res.hd.publisher_id = 1;
+    res.order_id = order_id;
+    res.price = price;
+    res.size = size;
+    res.flags = flags;
+    res.action = action;
+    res.side = side;
+    return res;
+  }
+
+  static void CheckLevel(const BidAskPair& level, std::int64_t bid_px,
+                         std::uint32_t bid_sz, std::uint32_t bid_ct,
+                         std::int64_t ask_px, std::uint32_t ask_sz,
+                         std::uint32_t ask_ct) {
+    EXPECT_EQ(level.bid_px, bid_px);
+    EXPECT_EQ(level.bid_sz, bid_sz);
+    EXPECT_EQ(level.bid_ct, bid_ct);
+    EXPECT_EQ(level.ask_px, ask_px);
+    EXPECT_EQ(level.ask_sz, ask_sz);
+    EXPECT_EQ(level.ask_ct, ask_ct);
+  }
+
+  MboBook target_;
+};
+
+TEST_F(MboBookTests, TestEmpty) {
+  EXPECT_EQ(target_.OrderCount(), 0);
+  CheckLevel(target_.Bbo(), kUndefPrice, 0, 0, kUndefPrice, 0, 0);
+  EXPECT_EQ(target_.Snapshot(10).size(), 10);
+}
+
+TEST_F(MboBookTests, TestAddCancelModify) {
+  target_.Apply(GenMbo(Action::Add, Side::Bid, 1, 100, 10));
+  target_.Apply(GenMbo(Action::Add, Side::Bid, 2, 100, 5));
+  target_.Apply(GenMbo(Action::Add, Side::Bid, 3, 99, 7));
+  target_.Apply(GenMbo(Action::Add, Side::Ask, 4, 102, 3));
+  target_.Apply(GenMbo(Action::Add, Side::Ask, 5, 101, 4));
+  EXPECT_EQ(target_.OrderCount(), 5);
+  EXPECT_EQ(target_.BidLevelCount(), 2);
+  EXPECT_EQ(target_.AskLevelCount(), 2);
+  std::vector<BidAskPair> levels(3);
+  ASSERT_EQ(target_.Snapshot(levels.data(), levels.size()), 2);
+  CheckLevel(levels[0], 100, 15, 2, 101, 4, 1);
+  CheckLevel(levels[1], 99, 7, 1, 102, 3, 1);
+  CheckLevel(levels[2], kUndefPrice, 0, 0, kUndefPrice, 0, 0);
+
+  // Partial cancel
+  target_.Apply(GenMbo(Action::Cancel, Side::Bid, 1, 100, 4));
+  CheckLevel(target_.Bbo(), 100, 11, 2, 101, 4, 1);
+  // Trades and fills don't change the book
+  target_.Apply(GenMbo(Action::Trade, Side::Ask, 0, 101, 4));
+  target_.Apply(GenMbo(Action::Fill, Side::Ask, 5, 101, 4));
+  CheckLevel(target_.Bbo(), 100, 11, 2, 101, 4, 1);
+  // Full cancel removes the level
+  target_.Apply(GenMbo(Action::Cancel, Side::Ask, 5, 101, 4));
+  CheckLevel(target_.Bbo(), 100, 11, 2, 102, 3, 1);
+  EXPECT_EQ(target_.AskLevelCount(), 1);
+  // Unknown orders are ignored
+  target_.Apply(GenMbo(Action::Cancel, Side::Ask, 42, 101, 4));
+  EXPECT_EQ(target_.OrderCount(), 4);
+
+  // Modify size and price
+  target_.Apply(GenMbo(Action::Modify, Side::Bid, 2, 100, 8));
+  CheckLevel(target_.Bbo(), 100, 14, 2, 102, 3, 1);
+  target_.Apply(GenMbo(Action::Modify, Side::Bid, 1, 101, 6));
+  CheckLevel(target_.Bbo(), 101, 6, 1, 102, 3, 1);
+  ASSERT_EQ(target_.Snapshot(levels.data(), levels.size()), 3);
+  CheckLevel(levels[1], 100, 8, 1, kUndefPrice, 0, 0);
+  CheckLevel(levels[2], 99, 7, 1, kUndefPrice, 0, 0);
+  // Modifying an unknown order adds it
+  target_.Apply(GenMbo(Action::Modify, Side::Ask, 6, 102, 2));
+  CheckLevel(target_.Bbo(), 101, 6, 1, 102, 5, 2);
+
+  target_.Apply(GenMbo(Action::Clear, Side::None, 0, kUndefPrice, 0));
+  EXPECT_EQ(target_.OrderCount(), 0);
+  CheckLevel(target_.Bbo(), kUndefPrice, 0, 0, kUndefPrice, 0, 0);
+  // Pooled nodes are reused
+  target_.Apply(GenMbo(Action::Add, Side::Ask, 1, 105, 1));
+  CheckLevel(target_.Bbo(), kUndefPrice, 0, 0, 105, 1, 1);
+}
+
+TEST_F(MboBookTests, TestTopOfBook) {
+  target_.Apply(GenMbo(Action::Add, Side::Bid, 1, 100, 10));
+  target_.Apply(GenMbo(Action::Add, Side::Bid, 2, 99, 5));
+  target_.Apply(GenMbo(Action::Add, Side::Bid, 0, 101, 20,
+                       FlagSet::kTob | FlagSet::kLast));
+  EXPECT_EQ(target_.BidLevelCount(), 1);
+  CheckLevel(target_.Bbo(), 101, 20, 1, kUndefPrice, 0, 0);
+  target_.Apply(GenMbo(Action::Add, Side::Bid, 0, kUndefPrice, 0,
+                       FlagSet::kTob | FlagSet::kLast));
+  EXPECT_EQ(target_.OrderCount(), 0);
+}
+
+TEST_F(MboBookTests, TestTopOfBookSharedOrderId) {
+  constexpr auto kTobFlags = FlagSet::kTob | FlagSet::kLast;
+  target_.Apply(GenMbo(Action::Add, Side::Bid, 0, 100, 10, kTobFlags));
+  target_.Apply(GenMbo(Action::Add, Side::Ask, 0, 101, 20, kTobFlags));
+  CheckLevel(target_.Bbo(), 100, 10, 1, 101, 20, 1);
+  // Replacing one side leaves the other alone
+  target_.Apply(GenMbo(Action::Add, Side::Bid, 0, 99, 5, kTobFlags));
+  CheckLevel(target_.Bbo(), 99, 5, 1, 101, 20, 1);
+  EXPECT_EQ(target_.OrderCount(), 2);
+  // Top-of-book levels aren't orders that can be canceled
+  target_.Apply(GenMbo(Action::Cancel, Side::Ask, 0, 101, 20));
+  CheckLevel(target_.Bbo(), 99, 5, 1, 101, 20, 1);
+  target_.Apply(GenMbo(Action::Add, Side::Ask, 0, kUndefPrice, 0, kTobFlags));
+  CheckLevel(target_.Bbo(), 99, 5, 1, kUndefPrice, 0, 0);
+  EXPECT_EQ(target_.OrderCount(), 1);
+}
+
+TEST_F(MboBookTests, TestLastAndSnapshotFlags) {
+  EXPECT_TRUE(target_.IsConsistent());
+  target_.Apply(GenMbo(Action::Clear, Side::None, 0, kUndefPrice, 0,
+                       FlagSet::kSnapshot));
+  EXPECT_FALSE(target_.IsConsistent());
+  EXPECT_TRUE(target_.InSnapshot());
+  target_.Apply(
+      GenMbo(Action::Add, Side::Bid, 1, 100, 10, FlagSet::kSnapshot));
+  EXPECT_TRUE(target_.InSnapshot());
+  target_.Apply(GenMbo(Action::Add, Side::Ask, 2, 101, 10,
+                       FlagSet::kSnapshot | FlagSet::kLast));
+  EXPECT_TRUE(target_.IsConsistent());
+  EXPECT_FALSE(target_.InSnapshot());
+  target_.Apply(GenMbo(Action::Add, Side::Ask, 3, 101, 10, {}));
+  EXPECT_FALSE(target_.IsConsistent());
+}
+
+// Checks against a map-based book of aggregated levels.
+TEST_F(MboBookTests, TestMatchesReference) {
+  struct RefOrder {
+    Side side;
+    std::int64_t price;
+    std::uint32_t size;
+  };
+  std::unordered_map<std::uint64_t, RefOrder> orders;
+  std::map<std::int64_t, std::uint32_t, std::greater<std::int64_t>> bids;
+  std::map<std::int64_t, std::uint32_t> asks;
+  const auto level_size = [&bids, &asks](Side side, std::int64_t px)
+      -> std::uint32_t& { return side == Side::Bid ? bids[px] : asks[px]; };
+  const auto remove_size = [&bids, &asks, &level_size](const RefOrder& order,
+                                                        std::uint32_t size) {
+    auto& level = level_size(order.side, order.price);
+    level -= size;
+    if (level == 0) {
+      if (order.side == Side::Bid) {
+        bids.erase(order.price);
+      } else {
+        asks.erase(order.price);
+      }
+    }
+  };
+
+  std::mt19937_64 gen{42};
+  std::uint64_t next_order_id = 1;
+  for (int i = 0; i < 50000; ++i) {
+    const auto roll = gen() % 10;
+    const auto size = static_cast<std::uint32_t>(gen() % 100 + 1);
+    if (roll < 4 || orders.empty()) {
+      const auto side = gen() % 2 == 0 ? Side::Bid : Side::Ask;
+      const auto price = static_cast<std::int64_t>(
+          side == Side::Bid ? 900 + gen() % 100 : 1001 + gen() % 100);
+      const auto order_id = next_order_id++;
+      target_.Apply(GenMbo(Action::Add, side, order_id, price, size));
+      orders.emplace(order_id, RefOrder{side, price, size});
+      level_size(side, price) += size;
+    } else {
+      // A pseudo-random existing order
+      auto it = orders.begin();
+      const auto offset = gen() % std::min<std::uint64_t>(orders.size(), 16);
+      std::advance(it, static_cast<std::ptrdiff_t>(offset));
+      auto& order = it->second;
+      if (roll < 8) {
+        target_.Apply(
+            GenMbo(Action::Cancel, order.side, it->first, order.price, size));
+        const auto canceled = std::min(size, order.size);
+        remove_size(order, canceled);
+        order.size -= canceled;
+        if (order.size == 0) {
+          orders.erase(it);
+        }
+      } else {
+        const auto price = order.price + (roll == 9 ? 1 : 0);
+        target_.Apply(
+            GenMbo(Action::Modify, order.side, it->first, price, size));
+        remove_size(order, order.size);
+        order.price = price;
+        order.size = size;
+        level_size(order.side, price) += size;
+      }
+    }
+    ASSERT_EQ(target_.OrderCount(), orders.size());
+    ASSERT_EQ(target_.BidLevelCount(), bids.size());
+    ASSERT_EQ(target_.AskLevelCount(), asks.size());
+    if (i % 100 == 0) {
+      const auto levels = target_.Snapshot(5);
+      auto bid_it = bids.begin();
+      auto ask_it = asks.begin();
+      for (const auto& level : levels) {
+        if (bid_it != bids.end()) {
+          ASSERT_EQ(level.bid_px, bid_it->first);
+          ASSERT_EQ(level.bid_sz, bid_it->second);
+          ++bid_it;
+        } else {
+          ASSERT_EQ(level.bid_px, kUndefPrice);
+        }
+        if (ask_it != asks.end()) {
+          ASSERT_EQ(level.ask_px, ask_it->first);
+          ASSERT_EQ(level.ask_sz, ask_it->second);
+          ++ask_it;
+        } else {
+          ASSERT_EQ(level.ask_px, kUndefPrice);
+        }
+      }
+    }
+  }
+}
+
+TEST(MboBookEngineTests, TestReplay) {
+  MboBookEngine target;
+  std::size_t consistent_count{};
+  const MboBook* last_book{};
+  MboMsg last_mbo{};
+  DbnFileStore{TEST_BUILD_DIR "/data/test_data.mbo.dbn"}.Replay(target.Bind(
+      [&consistent_count, &last_book, &last_mbo](const MboMsg& mbo,
+                                                 const MboBook& book) {
+        EXPECT_TRUE(book.IsConsistent());
+        EXPECT_EQ(book.LastUpdate(), mbo.ts_recv);
+        ++consistent_count;
+        last_book = &book;
+        last_mbo = mbo;
+        return KeepGoing::Continue;
+      }));
+  EXPECT_GT(consistent_count, 0);
+  ASSERT_EQ(target.BookCount(), 1);
+  EXPECT_EQ(target.Find(last_mbo.hd.instrument_id, last_mbo.hd.publisher_id),
+            last_book);
+}
+
+TEST(MboBookEngineTests, TestBooksPerInstrument) {
+  MboBookEngine target;
+  MboMsg mbo{};
+  mbo.hd.rtype = RType::Mbo;
+  mbo.hd.length = sizeof(MboMsg) / RecordHeader::kLengthMultiplier;
+  mbo.action = Action::Add;
+  mbo.side = Side::Bid;
+  mbo.size = 1;
+  mbo.flags = FlagSet::kLast;
+  for (std::uint32_t instrument_id = 1; instrument_id <= 3; ++instrument_id) {
+    mbo.hd.instrument_id = instrument_id;
+    mbo.order_id = instrument_id;
+    mbo.price = std::int64_t{instrument_id} * 10;
+    target.OnRecord(Record{&mbo.hd});
+  }
+  // Not MBO
+  TradeMsg trade{};
+  trade.hd.rtype = RType::Mbp0;
+  trade.hd.length = sizeof(TradeMsg) / RecordHeader::kLengthMultiplier;
+  trade.hd.instrument_id = 4;
+  target.OnRecord(Record{&trade.hd});
+  ASSERT_EQ(target.BookCount(), 3);
+  for (std::uint32_t instrument_id = 1; instrument_id <= 3; ++instrument_id) {
+    const auto* book = target.Find(instrument_id, 0);
+    ASSERT_NE(book, nullptr);
+    EXPECT_EQ(book->Bbo().bid_px, std::int64_t{instrument_id} * 10);
+  }
+  EXPECT_EQ(target.Find(4, 0), nullptr);
+}
+}  // namespace test
+}  // namespace databento
@@ -0,0 +1,157 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "databento/datetime.hpp"
+#include "databento/dbn.hpp"
+#include "databento/dbn_decoder.hpp"
+#include "databento/dbn_encoder.hpp"
+#include "databento/dbn_file_store.hpp"
+#include "databento/detail/file_stream.hpp"
+#include "databento/enums.hpp"
+#include "databento/exceptions.hpp"
+#include "databento/iwritable.hpp"
+#include "databento/merged_file_store.hpp"
+#include "databento/record.hpp"
+#include "databento/timeseries.hpp"
+#include "temp_file.hpp"
+
+namespace databento {
+namespace test {
+class MergedFileStoreTests : public testing::Test {
+ protected:
+  struct Tagged {
+    std::uint64_t index_ts;
+    std::size_t file_idx;
+    std::uint32_t sequence;
+  };
+
+  // Writes a trades file where record `i` has a `ts_recv` of
+  // `i * step + offset` and a `sequence` of `i`.
+  static void WriteTrades(const std::string& file_path, Compression compression,
+                          std::uint32_t count, std::uint64_t step,
+                          std::uint64_t offset) {
+    const auto metadata =
+        DbnDecoder{detail::FileStream{TEST_BUILD_DIR
+                                      "/data/test_data.trades.dbn"}}
+            .DecodeMetadata();
+    DbnEncoder encoder{metadata,
+                       std::unique_ptr<IWritable>{
+                           new detail::OutFileStream{file_path}},
+                       compression};
+    for (std::uint32_t i = 0; i < count; ++i) {
+      TradeMsg trade{};
+      trade.hd =
+          RecordHeader{sizeof(TradeMsg) / RecordHeader::kLengthMultiplier,
+                       RType::Mbp0, 1, 1, UnixNanos{}};
+      trade.ts_recv = UnixNanos{UnixNanos::duration{i * step + offset}};
+      trade.sequence = i;
+      encoder.EncodeRecord(trade);
+    }
+    encoder.Finish();
+  }
+
+  static std::vector<Tagged> ReplayTagged(MergedFileStore& target) {
+    std::vector<Tagged> res;
+    target.Replay([&res](const Record& record, std::size_t file_idx) {
+      const auto& trade = record.Get<TradeMsg>();
+      res.push_back(Tagged{trade.ts_recv.time_since_epoch().count(), file_idx,
+                           trade.sequence});
+      return KeepGoing::Continue;
+    });
+    return res;
+  }
+
+  static std::size_t CountRecords(const std::string& file_path) {
+    std::size_t count{};
+    DbnFileStore{file_path}.Replay([&count](const Record&) {
+      ++count;
+      return KeepGoing::Continue;
+    });
+    return count;
+  }
+};
+
+TEST_F(MergedFileStoreTests, TestEmptyFilePaths) {
+  ASSERT_THROW(MergedFileStore{std::vector<std::string>{}},
+               InvalidArgumentError);
+}
+
+TEST_F(MergedFileStoreTests, TestMergeTestData) {
+  const std::vector<std::string> file_paths{
+      TEST_BUILD_DIR "/data/test_data.trades.dbn",
+      TEST_BUILD_DIR "/data/test_data.mbo.dbn",
+      TEST_BUILD_DIR "/data/test_data.mbp-1.dbn.zst"};
+  MergedFileStore target{file_paths};
+  ASSERT_EQ(target.FileCount(), 3);
+  EXPECT_EQ(target.FilePath(1), file_paths[1]);
+  EXPECT_EQ(target.FileMetadata(0).schema, Schema::Trades);
+  EXPECT_EQ(target.FileMetadata(1).schema, Schema::Mbo);
+  EXPECT_EQ(target.FileMetadata(2).schema, Schema::Mbp1);
+
+  const std::vector<RType> rtypes{RType::Mbp0, RType::Mbo, RType::Mbp1};
+  std::size_t count{};
+  UnixNanos last_ts{};
+  target.Replay([&](const Record& record, std::size_t file_idx) {
+    EXPECT_EQ(record.RType(), rtypes[file_idx]);
+    EXPECT_GE(record.IndexTs(), last_ts);
+    last_ts = record.IndexTs();
+    ++count;
+    return KeepGoing::Continue;
+  });
+  std::size_t expected_count{};
+  for (const auto& file_path : file_paths) {
+    expected_count += CountRecords(file_path);
+  }
+  EXPECT_EQ(count, expected_count);
+}
+
+TEST_F(MergedFileStoreTests, TestMergeOrder) {
+  constexpr std::uint32_t kCount = 10000;
+  const TempFile even_file{testing::TempDir() + "/merge-even.trades.dbn"};
+  const TempFile odd_file{testing::TempDir() + "/merge-odd.trades.dbn.zst"};
+  WriteTrades(even_file.Path(), Compression::None, kCount, 2, 0);
+  WriteTrades(odd_file.Path(), Compression::Zstd, kCount, 2, 1);
+  // A queue holding only a few records makes the readers wait on the merge
+  MergedFileStore target{{odd_file.Path(), even_file.Path()},
+                         VersionUpgradePolicy::AsIs, 4096};
+  const auto res = ReplayTagged(target);
+  ASSERT_EQ(res.size(), 2 * kCount);
+  for (std::size_t i = 0; i < res.size(); ++i) {
+    ASSERT_EQ(res[i].index_ts, i);
+    ASSERT_EQ(res[i].file_idx, i % 2 == 0 ? 1U : 0U);
+    ASSERT_EQ(res[i].sequence, i / 2);
+  }
+}
+
+TEST_F(MergedFileStoreTests, TestMergeTiesInFileOrder) {
+  const TempFile first_file{testing::TempDir() + "/merge-first.trades.dbn"};
+  const TempFile second_file{testing::TempDir() + "/merge-second.trades.dbn"};
+  WriteTrades(first_file.Path(), Compression::None, 100, 1, 0);
+  WriteTrades(second_file.Path(), Compression::None, 100, 1, 0);
+  MergedFileStore target{{first_file.Path(), second_file.Path()}};
+  const auto res = ReplayTagged(target);
+  ASSERT_EQ(res.size(), 200);
+  for (std::size_t i = 0; i < res.size(); ++i) {
+    ASSERT_EQ(res[i].index_ts, i / 2);
+    ASSERT_EQ(res[i].file_idx, i % 2);
+  }
+}
+
+TEST_F(MergedFileStoreTests, TestStopEarly) {
+  const TempFile file{testing::TempDir() + "/merge-stop.trades.dbn"};
+  WriteTrades(file.Path(), Compression::None, 10000, 1, 0);
+  MergedFileStore target{{file.Path(), file.Path()},
+                         VersionUpgradePolicy::AsIs, 4096};
+  std::size_t count{};
+  target.Replay([&count](const Record&) {
+    return ++count == 5 ? KeepGoing::Stop : KeepGoing::Continue;
+  });
+  EXPECT_EQ(count, 5);
+}
+}  // namespace test
+}  // namespace databento
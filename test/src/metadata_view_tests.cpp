@@ -0,0 +1,192 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>  // fill_n, search
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <utility>  // move
+#include <vector>
+
+#include "databento/compat.hpp"
+#include "databento/constants.hpp"
+#include "databento/datetime.hpp"
+#include "databento/dbn.hpp"
+#include "databento/dbn_decoder.hpp"
+#include "databento/dbn_encoder.hpp"
+#include "databento/detail/mmap_file.hpp"
+#include "databento/enums.hpp"
+#include "databento/exceptions.hpp"
+#include "databento/metadata_view.hpp"
+
+namespace databento {
+namespace test {
+class MetadataViewTests : public testing::Test {
+ protected:
+  // Metadata with many symbols like an `ALL_SYMBOLS` request.
+  static Metadata LargeMetadata(std::uint8_t version) {
+    Metadata metadata{version,
+                      "OPRA.PILLAR",
+                      false,
+                      Schema::Trades,
+                      UnixNanos{std::chrono::nanoseconds{1}},
+                      UnixNanos{std::chrono::nanoseconds{2}},
+                      0,
+                      true,
+                      SType::RawSymbol,
+                      SType::InstrumentId,
+                      false,
+                      VersionSymbolCstrLen(version),
+                      {"ALL_SYMBOLS"},
+                      {},
+                      {"MISSING"},
+                      {}};
+    for (std::uint32_t i = 0; i < 2000; ++i) {
+      SymbolMapping mapping{"SYM" + std::to_string(i), {}};
+      // A variable number of intervals
+      for (std::uint32_t j = 0; j < i % 4; ++j) {
+        mapping.intervals.emplace_back(MappingInterval{
+            20240101 + j, 20240102 + j, std::to_string(i * 10 + j)});
+      }
+      if (i % 7 == 0) {
+        metadata.partial.emplace_back(mapping.raw_symbol);
+      }
+      metadata.mappings.emplace_back(std::move(mapping));
+    }
+    return metadata;
+  }
+
+  // The encoded metadata following the DBN prefix, version, and length.
+  static std::vector<std::uint8_t> Encode(const Metadata& metadata) {
+    auto encoded = DbnEncoder::EncodeMetadata(metadata);
+    encoded.erase(encoded.begin(), encoded.begin() + 8);
+    return encoded;
+  }
+
+  static void CheckSymbols(const MetadataView::SymbolList& actual,
+                           const std::vector<std::string>& expected) {
+    ASSERT_EQ(actual.Size(), expected.size());
+    std::size_t i = 0;
+    for (const char* symbol : actual) {
+      EXPECT_EQ(symbol, expected[i]);
+      EXPECT_EQ(actual[i], expected[i]);
+      ++i;
+    }
+    EXPECT_EQ(i, expected.size());
+  }
+};
+
+TEST_F(MetadataViewTests, TestLazyFieldsMatchMetadata) {
+  for (const auto version : std::initializer_list<std::uint8_t>{1, 2}) {
+    SCOPED_TRACE(static_cast<int>(version));
+    const auto metadata = LargeMetadata(version);
+    const MetadataView target{version, Encode(metadata)};
+    EXPECT_EQ(target.Version(), version);
+    EXPECT_EQ(target.Dataset(), metadata.dataset);
+    EXPECT_EQ(target.GetSchema(), metadata.schema);
+    EXPECT_EQ(target.Start(), metadata.start);
+    EXPECT_EQ(target.End(), metadata.end);
+    EXPECT_TRUE(target.HasMixedSTypeIn());
+    EXPECT_EQ(target.STypeOut(), metadata.stype_out);
+    EXPECT_EQ(target.SymbolCstrLen(), metadata.symbol_cstr_len);
+    CheckSymbols(target.Symbols(), metadata.symbols);
+    CheckSymbols(target.Partial(), metadata.partial);
+    CheckSymbols(target.NotFound(), metadata.not_found);
+
+    ASSERT_EQ(target.Mappings().Size(), metadata.mappings.size());
+    std::size_t i = 0;
+    for (const auto mapping : target.Mappings()) {
+      const auto& expected = metadata.mappings[i];
+      EXPECT_EQ(mapping.RawSymbol(), expected.raw_symbol);
+      const auto intervals = mapping.Intervals();
+      ASSERT_EQ(intervals.Size(), expected.intervals.size());
+      for (std::size_t j = 0; j < intervals.Size(); ++j) {
+        EXPECT_EQ(intervals[j].StartDate(), expected.intervals[j].start_date);
+        EXPECT_EQ(intervals[j].EndDate(), expected.intervals[j].end_date);
+        EXPECT_EQ(intervals[j].Symbol(), expected.intervals[j].symbol);
+      }
+      EXPECT_EQ(mapping.ToSymbolMapping(), expected);
+      ++i;
+    }
+    EXPECT_EQ(i, metadata.mappings.size());
+    EXPECT_EQ(target.ToMetadata(), metadata);
+  }
+}
+
+TEST_F(MetadataViewTests, TestMoveKeepsViews) {
+  const auto metadata = LargeMetadata(kDbnVersion);
+  MetadataView view{kDbnVersion, Encode(metadata)};
+  const auto mappings = view.Mappings();
+  const MetadataView target{std::move(view)};
+  EXPECT_EQ((*mappings.begin()).RawSymbol(), metadata.mappings[0].raw_symbol);
+  EXPECT_EQ(target.ToMetadata(), metadata);
+}
+
+TEST_F(MetadataViewTests, TestTruncated) {
+  Metadata metadata = LargeMetadata(kDbnVersion);
+  metadata.mappings.resize(4);
+  const auto encoded = Encode(metadata);
+  for (std::size_t size = 0; size < encoded.size(); ++size) {
+    SCOPED_TRACE(size);
+    std::vector<std::uint8_t> truncated{
+        encoded.begin(), encoded.begin() + static_cast<std::ptrdiff_t>(size)};
+    ASSERT_THROW((MetadataView{kDbnVersion, std::move(truncated)}),
+                 DbnResponseError);
+  }
+  ASSERT_THROW((MetadataView{kDbnVersion + 1, encoded}), DbnResponseError);
+}
+
+TEST_F(MetadataViewTests, TestUnterminatedSymbol) {
+  Metadata metadata = LargeMetadata(kDbnVersion);
+  metadata.partial.clear();
+  metadata.mappings.resize(4);
+  const auto encoded = Encode(metadata);
+  const auto symbol_offset = [&encoded](const std::string& symbol) {
+    // Include the null terminator to match the whole symbol
+    const auto it = std::search(encoded.begin(), encoded.end(), symbol.c_str(),
+                                symbol.c_str() + symbol.size() + 1);
+    EXPECT_NE(it, encoded.end());
+    return it - encoded.begin();
+  };
+  const auto raw_symbol_offset = symbol_offset("SYM1");
+  // The first interval's symbol follows the interval count, start date, and
+  // end date
+  const auto interval_symbol_offset =
+      raw_symbol_offset +
+      static_cast<std::ptrdiff_t>(metadata.symbol_cstr_len +
+                                  3 * sizeof(std::uint32_t));
+  for (const auto offset :
+       {symbol_offset("ALL_SYMBOLS"), symbol_offset("MISSING"),
+        raw_symbol_offset, interval_symbol_offset}) {
+    SCOPED_TRACE(offset);
+    auto corrupted = encoded;
+    std::fill_n(corrupted.begin() + offset, metadata.symbol_cstr_len, 'A');
+    ASSERT_THROW((MetadataView{kDbnVersion, std::move(corrupted)}),
+                 DbnResponseError);
+  }
+}
+
+TEST_F(MetadataViewTests, TestDecodeMetadataView) {
+  for (const auto* file_name :
+       {"test_data.definition.v1.dbn", "test_data.mbo.dbn.zst"}) {
+    const std::string file_path =
+        TEST_BUILD_DIR "/data/" + std::string{file_name};
+    SCOPED_TRACE(file_path);
+    DbnDecoder expected_decoder{detail::MmapFile{file_path}};
+    DbnDecoder target{detail::MmapFile{file_path}};
+    const auto view = target.DecodeMetadataView();
+    EXPECT_EQ(view.ToMetadata(), expected_decoder.DecodeMetadata());
+    std::size_t record_count{};
+    while (const auto* record = target.DecodeRecord()) {
+      const auto* expected = expected_decoder.DecodeRecord();
+      ASSERT_NE(expected, nullptr);
+      EXPECT_EQ(record->Size(), expected->Size());
+      ++record_count;
+    }
+    EXPECT_EQ(expected_decoder.DecodeRecord(), nullptr);
+    EXPECT_GT(record_count, 0);
+  }
+}
+}  // namespace test
+}  // namespace databento
@@ -0,0 +1,54 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>  // equal
+#include <cstdint>
+#include <fstream>  // ofstream
+#include <string>
+#include <utility>  // move
+#include <vector>
+
+#include "databento/detail/file_stream.hpp"
+#include "databento/detail/mmap_file.hpp"
+#include "databento/exceptions.hpp"
+#include "temp_file.hpp"
+
+namespace databento {
+namespace detail {
+namespace test {
+TEST(MmapFileTests, TestMatchesFileStream) {
+  const std::string file_path =
+      TEST_BUILD_DIR "/data/test_data.ohlcv-1d.v1.dbn";
+  const MmapFile target{file_path};
+  ASSERT_EQ(target.Size(), 206);
+  ASSERT_NE(target.Data(), nullptr);
+  FileStream file_stream{file_path};
+  std::vector<std::uint8_t> buffer(target.Size());
+  file_stream.ReadExact(buffer.data(), buffer.size());
+  EXPECT_TRUE(std::equal(buffer.cbegin(), buffer.cend(), target.Data()));
+}
+
+TEST(MmapFileTests, TestMove) {
+  MmapFile target{TEST_BUILD_DIR "/data/test_data.ohlcv-1d.v1.dbn"};
+  const auto* data = target.Data();
+  MmapFile moved{std::move(target)};
+  EXPECT_EQ(moved.Data(), data);
+  EXPECT_EQ(moved.Size(), 206);
+  EXPECT_EQ(target.Data(), nullptr);
+  EXPECT_EQ(target.Size(), 0);
+}
+
+TEST(MmapFileTests, TestEmptyFile) {
+  const TempFile temp_file{TEST_BUILD_DIR "/empty.dbn"};
+  { std::ofstream{temp_file.Path()}; }
+  const MmapFile target{temp_file.Path()};
+  EXPECT_EQ(target.Data(), nullptr);
+  EXPECT_EQ(target.Size(), 0);
+}
+
+TEST(MmapFileTests, TestNonExistentFile) {
+  ASSERT_THROW(MmapFile{TEST_BUILD_DIR "/data/not_a_file.dbn"},
+               InvalidArgumentError);
+}
+}  // namespace test
+}  // namespace detail
+}  // namespace databento
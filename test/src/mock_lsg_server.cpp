@@ -3,8 +3,9 @@
 #ifdef _WIN32
 #include <winsock2.h>
 #else
-#include <netinet/in.h>  // sockaddr_in
-#include <sys/socket.h>  // recv
+#include <netinet/in.h>   // IPPROTO_TCP, sockaddr_in
+#include <netinet/tcp.h>  // TCP_NODELAY
+#include <sys/socket.h>   // recv, setsockopt
 #endif
 #include <openssl/sha.h>  // SHA256_DIGEST_LENGTH
 
@@ -32,6 +33,19 @@ void MockLsgServer::Accept() {
   auto addr_len = static_cast<socklen_t>(sizeof(addr));
   conn_fd_ = detail::ScopedFd{
       ::accept(socket_.Get(), reinterpret_cast<sockaddr*>(&addr), &addr_len)};
+  const int flag = 1;
+#ifdef _WIN32
+  const auto flag_ptr = reinterpret_cast<const char*>(&flag);
+#else
+  const auto flag_ptr = &flag;
+#endif
+  // Disable Nagle's algorithm so records are sent as soon as possible, which
+  // is also what the real gateway does
+  const auto res = ::setsockopt(conn_fd_.Get(), IPPROTO_TCP, TCP_NODELAY,
+                                flag_ptr, sizeof(int));
+  if (res < 0) {
+    throw TcpError{errno, "Failed to disable Nagle's algorithm"};
+  }
 }
 
 std::string MockLsgServer::Receive() {
@@ -0,0 +1,268 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>  // binary_search
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "databento/datetime.hpp"
+#include "databento/dbn.hpp"
+#include "databento/dbn_decoder.hpp"
+#include "databento/dbn_encoder.hpp"
+#include "databento/detail/file_stream.hpp"
+#include "databento/enums.hpp"
+#include "databento/exceptions.hpp"
+#include "databento/iwritable.hpp"
+#include "databento/parallel_dbn_decoder.hpp"
+#include "databento/record.hpp"
+#include "databento/timeseries.hpp"
+#include "temp_file.hpp"
+
+namespace databento {
+namespace test {
+class ParallelDbnDecoderTests : public testing::Test {
+ protected:
+  template <typename R>
+  static R GenRecord(RType rtype, std::uint32_t sequence) {
+    R res{};
+    res.hd = RecordHeader{sizeof(R) / RecordHeader::kLengthMultiplier, rtype,
+                          1, sequence % 10, UnixNanos{}};
+    res.sequence = sequence;
+    return res;
+  }
+
+  static Metadata TestMetadata() {
+    return DbnDecoder{detail::FileStream{TEST_BUILD_DIR
+                                         "/data/test_data.mbo.dbn"}}
+        .DecodeMetadata();
+  }
+
+  // Writes `count` MBO records with sequences counting up from 0.
+  static void WriteMbo(const std::string& file_path, std::uint32_t count) {
+    DbnEncoder encoder{TestMetadata(),
+                       std::unique_ptr<IWritable>{
+                           new detail::OutFileStream{file_path}}};
+    for (std::uint32_t i = 0; i < count; ++i) {
+      encoder.EncodeRecord(GenRecord<MboMsg>(RType::Mbo, i));
+    }
+    encoder.Finish();
+  }
+
+  // Writes `count` records of varying schemas with sequences counting up from
+  // 0 and returns the offset of each record in the file.
+  static std::vector<std::uint64_t> WriteMixed(const std::string& file_path,
+                                               std::uint32_t count) {
+    auto metadata = TestMetadata();
+    metadata.has_mixed_schema = true;
+    const auto metadata_size = DbnEncoder::EncodeMetadata(metadata).size();
+    DbnEncoder encoder{metadata,
+                       std::unique_ptr<IWritable>{
+                           new detail::OutFileStream{file_path}}};
+    std::vector<std::uint64_t> offsets;
+    std::uint64_t offset = metadata_size;
+    for (std::uint32_t i = 0; i < count; ++i) {
+      offsets.push_back(offset);
+      // An uneven pattern of record sizes
+      switch (i * 7 % 5) {
+        case 0: {
+          encoder.EncodeRecord(GenRecord<Mbp10Msg>(RType::Mbp10, i));
+          offset += sizeof(Mbp10Msg);
+          break;
+        }
+        case 1:
+        case 3: {
+          encoder.EncodeRecord(GenRecord<TradeMsg>(RType::Mbp0, i));
+          offset += sizeof(TradeMsg);
+          break;
+        }
+        default: {
+          encoder.EncodeRecord(GenRecord<MboMsg>(RType::Mbo, i));
+          offset += sizeof(MboMsg);
+        }
+      }
+    }
+    encoder.Finish();
+    return offsets;
+  }
+
+  static std::uint32_t Sequence(const Record& record) {
+    if (record.Holds<MboMsg>()) {
+      return record.Get<MboMsg>().sequence;
+    }
+    if (record.Holds<Mbp10Msg>()) {
+      return record.Get<Mbp10Msg>().sequence;
+    }
+    return record.Get<TradeMsg>().sequence;
+  }
+
+  static std::vector<std::uint32_t> ReplaySequences(
+      ParallelDbnDecoder& target) {
+    std::vector<std::uint32_t> res;
+    target.Replay([&res](const Record& record) {
+      res.push_back(Sequence(record));
+      return KeepGoing::Continue;
+    });
+    return res;
+  }
+
+  // Concatenates the sequences of each chunk.
+  static std::vector<std::uint32_t> ReplayChunkSequences(
+      ParallelDbnDecoder& target) {
+    // Each chunk is only decoded by one thread
+    std::vector<std::vector<std::uint32_t>> chunks(target.ChunkCount());
+    target.ReplayChunks([&chunks](const Record& record, std::size_t chunk_idx) {
+      chunks[chunk_idx].push_back(Sequence(record));
+      return KeepGoing::Continue;
+    });
+    std::vector<std::uint32_t> res;
+    for (const auto& chunk : chunks) {
+      EXPECT_FALSE(chunk.empty());
+      res.insert(res.end(), chunk.begin(), chunk.end());
+    }
+    return res;
+  }
+
+  static std::vector<std::uint32_t> Range(std::uint32_t count) {
+    std::vector<std::uint32_t> res(count);
+    for (std::uint32_t i = 0; i < count; ++i) {
+      res[i] = i;
+    }
+    return res;
+  }
+};
+
+TEST_F(ParallelDbnDecoderTests, TestInvalidArguments) {
+  ASSERT_THROW(
+      ParallelDbnDecoder(TEST_BUILD_DIR "/data/test_data.mbo.dbn.zst", 2),
+      InvalidArgumentError);
+  ASSERT_THROW(ParallelDbnDecoder(TEST_BUILD_DIR "/data/test_data.mbo.dbn", 0),
+               InvalidArgumentError);
+}
+
+TEST_F(ParallelDbnDecoderTests, TestSingleSchemaChunks) {
+  constexpr std::uint32_t kCount = 10000;
+  const TempFile temp_file{testing::TempDir() + "/parallel.dbn"};
+  WriteMbo(temp_file.Path(), kCount);
+  ParallelDbnDecoder target{temp_file.Path(), VersionUpgradePolicy::AsIs, 3,
+                            7};
+  EXPECT_EQ(target.FileMetadata().schema, Schema::Mbo);
+  ASSERT_EQ(target.ChunkCount(), 7);
+  for (std::size_t i = 1; i <= target.ChunkCount(); ++i) {
+    EXPECT_GT(target.ChunkOffset(i), target.ChunkOffset(i - 1));
+    EXPECT_EQ((target.ChunkOffset(i) - target.ChunkOffset(0)) % sizeof(MboMsg),
+              0);
+  }
+  EXPECT_EQ(ReplaySequences(target), Range(kCount));
+  EXPECT_EQ(ReplayChunkSequences(target), Range(kCount));
+}
+
+TEST_F(ParallelDbnDecoderTests, TestMixedSchemaChunks) {
+  constexpr std::uint32_t kCount = 20000;
+  const TempFile temp_file{testing::TempDir() + "/parallel.dbn"};
+  const auto offsets = WriteMixed(temp_file.Path(), kCount);
+  ParallelDbnDecoder target{temp_file.Path(), VersionUpgradePolicy::AsIs, 4,
+                            13};
+  ASSERT_EQ(target.ChunkCount(), 13);
+  for (std::size_t i = 0; i < target.ChunkCount(); ++i) {
+    EXPECT_TRUE(std::binary_search(offsets.begin(), offsets.end(),
+                                   target.ChunkOffset(i)))
+        << "chunk " << i;
+  }
+  EXPECT_EQ(ReplaySequences(target), Range(kCount));
+  EXPECT_EQ(ReplayChunkSequences(target), Range(kCount));
+}
+
+TEST_F(ParallelDbnDecoderTests, TestSingleSchemaWithGatewayRecords) {
+  constexpr std::uint32_t kCount = 1000;
+  // Takes up the same space as 40 MBO records, so the file size is still a
+  // multiple of the MBO record size
+  constexpr std::size_t kSystemCount = 7;
+  const TempFile temp_file{testing::TempDir() + "/parallel.dbn"};
+  {
+    DbnEncoder encoder{TestMetadata(),
+                       std::unique_ptr<IWritable>{
+                           new detail::OutFileStream{temp_file.Path()}}};
+    for (std::uint32_t i = 0; i < kCount; ++i) {
+      // Straddle where the file would be split in two by record count
+      if (i == (kCount + 40) / 2 - 20) {
+        for (std::size_t j = 0; j < kSystemCount; ++j) {
+          SystemMsg system{};
+          system.hd = RecordHeader{
+              sizeof(SystemMsg) / RecordHeader::kLengthMultiplier,
+              RType::System, 0, 0, UnixNanos{}};
+          encoder.EncodeRecord(system);
+        }
+      }
+      encoder.EncodeRecord(GenRecord<MboMsg>(RType::Mbo, i));
+    }
+    encoder.Finish();
+  }
+  ParallelDbnDecoder target{temp_file.Path(), VersionUpgradePolicy::AsIs, 2,
+                            2};
+  ASSERT_EQ(target.ChunkCount(), 2);
+  std::vector<std::uint32_t> sequences;
+  std::size_t system_count{};
+  target.Replay([&sequences, &system_count](const Record& record) {
+    if (record.Holds<SystemMsg>()) {
+      ++system_count;
+    } else {
+      sequences.push_back(record.Get<MboMsg>().sequence);
+    }
+    return KeepGoing::Continue;
+  });
+  EXPECT_EQ(sequences, Range(kCount));
+  EXPECT_EQ(system_count, kSystemCount);
+}
+
+TEST_F(ParallelDbnDecoderTests, TestMoreChunksThanRecords) {
+  const TempFile temp_file{testing::TempDir() + "/parallel.dbn"};
+  WriteMbo(temp_file.Path(), 3);
+  ParallelDbnDecoder target{temp_file.Path(), VersionUpgradePolicy::AsIs, 2,
+                            8};
+  EXPECT_EQ(target.ChunkCount(), 3);
+  EXPECT_EQ(ReplaySequences(target), Range(3));
+}
+
+TEST_F(ParallelDbnDecoderTests, TestReplayStopEarly) {
+  const TempFile temp_file{testing::TempDir() + "/parallel.dbn"};
+  // Enough records to fill the queue of each thread
+  WriteMbo(temp_file.Path(), 100000);
+  ParallelDbnDecoder target{temp_file.Path(), 2};
+  std::uint32_t count{};
+  target.Replay([&count](const Record& record) {
+    EXPECT_EQ(Sequence(record), count);
+    return ++count == 50000 ? KeepGoing::Stop : KeepGoing::Continue;
+  });
+  EXPECT_EQ(count, 50000);
+}
+
+TEST_F(ParallelDbnDecoderTests, TestReplayChunksException) {
+  const TempFile temp_file{testing::TempDir() + "/parallel.dbn"};
+  WriteMbo(temp_file.Path(), 1000);
+  ParallelDbnDecoder target{temp_file.Path(), 2};
+  const auto throw_on_500 = [](const Record& record, std::size_t) {
+    if (Sequence(record) == 500) {
+      throw InvalidArgumentError{"test", "record", "Bad record"};
+    }
+    return KeepGoing::Continue;
+  };
+  ASSERT_THROW(target.ReplayChunks(throw_on_500), InvalidArgumentError);
+}
+
+TEST_F(ParallelDbnDecoderTests, TestUpgrade) {
+  ParallelDbnDecoder target{TEST_BUILD_DIR "/data/test_data.definition.v1.dbn",
+                            VersionUpgradePolicy::Upgrade, 2};
+  EXPECT_EQ(target.FileMetadata().version, 1);
+  std::size_t count{};
+  target.Replay([&count](const Record& record) {
+    EXPECT_TRUE(record.Holds<InstrumentDefMsg>());
+    EXPECT_EQ(record.Size(), sizeof(InstrumentDefMsg));
+    ++count;
+    return KeepGoing::Continue;
+  });
+  EXPECT_EQ(count, 2);
+}
+}  // namespace test
+}  // namespace databento
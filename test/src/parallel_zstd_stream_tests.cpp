@@ -0,0 +1,180 @@
+#include <gtest/gtest.h>
+#include <zstd.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "databento/detail/file_stream.hpp"
+#include "databento/detail/parallel_zstd_stream.hpp"
+#include "databento/detail/zstd_stream.hpp"
+#include "databento/exceptions.hpp"
+#include "databento/ireadable.hpp"
+
+namespace databento {
+namespace detail {
+namespace test {
+namespace {
+// Reads from a buffer in small, uneven chunks.
+class ChunkedReader : public IReadable {
+ public:
+  explicit ChunkedReader(std::vector<std::uint8_t> data)
+      : data_{std::move(data)} {}
+
+  void ReadExact(std::uint8_t* buffer, std::size_t length) override {
+    if (ReadSome(buffer, length) != length) {
+      throw DbnResponseError{"Unexpected end of input"};
+    }
+  }
+
+  std::size_t ReadSome(std::uint8_t* buffer, std::size_t max_length) override {
+    const auto read_size = std::min({max_length, data_.size() - pos_,
+                                     std::size_t{777}});
+    std::copy(data_.cbegin() + static_cast<std::ptrdiff_t>(pos_),
+              data_.cbegin() + static_cast<std::ptrdiff_t>(pos_ + read_size),
+              buffer);
+    pos_ += read_size;
+    return read_size;
+  }
+
+ private:
+  std::vector<std::uint8_t> data_;
+  std::size_t pos_{};
+};
+
+std::vector<std::uint8_t> ReadAll(IReadable* target) {
+  std::vector<std::uint8_t> res;
+  std::uint8_t buffer[1000];
+  std::size_t read_size;
+  while ((read_size = target->ReadSome(buffer, sizeof(buffer))) > 0) {
+    res.insert(res.end(), buffer, buffer + read_size);
+  }
+  return res;
+}
+
+void AppendFrame(const std::uint8_t* data, std::size_t size,
+                 bool include_content_size, std::vector<std::uint8_t>* out) {
+  std::unique_ptr<ZSTD_CCtx, std::size_t (*)(ZSTD_CCtx*)> c_ctx{
+      ::ZSTD_createCCtx(), ::ZSTD_freeCCtx};
+  ::ZSTD_CCtx_setParameter(c_ctx.get(), ZSTD_c_contentSizeFlag,
+                           include_content_size ? 1 : 0);
+  const auto out_pos = out->size();
+  out->resize(out_pos + ::ZSTD_compressBound(size));
+  const auto frame_size = ::ZSTD_compress2(c_ctx.get(), &(*out)[out_pos],
+                                           out->size() - out_pos, data, size);
+  ASSERT_FALSE(::ZSTD_isError(frame_size));
+  out->resize(out_pos + frame_size);
+}
+}  // namespace
+
+TEST(ParallelZstdStreamTests, TestMatchesZstdStream) {
+  for (const auto* file_name :
+       {"multi-frame.definition.v1.dbn.zst", "test_data.mbo.dbn.zst",
+        "test_data.definition.dbn.zst"}) {
+    const std::string file_path = TEST_BUILD_DIR "/data/" + std::string{file_name};
+    SCOPED_TRACE(file_path);
+    ZstdStream expected_stream{
+        std::unique_ptr<IReadable>{new FileStream{file_path}}};
+    const auto expected = ReadAll(&expected_stream);
+    ASSERT_FALSE(expected.empty());
+    for (const std::size_t thread_count : {1U, 4U}) {
+      ParallelZstdStream target{
+          std::unique_ptr<IReadable>{new FileStream{file_path}}, thread_count};
+      EXPECT_EQ(ReadAll(&target), expected);
+    }
+  }
+}
+
+TEST(ParallelZstdStreamTests, TestManyFrames) {
+  std::vector<std::uint8_t> expected(1024 * 1024);
+  for (std::size_t i = 0; i < expected.size(); ++i) {
+    expected[i] = static_cast<std::uint8_t>((i * 31) % 253);
+  }
+  std::vector<std::uint8_t> compressed;
+  std::size_t pos = 0;
+  for (std::size_t i = 0; pos < expected.size(); ++i) {
+    const auto frame_size = std::min(expected.size() - pos, 1000 + i * 997);
+    AppendFrame(&expected[pos], frame_size, true, &compressed);
+    pos += frame_size;
+    if (i == 5) {
+      // skippable frame with a 4-byte payload
+      const std::uint8_t skippable[] = {0x50, 0x2A, 0x4D, 0x18, 4, 0,
+                                        0,    0,    1,    2,    3, 4};
+      compressed.insert(compressed.end(), skippable,
+                        skippable + sizeof(skippable));
+    }
+  }
+  // An empty frame
+  AppendFrame(nullptr, 0, true, &compressed);
+  ParallelZstdStream target{
+      std::unique_ptr<IReadable>{new ChunkedReader{compressed}}, 3};
+  EXPECT_EQ(ReadAll(&target), expected);
+  // Stays at the end
+  std::uint8_t buffer[1];
+  EXPECT_EQ(target.ReadSome(buffer, sizeof(buffer)), 0);
+}
+
+TEST(ParallelZstdStreamTests, TestUnknownContentSize) {
+  std::vector<std::uint8_t> expected(100000);
+  for (std::size_t i = 0; i < expected.size(); ++i) {
+    expected[i] = static_cast<std::uint8_t>((i * 7) % 251);
+  }
+  std::vector<std::uint8_t> compressed;
+  AppendFrame(expected.data(), 20000, true, &compressed);
+  AppendFrame(&expected[20000], 20000, true, &compressed);
+  // The rest is streamed from this frame on
+  AppendFrame(&expected[40000], 30000, false, &compressed);
+  AppendFrame(&expected[70000], 30000, true, &compressed);
+  ParallelZstdStream target{
+      std::unique_ptr<IReadable>{new ChunkedReader{compressed}}, 2};
+  EXPECT_EQ(ReadAll(&target), expected);
+}
+
+TEST(ParallelZstdStreamTests, TestCorruptContentSize) {
+  // A frame header claiming 1 TiB of content followed by a 3-byte raw block
+  const std::vector<std::uint8_t> compressed{
+      0x28, 0xB5, 0x2F, 0xFD,  // magic number
+      0xE0,                    // single segment with an 8-byte content size
+      0,    0,    0,    0,    0, 1, 0, 0,  // content size
+      0x19, 0,    0,    1,    2, 3};       // last raw block
+  ParallelZstdStream target{
+      std::unique_ptr<IReadable>{new ChunkedReader{compressed}}, 2};
+  // Doesn't try to allocate the content size
+  ASSERT_THROW(ReadAll(&target), DbnResponseError);
+}
+
+TEST(ParallelZstdStreamTests, TestReadExact) {
+  const std::vector<std::uint8_t> expected(100, 7);
+  std::vector<std::uint8_t> compressed;
+  AppendFrame(expected.data(), 40, true, &compressed);
+  AppendFrame(&expected[40], 60, false, &compressed);
+  ParallelZstdStream target{
+      std::unique_ptr<IReadable>{new ChunkedReader{compressed}}, 2};
+  std::vector<std::uint8_t> res(90);
+  // Spans both frames
+  target.ReadExact(res.data(), res.size());
+  EXPECT_EQ(res, std::vector<std::uint8_t>(90, 7));
+  ASSERT_THROW(target.ReadExact(res.data(), res.size()), DbnResponseError);
+}
+
+TEST(ParallelZstdStreamTests, TestTruncatedFrame) {
+  const std::vector<std::uint8_t> data(10000, 1);
+  std::vector<std::uint8_t> compressed;
+  AppendFrame(data.data(), data.size(), true, &compressed);
+  AppendFrame(data.data(), data.size(), true, &compressed);
+  compressed.resize(compressed.size() - 4);
+  ParallelZstdStream target{
+      std::unique_ptr<IReadable>{new ChunkedReader{compressed}}, 2};
+  ASSERT_THROW(ReadAll(&target), DbnResponseError);
+}
+
+TEST(ParallelZstdStreamTests, TestZeroThreads) {
+  ASSERT_THROW((ParallelZstdStream{
+                   std::unique_ptr<IReadable>{new ChunkedReader{{}}}, 0}),
+               InvalidArgumentError);
+}
+}  // namespace test
+}  // namespace detail
+}  // namespace databento
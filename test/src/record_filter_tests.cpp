@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+#include "databento/datetime.hpp"
+#include "databento/enums.hpp"
+#include "databento/record.hpp"
+#include "databento/record_filter.hpp"
+
+namespace databento {
+namespace test {
+namespace {
+RecordHeader Header(RType rtype, std::uint16_t publisher_id,
+                    std::uint32_t instrument_id) {
+  return {sizeof(MboMsg) / RecordHeader::kLengthMultiplier, rtype,
+          publisher_id, instrument_id, UnixNanos{}};
+}
+}  // namespace
+
+TEST(RecordFilterTests, TestEmptyMatchesAll) {
+  const RecordFilter target;
+  EXPECT_TRUE(target.IsEmpty());
+  EXPECT_TRUE(target.Matches(Header(RType::Mbo, 1, 1)));
+  EXPECT_TRUE(target.Matches(Header(RType::Mbp0, 0, 0)));
+  EXPECT_TRUE(target.Matches(Header(RType::Error, UINT16_MAX, UINT32_MAX)));
+}
+
+TEST(RecordFilterTests, TestRType) {
+  RecordFilter target;
+  target.AddRType(RType::Mbo).AddRType(RType::Mbp0);
+  EXPECT_FALSE(target.IsEmpty());
+  EXPECT_TRUE(target.Matches(Header(RType::Mbo, 1, 1)));
+  EXPECT_TRUE(target.Matches(Header(RType::Mbp0, 2, 100)));
+  EXPECT_FALSE(target.Matches(Header(RType::Mbp1, 1, 1)));
+  EXPECT_FALSE(target.Matches(Header(RType::SymbolMapping, 1, 1)));
+}
+
+TEST(RecordFilterTests, TestInstrumentId) {
+  RecordFilter target;
+  target.AddInstrumentId(0)
+      .AddInstrumentId(5482)
+      .AddInstrumentId(0xFFFFFF)
+      .AddInstrumentId(0x1000000)
+      .AddInstrumentId(UINT32_MAX);
+  for (const std::uint32_t id :
+       {0U, 5482U, 0xFFFFFFU, 0x1000000U, UINT32_MAX}) {
+    EXPECT_TRUE(target.Matches(Header(RType::Mbo, 1, id))) << id;
+  }
+  for (const std::uint32_t id : {1U, 5481U, 5483U, 0xFFFFFEU, 0x1000001U,
+                                 UINT32_MAX - 1}) {
+    EXPECT_FALSE(target.Matches(Header(RType::Mbo, 1, id))) << id;
+  }
+}
+
+TEST(RecordFilterTests, TestInstrumentIdOnlyLarge) {
+  RecordFilter target;
+  target.AddInstrumentId(UINT32_MAX);
+  EXPECT_TRUE(target.Matches(Header(RType::Mbo, 1, UINT32_MAX)));
+  EXPECT_FALSE(target.Matches(Header(RType::Mbo, 1, 0)));
+  EXPECT_FALSE(target.Matches(Header(RType::Mbo, 1, 5482)));
+}
+
+TEST(RecordFilterTests, TestPublisherId) {
+  RecordFilter target;
+  target.AddPublisherId(1).AddPublisherId(UINT16_MAX);
+  EXPECT_TRUE(target.Matches(Header(RType::Mbo, 1, 1)));
+  EXPECT_TRUE(target.Matches(Header(RType::Mbo, UINT16_MAX, 1)));
+  EXPECT_FALSE(target.Matches(Header(RType::Mbo, 0, 1)));
+  EXPECT_FALSE(target.Matches(Header(RType::Mbo, 2, 1)));
+}
+
+TEST(RecordFilterTests, TestCombined) {
+  RecordFilter target;
+  target.AddRType(RType::Mbo).AddInstrumentId(10).AddPublisherId(2);
+  EXPECT_TRUE(target.Matches(Header(RType::Mbo, 2, 10)));
+  EXPECT_FALSE(target.Matches(Header(RType::Mbp0, 2, 10)));
+  EXPECT_FALSE(target.Matches(Header(RType::Mbo, 1, 10)));
+  EXPECT_FALSE(target.Matches(Header(RType::Mbo, 2, 11)));
+}
+}  // namespace test
+}  // namespace databento
@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "databento/compat.hpp"
+#include "databento/datetime.hpp"
+#include "databento/dbn.hpp"
+#include "databento/dbn_file_store.hpp"
+#include "databento/enums.hpp"
+#include "databento/record.hpp"
+#include "databento/record_visitor.hpp"
+#include "databento/timeseries.hpp"
+
+namespace databento {
+namespace test {
+namespace {
+template <typename T>
+RecordHeader DummyHeader(RType rtype) {
+  return {sizeof(T) / RecordHeader::kLengthMultiplier, rtype, 1, 1,
+          UnixNanos{}};
+}
+
+class CountingVisitor : public RecordVisitor<CountingVisitor> {
+ public:
+  void OnMetadata(Metadata&& metadata) {
+    schemas.emplace_back(metadata.schema);
+  }
+  KeepGoing OnMbo(const MboMsg&) {
+    ++mbo_count;
+    return mbo_count < stop_after ? KeepGoing::Continue : KeepGoing::Stop;
+  }
+  KeepGoing OnTrade(const TradeMsg&) {
+    ++trade_count;
+    return KeepGoing::Continue;
+  }
+  KeepGoing OnOhlcv(const OhlcvMsg&) {
+    ++ohlcv_count;
+    return KeepGoing::Continue;
+  }
+  KeepGoing OnInstrumentDef(const InstrumentDefMsg&) {
+    ++definition_count;
+    return KeepGoing::Continue;
+  }
+  KeepGoing OnInstrumentDefV1(const InstrumentDefMsgV1&) {
+    ++definition_v1_count;
+    return KeepGoing::Continue;
+  }
+  KeepGoing OnOther(const Record&) {
+    ++other_count;
+    return KeepGoing::Continue;
+  }
+
+  std::vector<Schema> schemas;
+  std::size_t stop_after{SIZE_MAX};
+  std::size_t mbo_count{};
+  std::size_t trade_count{};
+  std::size_t ohlcv_count{};
+  std::size_t definition_count{};
+  std::size_t definition_v1_count{};
+  std::size_t other_count{};
+};
+}  // namespace
+
+TEST(RecordVisitorTests, TestVisitDispatchesOnRType) {
+  CountingVisitor target;
+  MboMsg mbo{};
+  mbo.hd = DummyHeader<MboMsg>(RType::Mbo);
+  TradeMsg trade{};
+  trade.hd = DummyHeader<TradeMsg>(RType::Mbp0);
+  OhlcvMsg ohlcv{};
+  ohlcv.hd = DummyHeader<OhlcvMsg>(RType::Ohlcv1H);
+  Mbp1Msg mbp1{};
+  mbp1.hd = DummyHeader<Mbp1Msg>(RType::Mbp1);
+  RecordHeader unknown = DummyHeader<RecordHeader>(static_cast<RType>(0xFF));
+
+  EXPECT_EQ(target.Visit(Record{&mbo.hd}), KeepGoing::Continue);
+  EXPECT_EQ(target.Visit(Record{&trade.hd}), KeepGoing::Continue);
+  EXPECT_EQ(target.Visit(Record{&ohlcv.hd}), KeepGoing::Continue);
+  // Not handled by the visitor
+  EXPECT_EQ(target.Visit(Record{&mbp1.hd}), KeepGoing::Continue);
+  EXPECT_EQ(target.Visit(Record{&unknown}), KeepGoing::Continue);
+  EXPECT_EQ(target.mbo_count, 1);
+  EXPECT_EQ(target.trade_count, 1);
+  EXPECT_EQ(target.ohlcv_count, 1);
+  EXPECT_EQ(target.other_count, 1);
+}
+
+TEST(RecordVisitorTests, TestVisitReturnsHandlerResult) {
+  CountingVisitor target;
+  target.stop_after = 2;
+  MboMsg mbo{};
+  mbo.hd = DummyHeader<MboMsg>(RType::Mbo);
+  EXPECT_EQ(target.Visit(Record{&mbo.hd}), KeepGoing::Continue);
+  EXPECT_EQ(target.Visit(Record{&mbo.hd}), KeepGoing::Stop);
+}
+
+TEST(RecordVisitorTests, TestDbnFileStoreReplay) {
+  DbnFileStore file_store{TEST_BUILD_DIR "/data/test_data.mbo.dbn"};
+  CountingVisitor target;
+  file_store.Replay(target);
+  ASSERT_EQ(target.schemas, std::vector<Schema>{Schema::Mbo});
+  EXPECT_GT(target.mbo_count, 0);
+  EXPECT_EQ(target.other_count, 0);
+
+  std::size_t expected{};
+  DbnFileStore{TEST_BUILD_DIR "/data/test_data.mbo.dbn"}.Replay(
+      [&expected](const Record& record) {
+        expected += record.Holds<MboMsg>();
+        return KeepGoing::Continue;
+      });
+  EXPECT_EQ(target.mbo_count, expected);
+}
+
+TEST(RecordVisitorTests, TestDbnFileStoreReplayStop) {
+  DbnFileStore file_store{TEST_BUILD_DIR "/data/test_data.mbo.dbn"};
+  CountingVisitor target;
+  target.stop_after = 1;
+  file_store.Replay(target);
+  EXPECT_EQ(target.mbo_count, 1);
+}
+
+TEST(RecordVisitorTests, TestDbnFileStoreReplayVersion1) {
+  const std::string file_path =
+      TEST_BUILD_DIR "/data/test_data.definition.v1.dbn";
+  DbnFileStore as_is{file_path, VersionUpgradePolicy::AsIs};
+  CountingVisitor as_is_target;
+  as_is.Replay(as_is_target);
+  EXPECT_GT(as_is_target.definition_v1_count, 0);
+  EXPECT_EQ(as_is_target.definition_count, 0);
+
+  DbnFileStore upgraded{file_path, VersionUpgradePolicy::Upgrade};
+  CountingVisitor upgraded_target;
+  upgraded.Replay(upgraded_target);
+  EXPECT_EQ(upgraded_target.definition_count,
+            as_is_target.definition_v1_count);
+  EXPECT_EQ(upgraded_target.definition_v1_count, 0);
+}
+}  // namespace test
+}  // namespace databento
@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>  // copy, equal, fill_n
+#include <cstddef>
+#include <cstdint>
+#include <numeric>  // iota
+#include <utility>  // move
+#include <vector>
+
+#include "databento/detail/ring_buffer.hpp"
+
+namespace databento {
+namespace detail {
+namespace test {
+namespace {
+// Writes `length` bytes from `data` to `target`, returning the number written.
+std::size_t Write(RingBuffer& target, const std::uint8_t* data,
+                  std::size_t length) {
+  auto* const write_begin = target.WriteBegin();
+  const auto write_size = std::min(length, target.WritableSize());
+  std::copy(data, data + write_size, write_begin);
+  target.Fill(write_size);
+  return write_size;
+}
+}  // namespace
+
+TEST(RingBufferTests, TestCapacityRoundedUp) {
+  const RingBuffer target{100};
+  EXPECT_GE(target.Capacity(), 100);
+  EXPECT_EQ(target.Capacity() % 4096, 0);
+  EXPECT_EQ(target.ReadableSize(), 0);
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(target.ReadBegin()) % 8, 0);
+}
+
+TEST(RingBufferTests, TestWriteThenRead) {
+  RingBuffer target{4096};
+  std::vector<std::uint8_t> data(100);
+  std::iota(data.begin(), data.end(), 0);
+  ASSERT_EQ(Write(target, data.data(), data.size()), data.size());
+  ASSERT_EQ(target.ReadableSize(), data.size());
+  EXPECT_TRUE(std::equal(data.cbegin(), data.cend(), target.ReadBegin()));
+  target.Consume(40);
+  ASSERT_EQ(target.ReadableSize(), 60);
+  EXPECT_EQ(*target.ReadBegin(), 40);
+}
+
+TEST(RingBufferTests, TestFull) {
+  RingBuffer target{4096};
+  const std::vector<std::uint8_t> data(target.Capacity() + 10, 0xAB);
+  EXPECT_EQ(Write(target, data.data(), data.size()), target.Capacity());
+  EXPECT_EQ(target.WritableSize(), 0);
+  target.Consume(8);
+  target.WriteBegin();
+  EXPECT_EQ(target.WritableSize(), 8);
+}
+
+// Readable data should stay contiguous and in order across many wrap-arounds
+// regardless of whether the buffer is mirrored.
+TEST(RingBufferTests, TestWrapAround) {
+  RingBuffer target{4096};
+  const auto capacity = target.Capacity();
+  std::vector<std::uint8_t> data(capacity * 5);
+  for (std::size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<std::uint8_t>(i % 251);
+  }
+  std::size_t written = 0;
+  std::size_t read = 0;
+  // Chosen so writes and reads don't line up with the end of the buffer
+  constexpr std::size_t kChunk = 1000;
+  constexpr std::size_t kRecord = 136;
+  while (read < data.size()) {
+    if (written < data.size()) {
+      written += Write(target, &data[written],
+                       std::min(kChunk, data.size() - written));
+    }
+    while (target.ReadableSize() >= kRecord ||
+           (written == data.size() && target.ReadableSize() > 0)) {
+      const auto length = std::min(kRecord, target.ReadableSize());
+      ASSERT_TRUE(
+          std::equal(&data[read], &data[read] + length, target.ReadBegin()))
+          << "read=" << read;
+      target.Consume(length);
+      read += length;
+    }
+  }
+  EXPECT_EQ(target.ReadableSize(), 0);
+}
+
+TEST(RingBufferTests, TestMove) {
+  RingBuffer target{4096};
+  const std::uint8_t data[] = {1, 2, 3, 4};
+  Write(target, data, sizeof(data));
+  const auto* read_begin = target.ReadBegin();
+  const auto capacity = target.Capacity();
+  RingBuffer moved{std::move(target)};
+  EXPECT_EQ(moved.ReadBegin(), read_begin);
+  EXPECT_EQ(moved.ReadableSize(), 4);
+  EXPECT_EQ(moved.Capacity(), capacity);
+  EXPECT_EQ(target.Capacity(), 0);
+  EXPECT_EQ(target.ReadableSize(), 0);
+}
+
+#ifdef __linux__
+TEST(RingBufferTests, TestMirrored) {
+  RingBuffer target{4096};
+  ASSERT_TRUE(target.IsMirrored());
+  const auto capacity = target.Capacity();
+  std::vector<std::uint8_t> data(capacity - 4);
+  std::fill_n(data.begin(), data.size(), 0x11);
+  ASSERT_EQ(Write(target, data.data(), data.size()), data.size());
+  target.Consume(data.size() - 4);
+  // Straddles the end of the buffer
+  const std::uint8_t tail[] = {1, 2, 3, 4, 5, 6, 7, 8};
+  ASSERT_EQ(Write(target, tail, sizeof(tail)), sizeof(tail));
+  ASSERT_EQ(target.ReadableSize(), 12);
+  const auto* read_begin = target.ReadBegin();
+  EXPECT_TRUE(std::equal(tail, tail + sizeof(tail), read_begin + 4));
+  // Unread data wasn't moved
+  target.Consume(4);
+  EXPECT_EQ(target.ReadBegin(), read_begin + 4);
+}
+#endif
+}  // namespace test
+}  // namespace detail
+}  // namespace databento
@@ -0,0 +1,157 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>  // pair
+#include <vector>
+
+#include "databento/datetime.hpp"
+#include "databento/dbn.hpp"
+#include "databento/dbn_file_store.hpp"
+#include "databento/enums.hpp"
+#include "databento/exceptions.hpp"
+#include "databento/record.hpp"
+#include "databento/sharded_replay.hpp"
+#include "databento/timeseries.hpp"
+
+namespace databento {
+namespace test {
+class ShardedReplayTests : public testing::Test {
+ protected:
+  using Seen = std::vector<std::pair<std::uint32_t, std::uint32_t>>;
+
+  static TradeMsg GenTrade(std::uint32_t instrument_id,
+                           std::uint32_t sequence) {
+    TradeMsg res{};
+    res.hd = RecordHeader{sizeof(TradeMsg) / RecordHeader::kLengthMultiplier,
+                          RType::Mbp0, 1, instrument_id, UnixNanos{}};
+    res.sequence = sequence;
+    return res;
+  }
+
+  // Each shard only appends to its own element of `seen_`.
+  ShardedReplay::ShardCallbackFactory Collect(std::size_t shard_count) {
+    seen_.resize(shard_count);
+    return [this](std::size_t shard_idx) -> RecordCallback {
+      Seen* seen = &seen_[shard_idx];
+      return [seen](const Record& record) {
+        const auto& trade = record.Get<TradeMsg>();
+        seen->emplace_back(trade.hd.instrument_id, trade.sequence);
+        return KeepGoing::Continue;
+      };
+    };
+  }
+
+  std::vector<Seen> seen_;
+};
+
+TEST_F(ShardedReplayTests, TestZeroShards) {
+  ASSERT_THROW(ShardedReplay(0, Collect(1)), InvalidArgumentError);
+}
+
+TEST_F(ShardedReplayTests, TestShardOf) {
+  ShardedReplay target{4, Collect(4)};
+  ASSERT_EQ(target.ShardCount(), 4);
+  std::vector<std::size_t> counts(4);
+  for (std::uint32_t instrument_id = 0; instrument_id < 1000;
+       ++instrument_id) {
+    const auto shard_idx = target.ShardOf(instrument_id);
+    ASSERT_LT(shard_idx, 4);
+    ASSERT_EQ(target.ShardOf(instrument_id), shard_idx);
+    ++counts[shard_idx];
+  }
+  for (const auto count : counts) {
+    EXPECT_GT(count, 200);
+    EXPECT_LT(count, 300);
+  }
+}
+
+TEST_F(ShardedReplayTests, TestOrderWithinInstrument) {
+  constexpr std::uint32_t kInstrumentCount = 50;
+  constexpr std::uint32_t kSequenceCount = 1000;
+  // A small queue makes the dispatching thread wait on the workers
+  ShardedReplay target{3, Collect(3), 4096};
+  for (std::uint32_t sequence = 0; sequence < kSequenceCount; ++sequence) {
+    for (std::uint32_t instrument_id = 1; instrument_id <= kInstrumentCount;
+         ++instrument_id) {
+      auto trade = GenTrade(instrument_id, sequence);
+      ASSERT_EQ(target.OnRecord(Record{&trade.hd}), KeepGoing::Continue);
+    }
+  }
+  target.Flush();
+  std::size_t count{};
+  for (std::size_t shard_idx = 0; shard_idx < seen_.size(); ++shard_idx) {
+    std::vector<std::uint32_t> next_sequences(kInstrumentCount + 1);
+    for (const auto& instrument_and_sequence : seen_[shard_idx]) {
+      const auto instrument_id = instrument_and_sequence.first;
+      ASSERT_EQ(target.ShardOf(instrument_id), shard_idx);
+      ASSERT_EQ(instrument_and_sequence.second,
+                next_sequences[instrument_id]++);
+    }
+    count += seen_[shard_idx].size();
+  }
+  EXPECT_EQ(count, kInstrumentCount * kSequenceCount);
+  // Flushing again doesn't wait for anything
+  target.Flush();
+  target.Stop();
+  auto trade = GenTrade(1, 0);
+  EXPECT_EQ(target.OnRecord(Record{&trade.hd}), KeepGoing::Stop);
+}
+
+TEST_F(ShardedReplayTests, TestReplayFile) {
+  std::size_t expected_count{};
+  DbnFileStore{TEST_BUILD_DIR "/data/test_data.mbo.dbn"}.Replay(
+      [&expected_count](const Record&) {
+        ++expected_count;
+        return KeepGoing::Continue;
+      });
+  std::vector<std::size_t> counts(2);
+  ShardedReplay target{2, [&counts](std::size_t shard_idx) -> RecordCallback {
+                         std::size_t* count = &counts[shard_idx];
+                         return [count](const Record& record) {
+                           EXPECT_TRUE(record.Holds<MboMsg>());
+                           ++*count;
+                           return KeepGoing::Continue;
+                         };
+                       }};
+  DbnFileStore file_store{TEST_BUILD_DIR "/data/test_data.mbo.dbn"};
+  Schema schema{};
+  target.Replay(file_store,
+                [&schema](Metadata&& metadata) { schema = metadata.schema; });
+  EXPECT_EQ(schema, Schema::Mbo);
+  EXPECT_EQ(counts[0] + counts[1], expected_count);
+}
+
+TEST_F(ShardedReplayTests, TestCallbackException) {
+  ShardedReplay target{2, [](std::size_t) -> RecordCallback {
+                         return [](const Record& record) {
+                           if (record.Header().instrument_id == 7) {
+                             throw std::runtime_error{"Bad instrument"};
+                           }
+                           return KeepGoing::Continue;
+                         };
+                       }};
+  auto trade = GenTrade(7, 0);
+  target.OnRecord(Record{&trade.hd});
+  ASSERT_THROW(target.Flush(), std::runtime_error);
+  EXPECT_EQ(target.OnRecord(Record{&trade.hd}), KeepGoing::Stop);
+  // The exception is only rethrown once
+  target.Stop();
+}
+
+TEST_F(ShardedReplayTests, TestAllShardsStop) {
+  ShardedReplay target{2, [](std::size_t) -> RecordCallback {
+                         return [](const Record&) { return KeepGoing::Stop; };
+                       }};
+  for (std::uint32_t instrument_id = 0; instrument_id < 100;
+       ++instrument_id) {
+    auto trade = GenTrade(instrument_id, 0);
+    target.OnRecord(Record{&trade.hd});
+  }
+  target.Flush();
+  auto trade = GenTrade(0, 1);
+  EXPECT_EQ(target.OnRecord(Record{&trade.hd}), KeepGoing::Stop);
+}
+}  // namespace test
+}  // namespace databento
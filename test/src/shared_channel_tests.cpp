@@ -85,6 +85,63 @@ TEST_F(SharedChannelTests, TestReadSome) {
 
   ASSERT_EQ(res, "parsestreamtestssomelast");
 }
+
+TEST_F(SharedChannelTests, TestInvalidCapacity) {
+  ASSERT_THROW(SharedChannel{0}, InvalidArgumentError);
+}
+
+TEST_F(SharedChannelTests, TestWriteBlocksWhenFull) {
+  SharedChannel target{4};
+  ASSERT_EQ(target.Capacity(), 4);
+  const std::string input = "parsestreamtests";
+  // copies share the same channel
+  write_thread_ = ScopedThread{[target, input]() mutable {
+    target.Write(reinterpret_cast<const std::uint8_t*>(input.data()),
+                 input.size());
+    target.Finish();
+  }};
+  std::array<std::uint8_t, 16> buffer{};
+  std::string res;
+  while (true) {
+    const auto read_size = target.ReadSome(buffer.data(), buffer.size());
+    if (read_size == 0) {
+      break;
+    }
+    // never more than the capacity is buffered
+    EXPECT_LE(read_size, 4);
+    res.append(reinterpret_cast<const char*>(buffer.data()), read_size);
+    std::this_thread::sleep_for(std::chrono::milliseconds{1});
+  }
+  ASSERT_EQ(res, input);
+}
+
+TEST_F(SharedChannelTests, TestReadExactMoreThanCapacity) {
+  SharedChannel target{3};
+  write_thread_ = ScopedThread{[target]() mutable {
+    target.Write(reinterpret_cast<const std::uint8_t*>("parse"), 5);
+    target.Write(reinterpret_cast<const std::uint8_t*>("exact"), 5);
+    target.Finish();
+  }};
+  std::array<std::uint8_t, 16> buffer{};
+  target.ReadExact(buffer.data(), 10);
+  EXPECT_STREQ(reinterpret_cast<const char*>(buffer.data()), "parseexact");
+  ASSERT_THROW(target.ReadExact(buffer.data(), 1), DbnResponseError);
+}
+
+TEST_F(SharedChannelTests, TestCloseUnblocksWriter) {
+  SharedChannel target{4};
+  write_thread_ = ScopedThread{[target]() mutable {
+    target.Write(reinterpret_cast<const std::uint8_t*>("close early"), 11);
+    // writes after closing are discarded
+    target.Write(reinterpret_cast<const std::uint8_t*>("more"), 4);
+  }};
+  std::array<std::uint8_t, 16> buffer{};
+  target.ReadExact(buffer.data(), 2);
+  EXPECT_STREQ(reinterpret_cast<const char*>(buffer.data()), "cl");
+  target.Close();
+  // would hang if the writer were still blocked
+  write_thread_.Join();
+}
 }  // namespace test
 }  // namespace detail
 }  // namespace databento
@@ -0,0 +1,137 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <thread>  // this_thread
+
+#include "databento/datetime.hpp"
+#include "databento/detail/scoped_thread.hpp"
+#include "databento/detail/spsc_record_queue.hpp"
+#include "databento/enums.hpp"
+#include "databento/exceptions.hpp"
+#include "databento/record.hpp"
+
+namespace databento {
+namespace detail {
+namespace test {
+namespace {
+MboMsg MakeMbo(std::uint64_t order_id) {
+  MboMsg mbo{};
+  mbo.hd.length = sizeof(MboMsg) / RecordHeader::kLengthMultiplier;
+  mbo.hd.rtype = RType::Mbo;
+  mbo.order_id = order_id;
+  return mbo;
+}
+
+OhlcvMsg MakeOhlcv(std::int64_t open) {
+  OhlcvMsg ohlcv{};
+  ohlcv.hd.length = sizeof(OhlcvMsg) / RecordHeader::kLengthMultiplier;
+  ohlcv.hd.rtype = RType::Ohlcv1S;
+  ohlcv.open = open;
+  return ohlcv;
+}
+}  // namespace
+
+TEST(SpscRecordQueueTests, TestCapacityTooSmall) {
+  ASSERT_THROW(SpscRecordQueue{1024}, InvalidArgumentError);
+}
+
+TEST(SpscRecordQueueTests, TestPushPop) {
+  SpscRecordQueue target{4096};
+  EXPECT_EQ(target.Front(), nullptr);
+  auto mbo = MakeMbo(1);
+  auto ohlcv = MakeOhlcv(2);
+  ASSERT_TRUE(target.TryPush(Record{&mbo.hd}));
+  ASSERT_TRUE(target.TryPush(Record{&ohlcv.hd}));
+  EXPECT_EQ(target.Size(), sizeof(mbo) + sizeof(ohlcv));
+
+  const Record* front = target.Front();
+  ASSERT_NE(front, nullptr);
+  ASSERT_TRUE(front->Holds<MboMsg>());
+  EXPECT_EQ(front->Get<MboMsg>(), mbo);
+  target.Pop();
+  front = target.Front();
+  ASSERT_NE(front, nullptr);
+  ASSERT_TRUE(front->Holds<OhlcvMsg>());
+  EXPECT_EQ(front->Get<OhlcvMsg>(), ohlcv);
+  target.Pop();
+  EXPECT_EQ(target.Front(), nullptr);
+  EXPECT_EQ(target.Size(), 0);
+}
+
+TEST(SpscRecordQueueTests, TestFullAndWrapAround) {
+  SpscRecordQueue target{4096};
+  // Sizes that don't evenly divide the capacity so records wrap
+  std::uint64_t pushed{};
+  std::uint64_t popped{};
+  for (std::uint64_t round = 0; round < 20; ++round) {
+    while (true) {
+      auto mbo = MakeMbo(pushed);
+      if (!target.TryPush(Record{&mbo.hd})) {
+        break;
+      }
+      ++pushed;
+    }
+    EXPECT_GT(target.Size(), target.Capacity() - sizeof(MboMsg) * 2);
+    // Pop roughly half
+    const auto to_pop = (pushed - popped) / 2 + round % 3;
+    for (std::uint64_t i = 0; i < to_pop; ++i) {
+      const Record* front = target.Front();
+      ASSERT_NE(front, nullptr);
+      EXPECT_EQ(front->Get<MboMsg>().order_id, popped);
+      target.Pop();
+      ++popped;
+    }
+  }
+  const Record* front;
+  while ((front = target.Front()) != nullptr) {
+    EXPECT_EQ(front->Get<MboMsg>().order_id, popped);
+    target.Pop();
+    ++popped;
+  }
+  EXPECT_EQ(popped, pushed);
+}
+
+TEST(SpscRecordQueueTests, TestConcurrent) {
+  constexpr std::uint64_t kRecordCount = 100000;
+  SpscRecordQueue target{4096};
+  ScopedThread producer{[&target] {
+    for (std::uint64_t i = 0; i < kRecordCount; ++i) {
+      // Alternate sizes
+      if (i % 2 == 0) {
+        auto mbo = MakeMbo(i);
+        while (!target.TryPush(Record{&mbo.hd})) {
+          std::this_thread::yield();
+        }
+      } else {
+        auto ohlcv = MakeOhlcv(static_cast<std::int64_t>(i));
+        while (!target.TryPush(Record{&ohlcv.hd})) {
+          std::this_thread::yield();
+        }
+      }
+    }
+  }};
+  std::uint64_t popped{};
+  while (popped < kRecordCount) {
+    const Record* front = target.Front();
+    if (front == nullptr) {
+      std::this_thread::yield();
+      continue;
+    }
+    // Not asserting so the producer isn't left waiting on a full queue
+    if (popped % 2 == 0) {
+      EXPECT_TRUE(front->Holds<MboMsg>());
+      EXPECT_EQ(front->Get<MboMsg>().order_id, popped);
+    } else {
+      EXPECT_TRUE(front->Holds<OhlcvMsg>());
+      EXPECT_EQ(front->Get<OhlcvMsg>().open,
+                static_cast<std::int64_t>(popped));
+    }
+    target.Pop();
+    ++popped;
+  }
+  EXPECT_EQ(target.Front(), nullptr);
+}
+}  // namespace test
+}  // namespace detail
+}  // namespace databento
@@ -1,13 +1,23 @@
 #include <gtest/gtest.h>
 
+#include <chrono>
 #include <cstdint>
 #include <cstring>
 #include <string>
 #include <unordered_map>
+#include <utility>  // move
+#include <vector>
 
 #include "databento/compat.hpp"
+#include "databento/constants.hpp"
+#include "databento/datetime.hpp"
+#include "databento/dbn.hpp"
+#include "databento/dbn_file_store.hpp"
+#include "databento/enums.hpp"
+#include "databento/exceptions.hpp"
 #include "databento/record.hpp"
 #include "databento/symbol_map.hpp"
+#include "databento/timeseries.hpp"
 
 namespace databento {
 namespace test {
@@ -54,5 +64,188 @@ TEST(PitSymbolMapTests, TestOnRecord) {
   target.OnRecord(Record{&sm2.hd});
   ASSERT_EQ(target[1], "MSFT");
 }
+
+TEST(FlatPitSymbolMapTests, TestOnSymbolMapping) {
+  FlatPitSymbolMap target;
+  EXPECT_TRUE(target.IsEmpty());
+  EXPECT_EQ(target.Find(1), nullptr);
+  EXPECT_EQ(target.FindInstrumentId("AAPL"), nullptr);
+  target.OnSymbolMapping(GenMapping<SymbolMappingMsgV1>(1, "AAPL"));
+  target.OnSymbolMapping(GenMapping<SymbolMappingMsgV2>(2, "TSLA"));
+  target.OnSymbolMapping(GenMapping<SymbolMappingMsgV1>(3, "MSFT"));
+  const PitSymbolMap::Store exp{{1, "AAPL"}, {2, "TSLA"}, {3, "MSFT"}};
+  EXPECT_EQ(target.ToStore(), exp);
+  EXPECT_EQ(target.Size(), 3);
+  const char* aapl = target.Find(1);
+  EXPECT_STREQ(aapl, "AAPL");
+  EXPECT_EQ(*target.FindInstrumentId("TSLA"), 2);
+  target.OnSymbolMapping(GenMapping<SymbolMappingMsgV1>(10, "AAPL"));
+  target.OnSymbolMapping(GenMapping<SymbolMappingMsgV2>(1, "MSFT"));
+  EXPECT_EQ(target.Size(), 4);
+  // Symbols are interned
+  EXPECT_EQ(target.SymbolCount(), 3);
+  EXPECT_EQ(target.Find(10), aapl);
+  EXPECT_STREQ(target.Find(1), "MSFT");
+  EXPECT_EQ(*target.FindInstrumentId("AAPL"), 10);
+  EXPECT_EQ(*target.FindInstrumentId(std::string{"MSFT"}), 1);
+  EXPECT_EQ(target.FindInstrumentId("MSF"), nullptr);
+  target.Clear();
+  EXPECT_TRUE(target.IsEmpty());
+  EXPECT_EQ(target.Find(1), nullptr);
+  EXPECT_EQ(target.FindInstrumentId("MSFT"), nullptr);
+}
+
+TEST(FlatPitSymbolMapTests, TestRemapUnmapsPreviousSymbol) {
+  FlatPitSymbolMap target;
+  target.Insert(1, "ESZ3");
+  target.Insert(1, "ESH4");
+  EXPECT_EQ(target.FindInstrumentId("ESZ3"), nullptr);
+  EXPECT_EQ(*target.FindInstrumentId("ESH4"), 1);
+  // A symbol moving to another instrument stays mapped to the new one
+  target.Insert(2, "ESH4");
+  target.Insert(1, "ESM4");
+  EXPECT_EQ(*target.FindInstrumentId("ESH4"), 2);
+  EXPECT_EQ(*target.FindInstrumentId("ESM4"), 1);
+}
+
+TEST(FlatPitSymbolMapTests, TestMoveLeavesSourceEmpty) {
+  FlatPitSymbolMap source;
+  source.Insert(1, "ESZ3");
+  const char* symbol = source.Find(1);
+  FlatPitSymbolMap target{std::move(source)};
+  EXPECT_TRUE(source.IsEmpty());
+  // Inserting into the moved-from map mustn't write into the moved arena
+  source.Insert(2, "ESH4");
+  EXPECT_EQ(source.Find(1), nullptr);
+  EXPECT_STREQ(source.Find(2), "ESH4");
+  EXPECT_EQ(target.Find(1), symbol);
+  EXPECT_STREQ(target.Find(1), "ESZ3");
+  EXPECT_EQ(target.Find(2), nullptr);
+
+  target.Insert(3, "ESM4");
+  source = std::move(target);
+  EXPECT_TRUE(target.IsEmpty());
+  target.Insert(4, "ESU4");
+  EXPECT_STREQ(source.Find(1), "ESZ3");
+  EXPECT_STREQ(source.Find(3), "ESM4");
+  EXPECT_EQ(source.Find(4), nullptr);
+  EXPECT_STREQ(target.Find(4), "ESU4");
+}
+
+TEST(FlatPitSymbolMapTests, TestMatchesPitSymbolMap) {
+  FlatPitSymbolMap target{16};
+  PitSymbolMap expected;
+  std::vector<const char*> symbols;
+  // Enough to rehash several times and span multiple arena chunks
+  for (std::uint32_t i = 0; i < 20000; ++i) {
+    auto mapping = GenMapping<SymbolMappingMsgV2>(
+        i * 7919, ("SYM" + std::to_string(i / 2)).c_str());
+    target.OnRecord(Record{&mapping.hd});
+    expected.OnRecord(Record{&mapping.hd});
+    symbols.emplace_back(target.Find(i * 7919));
+  }
+  EXPECT_EQ(target.Size(), 20000);
+  EXPECT_EQ(target.SymbolCount(), 10000);
+  EXPECT_EQ(target.ToStore(), expected.Map());
+  for (std::uint32_t i = 0; i < 20000; ++i) {
+    // Symbols aren't moved by growth
+    ASSERT_EQ(target.Find(i * 7919), symbols[i]);
+    ASSERT_EQ(symbols[i], expected[i * 7919]);
+  }
+  EXPECT_EQ(*target.FindInstrumentId("SYM1234"), 2469 * 7919);
+}
+
+Metadata GenMetadata(SType stype_in, std::vector<SymbolMapping> mappings) {
+  Metadata res{};
+  res.version = kDbnVersion;
+  res.stype_in = stype_in;
+  res.stype_out = stype_in == SType::InstrumentId ? SType::RawSymbol
+                                                  : SType::InstrumentId;
+  res.mappings = std::move(mappings);
+  return res;
+}
+
+// 2023-11-02 UTC
+constexpr std::uint64_t kNov2Nanos = 1698883200000000000;
+constexpr std::uint64_t kNanosPerDay = 86400000000000;
+
+TEST(TsSymbolMapTests, TestFind) {
+  const TsSymbolMap target{GenMetadata(
+      SType::RawSymbol,
+      {SymbolMapping{"ESZ3",
+                     {MappingInterval{20231101, 20231102, "5481"},
+                      MappingInterval{20231102, 20231104, "5483"},
+                      // Didn't resolve
+                      MappingInterval{20231104, 20231105, ""}}},
+       SymbolMapping{"ES.FUT", {MappingInterval{20231101, 20231103, "5482"}}},
+       SymbolMapping{"NQZ3", {MappingInterval{20231101, 20231104, "10"}}}})};
+  EXPECT_EQ(target.Size(), 4);
+  EXPECT_EQ(target.SymbolCount(), 3);
+  EXPECT_EQ(*target.Find(20231101, 5481), "ESZ3");
+  EXPECT_EQ(*target.Find(20231102, 5482), "ES.FUT");
+  EXPECT_EQ(*target.Find(20231102, 5483), "ESZ3");
+  EXPECT_EQ(*target.Find(20231103, 5483), "ESZ3");
+  EXPECT_EQ(*target.Find(20231103, 10), "NQZ3");
+  // End dates are exclusive
+  EXPECT_EQ(target.Find(20231104, 5483), nullptr);
+  EXPECT_EQ(target.Find(20231103, 5482), nullptr);
+  EXPECT_EQ(target.Find(20231102, 5481), nullptr);
+  EXPECT_EQ(target.Find(20231031, 10), nullptr);
+  EXPECT_EQ(target.Find(20231102, 11), nullptr);
+  EXPECT_EQ(target.Find(20231102, 0), nullptr);
+  EXPECT_TRUE(TsSymbolMap{}.IsEmpty());
+  EXPECT_EQ(TsSymbolMap{}.Find(20231102, 10), nullptr);
+}
+
+TEST(TsSymbolMapTests, TestFindInverse) {
+  const TsSymbolMap target{GenMetadata(
+      SType::InstrumentId,
+      {SymbolMapping{"5482", {MappingInterval{20231101, 20231102, "ESZ3"},
+                              MappingInterval{20231102, 20231103, "ESH4"}}}})};
+  EXPECT_EQ(*target.Find(20231101, 5482), "ESZ3");
+  EXPECT_EQ(*target.Find(20231102, 5482), "ESH4");
+  ASSERT_THROW(
+      TsSymbolMap{GenMetadata(
+          SType::RawSymbol,
+          {SymbolMapping{"ESZ3", {MappingInterval{20231101, 20231102,
+                                                  "ESZ3"}}}})},
+      InvalidArgumentError);
+}
+
+TEST(TsSymbolMapTests, TestFindTimestamp) {
+  const TsSymbolMap target{GenMetadata(
+      SType::RawSymbol,
+      {SymbolMapping{"ESZ3", {MappingInterval{20231102, 20231103, "5482"}}}})};
+  const auto nanos = [](std::uint64_t count) {
+    return UnixNanos{UnixNanos::duration{count}};
+  };
+  EXPECT_EQ(target.Find(nanos(kNov2Nanos - 1), 5482), nullptr);
+  EXPECT_EQ(*target.Find(nanos(kNov2Nanos), 5482), "ESZ3");
+  EXPECT_EQ(*target.Find(nanos(kNov2Nanos + kNanosPerDay - 1), 5482), "ESZ3");
+  EXPECT_EQ(target.Find(nanos(kNov2Nanos + kNanosPerDay), 5482), nullptr);
+
+  TradeMsg trade{};
+  trade.hd.rtype = RType::Mbp0;
+  trade.hd.length = sizeof(TradeMsg) / RecordHeader::kLengthMultiplier;
+  trade.hd.instrument_id = 5482;
+  trade.ts_recv = nanos(kNov2Nanos + 1);
+  EXPECT_EQ(target.At(Record{&trade.hd}), "ESZ3");
+  trade.hd.instrument_id = 1;
+  ASSERT_THROW(target.At(Record{&trade.hd}), InvalidArgumentError);
+}
+
+TEST(TsSymbolMapTests, TestReplay) {
+  TsSymbolMap target;
+  std::size_t mapped_count{};
+  DbnFileStore{TEST_BUILD_DIR "/data/test_data.mbo.dbn"}.Replay(
+      [&target](Metadata&& metadata) { target.OnMetadata(metadata); },
+      target.Bind([&mapped_count](const Record&, const std::string& symbol) {
+        EXPECT_EQ(symbol, "ESH1");
+        ++mapped_count;
+        return KeepGoing::Continue;
+      }));
+  EXPECT_FALSE(target.IsEmpty());
+  EXPECT_GT(mapped_count, 0);
+}
 }  // namespace test
 }  // namespace databento
@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "databento/constants.hpp"
+#include "databento/dbn_file_store.hpp"
+#include "databento/enums.hpp"
+#include "databento/exceptions.hpp"
+#include "databento/record.hpp"
+#include "databento/tick_ladder_book.hpp"
+#include "databento/timeseries.hpp"
+
+namespace databento {
+namespace test {
+class TickLadderBookTests : public testing::Test {
+ protected:
+  static constexpr std::int64_t kTick = 25;
+
+  static void CheckLevel(const BidAskPair& level, std::int64_t bid_px,
+                         std::uint32_t bid_sz, std::int64_t ask_px,
+                         std::uint32_t ask_sz) {
+    EXPECT_EQ(level.bid_px, bid_px);
+    EXPECT_EQ(level.bid_sz, bid_sz);
+    EXPECT_EQ(level.ask_px, ask_px);
+    EXPECT_EQ(level.ask_sz, ask_sz);
+  }
+
+  // A window of 16 ticks
+  TickLadderBook target_{kTick, 16};
+};
+
+constexpr std::int64_t TickLadderBookTests::kTick;
+
+TEST_F(TickLadderBookTests, TestInvalidArguments) {
+  ASSERT_THROW(TickLadderBook(0), InvalidArgumentError);
+  ASSERT_THROW(TickLadderBook(-1), InvalidArgumentError);
+  ASSERT_THROW(TickLadderBook(1, 1), InvalidArgumentError);
+  InstrumentDefMsg definition{};
+  definition.min_price_increment = 250000000;
+  EXPECT_EQ(TickLadderBook{definition}.TickSize(), 250000000);
+  EXPECT_EQ(TickLadderBook{definition}.TickCount(),
+            TickLadderBook::kDefaultTickCount);
+}
+
+TEST_F(TickLadderBookTests, TestSetLevel) {
+  CheckLevel(target_.Bbo(), kUndefPrice, 0, kUndefPrice, 0);
+  target_.SetLevel(Side::Bid, 1000, 10, 2);
+  target_.SetLevel(Side::Bid, 950, 5, 1);
+  target_.SetLevel(Side::Ask, 1050, 7, 3);
+  target_.SetLevel(Side::Ask, 1100, 8, 1);
+  const auto bbo = target_.Bbo();
+  CheckLevel(bbo, 1000, 10, 1050, 7);
+  EXPECT_EQ(bbo.bid_ct, 2);
+  EXPECT_EQ(bbo.ask_ct, 3);
+  EXPECT_EQ(target_.DepthAt(Side::Bid, 950).size, 5);
+  EXPECT_EQ(target_.DepthAt(Side::Bid, 975).size, 0);
+  EXPECT_EQ(target_.DepthAt(Side::Ask, 950).size, 0);
+  EXPECT_EQ(target_.DepthAt(Side::Ask, 1100).count, 1);
+
+  std::vector<BidAskPair> levels(3);
+  ASSERT_EQ(target_.Snapshot(levels.data(), levels.size()), 2);
+  CheckLevel(levels[0], 1000, 10, 1050, 7);
+  CheckLevel(levels[1], 950, 5, 1100, 8);
+  CheckLevel(levels[2], kUndefPrice, 0, kUndefPrice, 0);
+
+  // Removing the best level finds the next one
+  target_.SetLevel(Side::Bid, 1000, 0, 0);
+  target_.SetLevel(Side::Ask, 1050, 0, 0);
+  CheckLevel(target_.Bbo(), 950, 5, 1100, 8);
+  target_.Clear();
+  CheckLevel(target_.Bbo(), kUndefPrice, 0, kUndefPrice, 0);
+}
+
+TEST_F(TickLadderBookTests, TestRecenter) {
+  target_.SetLevel(Side::Bid, 1000, 10, 1);
+  target_.SetLevel(Side::Ask, 1025, 10, 1);
+  EXPECT_EQ(target_.BasePrice(), 1000 - 8 * kTick);
+  // Too deep to fit in the window
+  target_.SetLevel(Side::Bid, 1000 - 10 * kTick, 10, 1);
+  EXPECT_EQ(target_.DroppedCount(), 1);
+  // The market drifts up
+  target_.SetLevel(Side::Bid, 1000 + 10 * kTick, 5, 1);
+  EXPECT_EQ(target_.DroppedCount(), 1);
+  EXPECT_EQ(target_.BasePrice(), 1000 + 2 * kTick);
+  // Fell out of the window
+  EXPECT_EQ(target_.DepthAt(Side::Bid, 1000).size, 0);
+  CheckLevel(target_.Bbo(), 1000 + 10 * kTick, 5, kUndefPrice, 0);
+  // And back down
+  target_.SetLevel(Side::Ask, 1000 - 20 * kTick, 3, 1);
+  EXPECT_EQ(target_.BasePrice(), 1000 - 28 * kTick);
+  CheckLevel(target_.Bbo(), kUndefPrice, 0, 1000 - 20 * kTick, 3);
+}
+
+TEST_F(TickLadderBookTests, TestApplyLevels) {
+  std::vector<BidAskPair> levels{{1000, 1050, 1, 2, 1, 1},
+                                 {975, 1075, 3, 4, 1, 1},
+                                 {950, 1100, 5, 6, 1, 1}};
+  target_.ApplyLevels(levels.data(), levels.size());
+  EXPECT_EQ(target_.Snapshot(3), levels);
+  // The best bid is removed and the asks shift down
+  levels = {{975, 1025, 3, 9, 1, 1},
+            {950, 1050, 5, 2, 1, 1},
+            {925, 1075, 7, 4, 1, 1}};
+  target_.ApplyLevels(levels.data(), levels.size());
+  EXPECT_EQ(target_.Snapshot(3), levels);
+  // Levels below the worst in the update are kept
+  levels.resize(2);
+  levels[0].bid_px = 950;
+  levels[1].bid_px = 925;
+  levels[0].ask_px = 1050;
+  levels[1].ask_px = 1075;
+  target_.ApplyLevels(levels.data(), levels.size());
+  EXPECT_EQ(target_.DepthAt(Side::Ask, 1100).size, 6);
+  EXPECT_EQ(target_.DepthAt(Side::Bid, 975).size, 0);
+  EXPECT_EQ(target_.DepthAt(Side::Ask, 1025).size, 0);
+  // An undefined price ends the side
+  levels[1].bid_px = kUndefPrice;
+  target_.ApplyLevels(levels.data(), levels.size());
+  const auto snapshot = target_.Snapshot(3);
+  EXPECT_EQ(snapshot[0].bid_px, 950);
+  EXPECT_EQ(snapshot[1].bid_px, kUndefPrice);
+  EXPECT_EQ(snapshot[2].ask_px, 1100);
+}
+
+TEST(TickLadderBookReplayTests, TestReplayMbp10) {
+  // ES has a tick size of 0.25
+  TickLadderBook target{250000000, 256};
+  std::size_t mbp_count{};
+  DbnFileStore{TEST_BUILD_DIR "/data/test_data.mbp-10.dbn.zst"}.Replay(
+      [&target, &mbp_count](const Record& record) {
+        const auto& mbp = record.Get<Mbp10Msg>();
+        target.Apply(mbp);
+        const auto snapshot = target.Snapshot(mbp.levels.size());
+        for (std::size_t i = 0; i < mbp.levels.size(); ++i) {
+          EXPECT_EQ(snapshot[i], mbp.levels[i]);
+        }
+        ++mbp_count;
+        return KeepGoing::Continue;
+      });
+  EXPECT_GT(mbp_count, 0);
+  EXPECT_EQ(target.DroppedCount(), 0);
+}
+}  // namespace test
+}  // namespace databento
@@ -3,12 +3,15 @@
 #include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <vector>
 
 #include "databento/compat.hpp"
 #include "databento/detail/file_stream.hpp"
 #include "databento/detail/zstd_stream.hpp"
 #include "databento/enums.hpp"
 #include "databento/ireadable.hpp"
+#include "databento/iwritable.hpp"
+#include "temp_file.hpp"
 
 namespace databento {
 namespace detail {
@@ -27,6 +30,33 @@ TEST(ZstdStreamTests, TestMultiFrameFiles) {
     EXPECT_EQ(def_msg.hd.rtype, databento::rtype::InstrumentDef);
   }
 }
+
+TEST(ZstdStreamTests, TestCompressMultiFrame) {
+  const TempFile temp_file{TEST_BUILD_DIR "/data/zstd_stream_test.zst"};
+  std::vector<std::uint8_t> expected(1024 * 1024);
+  for (std::size_t i = 0; i < expected.size(); ++i) {
+    expected[i] = static_cast<std::uint8_t>(i % 251);
+  }
+  {
+    databento::detail::ZstdCompressStream target{
+        std::unique_ptr<databento::IWritable>{
+            new databento::detail::OutFileStream{temp_file.Path()}}};
+    const auto half = expected.size() / 2;
+    target.WriteAll(expected.data(), half);
+    target.Flush();
+    target.EndFrame();
+    target.WriteAll(&expected[half], expected.size() - half);
+    target.EndFrame();
+  }
+  databento::detail::ZstdStream decompressed{
+      std::unique_ptr<databento::IReadable>{
+          new databento::detail::FileStream{temp_file.Path()}}};
+  std::vector<std::uint8_t> actual(expected.size());
+  decompressed.ReadExact(actual.data(), actual.size());
+  EXPECT_EQ(actual, expected);
+  std::uint8_t extra{};
+  EXPECT_EQ(decompressed.ReadSome(&extra, 1), 0);
+}
 }  // namespace test
 }  // namespace detail
 }  // namespace databento